@@ -13,7 +13,12 @@
 #include <summarystatsreduce.h>
 #include <transform.h>
 #include <scalar.h>
+#include <histogram.h>
+#include <ternary.h>
+#include <mask.h>
 #include <pointercast.h>
+#include <opcache.h>
+#include <opprofiler.h>
 /**
  * Native op executioner:
  *
@@ -21,27 +26,9 @@
 template <typename T>
 class NativeOpExcutioner {
 private:
-    functions::broadcast::BroadcastOpFactory<T> *broadcastOpFactory = new functions::broadcast::BroadcastOpFactory<T>();
-    functions::indexreduce::IndexReduceOpFactory<T> *indexReduceOpFactory = new functions::indexreduce::IndexReduceOpFactory<T>();
-    functions::pairwise_transforms::PairWiseTransformOpFactory<T> *pairWiseTransformOpFactory = new functions::pairwise_transforms::PairWiseTransformOpFactory<T>();
-    functions::reduce::ReduceOpFactory<T> *reduceOpFactory = new functions::reduce::ReduceOpFactory<T>();
-    functions::reduce3::Reduce3OpFactory<T> *reduce3OpFactory = new functions::reduce3::Reduce3OpFactory<T>();
-    functions::scalar::ScalarOpFactory<T> *scalarOpFactory = new functions::scalar::ScalarOpFactory<T>();
-    functions::summarystats::SummaryStatsReduceOpFactory<T> *summaryStatsReduceOpFactory = new functions::summarystats::SummaryStatsReduceOpFactory<T>();
-    functions::transform::TransformOpFactory<T> *transformOpFactory = new functions::transform::TransformOpFactory<T>();
+    nd4j::OpCache<T> *ops = nd4j::OpCache<T>::getInstance();
 
 public:
-    ~NativeOpExcutioner() {
-        delete broadcastOpFactory;
-        delete indexReduceOpFactory;
-        delete pairWiseTransformOpFactory;
-        delete reduceOpFactory;
-        delete reduce3OpFactory;
-        delete scalarOpFactory;
-        delete summaryStatsReduceOpFactory;
-        delete transformOpFactory;
-    }
-
     /**
      *
      * @param opNum
@@ -55,9 +42,9 @@ public:
                             T *x,
                             int *xShapeInfo,
                             T *extraParams) {
-        functions::indexreduce::IndexReduce<T> *op = indexReduceOpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_INDEX_REDUCE, opNum, xShapeInfo);
+        functions::indexreduce::IndexReduce<T> *op = ops->indexReduce(opNum);
         T ret = op->execScalar(x,xShapeInfo,extraParams);
-        delete op;
         return ret;
 
     }
@@ -80,9 +67,9 @@ public:
                          T *result,
                          int *resultShapeInfoBuffer,
                          int *dimension, int dimensionLength) {
-        functions::indexreduce::IndexReduce<T> *op = indexReduceOpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_INDEX_REDUCE, opNum, xShapeInfo, nullptr, resultShapeInfoBuffer);
+        functions::indexreduce::IndexReduce<T> *op = ops->indexReduce(opNum);
         op->exec(x,xShapeInfo,extraParams,result,resultShapeInfoBuffer,dimension,dimensionLength);
-        delete op;
     }
 
     /**
@@ -104,10 +91,33 @@ public:
                        int *yShapeInfo,
                        T *result,
                        int *dimension, int dimensionLength) {
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_BROADCAST, opNum, xShapeInfo, yShapeInfo, xShapeInfo);
 
-        functions::broadcast::Broadcast<T> *broadcast = broadcastOpFactory->getOp(opNum);
+        functions::broadcast::Broadcast<T> *broadcast = ops->broadcast(opNum);
         broadcast->exec(x, xShapeInfo, y, yShapeInfo, result, dimension, dimensionLength);
-        delete broadcast;
+    }
+
+    /**
+     * NumPy style broadcast of x and y to the result shape
+     * @param opNum
+     * @param x
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     */
+    void execBroadcast(int opNum,
+                       T *x,
+                       int *xShapeInfo,
+                       T *y,
+                       int *yShapeInfo,
+                       T *result,
+                       int *resultShapeInfo) {
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_BROADCAST, opNum, xShapeInfo, yShapeInfo, resultShapeInfo);
+
+        functions::broadcast::Broadcast<T> *broadcast = ops->broadcast(opNum);
+        broadcast->exec(x, xShapeInfo, y, yShapeInfo, result, resultShapeInfo);
     }
 
 
@@ -131,7 +141,8 @@ public:
                                T *result,
                                int resultStride,
                                T *extraParams, Nd4jIndex n) {
-        functions::pairwise_transforms::PairWiseTransform<T> *op = pairWiseTransformOpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_PAIRWISE, opNum, n, 3);
+        functions::pairwise_transforms::PairWiseTransform<T> *op = ops->pairwise(opNum);
         op->exec(
                 dx,
                 xStride,
@@ -141,7 +152,6 @@ public:
                 resultStride,
                 extraParams,
                 n);
-        delete op;
     }
 
     /**
@@ -164,7 +174,8 @@ public:
                                T *result,
                                int *resultShapeInfo,
                                T *extraParams) {
-        functions::pairwise_transforms::PairWiseTransform<T> *op = pairWiseTransformOpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_PAIRWISE, opNum, xShapeInfo, yShapeInfo, resultShapeInfo);
+        functions::pairwise_transforms::PairWiseTransform<T> *op = ops->pairwise(opNum);
         op->exec(dx,
                  xShapeInfo,
                  y,
@@ -172,7 +183,6 @@ public:
                  result,
                  resultShapeInfo,
                  extraParams);
-        delete op;
     }
 
     /**
@@ -198,7 +208,8 @@ public:
                                int *xIndexes,
                                int *yIndexes,
                                int *resultIndexes) {
-        functions::pairwise_transforms::PairWiseTransform<T> *op = pairWiseTransformOpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_PAIRWISE, opNum, xShapeInfo, yShapeInfo, resultShapeInfo);
+        functions::pairwise_transforms::PairWiseTransform<T> *op = ops->pairwise(opNum);
         op->exec(dx,
                  xShapeInfo,
                  y,
@@ -209,7 +220,42 @@ public:
                  xIndexes,
                  yIndexes,
                  resultIndexes);
-        delete op;
+    }
+
+    /**
+     * Elementwise op over three inputs
+     * @param opNum
+     * @param dx
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param z
+     * @param zShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param extraParams
+     */
+    void execTernaryTransform(int opNum,
+                              T *dx,
+                              int *xShapeInfo,
+                              T *y,
+                              int *yShapeInfo,
+                              T *z,
+                              int *zShapeInfo,
+                              T *result,
+                              int *resultShapeInfo,
+                              T *extraParams) {
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_TERNARY, opNum, xShapeInfo, yShapeInfo, resultShapeInfo, zShapeInfo);
+        functions::ternary::TernaryTransform<T> *op = ops->ternary(opNum);
+        op->exec(dx,
+                 xShapeInfo,
+                 y,
+                 yShapeInfo,
+                 z,
+                 zShapeInfo,
+                 result,
+                 resultShapeInfo,
+                 extraParams);
     }
 
 
@@ -231,9 +277,9 @@ public:
                     int *resultShapeInfo,
                     int *dimension,
                     int dimensionLength) {
-        functions::reduce::ReduceFunction<T> *reduceFunction = reduceOpFactory->create(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_REDUCE, opNum, xShapeInfo, nullptr, resultShapeInfo);
+        functions::reduce::ReduceFunction<T> *reduceFunction = ops->reduce(opNum);
         reduceFunction->exec(x,xShapeInfo,extraParams,result,resultShapeInfo,dimension,dimensionLength);
-        delete reduceFunction;
     }
 
     /**
@@ -248,9 +294,9 @@ public:
                        T *x,
                        int *xShapeInfo,
                        T *extraParams) {
-        functions::reduce::ReduceFunction<T> *reduceFunction = reduceOpFactory->create(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_REDUCE, opNum, xShapeInfo);
+        functions::reduce::ReduceFunction<T> *reduceFunction = ops->reduce(opNum);
         T ret = reduceFunction->execScalar(x,xShapeInfo,extraParams);
-        delete reduceFunction;
         return ret;
     }
     /**
@@ -271,9 +317,9 @@ public:
                      T *y,
                      int *yShapeInfo,
                      T *result, int *resultShapeInfo) {
-        functions::reduce3::Reduce3<T> *reduce3 = reduce3OpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_REDUCE3, opNum, xShapeInfo, yShapeInfo, resultShapeInfo);
+        functions::reduce3::Reduce3<T> *reduce3 = ops->reduce3(opNum);
         reduce3->exec(x,xShapeInfo,extraParamsVals,y,yShapeInfo,result,resultShapeInfo);
-        delete reduce3;
 
     }
 
@@ -297,9 +343,9 @@ public:
                         T *extraParamsVals,
                         T *y,
                         int *yShapeInfo) {
-        functions::reduce3::Reduce3<T> *reduce3 = reduce3OpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_REDUCE3, opNum, xShapeInfo, yShapeInfo);
+        functions::reduce3::Reduce3<T> *reduce3 = ops->reduce3(opNum);
         T ret = reduce3->execScalar(x,xShapeInfo,extraParamsVals,y,yShapeInfo);
-        delete reduce3;
         return ret;
 
     }
@@ -327,9 +373,9 @@ public:
                      int *resultShapeInfoBuffer,
                      int *dimension,
                      int dimensionLength) {
-        functions::reduce3::Reduce3<T> *reduce3 = reduce3OpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_REDUCE3, opNum, xShapeInfo, yShapeInfo, resultShapeInfoBuffer);
+        functions::reduce3::Reduce3<T> *reduce3 = ops->reduce3(opNum);
         reduce3->exec(x,xShapeInfo,extraParamsVals,y,yShapeInfo,result,resultShapeInfoBuffer,dimension,dimensionLength);
-        delete reduce3;
 
     }
 
@@ -352,9 +398,9 @@ public:
                     T scalar,
                     T *extraParams,
                     Nd4jIndex n) {
-        functions::scalar::ScalarTransform<T> *scalarTransform = scalarOpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_SCALAR, opNum, n, 2);
+        functions::scalar::ScalarTransform<T> *scalarTransform = ops->scalar(opNum);
         scalarTransform->transform(x,xStride,result,resultStride,scalar,extraParams,n);
-        delete scalarTransform;
 
 
     }
@@ -378,14 +424,14 @@ public:
                     int *resultShapeInfo,
                     T scalar,
                     T *extraParams) {
-        functions::scalar::ScalarTransform<T> *scalarTransform = scalarOpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_SCALAR, opNum, xShapeInfo, nullptr, resultShapeInfo);
+        functions::scalar::ScalarTransform<T> *scalarTransform = ops->scalar(opNum);
         scalarTransform->transform(x,
                                    xShapeInfo,
                                    result,
                                    resultShapeInfo,
                                    scalar,
                                    extraParams);
-        delete scalarTransform;
 
 
     }
@@ -410,7 +456,8 @@ public:
                     T *extraParams,
                     int *xIndexes,
                     int *resultIndexes) {
-        functions::scalar::ScalarTransform<T> *scalarTransform = scalarOpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_SCALAR, opNum, xShapeInfo, nullptr, resultShapeInfo);
+        functions::scalar::ScalarTransform<T> *scalarTransform = ops->scalar(opNum);
         scalarTransform->transform(x,
                                    xShapeInfo,
                                    result,
@@ -419,11 +466,46 @@ public:
                                    extraParams,
                                    xIndexes,
                                    resultIndexes);
-        delete scalarTransform;
 
 
     }
 
+    /**
+     * Scalar op with one scalar per tensor along dimension
+     * @param opNum
+     * @param x
+     * @param xShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param scalars
+     * @param scalarsShapeInfo
+     * @param extraParams
+     * @param dimension
+     * @param dimensionLength
+     */
+    void execScalar(int opNum,
+                    T *x,
+                    int *xShapeInfo,
+                    T *result,
+                    int *resultShapeInfo,
+                    T *scalars,
+                    int *scalarsShapeInfo,
+                    T *extraParams,
+                    int *dimension,
+                    int dimensionLength) {
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_SCALAR, opNum, xShapeInfo, scalarsShapeInfo, resultShapeInfo);
+        functions::scalar::ScalarTransform<T> *scalarTransform = ops->scalar(opNum);
+        scalarTransform->transform(x,
+                                   xShapeInfo,
+                                   result,
+                                   resultShapeInfo,
+                                   scalars,
+                                   scalarsShapeInfo,
+                                   extraParams,
+                                   dimension,
+                                   dimensionLength);
+    }
+
     /**
      *
      * @param opNum
@@ -439,9 +521,9 @@ public:
                           T *extraParams,
                           T *result,
                           int *resultShapeInfo,bool biasCorrected) {
-        functions::summarystats::SummaryStatsReduce<T> *op = summaryStatsReduceOpFactory->getOp(opNum,biasCorrected);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_SUMMARY_STATS, opNum, xShapeInfo, nullptr, resultShapeInfo);
+        functions::summarystats::SummaryStatsReduce<T> *op = ops->summaryStats(opNum,biasCorrected);
         op->exec(x,xShapeInfo,extraParams,result,resultShapeInfo);
-        delete op;
     }
 
     /**
@@ -457,9 +539,9 @@ public:
                              T *x,
                              int *xShapeInfo,
                              T *extraParams,bool biasCorrected) {
-        functions::summarystats::SummaryStatsReduce<T> *op = summaryStatsReduceOpFactory->getOp(opNum,biasCorrected);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_SUMMARY_STATS, opNum, xShapeInfo);
+        functions::summarystats::SummaryStatsReduce<T> *op = ops->summaryStats(opNum,biasCorrected);
         T ret = op->execScalar(x,xShapeInfo,extraParams);
-        delete op;
         return ret;
     }
 
@@ -480,7 +562,8 @@ public:
                           T *result,
                           int *resultShapeInfoBuffer,
                           int *dimension, int dimensionLength, bool biasCorrected) {
-        functions::summarystats::SummaryStatsReduce<T> *op = summaryStatsReduceOpFactory->getOp(opNum,biasCorrected);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_SUMMARY_STATS, opNum, xShapeInfo, nullptr, resultShapeInfoBuffer);
+        functions::summarystats::SummaryStatsReduce<T> *op = ops->summaryStats(opNum,biasCorrected);
         op->exec(x,
                  xShapeInfo,
                  extraParams,
@@ -488,7 +571,6 @@ public:
                  resultShapeInfoBuffer,
                  dimension,
                  dimensionLength);
-        delete op;
 
     }
 
@@ -511,14 +593,14 @@ public:
                        int resultStride,
                        T *extraParams,
                        Nd4jIndex n) {
-        functions::transform::Transform<T> *transform = transformOpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_TRANSFORM, opNum, n, 2);
+        functions::transform::Transform<T> *transform = ops->transform(opNum);
         transform->exec(dx,
                         xStride,
                         result,
                         resultStride,
                         extraParams,
                         n);
-        delete transform;
 
     }
 
@@ -538,13 +620,13 @@ public:
                        T *result,
                        int *resultShapeInfo,
                        T *extraParams) {
-        functions::transform::Transform<T> *transform = transformOpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_TRANSFORM, opNum, xShapeInfo, nullptr, resultShapeInfo);
+        functions::transform::Transform<T> *transform = ops->transform(opNum);
         transform->exec(dx,
                         xShapeInfo,
                         result,
                         resultShapeInfo,
                         extraParams);
-        delete transform;
 
     }
 
@@ -566,7 +648,8 @@ public:
                        T *extraParams,
                        Nd4jIndex *xIndexes,
                        Nd4jIndex *resultIndexes) {
-        functions::transform::Transform<T> *transform = transformOpFactory->getOp(opNum);
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_TRANSFORM, opNum, xShapeInfo, nullptr, resultShapeInfo);
+        functions::transform::Transform<T> *transform = ops->transform(opNum);
         transform->exec(dx,
                         xShapeInfo,
                         result,
@@ -574,11 +657,184 @@ public:
                         extraParams,
                         xIndexes,
                         resultIndexes);
-        delete transform;
 
     }
 
 
+
+    /**
+     * Histogram of x, optionally per tensor along dimension
+     * @param x the input
+     * @param xShapeInfo the shape information for the input
+     * @param result the result buffer
+     * @param resultShapeInfo the shape information for the result
+     * @param numBins the number of bins
+     * @param min the lower edge of the first bin
+     * @param max the upper edge of the last bin (min >= max: use the data range)
+     * @param dimension the dimensions (may be null for the whole array)
+     * @param dimensionLength the length of the dimension buffer
+     */
+    void execHistogram(T *x,
+                       int *xShapeInfo,
+                       T *result,
+                       int *resultShapeInfo,
+                       int numBins,
+                       T min,
+                       T max,
+                       int *dimension,
+                       int dimensionLength) {
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_HISTOGRAM, 0, xShapeInfo, nullptr, resultShapeInfo);
+        functions::histogram::Histogram<T> histogram;
+        histogram.exec(x, xShapeInfo, result, resultShapeInfo, numBins, min, max, dimension, dimensionLength);
+    }
+
+    /**
+     * Approximate quantiles of x, optionally per tensor along dimension
+     * @param x the input
+     * @param xShapeInfo the shape information for the input
+     * @param probabilities the quantiles to estimate
+     * @param numQuantiles the number of quantiles
+     * @param compression the t-digest compression
+     * @param result the result buffer
+     * @param resultShapeInfo the shape information for the result
+     * @param dimension the dimensions (may be null for the whole array)
+     * @param dimensionLength the length of the dimension buffer
+     */
+    void execQuantiles(T *x,
+                       int *xShapeInfo,
+                       T *probabilities,
+                       int numQuantiles,
+                       T compression,
+                       T *result,
+                       int *resultShapeInfo,
+                       int *dimension,
+                       int dimensionLength) {
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_QUANTILES, 0, xShapeInfo, nullptr, resultShapeInfo);
+        functions::histogram::Quantiles<T> quantiles;
+        quantiles.exec(x, xShapeInfo, probabilities, numQuantiles, compression, result, resultShapeInfo, dimension, dimensionLength);
+    }
+
+
+    /**
+     * Pairwise comparison writing a mask
+     * @param opNum the pairwise comparison op
+     * @param x
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param extraParams
+     * @param mask
+     * @param packed whether to write a bit mask
+     */
+    void execCompareMask(int opNum,
+                         T *x,
+                         int *xShapeInfo,
+                         T *y,
+                         int *yShapeInfo,
+                         T *extraParams,
+                         unsigned char *mask,
+                         bool packed) {
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_COMPARE_MASK, opNum, xShapeInfo, yShapeInfo);
+        functions::pairwise_transforms::PairWiseTransform<T> *op = ops->pairwise(opNum);
+        functions::mask::Mask<T> masks;
+        masks.compare(op, x, xShapeInfo, y, yShapeInfo, extraParams, mask, packed);
+    }
+
+    /**
+     * Scalar comparison writing a mask
+     * @param opNum the scalar comparison op
+     * @param x
+     * @param xShapeInfo
+     * @param scalar
+     * @param extraParams
+     * @param mask
+     * @param packed whether to write a bit mask
+     */
+    void execScalarCompareMask(int opNum,
+                               T *x,
+                               int *xShapeInfo,
+                               T scalar,
+                               T *extraParams,
+                               unsigned char *mask,
+                               bool packed) {
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_SCALAR_COMPARE_MASK, opNum, xShapeInfo);
+        functions::scalar::ScalarTransform<T> *op = ops->scalar(opNum);
+        functions::mask::Mask<T> masks;
+        masks.compare(op, x, xShapeInfo, scalar, extraParams, mask, packed);
+    }
+
+    /**
+     * Transform applied where the mask is set
+     * @param opNum
+     * @param x
+     * @param xShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param extraParams
+     * @param mask
+     * @param packed whether the mask is a bit mask
+     */
+    void execMaskedTransform(int opNum,
+                             T *x,
+                             int *xShapeInfo,
+                             T *result,
+                             int *resultShapeInfo,
+                             T *extraParams,
+                             unsigned char *mask,
+                             bool packed) {
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_MASKED_TRANSFORM, opNum, xShapeInfo, nullptr, resultShapeInfo);
+        functions::transform::Transform<T> *op = ops->transform(opNum);
+        functions::mask::Mask<T> masks;
+        masks.transform(op, x, xShapeInfo, result, resultShapeInfo, extraParams, mask, packed);
+    }
+
+    /**
+     * Reduction over the elements where the mask is set
+     * @param opNum
+     * @param x
+     * @param xShapeInfo
+     * @param extraParams
+     * @param mask
+     * @param packed whether the mask is a bit mask
+     * @return
+     */
+    T execMaskedReduceScalar(int opNum,
+                             T *x,
+                             int *xShapeInfo,
+                             T *extraParams,
+                             unsigned char *mask,
+                             bool packed) {
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_MASKED_REDUCE, opNum, xShapeInfo);
+        functions::reduce::ReduceFunction<T> *op = ops->reduce(opNum);
+        functions::mask::Mask<T> masks;
+        T ret = masks.reduce(op, x, xShapeInfo, extraParams, mask, packed);
+        return ret;
+    }
+
+    /**
+     * result = mask ? x : y
+     * @param x
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param mask
+     * @param packed whether the mask is a bit mask
+     */
+    void execSelect(T *x,
+                    int *xShapeInfo,
+                    T *y,
+                    int *yShapeInfo,
+                    T *result,
+                    int *resultShapeInfo,
+                    unsigned char *mask,
+                    bool packed) {
+        nd4j::OpProfileScope<T> profile(nd4j::OP_FAMILY_SELECT, 0, xShapeInfo, yShapeInfo, resultShapeInfo);
+        functions::mask::Mask<T> masks;
+        masks.select(x, xShapeInfo, y, yShapeInfo, result, resultShapeInfo, mask, packed);
+    }
+
 };
 
 
@@ -93,6 +93,27 @@ public:
             Nd4jPointer resultShapeInfo,
             Nd4jPointer dimension, int dimensionLength);
 
+    /**
+     * NumPy style broadcasting: x and y are both broadcast
+     * to the shape of the result without being tiled.
+     * @param opNum
+     * @param x
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     */
+    void   execBroadcastDouble(
+            Nd4jPointer *extraPointers,
+            int opNum,
+            Nd4jPointer x,
+            Nd4jPointer xShapeInfo,
+            Nd4jPointer y,
+            Nd4jPointer yShapeInfo,
+            Nd4jPointer result,
+            Nd4jPointer resultShapeInfo);
+
 
 
     /**
@@ -167,6 +188,34 @@ public:
             Nd4jPointer  resultShapeInfo,
             Nd4jPointer extraParams);
 
+    /**
+     * Elementwise op over three inputs, result = op(x, y, z):
+     * 0: fused multiply add, 1: axpby, 2: select, 3: clamp
+     * @param extraPointers
+     * @param opNum
+     * @param dx
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param z
+     * @param zShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param extraParams
+     */
+    void execTernaryTransformDouble(
+            Nd4jPointer *extraPointers,
+            int opNum,
+            Nd4jPointer dx,
+            Nd4jPointer xShapeInfo,
+            Nd4jPointer y,
+            Nd4jPointer yShapeInfo,
+            Nd4jPointer z,
+            Nd4jPointer zShapeInfo,
+            Nd4jPointer result,
+            Nd4jPointer resultShapeInfo,
+            Nd4jPointer extraParams);
+
     /**
      *
      * @param opNum
@@ -333,6 +382,30 @@ public:
                           Nd4jIndex n,
                           Nd4jPointer xIndexes,
                           Nd4jPointer resultIndexes);
+
+    /**
+     * Scalar op with one scalar per tensor along dimension:
+     * tensor i is combined with scalars[i]
+     * @param opNum
+     * @param x
+     * @param xShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param scalars
+     * @param scalarsShapeInfo
+     * @param extraParams
+     * @param dimension
+     * @param dimensionLength
+     */
+    void execScalarAlongDimensionDouble(Nd4jPointer *extraPointers,int opNum,
+                          Nd4jPointer x,
+                          Nd4jPointer xShapeInfo,
+                          Nd4jPointer result,
+                          Nd4jPointer resultShapeInfo,
+                          Nd4jPointer scalars,
+                          Nd4jPointer scalarsShapeInfo,
+                          Nd4jPointer extraParams,
+                          Nd4jPointer dimension, int dimensionLength);
     /**
      *
      * @param opNum
@@ -482,6 +555,27 @@ public:
             Nd4jPointer resultShapeInfo,
             Nd4jPointer dimension, int dimensionLength);
 
+    /**
+     * NumPy style broadcasting: x and y are both broadcast
+     * to the shape of the result without being tiled.
+     * @param opNum
+     * @param x
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     */
+    void   execBroadcastFloat(
+            Nd4jPointer *extraPointers,
+            int opNum,
+            Nd4jPointer x,
+            Nd4jPointer xShapeInfo,
+            Nd4jPointer y,
+            Nd4jPointer yShapeInfo,
+            Nd4jPointer result,
+            Nd4jPointer resultShapeInfo);
+
 
 
     /**
@@ -553,6 +647,34 @@ public:
                                     Nd4jPointer  resultShapeInfo,
                                     Nd4jPointer extraParams);
 
+    /**
+     * Elementwise op over three inputs, result = op(x, y, z):
+     * 0: fused multiply add, 1: axpby, 2: select, 3: clamp
+     * @param extraPointers
+     * @param opNum
+     * @param dx
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param z
+     * @param zShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param extraParams
+     */
+    void execTernaryTransformFloat(
+            Nd4jPointer *extraPointers,
+            int opNum,
+            Nd4jPointer dx,
+            Nd4jPointer xShapeInfo,
+            Nd4jPointer y,
+            Nd4jPointer yShapeInfo,
+            Nd4jPointer z,
+            Nd4jPointer zShapeInfo,
+            Nd4jPointer result,
+            Nd4jPointer resultShapeInfo,
+            Nd4jPointer extraParams);
+
     /**
      *
      * @param opNum
@@ -718,6 +840,30 @@ public:
                          Nd4jPointer extraParams,
                          Nd4jPointer xIndexes,
                          Nd4jPointer resultIndexes);
+
+    /**
+     * Scalar op with one scalar per tensor along dimension:
+     * tensor i is combined with scalars[i]
+     * @param opNum
+     * @param x
+     * @param xShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param scalars
+     * @param scalarsShapeInfo
+     * @param extraParams
+     * @param dimension
+     * @param dimensionLength
+     */
+    void execScalarAlongDimensionFloat(Nd4jPointer *extraPointers,int opNum,
+                          Nd4jPointer x,
+                          Nd4jPointer xShapeInfo,
+                          Nd4jPointer result,
+                          Nd4jPointer resultShapeInfo,
+                          Nd4jPointer scalars,
+                          Nd4jPointer scalarsShapeInfo,
+                          Nd4jPointer extraParams,
+                          Nd4jPointer dimension, int dimensionLength);
     /**
      *
      * @param opNum
@@ -879,6 +1025,480 @@ public:
             Nd4jPointer result,
             Nd4jPointer resultShapeInfo, Nd4jPointer *tadPointers, Nd4jPointer *offsetPointers);
 
+    /**
+     * Histogram with numBins equal width bins over [min, max].
+     * Values outside of the range are ignored; if min >= max
+     * the range is taken from the data. With a dimension the
+     * result holds numBins counts per tensor along dimension.
+     * @param extraPointers
+     * @param x the input
+     * @param xShapeInfo the shape information for the input
+     * @param result the result buffer
+     * @param resultShapeInfo the shape information for the result
+     * @param numBins the number of bins
+     * @param min the lower edge of the first bin
+     * @param max the upper edge of the last bin
+     * @param dimension the dimensions (may be null for the whole array)
+     * @param dimensionLength the length of the dimension buffer
+     */
+    void execHistogramFloat(Nd4jPointer *extraPointers,
+                            Nd4jPointer x,
+                            Nd4jPointer xShapeInfo,
+                            Nd4jPointer result,
+                            Nd4jPointer resultShapeInfo,
+                            int numBins,
+                            double min,
+                            double max,
+                            Nd4jPointer dimension,
+                            int dimensionLength);
+
+    /**
+     * Approximate quantiles (t-digest). With a dimension
+     * the result holds numQuantiles estimates per tensor
+     * along dimension.
+     * @param extraPointers
+     * @param x the input
+     * @param xShapeInfo the shape information for the input
+     * @param quantiles the quantiles to estimate, each in [0, 1]
+     * @param numQuantiles the number of quantiles
+     * @param compression the t-digest compression (100 is a sensible default)
+     * @param result the result buffer
+     * @param resultShapeInfo the shape information for the result
+     * @param dimension the dimensions (may be null for the whole array)
+     * @param dimensionLength the length of the dimension buffer
+     */
+    void execQuantilesFloat(Nd4jPointer *extraPointers,
+                            Nd4jPointer x,
+                            Nd4jPointer xShapeInfo,
+                            Nd4jPointer quantiles,
+                            int numQuantiles,
+                            double compression,
+                            Nd4jPointer result,
+                            Nd4jPointer resultShapeInfo,
+                            Nd4jPointer dimension,
+                            int dimensionLength);
+
+    /**
+     * Histogram with numBins equal width bins over [min, max].
+     * Values outside of the range are ignored; if min >= max
+     * the range is taken from the data. With a dimension the
+     * result holds numBins counts per tensor along dimension.
+     * @param extraPointers
+     * @param x the input
+     * @param xShapeInfo the shape information for the input
+     * @param result the result buffer
+     * @param resultShapeInfo the shape information for the result
+     * @param numBins the number of bins
+     * @param min the lower edge of the first bin
+     * @param max the upper edge of the last bin
+     * @param dimension the dimensions (may be null for the whole array)
+     * @param dimensionLength the length of the dimension buffer
+     */
+    void execHistogramDouble(Nd4jPointer *extraPointers,
+                            Nd4jPointer x,
+                            Nd4jPointer xShapeInfo,
+                            Nd4jPointer result,
+                            Nd4jPointer resultShapeInfo,
+                            int numBins,
+                            double min,
+                            double max,
+                            Nd4jPointer dimension,
+                            int dimensionLength);
+
+    /**
+     * Approximate quantiles (t-digest). With a dimension
+     * the result holds numQuantiles estimates per tensor
+     * along dimension.
+     * @param extraPointers
+     * @param x the input
+     * @param xShapeInfo the shape information for the input
+     * @param quantiles the quantiles to estimate, each in [0, 1]
+     * @param numQuantiles the number of quantiles
+     * @param compression the t-digest compression (100 is a sensible default)
+     * @param result the result buffer
+     * @param resultShapeInfo the shape information for the result
+     * @param dimension the dimensions (may be null for the whole array)
+     * @param dimensionLength the length of the dimension buffer
+     */
+    void execQuantilesDouble(Nd4jPointer *extraPointers,
+                            Nd4jPointer x,
+                            Nd4jPointer xShapeInfo,
+                            Nd4jPointer quantiles,
+                            int numQuantiles,
+                            double compression,
+                            Nd4jPointer result,
+                            Nd4jPointer resultShapeInfo,
+                            Nd4jPointer dimension,
+                            int dimensionLength);
+
+    /**
+     * Pairwise comparison (EqualTo, GreaterThan, LessThan, ...)
+     * writing a uint8 mask (one byte per element) or, when
+     * packed is set, a bit mask ((length + 7) / 8 bytes,
+     * least significant bit first). Mask element i is
+     * element i of x in x's own order.
+     * @param extraPointers
+     * @param opNum the pairwise transform op number
+     * @param x
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param extraParams
+     * @param mask the mask to write
+     * @param packed non zero for a bit mask
+     */
+    void execCompareMaskFloat(Nd4jPointer *extraPointers,
+                            int opNum,
+                            Nd4jPointer x,
+                            Nd4jPointer xShapeInfo,
+                            Nd4jPointer y,
+                            Nd4jPointer yShapeInfo,
+                            Nd4jPointer extraParams,
+                            Nd4jPointer mask,
+                            int packed);
+
+    /**
+     * Scalar comparison (LessThan, GreaterThan, Equals, ...)
+     * writing a uint8 or bit mask, see execCompareMaskFloat
+     * @param extraPointers
+     * @param opNum the scalar op number
+     * @param x
+     * @param xShapeInfo
+     * @param scalar
+     * @param extraParams
+     * @param mask the mask to write
+     * @param packed non zero for a bit mask
+     */
+    void execScalarCompareMaskFloat(Nd4jPointer *extraPointers,
+                                  int opNum,
+                                  Nd4jPointer x,
+                                  Nd4jPointer xShapeInfo,
+                                  double scalar,
+                                  Nd4jPointer extraParams,
+                                  Nd4jPointer mask,
+                                  int packed);
+
+    /**
+     * Transform applied only where the mask is set,
+     * other result elements are left untouched
+     * @param extraPointers
+     * @param opNum the transform op number
+     * @param x
+     * @param xShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param extraParams
+     * @param mask
+     * @param packed non zero for a bit mask
+     */
+    void execMaskedTransformFloat(Nd4jPointer *extraPointers,
+                                int opNum,
+                                Nd4jPointer x,
+                                Nd4jPointer xShapeInfo,
+                                Nd4jPointer result,
+                                Nd4jPointer resultShapeInfo,
+                                Nd4jPointer extraParams,
+                                Nd4jPointer mask,
+                                int packed);
+
+    /**
+     * Reduction over the elements where the mask is set
+     * @param extraPointers
+     * @param opNum the reduce op number
+     * @param x
+     * @param xShapeInfo
+     * @param extraParams
+     * @param mask
+     * @param packed non zero for a bit mask
+     * @return
+     */
+    float execMaskedReduceScalarFloat(Nd4jPointer *extraPointers,
+                                    int opNum,
+                                    Nd4jPointer x,
+                                    Nd4jPointer xShapeInfo,
+                                    Nd4jPointer extraParams,
+                                    Nd4jPointer mask,
+                                    int packed);
+
+    /**
+     * result = mask ? x : y, mask element i is element i
+     * of the result in the result's own order
+     * @param extraPointers
+     * @param x
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param mask
+     * @param packed non zero for a bit mask
+     */
+    void execSelectFloat(Nd4jPointer *extraPointers,
+                       Nd4jPointer x,
+                       Nd4jPointer xShapeInfo,
+                       Nd4jPointer y,
+                       Nd4jPointer yShapeInfo,
+                       Nd4jPointer result,
+                       Nd4jPointer resultShapeInfo,
+                       Nd4jPointer mask,
+                       int packed);
+
+    /**
+     * Pairwise comparison (EqualTo, GreaterThan, LessThan, ...)
+     * writing a uint8 mask (one byte per element) or, when
+     * packed is set, a bit mask ((length + 7) / 8 bytes,
+     * least significant bit first). Mask element i is
+     * element i of x in x's own order.
+     * @param extraPointers
+     * @param opNum the pairwise transform op number
+     * @param x
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param extraParams
+     * @param mask the mask to write
+     * @param packed non zero for a bit mask
+     */
+    void execCompareMaskDouble(Nd4jPointer *extraPointers,
+                            int opNum,
+                            Nd4jPointer x,
+                            Nd4jPointer xShapeInfo,
+                            Nd4jPointer y,
+                            Nd4jPointer yShapeInfo,
+                            Nd4jPointer extraParams,
+                            Nd4jPointer mask,
+                            int packed);
+
+    /**
+     * Scalar comparison (LessThan, GreaterThan, Equals, ...)
+     * writing a uint8 or bit mask, see execCompareMaskDouble
+     * @param extraPointers
+     * @param opNum the scalar op number
+     * @param x
+     * @param xShapeInfo
+     * @param scalar
+     * @param extraParams
+     * @param mask the mask to write
+     * @param packed non zero for a bit mask
+     */
+    void execScalarCompareMaskDouble(Nd4jPointer *extraPointers,
+                                  int opNum,
+                                  Nd4jPointer x,
+                                  Nd4jPointer xShapeInfo,
+                                  double scalar,
+                                  Nd4jPointer extraParams,
+                                  Nd4jPointer mask,
+                                  int packed);
+
+    /**
+     * Transform applied only where the mask is set,
+     * other result elements are left untouched
+     * @param extraPointers
+     * @param opNum the transform op number
+     * @param x
+     * @param xShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param extraParams
+     * @param mask
+     * @param packed non zero for a bit mask
+     */
+    void execMaskedTransformDouble(Nd4jPointer *extraPointers,
+                                int opNum,
+                                Nd4jPointer x,
+                                Nd4jPointer xShapeInfo,
+                                Nd4jPointer result,
+                                Nd4jPointer resultShapeInfo,
+                                Nd4jPointer extraParams,
+                                Nd4jPointer mask,
+                                int packed);
+
+    /**
+     * Reduction over the elements where the mask is set
+     * @param extraPointers
+     * @param opNum the reduce op number
+     * @param x
+     * @param xShapeInfo
+     * @param extraParams
+     * @param mask
+     * @param packed non zero for a bit mask
+     * @return
+     */
+    double execMaskedReduceScalarDouble(Nd4jPointer *extraPointers,
+                                    int opNum,
+                                    Nd4jPointer x,
+                                    Nd4jPointer xShapeInfo,
+                                    Nd4jPointer extraParams,
+                                    Nd4jPointer mask,
+                                    int packed);
+
+    /**
+     * result = mask ? x : y, mask element i is element i
+     * of the result in the result's own order
+     * @param extraPointers
+     * @param x
+     * @param xShapeInfo
+     * @param y
+     * @param yShapeInfo
+     * @param result
+     * @param resultShapeInfo
+     * @param mask
+     * @param packed non zero for a bit mask
+     */
+    void execSelectDouble(Nd4jPointer *extraPointers,
+                       Nd4jPointer x,
+                       Nd4jPointer xShapeInfo,
+                       Nd4jPointer y,
+                       Nd4jPointer yShapeInfo,
+                       Nd4jPointer result,
+                       Nd4jPointer resultShapeInfo,
+                       Nd4jPointer mask,
+                       int packed);
+
+    /**
+     * Runs a batch of ops in one call, see opbatch.h
+     * for the descriptor layout
+     * @param extraPointers
+     * @param descriptors numOps * nd4j::DESCRIPTOR_LENGTH packed op descriptors
+     * @param numOps the number of ops
+     */
+    void execBatchFloat(Nd4jPointer *extraPointers, Nd4jPointer descriptors, int numOps);
+
+    /**
+     * Runs a batch of ops in one call, see opbatch.h
+     * for the descriptor layout
+     * @param extraPointers
+     * @param descriptors numOps * nd4j::DESCRIPTOR_LENGTH packed op descriptors
+     * @param numOps the number of ops
+     */
+    void execBatchDouble(Nd4jPointer *extraPointers, Nd4jPointer descriptors, int numOps);
+
+    /**
+     * Creates an empty lazy op graph, see opgraph.h
+     */
+    Nd4jPointer createGraphFloat();
+
+    /**
+     * Adds an existing array to a graph
+     * @return the id of the value, -1 if refused (see opgraph.h)
+     */
+    int graphInputFloat(Nd4jPointer graph, Nd4jPointer x, Nd4jPointer xShapeInfo);
+
+    /**
+     * Records a transform of value x
+     * @return the id of the value, -1 if the op is refused (see opgraph.h)
+     */
+    int graphTransformFloat(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams);
+
+    /**
+     * Records a scalar op of value x
+     * @return the id of the value, -1 if the op is refused (see opgraph.h)
+     */
+    int graphScalarFloat(Nd4jPointer graph, int opNum, int x, float scalar, Nd4jPointer extraParams);
+
+    /**
+     * Records a pairwise op of values x and y
+     * @return the id of the value, -1 if the op is refused (see opgraph.h)
+     */
+    int graphPairwiseFloat(Nd4jPointer graph, int opNum, int x, int y, Nd4jPointer extraParams);
+
+    /**
+     * Records a broadcast op of value x and value y,
+     * broadcast NumPy style to the shape of x
+     * @return the id of the value, -1 if the op is refused (see opgraph.h)
+     */
+    int graphBroadcastFloat(Nd4jPointer graph, int opNum, int x, int y);
+
+    /**
+     * Records a reduction over all of value x,
+     * written to result[0] when the graph runs
+     * @return the id of the node, -1 if the op is refused (see opgraph.h)
+     */
+    int graphReduceFloat(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams, Nd4jPointer result);
+
+    /**
+     * Asks for a value to be written to result when the graph
+     * runs; values nothing asks for are never written
+     * @return 0, or -1 if refused: resultShapeInfo must
+     * have the value's shape (see opgraph.h)
+     */
+    int graphOutputFloat(Nd4jPointer graph, int value, Nd4jPointer result, Nd4jPointer resultShapeInfo);
+
+    /**
+     * Runs a graph, fusing its elementwise ops
+     * @return 0, or -1 without running anything if
+     * the graph has a node that was refused
+     */
+    int execGraphFloat(Nd4jPointer *extraPointers, Nd4jPointer graph);
+
+    /**
+     * Frees a graph
+     */
+    void deleteGraphFloat(Nd4jPointer graph);
+
+    /**
+     * Creates an empty lazy op graph, see opgraph.h
+     */
+    Nd4jPointer createGraphDouble();
+
+    /**
+     * Adds an existing array to a graph
+     * @return the id of the value, -1 if refused (see opgraph.h)
+     */
+    int graphInputDouble(Nd4jPointer graph, Nd4jPointer x, Nd4jPointer xShapeInfo);
+
+    /**
+     * Records a transform of value x
+     * @return the id of the value, -1 if the op is refused (see opgraph.h)
+     */
+    int graphTransformDouble(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams);
+
+    /**
+     * Records a scalar op of value x
+     * @return the id of the value, -1 if the op is refused (see opgraph.h)
+     */
+    int graphScalarDouble(Nd4jPointer graph, int opNum, int x, double scalar, Nd4jPointer extraParams);
+
+    /**
+     * Records a pairwise op of values x and y
+     * @return the id of the value, -1 if the op is refused (see opgraph.h)
+     */
+    int graphPairwiseDouble(Nd4jPointer graph, int opNum, int x, int y, Nd4jPointer extraParams);
+
+    /**
+     * Records a broadcast op of value x and value y,
+     * broadcast NumPy style to the shape of x
+     * @return the id of the value, -1 if the op is refused (see opgraph.h)
+     */
+    int graphBroadcastDouble(Nd4jPointer graph, int opNum, int x, int y);
+
+    /**
+     * Records a reduction over all of value x,
+     * written to result[0] when the graph runs
+     * @return the id of the node, -1 if the op is refused (see opgraph.h)
+     */
+    int graphReduceDouble(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams, Nd4jPointer result);
+
+    /**
+     * Asks for a value to be written to result when the graph
+     * runs; values nothing asks for are never written
+     * @return 0, or -1 if refused: resultShapeInfo must
+     * have the value's shape (see opgraph.h)
+     */
+    int graphOutputDouble(Nd4jPointer graph, int value, Nd4jPointer result, Nd4jPointer resultShapeInfo);
+
+    /**
+     * Runs a graph, fusing its elementwise ops
+     * @return 0, or -1 without running anything if
+     * the graph has a node that was refused
+     */
+    int execGraphDouble(Nd4jPointer *extraPointers, Nd4jPointer graph);
+
+    /**
+     * Frees a graph
+     */
+    void deleteGraphDouble(Nd4jPointer graph);
+
     /**
      * This method implementation exists only for cuda.
      * The other backends should have dummy method for JNI compatibility reasons.
@@ -887,11 +1507,17 @@ public:
 
 
     /**
-     * This method acquires memory chunk of requested size on host side
+     * This method acquires memory chunk of requested size on host side.
+     * The CPU backend serves it from a size class pool,
+     * so it must be released with freeHost
      *
      * @param pointer pointer that'll be used for allocation
      * @param memorySize memory size, in bytes
-     * @param flags optional parameter
+     * @param flags optional parameter. On CPU these are nd4j::HostAllocFlags
+     * or'ed together: 1 for 64 byte alignment (always given), 2 for transparent
+     * huge page advice, 4 for explicit huge pages and 8 to prefault every page;
+     * 16, 32 and 64 place the pages on the node of the thread touching them
+     * first, round robin over every node or on the node given in bits 16 and up
      */
     Nd4jPointer mallocHost(long memorySize, int flags);
 
@@ -938,6 +1564,12 @@ public:
 
     Nd4jPointer destroyEvent(Nd4jPointer event);
 
+    /**
+     * Runs what is still queued on a stream, then frees
+     * it; events recorded on it can still be waited on
+     */
+    Nd4jPointer destroyStream(Nd4jPointer stream);
+
     Nd4jPointer setBlasStream(Nd4jPointer handle, Nd4jPointer stream);
 
     Nd4jPointer setDevice(Nd4jPointer ptrToDeviceId);
@@ -970,7 +1602,192 @@ public:
 
     void setGridLimit(int gridSize);
 
-    void tadOnlyShapeInfo(Nd4jPointer xShapeInfo, Nd4jPointer dimension, int dimensionLength, Nd4jPointer targetBuffer, Nd4jPointer offsetsBuffer);
+    /**
+     * Copies the TAD shape information and the TAD offsets
+     * for the given shape and dimensions in to the target
+     * and offsets buffers. TADs come from the shared TAD cache.
+     * @param xShapeInfo the shape information of the array
+     * @param dimension the dimensions to do the TAD along
+     * @param dimensionLength the number of dimensions
+     * @param targetBuffer the buffer for the TAD shape information
+     * @param offsetsBuffer the buffer for the TAD offsets (one int per TAD)
+     * @return 0, or -1 without writing anything when an offset does not
+     * fit an int; tadOnlyShapeInfo64 takes those arrays
+     */
+    int tadOnlyShapeInfo(Nd4jPointer xShapeInfo, Nd4jPointer dimension, int dimensionLength, Nd4jPointer targetBuffer, Nd4jPointer offsetsBuffer);
+
+    /**
+     * tadOnlyShapeInfo with 64 bit offsets, for
+     * arrays of more than 2^31 - 1 elements
+     * @param offsetsBuffer the buffer for the TAD offsets (one Nd4jIndex per TAD)
+     */
+    void tadOnlyShapeInfo64(Nd4jPointer xShapeInfo, Nd4jPointer dimension, int dimensionLength, Nd4jPointer targetBuffer, Nd4jPointer offsetsBuffer);
+
+    /**
+     * Limits the TAD cache, least recently used entries
+     * are evicted first. A maxEntries of 0 disables the cache.
+     * @param maxEntries the maximum number of cached TADs
+     * @param maxBytes the maximum number of bytes held by cached TADs
+     */
+    void setTadCacheLimits(int maxEntries, Nd4jIndex maxBytes);
+
+    /**
+     * Drops every entry of the TAD cache
+     */
+    void purgeTadCache();
+
+    /**
+     * The number of TAD cache lookups served from the cache
+     */
+    Nd4jIndex getTadCacheHits();
+
+    /**
+     * The number of TAD cache lookups that had to build the TAD
+     */
+    Nd4jIndex getTadCacheMisses();
+
+    /**
+     * The number of TADs evicted from the cache
+     */
+    Nd4jIndex getTadCacheEvictions();
+
+    /**
+     * Limits the memory the host pool behind mallocHost / freeHost
+     * keeps for reuse. Lowering the limits releases cached memory
+     * to the OS. Has no effect on backends that do not pool host memory.
+     * @param maxCachedBytes the maximum number of free bytes kept overall
+     * @param maxThreadCachedBytes the maximum number of free bytes kept by each thread
+     */
+    void setHostPoolLimits(Nd4jIndex maxCachedBytes, Nd4jIndex maxThreadCachedBytes);
+
+    /**
+     * Releases the memory cached by the host pool to the OS
+     */
+    void purgeHostPool();
+
+    /**
+     * The number of bytes handed out by mallocHost and not yet freed
+     */
+    Nd4jIndex getHostPoolBytesInUse();
+
+    /**
+     * The number of freed bytes the host pool keeps for reuse
+     */
+    Nd4jIndex getHostPoolBytesCached();
+
+    /**
+     * The number of mallocHost calls served from the host pool
+     */
+    Nd4jIndex getHostPoolHits();
+
+    /**
+     * The number of mallocHost calls that had to go to the OS
+     */
+    Nd4jIndex getHostPoolMisses();
+
+    /**
+     * The alignment, in bytes, of a buffer returned by mallocHost,
+     * so callers can pick aligned code paths
+     * @param pointer the buffer
+     * @return the alignment, 0 for a null pointer
+     */
+    int getHostAlignment(Nd4jPointer pointer);
+
+    /**
+     * Runs the parallel loops of the CPU kernels on the internal
+     * work stealing thread pool instead of OpenMP
+     * @param reallyEnable true for the thread pool, false for OpenMP
+     */
+    void enableThreadPool(bool reallyEnable);
+
+    /**
+     * Caps the number of pool threads helping kernels at any one
+     * time, shared by every thread calling in to NativeOps
+     * @param threads the most helper threads, 0 to run every call on its own thread
+     */
+    void setThreadPoolConcurrency(int threads);
+
+    /**
+     * Creates an execution context: exec* calls handed it in
+     * extraPointers[0] run with their own thread budget and,
+     * optionally, pinned to a set of cores, whatever
+     * setOmpNumThreads says
+     * @param threads the most threads a call may use, 0 for no limit
+     * @param cores the ids of the cores to run on (int), 0 for any
+     * @param numCores the number of cores
+     */
+    Nd4jPointer createExecutionContext(int threads, Nd4jPointer cores, int numCores);
+
+    /**
+     * Destroys a context made by createExecutionContext;
+     * no call using it may still be running or queued
+     */
+    void destroyExecutionContext(Nd4jPointer context);
+
+    /**
+     * The number of NUMA nodes of the machine, 1 without NUMA
+     */
+    int getNumaNodes();
+
+    /**
+     * Pins the OpenMP threads of the calling thread to NUMA nodes,
+     * consecutive threads on the same node, so the ranges kernels hand
+     * each thread stay on the pages that thread placed with
+     * mallocHost(size, 16 | 8), until unbindThreadsFromNumaNodes
+     * @return the number of threads that could not be pinned
+     */
+    int bindThreadsToNumaNodes();
+
+    /**
+     * Lets the OpenMP threads of the calling thread run on
+     * every core again after bindThreadsToNumaNodes
+     * @return the number of threads that could not be unbound
+     */
+    int unbindThreadsFromNumaNodes();
+
+    /**
+     * Turns per op counting on or off: calls, wall time, elements
+     * and bytes per (op family, op number, data type)
+     */
+    void enableOpProfiling(bool reallyEnable);
+
+    /**
+     * Zeroes the per op counters
+     */
+    void resetOpProfile();
+
+    /**
+     * Writes the per op counters, the most total time first,
+     * as a text table or as a JSON array. Like snprintf, at most
+     * length - 1 characters and a terminating 0 are written.
+     * @param buffer the destination, may be null when length is 0
+     * @param length the size of buffer
+     * @param json whether to write JSON rather than text
+     * @return the length of the whole profile, without the 0
+     */
+    int getOpProfile(char *buffer, int length, bool json);
+
+    /**
+     * Turns the op timeline on or off: a ring of the latest
+     * begin and end events of op calls, with their thread,
+     * op and shape
+     */
+    void enableOpTrace(bool reallyEnable);
+
+    /**
+     * Drops every event of the op timeline
+     */
+    void clearOpTrace();
+
+    /**
+     * Writes the op timeline in the Chrome trace event format,
+     * for chrome://tracing. Like snprintf, at most length - 1
+     * characters and a terminating 0 are written.
+     * @param buffer the destination, may be null when length is 0
+     * @param length the size of buffer
+     * @return the length of the whole trace, without the 0
+     */
+    int getOpTrace(char *buffer, int length);
 
 };
 
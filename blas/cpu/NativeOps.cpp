@@ -6,37 +6,37 @@
 #include "../NativeOpExcutioner.h"
 #include <pointercast.h>
 #include <pairwise_util.h>
+#include <tadcache.h>
+#include <hostpool.h>
+#include <cpustream.h>
+#include <hostcopy.h>
+#include <opbatch.h>
+#include <opgraph.h>
+#include <threadpool.h>
+#include <executioncontext.h>
+#include <numaplacement.h>
+#include <opprofiler.h>
+#include <optrace.h>
 
 class DoubleNativeOpExecutioner : public NativeOpExcutioner<double> {
-private:
-    static DoubleNativeOpExecutioner *DOUBLE_INSTANCE;
 public:
     static DoubleNativeOpExecutioner * getInstance() {
-        if(DOUBLE_INSTANCE == nullptr)
-            DOUBLE_INSTANCE = new DoubleNativeOpExecutioner();
-        return DOUBLE_INSTANCE;
+        //C++11 runs this initializer exactly once, even with concurrent first calls
+        static DoubleNativeOpExecutioner *instance = new DoubleNativeOpExecutioner();
+        return instance;
     }
 };
 
 class FloatNativeOpExecutioner : public NativeOpExcutioner<float> {
-private:
-    static FloatNativeOpExecutioner *FLOAT_INSTANCE ;
 public:
     static FloatNativeOpExecutioner * getInstance() {
-        if(FLOAT_INSTANCE == nullptr)
-            FLOAT_INSTANCE = new FloatNativeOpExecutioner();
-        return FLOAT_INSTANCE;
+        static FloatNativeOpExecutioner *instance = new FloatNativeOpExecutioner();
+        return instance;
     }
 };
 
 
 
-
-FloatNativeOpExecutioner *FloatNativeOpExecutioner::FLOAT_INSTANCE = nullptr;
-DoubleNativeOpExecutioner *DoubleNativeOpExecutioner::DOUBLE_INSTANCE = nullptr;
-
-
-
 /**
  *
  * @param opNum
@@ -48,6 +48,10 @@ double   NativeOps::execIndexReduceScalarDouble(Nd4jPointer *extraPointers,int o
                                                 Nd4jPointer x,
                                                 Nd4jPointer xShapeInfo,
                                                 Nd4jPointer extraParams) {
+    nd4j::ExecutionScope scope(extraPointers);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers))
+        stream->synchronize();
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
@@ -73,6 +77,13 @@ void   NativeOps::execIndexReduceDouble(Nd4jPointer *extraPointers,int opNum,
                                         Nd4jPointer result,
                                         Nd4jPointer resultShapeInfoBuffer,
                                         Nd4jPointer dimension, int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execIndexReduceDouble(nullptr, opNum, x, xShapeInfo, extraParams, result, resultShapeInfoBuffer, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
@@ -105,6 +116,13 @@ void   NativeOps::execBroadcastDouble(Nd4jPointer *extraPointers,int opNum,
                                       Nd4jPointer result,
                                       Nd4jPointer resultShapeInfo,
                                       Nd4jPointer dimension, int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execBroadcastDouble(nullptr, opNum, x, xShapeInfo, y, yShapeInfo, result, resultShapeInfo, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *yPointer = reinterpret_cast<double *>(y);
@@ -124,6 +142,47 @@ void   NativeOps::execBroadcastDouble(Nd4jPointer *extraPointers,int opNum,
 }
 
 
+/**
+ * NumPy style broadcasting of x and y to the result shape
+ * @param opNum
+ * @param x
+ * @param xShapeInfo
+ * @param y
+ * @param yShapeInfo
+ * @param result
+ * @param resultShapeInfo
+ */
+void   NativeOps::execBroadcastDouble(Nd4jPointer *extraPointers,int opNum,
+                                      Nd4jPointer x,
+                                      Nd4jPointer xShapeInfo,
+                                      Nd4jPointer y,
+                                      Nd4jPointer yShapeInfo,
+                                      Nd4jPointer result,
+                                      Nd4jPointer resultShapeInfo) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execBroadcastDouble(nullptr, opNum, x, xShapeInfo, y, yShapeInfo, result, resultShapeInfo); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    double *xPointer = reinterpret_cast<double *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    double *yPointer = reinterpret_cast<double *>(y);
+    int *yShapeInfoPointer = reinterpret_cast<int *>(yShapeInfo);
+    double *resultPointer = reinterpret_cast<double *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    DoubleNativeOpExecutioner::getInstance()->execBroadcast(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            yPointer,
+            yShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer);
+}
+
+
 
 /**
  *
@@ -145,6 +204,13 @@ void   NativeOps::execPairwiseTransformDouble(Nd4jPointer *extraPointers,int opN
                                               Nd4jPointer result,
                                               int resultStride,
                                               Nd4jPointer extraParams, Nd4jIndex n) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execPairwiseTransformDouble(nullptr, opNum, dx, xStride, y, yStride, result, resultStride, extraParams, n); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(dx);
     double *yPointer = reinterpret_cast<double *>(y);
     double *resultPointer = reinterpret_cast<double *>(result);
@@ -180,6 +246,13 @@ void NativeOps::execPairwiseTransformDouble(
         Nd4jPointer xIndexes,
         Nd4jPointer yIndexes,
         Nd4jPointer resultIndexes) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execPairwiseTransformDouble(nullptr, opNum, dx, xShapeInfo, y, yShapeInfo, result, resultShapeInfo, extraParams, xIndexes, yIndexes, resultIndexes); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(dx);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *yPointer = reinterpret_cast<double *>(y);
@@ -226,6 +299,13 @@ void NativeOps::execPairwiseTransformDouble(
         Nd4jPointer result,
         Nd4jPointer  resultShapeInfo,
         Nd4jPointer extraParams) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execPairwiseTransformDouble(nullptr, opNum, dx, xShapeInfo, y, yShapeInfo, result, resultShapeInfo, extraParams); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(dx);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *yPointer = reinterpret_cast<double *>(y);
@@ -244,6 +324,61 @@ void NativeOps::execPairwiseTransformDouble(
             extraParamsPointer);
 }
 
+/**
+ * Elementwise op over three inputs
+ * @param extraPointers
+ * @param opNum
+ * @param dx
+ * @param xShapeInfo
+ * @param y
+ * @param yShapeInfo
+ * @param z
+ * @param zShapeInfo
+ * @param result
+ * @param resultShapeInfo
+ * @param extraParams
+ */
+void NativeOps::execTernaryTransformDouble(
+        Nd4jPointer *extraPointers,
+        int opNum,
+        Nd4jPointer dx,
+        Nd4jPointer xShapeInfo,
+        Nd4jPointer y,
+        Nd4jPointer yShapeInfo,
+        Nd4jPointer z,
+        Nd4jPointer zShapeInfo,
+        Nd4jPointer result,
+        Nd4jPointer resultShapeInfo,
+        Nd4jPointer extraParams) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execTernaryTransformDouble(nullptr, opNum, dx, xShapeInfo, y, yShapeInfo, z, zShapeInfo, result, resultShapeInfo, extraParams); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    double *xPointer = reinterpret_cast<double *>(dx);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    double *yPointer = reinterpret_cast<double *>(y);
+    int *yShapeInfoPointer = reinterpret_cast<int *>(yShapeInfo);
+    double *zPointer = reinterpret_cast<double *>(z);
+    int *zShapeInfoPointer = reinterpret_cast<int *>(zShapeInfo);
+    double *resultPointer = reinterpret_cast<double *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
+    DoubleNativeOpExecutioner::getInstance()->execTernaryTransform(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            yPointer,
+            yShapeInfoPointer,
+            zPointer,
+            zShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer,
+            extraParamsPointer);
+}
+
 /**
  *
  * @param opNum
@@ -261,6 +396,13 @@ void   NativeOps::execReduceDouble(
         Nd4jPointer extraParams,
         Nd4jPointer result,
         Nd4jPointer resultShapeInfo) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execReduceDouble(nullptr, opNum, x, xShapeInfo, extraParams, result, resultShapeInfo); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *resultPointer = reinterpret_cast<double *>(result);
@@ -289,6 +431,13 @@ void   NativeOps::execReduceDouble(Nd4jPointer *extraPointers,int opNum,
                                    Nd4jPointer result,
                                    Nd4jPointer resultShapeInfo,
                                    Nd4jPointer dimension,int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execReduceDouble(nullptr, opNum, x, xShapeInfo, extraParams, result, resultShapeInfo, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *resultPointer = reinterpret_cast<double *>(result);
@@ -311,6 +460,10 @@ double NativeOps::execReduceScalarDouble(Nd4jPointer *extraPointers,int opNum,
                                          Nd4jPointer x,
                                          Nd4jPointer xShapeInfo,
                                          Nd4jPointer extraParams) {
+    nd4j::ExecutionScope scope(extraPointers);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers))
+        stream->synchronize();
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
@@ -336,6 +489,13 @@ void   NativeOps::execReduce3Double(Nd4jPointer *extraPointers,int opNum,
                                     Nd4jPointer yShapeInfo,
                                     Nd4jPointer result,
                                     Nd4jPointer resultShapeInfo) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execReduce3Double(nullptr, opNum, x, xShapeInfo, extraParamsVals, y, yShapeInfo, result, resultShapeInfo); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *yPointer = reinterpret_cast<double *>(y);
@@ -361,6 +521,10 @@ double   NativeOps::execReduce3ScalarDouble(Nd4jPointer *extraPointers,int opNum
                                             Nd4jPointer extraParamsVals,
                                             Nd4jPointer y,
                                             Nd4jPointer yShapeInfo) {
+    nd4j::ExecutionScope scope(extraPointers);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers))
+        stream->synchronize();
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *yPointer = reinterpret_cast<double *>(y);
@@ -391,6 +555,13 @@ void   NativeOps::execReduce3Double(Nd4jPointer *extraPointers,int opNum,
                                     Nd4jPointer resultShapeInfoBuffer,
                                     Nd4jPointer dimension,
                                     int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execReduce3Double(nullptr, opNum, x, xShapeInfo, extraParamsVals, y, yShapeInfo, result, resultShapeInfoBuffer, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *yPointer = reinterpret_cast<double *>(y);
@@ -432,6 +603,13 @@ void   NativeOps::execScalarDouble(
         double scalar,
         Nd4jPointer extraParams,
         Nd4jIndex n) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execScalarDouble(nullptr, opNum, x, xStride, result, resultStride, scalar, extraParams, n); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(x);
     double *resultPointer = reinterpret_cast<double *>(result);
     double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
@@ -467,6 +645,13 @@ void NativeOps::execScalarDouble(
         Nd4jPointer resultShapeInfo,
         double scalar,
         Nd4jPointer extraParams) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execScalarDouble(nullptr, opNum, x, xShapeInfo, result, resultShapeInfo, scalar, extraParams); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *resultPointer = reinterpret_cast<double *>(result);
@@ -507,6 +692,13 @@ void NativeOps::execScalarDouble(
         Nd4jIndex n,
         Nd4jPointer xIndexes,
         Nd4jPointer resultIndexes) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execScalarDouble(nullptr, opNum, x, xShapeInfo, result, resultShapeInfo, scalar, extraParams, n, xIndexes, resultIndexes); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *resultPointer = reinterpret_cast<double *>(result);
@@ -526,6 +718,58 @@ void NativeOps::execScalarDouble(
             resultIndexesPointer);
 
 }
+
+/**
+ * Scalar op with one scalar per tensor along dimension
+ * @param opNum
+ * @param x
+ * @param xShapeInfo
+ * @param result
+ * @param resultShapeInfo
+ * @param scalars
+ * @param scalarsShapeInfo
+ * @param extraParams
+ * @param dimension
+ * @param dimensionLength
+ */
+void NativeOps::execScalarAlongDimensionDouble(
+        Nd4jPointer *extraPointers,
+        int opNum,
+        Nd4jPointer x,
+        Nd4jPointer xShapeInfo,
+        Nd4jPointer result,
+        Nd4jPointer resultShapeInfo,
+        Nd4jPointer scalars,
+        Nd4jPointer scalarsShapeInfo,
+        Nd4jPointer extraParams,
+        Nd4jPointer dimension, int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execScalarAlongDimensionDouble(nullptr, opNum, x, xShapeInfo, result, resultShapeInfo, scalars, scalarsShapeInfo, extraParams, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    double *xPointer = reinterpret_cast<double *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    double *resultPointer = reinterpret_cast<double *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    double *scalarsPointer = reinterpret_cast<double *>(scalars);
+    int *scalarsShapeInfoPointer = reinterpret_cast<int *>(scalarsShapeInfo);
+    double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
+    int *dimensionPointer = reinterpret_cast<int *>(dimension);
+    DoubleNativeOpExecutioner::getInstance()->execScalar(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer,
+            scalarsPointer,
+            scalarsShapeInfoPointer,
+            extraParamsPointer,
+            dimensionPointer,
+            dimensionLength);
+}
 /**
  *
  * @param opNum
@@ -536,6 +780,10 @@ void NativeOps::execScalarDouble(
 double   NativeOps::execSummaryStatsScalarDouble(Nd4jPointer *extraPointers, int opNum,Nd4jPointer x,
                                                  Nd4jPointer xShapeInfo,
                                                  Nd4jPointer extraParams,bool biasCorrected) {
+    nd4j::ExecutionScope scope(extraPointers);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers))
+        stream->synchronize();
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
@@ -560,6 +808,13 @@ void   NativeOps::execSummaryStatsDouble(Nd4jPointer *extraPointers, int opNum,
                                          Nd4jPointer extraParams,
                                          Nd4jPointer result,
                                          Nd4jPointer resultShapeInfo,bool biasCorrected) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execSummaryStatsDouble(nullptr, opNum, x, xShapeInfo, extraParams, result, resultShapeInfo, biasCorrected); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *resultPointer = reinterpret_cast<double *>(result);
@@ -591,6 +846,13 @@ void   NativeOps::execSummaryStatsDouble(Nd4jPointer *extraPointers, int opNum,N
                                          Nd4jPointer result,
                                          Nd4jPointer resultShapeInfoBuffer,
                                          Nd4jPointer dimension, int dimensionLength,bool biasCorrected) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execSummaryStatsDouble(nullptr, opNum, x, xShapeInfo, extraParams, result, resultShapeInfoBuffer, dimension, dimensionLength, biasCorrected); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *resultPointer = reinterpret_cast<double *>(result);
@@ -624,6 +886,13 @@ void   NativeOps::execTransformDouble(Nd4jPointer *extraPointers, int opNum,
                                       Nd4jPointer result,
                                       int resultStride,
                                       Nd4jPointer extraParams, Nd4jIndex n) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execTransformDouble(nullptr, opNum, dx, xStride, result, resultStride, extraParams, n); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(dx);
     double *resultPointer = reinterpret_cast<double *>(result);
     double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
@@ -648,6 +917,13 @@ void   NativeOps::execTransformDouble(
         Nd4jPointer result,
         Nd4jPointer resultShapeInfo,
         Nd4jPointer extraParams) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execTransformDouble(nullptr, opNum, dx, xShapeInfo, result, resultShapeInfo, extraParams); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(dx);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *resultPointer = reinterpret_cast<double *>(result);
@@ -682,6 +958,13 @@ void   NativeOps::execTransformDouble(
         Nd4jPointer extraParams,
         Nd4jPointer xIndexes,
         Nd4jPointer resultIndexes) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execTransformDouble(nullptr, opNum, dx, xShapeInfo, result, resultShapeInfo, extraParams, xIndexes, resultIndexes); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     double *xPointer = reinterpret_cast<double *>(dx);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     double *resultPointer = reinterpret_cast<double *>(result);
@@ -712,6 +995,10 @@ float   NativeOps::execIndexReduceScalarFloat(Nd4jPointer *extraPointers, int op
                                               Nd4jPointer x,
                                               Nd4jPointer xShapeInfo,
                                               Nd4jPointer extraParams) {
+    nd4j::ExecutionScope scope(extraPointers);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers))
+        stream->synchronize();
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
@@ -736,6 +1023,13 @@ void   NativeOps::execIndexReduceFloat(Nd4jPointer *extraPointers, int opNum,
                                        Nd4jPointer result,
                                        Nd4jPointer resultShapeInfoBuffer,
                                        Nd4jPointer dimension, int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execIndexReduceFloat(nullptr, opNum, x, xShapeInfo, extraParams, result, resultShapeInfoBuffer, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
@@ -765,6 +1059,13 @@ void   NativeOps::execBroadcastFloat(Nd4jPointer *extraPointers,int opNum,
                                      Nd4jPointer yShapeInfo,
                                      Nd4jPointer result,Nd4jPointer resultShapeInfo,
                                      Nd4jPointer dimension, int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execBroadcastFloat(nullptr, opNum, x, xShapeInfo, y, yShapeInfo, result, resultShapeInfo, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *yPointer = reinterpret_cast<float *>(y);
@@ -776,6 +1077,47 @@ void   NativeOps::execBroadcastFloat(Nd4jPointer *extraPointers,int opNum,
 }
 
 
+/**
+ * NumPy style broadcasting of x and y to the result shape
+ * @param opNum
+ * @param x
+ * @param xShapeInfo
+ * @param y
+ * @param yShapeInfo
+ * @param result
+ * @param resultShapeInfo
+ */
+void   NativeOps::execBroadcastFloat(Nd4jPointer *extraPointers,int opNum,
+                                      Nd4jPointer x,
+                                      Nd4jPointer xShapeInfo,
+                                      Nd4jPointer y,
+                                      Nd4jPointer yShapeInfo,
+                                      Nd4jPointer result,
+                                      Nd4jPointer resultShapeInfo) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execBroadcastFloat(nullptr, opNum, x, xShapeInfo, y, yShapeInfo, result, resultShapeInfo); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    float *xPointer = reinterpret_cast<float *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    float *yPointer = reinterpret_cast<float *>(y);
+    int *yShapeInfoPointer = reinterpret_cast<int *>(yShapeInfo);
+    float *resultPointer = reinterpret_cast<float *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    FloatNativeOpExecutioner::getInstance()->execBroadcast(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            yPointer,
+            yShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer);
+}
+
+
 
 /**
  *
@@ -799,6 +1141,13 @@ void   NativeOps::execPairwiseTransformFloat(
         Nd4jPointer result,
         int resultStride,
         Nd4jPointer extraParams, Nd4jIndex n) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execPairwiseTransformFloat(nullptr, opNum, dx, xStride, y, yStride, result, resultStride, extraParams, n); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(dx);
     float *yPointer = reinterpret_cast<float *>(y);
     float *resultPointer = reinterpret_cast<float *>(result);
@@ -843,6 +1192,13 @@ void NativeOps::execPairwiseTransformFloat(
         Nd4jPointer xIndexes,
         Nd4jPointer yIndexes,
         Nd4jPointer resultIndexes) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execPairwiseTransformFloat(nullptr, opNum, dx, xShapeInfo, y, yShapeInfo, result, resultShapeInfo, extraParams, xIndexes, yIndexes, resultIndexes); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(dx);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *yPointer = reinterpret_cast<float *>(y);
@@ -890,6 +1246,13 @@ void NativeOps::execPairwiseTransformFloat(
         Nd4jPointer result,
         Nd4jPointer  resultShapeInfo,
         Nd4jPointer extraParams) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execPairwiseTransformFloat(nullptr, opNum, dx, xShapeInfo, y, yShapeInfo, result, resultShapeInfo, extraParams); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(dx);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *yPointer = reinterpret_cast<float *>(y);
@@ -902,29 +1265,89 @@ void NativeOps::execPairwiseTransformFloat(
 }
 
 /**
- *
+ * Elementwise op over three inputs
+ * @param extraPointers
  * @param opNum
- * @param x
+ * @param dx
  * @param xShapeInfo
- * @param extraParams
+ * @param y
+ * @param yShapeInfo
+ * @param z
+ * @param zShapeInfo
  * @param result
  * @param resultShapeInfo
+ * @param extraParams
  */
-void   NativeOps::execReduceFloat(Nd4jPointer *extraPointers,int opNum,
-                                  Nd4jPointer x,
-                                  Nd4jPointer xShapeInfo,
+void NativeOps::execTernaryTransformFloat(
+        Nd4jPointer *extraPointers,
+        int opNum,
+        Nd4jPointer dx,
+        Nd4jPointer xShapeInfo,
+        Nd4jPointer y,
+        Nd4jPointer yShapeInfo,
+        Nd4jPointer z,
+        Nd4jPointer zShapeInfo,
+        Nd4jPointer result,
+        Nd4jPointer resultShapeInfo,
+        Nd4jPointer extraParams) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execTernaryTransformFloat(nullptr, opNum, dx, xShapeInfo, y, yShapeInfo, z, zShapeInfo, result, resultShapeInfo, extraParams); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    float *xPointer = reinterpret_cast<float *>(dx);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    float *yPointer = reinterpret_cast<float *>(y);
+    int *yShapeInfoPointer = reinterpret_cast<int *>(yShapeInfo);
+    float *zPointer = reinterpret_cast<float *>(z);
+    int *zShapeInfoPointer = reinterpret_cast<int *>(zShapeInfo);
+    float *resultPointer = reinterpret_cast<float *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
+    FloatNativeOpExecutioner::getInstance()->execTernaryTransform(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            yPointer,
+            yShapeInfoPointer,
+            zPointer,
+            zShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer,
+            extraParamsPointer);
+}
+
+/**
+ *
+ * @param opNum
+ * @param x
+ * @param xShapeInfo
+ * @param extraParams
+ * @param result
+ * @param resultShapeInfo
+ */
+void   NativeOps::execReduceFloat(Nd4jPointer *extraPointers,int opNum,
+                                  Nd4jPointer x,
+                                  Nd4jPointer xShapeInfo,
                                   Nd4jPointer extraParams,
                                   Nd4jPointer result,
                                   Nd4jPointer resultShapeInfo) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execReduceFloat(nullptr, opNum, x, xShapeInfo, extraParams, result, resultShapeInfo); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *resultPointer = reinterpret_cast<float *>(result);
     int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
     float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
-    int *dimension = new int[1];
-    dimension[0] = MAX_DIMENSION;
+    int dimension[1] = {MAX_DIMENSION};
     FloatNativeOpExecutioner::getInstance()->execReduce(opNum,xPointer,xShapeInfoPointer,extraParamsPointer,resultPointer,resultShapeInfoPointer,dimension,1);
-    delete[] dimension;
 }
 
 /**
@@ -946,6 +1369,13 @@ void   NativeOps::execReduceFloat(
         Nd4jPointer resultShapeInfo,
         Nd4jPointer dimension,
         int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execReduceFloat(nullptr, opNum, x, xShapeInfo, extraParams, result, resultShapeInfo, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *resultPointer = reinterpret_cast<float *>(result);
@@ -978,6 +1408,10 @@ float NativeOps::execReduceScalarFloat(
         Nd4jPointer x,
         Nd4jPointer xShapeInfo,
         Nd4jPointer extraParams) {
+    nd4j::ExecutionScope scope(extraPointers);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers))
+        stream->synchronize();
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
@@ -1005,6 +1439,13 @@ void   NativeOps::execReduce3Float(
         Nd4jPointer yShapeInfo,
         Nd4jPointer result,
         Nd4jPointer resultShapeInfo) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execReduce3Float(nullptr, opNum, x, xShapeInfo, extraParamsVals, y, yShapeInfo, result, resultShapeInfo); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *yPointer = reinterpret_cast<float *>(y);
@@ -1039,6 +1480,10 @@ float   NativeOps::execReduce3ScalarFloat(Nd4jPointer *extraPointers,int opNum,
                                           Nd4jPointer extraParamsVals,
                                           Nd4jPointer y,
                                           Nd4jPointer yShapeInfo) {
+    nd4j::ExecutionScope scope(extraPointers);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers))
+        stream->synchronize();
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *yPointer = reinterpret_cast<float *>(y);
@@ -1069,6 +1514,13 @@ void   NativeOps::execReduce3Float(Nd4jPointer *extraPointers,int opNum,
                                    Nd4jPointer resultShapeInfoBuffer,
                                    Nd4jPointer dimension,
                                    int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execReduce3Float(nullptr, opNum, x, xShapeInfo, extraParamsVals, y, yShapeInfo, result, resultShapeInfoBuffer, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *yPointer = reinterpret_cast<float *>(y);
@@ -1109,6 +1561,13 @@ void   NativeOps::execScalarFloat(Nd4jPointer *extraPointers,int opNum,
                                   double scalar,
                                   Nd4jPointer extraParams,
                                   Nd4jIndex n) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execScalarFloat(nullptr, opNum, x, xStride, result, resultStride, scalar, extraParams, n); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(x);
     float *resultPointer = reinterpret_cast<float *>(result);
     float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
@@ -1136,6 +1595,13 @@ void NativeOps::execScalarFloat(
         Nd4jPointer resultShapeInfo,
         float scalar,
         Nd4jPointer extraParams) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execScalarFloat(nullptr, opNum, x, xShapeInfo, result, resultShapeInfo, scalar, extraParams); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(x);
     float *resultPointer = reinterpret_cast<float *>(result);
     int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
@@ -1168,6 +1634,13 @@ void NativeOps::execScalarFloat(
         Nd4jPointer extraParams,
         Nd4jPointer xIndexes,
         Nd4jPointer resultIndexes) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execScalarFloat(nullptr, opNum, x, xShapeInfo, result, resultShapeInfo, scalar, extraParams, xIndexes, resultIndexes); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *resultPointer = reinterpret_cast<float *>(result);
@@ -1187,6 +1660,58 @@ void NativeOps::execScalarFloat(
             resultIndexesPointer);
 
 }
+
+/**
+ * Scalar op with one scalar per tensor along dimension
+ * @param opNum
+ * @param x
+ * @param xShapeInfo
+ * @param result
+ * @param resultShapeInfo
+ * @param scalars
+ * @param scalarsShapeInfo
+ * @param extraParams
+ * @param dimension
+ * @param dimensionLength
+ */
+void NativeOps::execScalarAlongDimensionFloat(
+        Nd4jPointer *extraPointers,
+        int opNum,
+        Nd4jPointer x,
+        Nd4jPointer xShapeInfo,
+        Nd4jPointer result,
+        Nd4jPointer resultShapeInfo,
+        Nd4jPointer scalars,
+        Nd4jPointer scalarsShapeInfo,
+        Nd4jPointer extraParams,
+        Nd4jPointer dimension, int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execScalarAlongDimensionFloat(nullptr, opNum, x, xShapeInfo, result, resultShapeInfo, scalars, scalarsShapeInfo, extraParams, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    float *xPointer = reinterpret_cast<float *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    float *resultPointer = reinterpret_cast<float *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    float *scalarsPointer = reinterpret_cast<float *>(scalars);
+    int *scalarsShapeInfoPointer = reinterpret_cast<int *>(scalarsShapeInfo);
+    float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
+    int *dimensionPointer = reinterpret_cast<int *>(dimension);
+    FloatNativeOpExecutioner::getInstance()->execScalar(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer,
+            scalarsPointer,
+            scalarsShapeInfoPointer,
+            extraParamsPointer,
+            dimensionPointer,
+            dimensionLength);
+}
 /**
  *
  * @param opNum
@@ -1200,6 +1725,10 @@ float   NativeOps::execSummaryStatsScalarFloat(
         Nd4jPointer x,
         Nd4jPointer xShapeInfo,
         Nd4jPointer extraParams,bool biasCorrected) {
+    nd4j::ExecutionScope scope(extraPointers);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers))
+        stream->synchronize();
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
@@ -1227,6 +1756,13 @@ void   NativeOps::execSummaryStatsFloat(
         Nd4jPointer extraParams,
         Nd4jPointer result,
         Nd4jPointer resultShapeInfo,bool biasCorrected) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execSummaryStatsFloat(nullptr, opNum, x, xShapeInfo, extraParams, result, resultShapeInfo, biasCorrected); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *resultPointer = reinterpret_cast<float *>(result);
@@ -1258,6 +1794,13 @@ void   NativeOps::execSummaryStatsFloat(Nd4jPointer *extraPointers,int opNum,Nd4
                                         Nd4jPointer result,
                                         Nd4jPointer resultShapeInfoBuffer,
                                         Nd4jPointer dimension, int dimensionLength,bool biasCorrected) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execSummaryStatsFloat(nullptr, opNum, x, xShapeInfo, extraParams, result, resultShapeInfoBuffer, dimension, dimensionLength, biasCorrected); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(x);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *resultPointer = reinterpret_cast<float *>(result);
@@ -1294,6 +1837,13 @@ void   NativeOps::execTransformFloat(
         Nd4jPointer result,
         int resultStride,
         Nd4jPointer extraParams, Nd4jIndex n) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execTransformFloat(nullptr, opNum, dx, xStride, result, resultStride, extraParams, n); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(dx);
     float *resultPointer = reinterpret_cast<float *>(result);
     float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
@@ -1318,6 +1868,13 @@ void   NativeOps::execTransformFloat(
         Nd4jPointer result,
         Nd4jPointer resultShapeInfo,
         Nd4jPointer extraParams) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execTransformFloat(nullptr, opNum, dx, xShapeInfo, result, resultShapeInfo, extraParams); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(dx);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *resultPointer = reinterpret_cast<float *>(result);
@@ -1352,6 +1909,13 @@ void   NativeOps::execTransformFloat(
         Nd4jPointer extraParams,
         Nd4jPointer xIndexes,
         Nd4jPointer resultIndexes) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execTransformFloat(nullptr, opNum, dx, xShapeInfo, result, resultShapeInfo, extraParams, xIndexes, resultIndexes); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     float *xPointer = reinterpret_cast<float *>(dx);
     int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
     float *resultPointer = reinterpret_cast<float *>(result);
@@ -1398,7 +1962,7 @@ void flattenGeneric(Nd4jPointer *extraPointers,
     //start at the given offset
     resultPointer += offset;
     char inputOrder = shape::order(inputShapeInfoPointer);
-    int len = shape::length(inputShapeInfoPointer);
+    Nd4jIndex len = shape::length(inputShapeInfoPointer);
     int resultEleStride = shape::elementWiseStride(resultShapeInfoBufferPointer);
     int inputEleStride = shape::elementWiseStride(inputShapeInfoPointer);
     int numTads, stride, dimension, dimensionLength;
@@ -1428,13 +1992,13 @@ void flattenGeneric(Nd4jPointer *extraPointers,
         }
         else if (resultEleStride >= 1 && inputEleStride >= 1) {
             if (len < 8000) {
-                for (int i = 0; i < len; i++) {
+                for (Nd4jIndex i = 0; i < len; i++) {
                     resultPointer[i * resultEleStride] = inputPointer[i * inputEleStride];
                 }
             }
             else {
 #pragma omp parallel for
-                for (int i = 0; i < len; i++) {
+                for (Nd4jIndex i = 0; i < len; i++) {
                     resultPointer[i * resultEleStride] = inputPointer[i * inputEleStride];
                 }
             }
@@ -1442,36 +2006,34 @@ void flattenGeneric(Nd4jPointer *extraPointers,
         else {
             int idx = 0;
             int rank = shape::rank(inputShapeInfoPointer);
-            int *coord = new int[rank];
+            int coord[MAX_RANK];
             int *xShape = shape::shapeOf(inputShapeInfoPointer);
             int *xStride = shape::stride(inputShapeInfoPointer);
-            int len = shape::length(inputShapeInfoPointer);
+            Nd4jIndex len = shape::length(inputShapeInfoPointer);
             if(order == 'f') {
-                for(int i = 0; i < len; i++) {
+                for(Nd4jIndex i = 0; i < len; i++) {
                     shape::ind2sub(rank, xShape, i, coord);
-                    int offset = shape::getOffset(0,xShape,xStride,coord,rank);
+                    Nd4jIndex offset = shape::getOffset(0,xShape,xStride,coord,rank);
                     resultPointer[idx++] = inputPointer[offset];
 
                 }
             }
             else {
-                for(int i = 0; i < len; i++) {
+                for(Nd4jIndex i = 0; i < len; i++) {
                     shape::ind2subC(rank, xShape, i, coord);
-                    int offset = shape::getOffset(0,xShape,xStride,coord,rank);
+                    Nd4jIndex offset = shape::getOffset(0,xShape,xStride,coord,rank);
                     resultPointer[idx++] = inputPointer[offset];
 
                 }
             }
-
-            delete[] coord;
         }
     }
     else {
         int rank = shape::rank(inputShapeInfoPointer);
         int *xShape = shape::shapeOf(inputShapeInfoPointer);
         int tadShape = xShape[dimension];
-        shape::TAD tad(inputShapeInfoPointer,&dimension,dimensionLength);
-        tad.createTadOnlyShapeInfo();
+        std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(inputShapeInfoPointer,&dimension,dimensionLength);
+        shape::TAD &tad = *tadPack->tad;
 #pragma omp  parallel  for
         for(int i = 0; i < numTads; i++) {
 
@@ -1479,7 +2041,7 @@ void flattenGeneric(Nd4jPointer *extraPointers,
 
             if (order == 'f') {
                 // 1. get c ordering coordinates
-                int *cIndexCoordinates = new int[rank - 1];
+                int cIndexCoordinates[MAX_RANK];
                 int divisor = 1;
                 for (int dim = rank - 1; dim > 0; dim--) {
                     cIndexCoordinates[dim - 1] = (i / divisor) % xShape[dim];
@@ -1496,14 +2058,13 @@ void flattenGeneric(Nd4jPointer *extraPointers,
                 }
 
                 resultOffset = fIndex * tadShape;
-                delete[] cIndexCoordinates;
 
             }
             else {
                 resultOffset = i *  tadShape;
             }
 
-            int tadOffset = tad.tadOffset(i);
+            Nd4jIndex tadOffset = tad.tadOffset(i);
             for( int j = 0; j < tadShape; j++) {
 
                 // TAD are returned in C ordering always
@@ -1555,13 +2116,13 @@ void concatGeneric(
         allC &= (shape::order(inputShapeInfoPointers[i]) == 'c');
     }
 
-    int length = shape::length(resultShapeInfoPointer);
+    Nd4jIndex length = shape::length(resultShapeInfoPointer);
 
 
     if(allC && dimension == 0 && shape::order(resultShapeInfoPointer) == 'c') {
         int currBuffer = 0;
         int currBufferOffset = 0;
-        for(int i = 0; i <  length; i++) {
+        for(Nd4jIndex i = 0; i <  length; i++) {
             resultPointer[i] = dataBuffers[currBuffer][currBufferOffset++];
             if(currBufferOffset >= shape::length(inputShapeInfoPointers[currBuffer])) {
                 currBuffer++;
@@ -1604,7 +2165,7 @@ void concatGeneric(
                 }
                     //non vector or different order (element wise stride can't be used)
                 else {
-                    int *coordsUse = new int[shape::rank(inputShapeInfoPointers[i])];
+                    int coordsUse[MAX_RANK];
                     Nd4jIndex  currArrLength = shape::length(inputShapeInfoPointers[i]);
                     for(Nd4jIndex arrIdx = 0; arrIdx < currArrLength; arrIdx++) {
                         shape::ind2subC(shape::rank(inputShapeInfoPointers[i]),shape::shapeOf(inputShapeInfoPointers[i]),arrIdx,coordsUse);
@@ -1617,8 +2178,6 @@ void concatGeneric(
                         idx++;
 
                     }
-
-                    delete[] coordsUse;
                 }
 
 
@@ -1652,7 +2211,7 @@ void concatGeneric(
                 }
                 //non vector or different order (element wise stride can't be used)
                 else {
-                    int *coordsUse = new int[shape::rank(inputShapeInfoPointers[i])];
+                    int coordsUse[MAX_RANK];
                     Nd4jIndex  currArrLength = shape::length(inputShapeInfoPointers[i]);
 
                     for(Nd4jIndex arrIdx = 0; arrIdx < currArrLength; arrIdx++) {
@@ -1666,8 +2225,6 @@ void concatGeneric(
                         idx++;
 
                     }
-
-                    delete[] coordsUse;
                 }
 
             }
@@ -1678,59 +2235,55 @@ void concatGeneric(
 
 
     //tad shape information for result
-    shape::TAD resultTad(resultShapeInfoPointer,&dimension,1);
-    resultTad.createTadOnlyShapeInfo();
-    resultTad.createOffsets();
+    std::shared_ptr<shape::TadPack> resultTadPack = shape::TadCache::getInstance()->get(resultShapeInfoPointer,&dimension,1);
+    shape::TAD &resultTad = *resultTadPack->tad;
     int resultTadEleStride = shape::elementWiseStride(resultTad.tadOnlyShapeInfo);
 
-    int arrOffset = 0;
+    Nd4jIndex arrOffset = 0;
     int tadEleStride = shape::elementWiseStride(resultTad.tadOnlyShapeInfo);
     for(int i = 0; i < numArrays; i++) {
         //tad info for the current array
-        shape::TAD arrTad(inputShapeInfoPointers[i],&dimension,1);
-        arrTad.createTadOnlyShapeInfo();
-        arrTad.createOffsets();
+        std::shared_ptr<shape::TadPack> arrTadPack = shape::TadCache::getInstance()->get(inputShapeInfoPointers[i],&dimension,1);
+        shape::TAD &arrTad = *arrTadPack->tad;
 
         //element wise stride and length for tad of current array
         int arrTadEleStride = shape::elementWiseStride(arrTad.tadOnlyShapeInfo);
-        int arrTadLength = shape::length(arrTad.tadOnlyShapeInfo);
+        Nd4jIndex arrTadLength = shape::length(arrTad.tadOnlyShapeInfo);
         for(int j = 0; j < arrTad.numTads; j++) {
             T *arrTadData = dataBuffers[i] + arrTad.tadOffsets[j];
             //result tad offset + the current offset for each tad + array offset (matches current array)
             T *currResultTadWithOffset = resultPointer  + resultTad.tadOffsets[j];
             //ensure we start at the proper index, we need to move the starting index forward relative to the desired array offset
-            int* sub = shape::ind2subC(shape::rank(resultTad.tadOnlyShapeInfo),shape::shapeOf(resultTad.tadOnlyShapeInfo),arrOffset);
+            int sub[MAX_RANK];
+            shape::ind2subC(shape::rank(resultTad.tadOnlyShapeInfo),shape::shapeOf(resultTad.tadOnlyShapeInfo),arrOffset,sub);
             Nd4jIndex baseOffset = shape::getOffset(0,shape::shapeOf(resultTad.tadOnlyShapeInfo),shape::stride(resultTad.tadOnlyShapeInfo),sub,shape::rank(resultTad.tadOnlyShapeInfo));
-            delete[] sub;
             currResultTadWithOffset += baseOffset;
             if(arrTadEleStride > 0 && shape::order(resultShapeInfoPointer) == shape::order(arrTad.tadOnlyShapeInfo)) {
                 if(arrTadEleStride == 1 && resultTadEleStride == 1) {
                     //iterate over the specified chunk of the tad
-                    for(int k = 0; k < arrTadLength; k++) {
+                    for(Nd4jIndex k = 0; k < arrTadLength; k++) {
                         currResultTadWithOffset[k] = arrTadData[k];
                     }
 
                 } //element wise stride isn't 1 for both can't use memcpy
                 else if(tadEleStride > 0 && shape::order(resultShapeInfoPointer) == shape::order(arrTad.tadOnlyShapeInfo)) {
-                    for(int k = 0; k < arrTadLength; k++) {
+                    for(Nd4jIndex k = 0; k < arrTadLength; k++) {
                         currResultTadWithOffset[k * tadEleStride] = arrTadData[k * arrTadEleStride];
                     }
                 }
             }
             else {
-                int idx = 0;
+                Nd4jIndex idx = 0;
                 //use element wise stride for result but not this tad
                 if(tadEleStride > 0 && shape::order(resultShapeInfoPointer) == shape::order(arrTad.tadOnlyShapeInfo)) {
                     if(arrTad.wholeThing) {
-                        for(int k = 0; k < shape::length(arrTad.tadOnlyShapeInfo); k++) {
+                        for(Nd4jIndex k = 0; k < shape::length(arrTad.tadOnlyShapeInfo); k++) {
                             currResultTadWithOffset[idx *resultTadEleStride] = arrTadData[k];
 
                         }
                     }
                     else {
                         int shapeIter[MAX_RANK];
-                        int coord[MAX_RANK];
-                        int dim;
                         int rankIter = shape::rank(arrTad.tadOnlyShapeInfo);
                         int xStridesIter[MAX_RANK];
                         if (PrepareOneRawArrayIter<T>(rankIter,
@@ -1741,16 +2294,11 @@ void concatGeneric(
                                                       shapeIter,
                                                       &arrTadData,
                                                       xStridesIter) >= 0) {
-                            ND4J_RAW_ITER_START(dim, shape::rank(arrTad.tadOnlyShapeInfo), coord, shapeIter); {
-                                    /* Process the innermost dimension */
-                                    currResultTadWithOffset[idx *resultTadEleStride] = arrTadData[0];
-                                }
-                            ND4J_RAW_ITER_ONE_NEXT(dim,
-                                                   rankIter,
-                                                   coord,
-                                                   shapeIter,
-                                                   arrTadData,
-                                                   xStridesIter);
+                            auto kernel = [&](T *arrTadData) {
+                                /* Process the innermost dimension */
+                                currResultTadWithOffset[idx *resultTadEleStride] = arrTadData[0];
+                            };
+                            RawIterOne(rankIter, shapeIter, arrTadData, xStridesIter, kernel);
 
                         }
                         else {
@@ -1765,8 +2313,6 @@ void concatGeneric(
                 else {
 
                     int shapeIter[MAX_RANK];
-                    int coord[MAX_RANK];
-                    int dim;
                     int xStridesIter[MAX_RANK];
                     int resultStridesIter[MAX_RANK];
                     int *xShape = shape::shapeOf(arrTad.tadOnlyShapeInfo);
@@ -1785,17 +2331,10 @@ void concatGeneric(
                                                   xStridesIter,
                                                   &currResultTadWithOffset,
                                                   resultStridesIter) >= 0) {
-                        ND4J_RAW_ITER_START(dim, rank, coord, shapeIter); {
-                                currResultTadWithOffset[0] = arrTadData[0];
-                            } ND4J_RAW_ITER_TWO_NEXT(
-                                dim,
-                                rank,
-                                coord,
-                                shapeIter,
-                                arrTadData,
-                                xStridesIter,
-                                currResultTadWithOffset,
-                                resultStridesIter);
+                        auto kernel = [&](T *arrTadData, T *currResultTadWithOffset) {
+                            currResultTadWithOffset[0] = arrTadData[0];
+                        };
+                        RawIterTwo(rank, shapeIter, arrTadData, xStridesIter, currResultTadWithOffset, resultStridesIter, kernel);
 
 
                     }
@@ -1820,6 +2359,13 @@ void NativeOps::concatFloat(
         Nd4jPointer *inputShapeInfo,
         Nd4jPointer result,
         Nd4jPointer resultShapeInfo, Nd4jPointer *tadPointers, Nd4jPointer *offsetPointers) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { concatFloat(nullptr, dimension, numArrays, data, inputShapeInfo, result, resultShapeInfo, tadPointers, offsetPointers); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     concatGeneric<float>(
             dimension,
             numArrays,
@@ -1841,6 +2387,13 @@ void NativeOps::concatDouble(
         Nd4jPointer *inputShapeInfo,
         Nd4jPointer result,
         Nd4jPointer resultShapeInfo, Nd4jPointer *tadPointers, Nd4jPointer *offsetPointers) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { concatDouble(nullptr, dimension, numArrays, data, inputShapeInfo, result, resultShapeInfo, tadPointers, offsetPointers); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     concatGeneric<double>(
             dimension,
             numArrays,
@@ -1870,6 +2423,13 @@ void NativeOps::flattenFloat(
         Nd4jPointer resultShapeInfo,
         Nd4jPointer input,
         Nd4jPointer inputShapeInfo) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { flattenFloat(nullptr, offset, order, result, resultShapeInfo, input, inputShapeInfo); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     flattenGeneric<float>(
             extraPointers,
             offset,
@@ -1900,6 +2460,13 @@ void NativeOps::flattenDouble(
         Nd4jPointer resultShapeInfo,
         Nd4jPointer input,
         Nd4jPointer inputShapeInfo) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { flattenDouble(nullptr, offset, order, result, resultShapeInfo, input, inputShapeInfo); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
     flattenGeneric<double>(
             extraPointers,
             offset,
@@ -1911,78 +2478,728 @@ void NativeOps::flattenDouble(
 }
 
 /**
- * This is dummy method for JNI compatibility
- * Since we'll use this from java, jni compiler would like to have method no matter what.
+ * Histogram with numBins equal width bins over [min, max]
+ * @param extraPointers
+ * @param x the input
+ * @param xShapeInfo the shape information for the input
+ * @param result the result buffer
+ * @param resultShapeInfo the shape information for the result
+ * @param numBins the number of bins
+ * @param min the lower edge of the first bin
+ * @param max the upper edge of the last bin
+ * @param dimension the dimensions (may be null for the whole array)
+ * @param dimensionLength the length of the dimension buffer
  */
-void NativeOps::initializeDevicesAndFunctions() {
+void NativeOps::execHistogramFloat(Nd4jPointer *extraPointers,
+                                Nd4jPointer x,
+                                Nd4jPointer xShapeInfo,
+                                Nd4jPointer result,
+                                Nd4jPointer resultShapeInfo,
+                                int numBins,
+                                double min,
+                                double max,
+                                Nd4jPointer dimension,
+                                int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execHistogramFloat(nullptr, x, xShapeInfo, result, resultShapeInfo, numBins, min, max, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
 
-}
+    nd4j::ExecutionScope scope(extraPointers);
 
-/**
-       * This method acquires memory chunk of requested size on host side
-       *
-       * @param pointer pointer that'll be used for allocation
-       * @param memorySize memory size, in bytes
-       * @param flags optional parameter
-       */
-Nd4jPointer NativeOps::mallocHost(long memorySize, int flags) {
-    Nd4jPointer pointer = (Nd4jPointer) malloc(memorySize);
-    if (pointer == 0)
-        return 0L;
-    return pointer;
+    float *xPointer = reinterpret_cast<float *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    float *resultPointer = reinterpret_cast<float *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    int *dimensionPointer = reinterpret_cast<int *>(dimension);
+    FloatNativeOpExecutioner::getInstance()->execHistogram(
+            xPointer,
+            xShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer,
+            numBins,
+            (float) min,
+            (float) max,
+            dimensionPointer,
+            dimensionLength);
 }
 
 /**
- * This method acquires memory chunk of requested size on specified device
- *
- * PLEASE NOTE: This method is NOT supported and has NO effect in CPU-based backend.
- *
- * @param pointer pointer that'll be used for allocation
- * @param memorySize memory size, in bytes
- * @param ptrToDeviceId pointer to deviceId. For cuda that's just and int, for OpenCL that's pointer to device_id, etc
- * @param flags optional parameter
+ * Approximate quantiles (t-digest)
+ * @param extraPointers
+ * @param x the input
+ * @param xShapeInfo the shape information for the input
+ * @param quantiles the quantiles to estimate, each in [0, 1]
+ * @param numQuantiles the number of quantiles
+ * @param compression the t-digest compression
+ * @param result the result buffer
+ * @param resultShapeInfo the shape information for the result
+ * @param dimension the dimensions (may be null for the whole array)
+ * @param dimensionLength the length of the dimension buffer
  */
-Nd4jPointer NativeOps::mallocDevice(long memorySize, Nd4jPointer ptrToDeviceId, int flags) {
-    // not supported
-    return 0L;
-}
+void NativeOps::execQuantilesFloat(Nd4jPointer *extraPointers,
+                                Nd4jPointer x,
+                                Nd4jPointer xShapeInfo,
+                                Nd4jPointer quantiles,
+                                int numQuantiles,
+                                double compression,
+                                Nd4jPointer result,
+                                Nd4jPointer resultShapeInfo,
+                                Nd4jPointer dimension,
+                                int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execQuantilesFloat(nullptr, x, xShapeInfo, quantiles, numQuantiles, compression, result, resultShapeInfo, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
 
-/**
- * This method releases previously allocated host memory space
- *
- * @param pointer pointer that'll be freed
- */
-Nd4jPointer NativeOps::freeHost(Nd4jPointer pointer) {
-    free((void *) pointer);
-    return 1L;
+    nd4j::ExecutionScope scope(extraPointers);
+
+    float *xPointer = reinterpret_cast<float *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    float *quantilesPointer = reinterpret_cast<float *>(quantiles);
+    float *resultPointer = reinterpret_cast<float *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    int *dimensionPointer = reinterpret_cast<int *>(dimension);
+    FloatNativeOpExecutioner::getInstance()->execQuantiles(
+            xPointer,
+            xShapeInfoPointer,
+            quantilesPointer,
+            numQuantiles,
+            (float) compression,
+            resultPointer,
+            resultShapeInfoPointer,
+            dimensionPointer,
+            dimensionLength);
 }
 
 /**
- * This method releases previously allocated memory space on device
- *
- * PLEASE NOTE: This method is NOT supported and has NO effect in CPU-based backend.
- *
- * @param pointer pointer that'll be freed
- * @param ptrToDeviceId pointer to deviceId.
+ * Histogram with numBins equal width bins over [min, max]
+ * @param extraPointers
+ * @param x the input
+ * @param xShapeInfo the shape information for the input
+ * @param result the result buffer
+ * @param resultShapeInfo the shape information for the result
+ * @param numBins the number of bins
+ * @param min the lower edge of the first bin
+ * @param max the upper edge of the last bin
+ * @param dimension the dimensions (may be null for the whole array)
+ * @param dimensionLength the length of the dimension buffer
  */
-Nd4jPointer NativeOps::freeDevice(Nd4jPointer pointer, Nd4jPointer ptrToDeviceId) {
-    // not supported
-    return 0L;
-}
+void NativeOps::execHistogramDouble(Nd4jPointer *extraPointers,
+                                Nd4jPointer x,
+                                Nd4jPointer xShapeInfo,
+                                Nd4jPointer result,
+                                Nd4jPointer resultShapeInfo,
+                                int numBins,
+                                double min,
+                                double max,
+                                Nd4jPointer dimension,
+                                int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execHistogramDouble(nullptr, x, xShapeInfo, result, resultShapeInfo, numBins, min, max, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
 
+    nd4j::ExecutionScope scope(extraPointers);
 
-/**
- * Returns the number open mp threads
- */
-int NativeOps::ompGetNumThreads() {
-    return omp_get_num_threads();
+    double *xPointer = reinterpret_cast<double *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    double *resultPointer = reinterpret_cast<double *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    int *dimensionPointer = reinterpret_cast<int *>(dimension);
+    DoubleNativeOpExecutioner::getInstance()->execHistogram(
+            xPointer,
+            xShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer,
+            numBins,
+            (double) min,
+            (double) max,
+            dimensionPointer,
+            dimensionLength);
 }
 
 /**
- * Sets the number of openmp threads
+ * Approximate quantiles (t-digest)
+ * @param extraPointers
+ * @param x the input
+ * @param xShapeInfo the shape information for the input
+ * @param quantiles the quantiles to estimate, each in [0, 1]
+ * @param numQuantiles the number of quantiles
+ * @param compression the t-digest compression
+ * @param result the result buffer
+ * @param resultShapeInfo the shape information for the result
+ * @param dimension the dimensions (may be null for the whole array)
+ * @param dimensionLength the length of the dimension buffer
  */
-void NativeOps::setOmpNumThreads(int threads) {
-    omp_set_num_threads(threads);
+void NativeOps::execQuantilesDouble(Nd4jPointer *extraPointers,
+                                Nd4jPointer x,
+                                Nd4jPointer xShapeInfo,
+                                Nd4jPointer quantiles,
+                                int numQuantiles,
+                                double compression,
+                                Nd4jPointer result,
+                                Nd4jPointer resultShapeInfo,
+                                Nd4jPointer dimension,
+                                int dimensionLength) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execQuantilesDouble(nullptr, x, xShapeInfo, quantiles, numQuantiles, compression, result, resultShapeInfo, dimension, dimensionLength); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    double *xPointer = reinterpret_cast<double *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    double *quantilesPointer = reinterpret_cast<double *>(quantiles);
+    double *resultPointer = reinterpret_cast<double *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    int *dimensionPointer = reinterpret_cast<int *>(dimension);
+    DoubleNativeOpExecutioner::getInstance()->execQuantiles(
+            xPointer,
+            xShapeInfoPointer,
+            quantilesPointer,
+            numQuantiles,
+            (double) compression,
+            resultPointer,
+            resultShapeInfoPointer,
+            dimensionPointer,
+            dimensionLength);
+}
+
+/**
+ * Pairwise comparison writing a uint8 or bit mask
+ */
+void NativeOps::execCompareMaskFloat(Nd4jPointer *extraPointers,
+                                   int opNum,
+                                   Nd4jPointer x,
+                                   Nd4jPointer xShapeInfo,
+                                   Nd4jPointer y,
+                                   Nd4jPointer yShapeInfo,
+                                   Nd4jPointer extraParams,
+                                   Nd4jPointer mask,
+                                   int packed) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execCompareMaskFloat(nullptr, opNum, x, xShapeInfo, y, yShapeInfo, extraParams, mask, packed); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    float *xPointer = reinterpret_cast<float *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    float *yPointer = reinterpret_cast<float *>(y);
+    int *yShapeInfoPointer = reinterpret_cast<int *>(yShapeInfo);
+    float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
+    unsigned char *maskPointer = reinterpret_cast<unsigned char *>(mask);
+    FloatNativeOpExecutioner::getInstance()->execCompareMask(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            yPointer,
+            yShapeInfoPointer,
+            extraParamsPointer,
+            maskPointer,
+            packed != 0);
+}
+
+/**
+ * Scalar comparison writing a uint8 or bit mask
+ */
+void NativeOps::execScalarCompareMaskFloat(Nd4jPointer *extraPointers,
+                                         int opNum,
+                                         Nd4jPointer x,
+                                         Nd4jPointer xShapeInfo,
+                                         double scalar,
+                                         Nd4jPointer extraParams,
+                                         Nd4jPointer mask,
+                                         int packed) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execScalarCompareMaskFloat(nullptr, opNum, x, xShapeInfo, scalar, extraParams, mask, packed); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    float *xPointer = reinterpret_cast<float *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
+    unsigned char *maskPointer = reinterpret_cast<unsigned char *>(mask);
+    FloatNativeOpExecutioner::getInstance()->execScalarCompareMask(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            (float) scalar,
+            extraParamsPointer,
+            maskPointer,
+            packed != 0);
+}
+
+/**
+ * Transform applied where the mask is set
+ */
+void NativeOps::execMaskedTransformFloat(Nd4jPointer *extraPointers,
+                                       int opNum,
+                                       Nd4jPointer x,
+                                       Nd4jPointer xShapeInfo,
+                                       Nd4jPointer result,
+                                       Nd4jPointer resultShapeInfo,
+                                       Nd4jPointer extraParams,
+                                       Nd4jPointer mask,
+                                       int packed) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execMaskedTransformFloat(nullptr, opNum, x, xShapeInfo, result, resultShapeInfo, extraParams, mask, packed); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    float *xPointer = reinterpret_cast<float *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    float *resultPointer = reinterpret_cast<float *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
+    unsigned char *maskPointer = reinterpret_cast<unsigned char *>(mask);
+    FloatNativeOpExecutioner::getInstance()->execMaskedTransform(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer,
+            extraParamsPointer,
+            maskPointer,
+            packed != 0);
+}
+
+/**
+ * Reduction over the elements where the mask is set
+ */
+float NativeOps::execMaskedReduceScalarFloat(Nd4jPointer *extraPointers,
+                                           int opNum,
+                                           Nd4jPointer x,
+                                           Nd4jPointer xShapeInfo,
+                                           Nd4jPointer extraParams,
+                                           Nd4jPointer mask,
+                                           int packed) {
+    nd4j::ExecutionScope scope(extraPointers);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers))
+        stream->synchronize();
+
+    float *xPointer = reinterpret_cast<float *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    float *extraParamsPointer = reinterpret_cast<float *>(extraParams);
+    unsigned char *maskPointer = reinterpret_cast<unsigned char *>(mask);
+    return FloatNativeOpExecutioner::getInstance()->execMaskedReduceScalar(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            extraParamsPointer,
+            maskPointer,
+            packed != 0);
+}
+
+/**
+ * result = mask ? x : y
+ */
+void NativeOps::execSelectFloat(Nd4jPointer *extraPointers,
+                              Nd4jPointer x,
+                              Nd4jPointer xShapeInfo,
+                              Nd4jPointer y,
+                              Nd4jPointer yShapeInfo,
+                              Nd4jPointer result,
+                              Nd4jPointer resultShapeInfo,
+                              Nd4jPointer mask,
+                              int packed) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execSelectFloat(nullptr, x, xShapeInfo, y, yShapeInfo, result, resultShapeInfo, mask, packed); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    float *xPointer = reinterpret_cast<float *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    float *yPointer = reinterpret_cast<float *>(y);
+    int *yShapeInfoPointer = reinterpret_cast<int *>(yShapeInfo);
+    float *resultPointer = reinterpret_cast<float *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    unsigned char *maskPointer = reinterpret_cast<unsigned char *>(mask);
+    FloatNativeOpExecutioner::getInstance()->execSelect(
+            xPointer,
+            xShapeInfoPointer,
+            yPointer,
+            yShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer,
+            maskPointer,
+            packed != 0);
+}
+
+/**
+ * Pairwise comparison writing a uint8 or bit mask
+ */
+void NativeOps::execCompareMaskDouble(Nd4jPointer *extraPointers,
+                                   int opNum,
+                                   Nd4jPointer x,
+                                   Nd4jPointer xShapeInfo,
+                                   Nd4jPointer y,
+                                   Nd4jPointer yShapeInfo,
+                                   Nd4jPointer extraParams,
+                                   Nd4jPointer mask,
+                                   int packed) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execCompareMaskDouble(nullptr, opNum, x, xShapeInfo, y, yShapeInfo, extraParams, mask, packed); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    double *xPointer = reinterpret_cast<double *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    double *yPointer = reinterpret_cast<double *>(y);
+    int *yShapeInfoPointer = reinterpret_cast<int *>(yShapeInfo);
+    double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
+    unsigned char *maskPointer = reinterpret_cast<unsigned char *>(mask);
+    DoubleNativeOpExecutioner::getInstance()->execCompareMask(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            yPointer,
+            yShapeInfoPointer,
+            extraParamsPointer,
+            maskPointer,
+            packed != 0);
+}
+
+/**
+ * Scalar comparison writing a uint8 or bit mask
+ */
+void NativeOps::execScalarCompareMaskDouble(Nd4jPointer *extraPointers,
+                                         int opNum,
+                                         Nd4jPointer x,
+                                         Nd4jPointer xShapeInfo,
+                                         double scalar,
+                                         Nd4jPointer extraParams,
+                                         Nd4jPointer mask,
+                                         int packed) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execScalarCompareMaskDouble(nullptr, opNum, x, xShapeInfo, scalar, extraParams, mask, packed); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    double *xPointer = reinterpret_cast<double *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
+    unsigned char *maskPointer = reinterpret_cast<unsigned char *>(mask);
+    DoubleNativeOpExecutioner::getInstance()->execScalarCompareMask(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            (double) scalar,
+            extraParamsPointer,
+            maskPointer,
+            packed != 0);
+}
+
+/**
+ * Transform applied where the mask is set
+ */
+void NativeOps::execMaskedTransformDouble(Nd4jPointer *extraPointers,
+                                       int opNum,
+                                       Nd4jPointer x,
+                                       Nd4jPointer xShapeInfo,
+                                       Nd4jPointer result,
+                                       Nd4jPointer resultShapeInfo,
+                                       Nd4jPointer extraParams,
+                                       Nd4jPointer mask,
+                                       int packed) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execMaskedTransformDouble(nullptr, opNum, x, xShapeInfo, result, resultShapeInfo, extraParams, mask, packed); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    double *xPointer = reinterpret_cast<double *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    double *resultPointer = reinterpret_cast<double *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
+    unsigned char *maskPointer = reinterpret_cast<unsigned char *>(mask);
+    DoubleNativeOpExecutioner::getInstance()->execMaskedTransform(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer,
+            extraParamsPointer,
+            maskPointer,
+            packed != 0);
+}
+
+/**
+ * Reduction over the elements where the mask is set
+ */
+double NativeOps::execMaskedReduceScalarDouble(Nd4jPointer *extraPointers,
+                                           int opNum,
+                                           Nd4jPointer x,
+                                           Nd4jPointer xShapeInfo,
+                                           Nd4jPointer extraParams,
+                                           Nd4jPointer mask,
+                                           int packed) {
+    nd4j::ExecutionScope scope(extraPointers);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers))
+        stream->synchronize();
+
+    double *xPointer = reinterpret_cast<double *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    double *extraParamsPointer = reinterpret_cast<double *>(extraParams);
+    unsigned char *maskPointer = reinterpret_cast<unsigned char *>(mask);
+    return DoubleNativeOpExecutioner::getInstance()->execMaskedReduceScalar(
+            opNum,
+            xPointer,
+            xShapeInfoPointer,
+            extraParamsPointer,
+            maskPointer,
+            packed != 0);
+}
+
+/**
+ * result = mask ? x : y
+ */
+void NativeOps::execSelectDouble(Nd4jPointer *extraPointers,
+                              Nd4jPointer x,
+                              Nd4jPointer xShapeInfo,
+                              Nd4jPointer y,
+                              Nd4jPointer yShapeInfo,
+                              Nd4jPointer result,
+                              Nd4jPointer resultShapeInfo,
+                              Nd4jPointer mask,
+                              int packed) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execSelectDouble(nullptr, x, xShapeInfo, y, yShapeInfo, result, resultShapeInfo, mask, packed); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    double *xPointer = reinterpret_cast<double *>(x);
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    double *yPointer = reinterpret_cast<double *>(y);
+    int *yShapeInfoPointer = reinterpret_cast<int *>(yShapeInfo);
+    double *resultPointer = reinterpret_cast<double *>(result);
+    int *resultShapeInfoPointer = reinterpret_cast<int *>(resultShapeInfo);
+    unsigned char *maskPointer = reinterpret_cast<unsigned char *>(mask);
+    DoubleNativeOpExecutioner::getInstance()->execSelect(
+            xPointer,
+            xShapeInfoPointer,
+            yPointer,
+            yShapeInfoPointer,
+            resultPointer,
+            resultShapeInfoPointer,
+            maskPointer,
+            packed != 0);
+}
+
+void NativeOps::execBatchFloat(Nd4jPointer *extraPointers, Nd4jPointer descriptors, int numOps) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execBatchFloat(nullptr, descriptors, numOps); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    static nd4j::OpBatch<float> batch;
+    batch.exec(reinterpret_cast<Nd4jPointer *>(descriptors), numOps);
+}
+
+void NativeOps::execBatchDouble(Nd4jPointer *extraPointers, Nd4jPointer descriptors, int numOps) {
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        stream->enqueue([=] { execBatchDouble(nullptr, descriptors, numOps); }, nd4j::ExecutionContext::find(extraPointers));
+        return;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    static nd4j::OpBatch<double> batch;
+    batch.exec(reinterpret_cast<Nd4jPointer *>(descriptors), numOps);
+}
+
+Nd4jPointer NativeOps::createGraphFloat() {
+    return reinterpret_cast<Nd4jPointer>(new nd4j::OpGraph<float>());
+}
+
+int NativeOps::graphInputFloat(Nd4jPointer graph, Nd4jPointer x, Nd4jPointer xShapeInfo) {
+    return reinterpret_cast<nd4j::OpGraph<float> *>(graph)->input(reinterpret_cast<float *>(x), reinterpret_cast<int *>(xShapeInfo));
+}
+
+int NativeOps::graphTransformFloat(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams) {
+    return reinterpret_cast<nd4j::OpGraph<float> *>(graph)->transform(opNum, x, reinterpret_cast<float *>(extraParams));
+}
+
+int NativeOps::graphScalarFloat(Nd4jPointer graph, int opNum, int x, float scalar, Nd4jPointer extraParams) {
+    return reinterpret_cast<nd4j::OpGraph<float> *>(graph)->scalar(opNum, x, scalar, reinterpret_cast<float *>(extraParams));
+}
+
+int NativeOps::graphPairwiseFloat(Nd4jPointer graph, int opNum, int x, int y, Nd4jPointer extraParams) {
+    return reinterpret_cast<nd4j::OpGraph<float> *>(graph)->pairwise(opNum, x, y, reinterpret_cast<float *>(extraParams));
+}
+
+int NativeOps::graphBroadcastFloat(Nd4jPointer graph, int opNum, int x, int y) {
+    return reinterpret_cast<nd4j::OpGraph<float> *>(graph)->broadcast(opNum, x, y);
+}
+
+int NativeOps::graphReduceFloat(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams, Nd4jPointer result) {
+    return reinterpret_cast<nd4j::OpGraph<float> *>(graph)->reduce(opNum, x, reinterpret_cast<float *>(extraParams), reinterpret_cast<float *>(result));
+}
+
+int NativeOps::graphOutputFloat(Nd4jPointer graph, int value, Nd4jPointer result, Nd4jPointer resultShapeInfo) {
+    return reinterpret_cast<nd4j::OpGraph<float> *>(graph)->output(value, reinterpret_cast<float *>(result), reinterpret_cast<int *>(resultShapeInfo));
+}
+
+int NativeOps::execGraphFloat(Nd4jPointer *extraPointers, Nd4jPointer graph) {
+    nd4j::OpGraph<float> *opGraph = reinterpret_cast<nd4j::OpGraph<float> *>(graph);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        if (opGraph->hasRefused())
+            return -1;
+        stream->enqueue([=] { execGraphFloat(nullptr, graph); }, nd4j::ExecutionContext::find(extraPointers));
+        return 0;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    return opGraph->exec();
+}
+
+void NativeOps::deleteGraphFloat(Nd4jPointer graph) {
+    delete reinterpret_cast<nd4j::OpGraph<float> *>(graph);
+}
+
+Nd4jPointer NativeOps::createGraphDouble() {
+    return reinterpret_cast<Nd4jPointer>(new nd4j::OpGraph<double>());
+}
+
+int NativeOps::graphInputDouble(Nd4jPointer graph, Nd4jPointer x, Nd4jPointer xShapeInfo) {
+    return reinterpret_cast<nd4j::OpGraph<double> *>(graph)->input(reinterpret_cast<double *>(x), reinterpret_cast<int *>(xShapeInfo));
+}
+
+int NativeOps::graphTransformDouble(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams) {
+    return reinterpret_cast<nd4j::OpGraph<double> *>(graph)->transform(opNum, x, reinterpret_cast<double *>(extraParams));
+}
+
+int NativeOps::graphScalarDouble(Nd4jPointer graph, int opNum, int x, double scalar, Nd4jPointer extraParams) {
+    return reinterpret_cast<nd4j::OpGraph<double> *>(graph)->scalar(opNum, x, scalar, reinterpret_cast<double *>(extraParams));
+}
+
+int NativeOps::graphPairwiseDouble(Nd4jPointer graph, int opNum, int x, int y, Nd4jPointer extraParams) {
+    return reinterpret_cast<nd4j::OpGraph<double> *>(graph)->pairwise(opNum, x, y, reinterpret_cast<double *>(extraParams));
+}
+
+int NativeOps::graphBroadcastDouble(Nd4jPointer graph, int opNum, int x, int y) {
+    return reinterpret_cast<nd4j::OpGraph<double> *>(graph)->broadcast(opNum, x, y);
+}
+
+int NativeOps::graphReduceDouble(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams, Nd4jPointer result) {
+    return reinterpret_cast<nd4j::OpGraph<double> *>(graph)->reduce(opNum, x, reinterpret_cast<double *>(extraParams), reinterpret_cast<double *>(result));
+}
+
+int NativeOps::graphOutputDouble(Nd4jPointer graph, int value, Nd4jPointer result, Nd4jPointer resultShapeInfo) {
+    return reinterpret_cast<nd4j::OpGraph<double> *>(graph)->output(value, reinterpret_cast<double *>(result), reinterpret_cast<int *>(resultShapeInfo));
+}
+
+int NativeOps::execGraphDouble(Nd4jPointer *extraPointers, Nd4jPointer graph) {
+    nd4j::OpGraph<double> *opGraph = reinterpret_cast<nd4j::OpGraph<double> *>(graph);
+    if (nd4j::CpuStream *stream = nd4j::CpuStream::find(extraPointers)) {
+        if (opGraph->hasRefused())
+            return -1;
+        stream->enqueue([=] { execGraphDouble(nullptr, graph); }, nd4j::ExecutionContext::find(extraPointers));
+        return 0;
+    }
+
+    nd4j::ExecutionScope scope(extraPointers);
+
+    return opGraph->exec();
+}
+
+void NativeOps::deleteGraphDouble(Nd4jPointer graph) {
+    delete reinterpret_cast<nd4j::OpGraph<double> *>(graph);
+}
+
+/**
+ * This is dummy method for JNI compatibility
+ * Since we'll use this from java, jni compiler would like to have method no matter what.
+ */
+void NativeOps::initializeDevicesAndFunctions() {
+
+}
+
+/**
+       * This method acquires memory chunk of requested size on host side
+       *
+       * @param pointer pointer that'll be used for allocation
+       * @param memorySize memory size, in bytes
+       * @param flags optional parameter
+       */
+Nd4jPointer NativeOps::mallocHost(long memorySize, int flags) {
+    Nd4jPointer pointer = (Nd4jPointer) nd4j::HostMemoryPool::getInstance()->allocate(memorySize, flags);
+    if (pointer == 0)
+        return 0L;
+    return pointer;
+}
+
+/**
+ * This method acquires memory chunk of requested size on specified device
+ *
+ * PLEASE NOTE: This method is NOT supported and has NO effect in CPU-based backend.
+ *
+ * @param pointer pointer that'll be used for allocation
+ * @param memorySize memory size, in bytes
+ * @param ptrToDeviceId pointer to deviceId. For cuda that's just and int, for OpenCL that's pointer to device_id, etc
+ * @param flags optional parameter
+ */
+Nd4jPointer NativeOps::mallocDevice(long memorySize, Nd4jPointer ptrToDeviceId, int flags) {
+    // not supported
+    return 0L;
+}
+
+/**
+ * This method releases previously allocated host memory space
+ *
+ * @param pointer pointer that'll be freed
+ */
+Nd4jPointer NativeOps::freeHost(Nd4jPointer pointer) {
+    nd4j::HostMemoryPool::getInstance()->release((void *) pointer);
+    return 1L;
+}
+
+/**
+ * This method releases previously allocated memory space on device
+ *
+ * PLEASE NOTE: This method is NOT supported and has NO effect in CPU-based backend.
+ *
+ * @param pointer pointer that'll be freed
+ * @param ptrToDeviceId pointer to deviceId.
+ */
+Nd4jPointer NativeOps::freeDevice(Nd4jPointer pointer, Nd4jPointer ptrToDeviceId) {
+    // not supported
+    return 0L;
+}
+
+
+/**
+ * Returns the number open mp threads
+ */
+int NativeOps::ompGetNumThreads() {
+    return omp_get_num_threads();
+}
+
+/**
+ * Sets the number of openmp threads
+ */
+void NativeOps::setOmpNumThreads(int threads) {
+    omp_set_num_threads(threads);
 
 }
 
@@ -1990,12 +3207,16 @@ Nd4jPointer NativeOps::createContext() {
     return 0L;
 }
 
+/**
+ * Creates a stream: a worker thread running
+ * the work queued on it in order
+ */
 Nd4jPointer NativeOps::createStream() {
-    return 0L;
+    return reinterpret_cast<Nd4jPointer>(new nd4j::CpuStream());
 }
 
 Nd4jPointer NativeOps::createEvent() {
-    return 0L;
+    return reinterpret_cast<Nd4jPointer>(new nd4j::CpuEvent());
 }
 
 Nd4jPointer NativeOps::createBlasHandle() {
@@ -2003,7 +3224,11 @@ Nd4jPointer NativeOps::createBlasHandle() {
 }
 
 Nd4jPointer NativeOps::registerEvent(Nd4jPointer event, Nd4jPointer stream) {
-    return 0L;
+    nd4j::CpuStream *cpuStream = nd4j::CpuStream::find(stream);
+    if (event == 0 || cpuStream == nullptr)
+        return 0L;
+    reinterpret_cast<nd4j::CpuEvent *>(event)->record(cpuStream);
+    return 1L;
 }
 
 Nd4jPointer NativeOps::setBlasStream(Nd4jPointer handle, Nd4jPointer stream) {
@@ -2022,32 +3247,84 @@ long NativeOps::getDeviceTotalMemory(Nd4jPointer ptrToDeviceId) {
     return 0L;
 }
 
+/**
+ * Host to host copy, spread over threads for large
+ * buffers; the direction flags are all the same
+ * thing on this backend
+ */
 Nd4jPointer NativeOps::memcpy(Nd4jPointer dst, Nd4jPointer src, long size, int flags, Nd4jPointer reserved) {
-    return 0L;
+    nd4j::hostMemcpy((void *) dst, (const void *) src, size);
+    return 1L;
 }
 
+/**
+ * Copies on the stream passed as reserved,
+ * or right away when it is not a stream
+ */
 Nd4jPointer NativeOps::memcpyAsync(Nd4jPointer dst, Nd4jPointer src, long size, int flags, Nd4jPointer reserved) {
-    return 0L;
+    nd4j::CpuStream *stream = nd4j::CpuStream::find(reserved);
+    if (stream == nullptr)
+        return memcpy(dst, src, size, flags, reserved);
+
+    stream->enqueue([=] { nd4j::hostMemcpy((void *) dst, (const void *) src, size); });
+    return 1L;
 }
 
 Nd4jPointer NativeOps::memset(Nd4jPointer dst, int value, long size, int flags, Nd4jPointer reserved) {
-    return 0L;
+    nd4j::hostMemset((void *) dst, value, size);
+    return 1L;
 }
 
+/**
+ * Sets the memory on the stream passed as reserved,
+ * or right away when it is not a stream
+ */
 Nd4jPointer NativeOps::memsetAsync(Nd4jPointer dst, int value, long size,  int flags, Nd4jPointer reserved) {
-    return 0L;
+    nd4j::CpuStream *stream = nd4j::CpuStream::find(reserved);
+    if (stream == nullptr)
+        return memset(dst, value, size, flags, reserved);
+
+    stream->enqueue([=] { nd4j::hostMemset((void *) dst, value, size); });
+    return 1L;
 }
 
+/**
+ * Waits for the event before freeing it
+ */
 Nd4jPointer NativeOps::destroyEvent(Nd4jPointer event) {
-    return 0L;
+    if (event == 0)
+        return 0L;
+    nd4j::CpuEvent *cpuEvent = reinterpret_cast<nd4j::CpuEvent *>(event);
+    cpuEvent->synchronize();
+    delete cpuEvent;
+    return 1L;
+}
+
+/**
+ * Drains the stream, stops its worker and
+ * takes it out of the registry find() uses
+ */
+Nd4jPointer NativeOps::destroyStream(Nd4jPointer stream) {
+    nd4j::CpuStream *cpuStream = nd4j::CpuStream::find(stream);
+    if (cpuStream == nullptr)
+        return 0L;
+    delete cpuStream;
+    return 1L;
 }
 
 Nd4jPointer NativeOps::streamSynchronize(Nd4jPointer stream) {
-    return 0L;
+    nd4j::CpuStream *cpuStream = nd4j::CpuStream::find(stream);
+    if (cpuStream == nullptr)
+        return 0L;
+    cpuStream->synchronize();
+    return 1L;
 }
 
 Nd4jPointer NativeOps::eventSynchronize(Nd4jPointer event) {
-    return 0L;
+    if (event == 0)
+        return 0L;
+    reinterpret_cast<nd4j::CpuEvent *>(event)->synchronize();
+    return 1L;
 }
 
 Nd4jPointer NativeOps::getAvailableDevices() {
@@ -2066,8 +3343,151 @@ void NativeOps::setGridLimit(int gridSize) {
     // no-op
 }
 
-void NativeOps::tadOnlyShapeInfo(Nd4jPointer xShapeInfo, Nd4jPointer dimension, int dimensionLength, Nd4jPointer targetBuffer, Nd4jPointer offsetsBuffer) {
-    // TODO: add impl here
+int NativeOps::tadOnlyShapeInfo(Nd4jPointer xShapeInfo, Nd4jPointer dimension, int dimensionLength, Nd4jPointer targetBuffer, Nd4jPointer offsetsBuffer) {
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    int *dimensionPointer = reinterpret_cast<int *>(dimension);
+    int *target = reinterpret_cast<int *>(targetBuffer);
+    int *offsets = reinterpret_cast<int *>(offsetsBuffer);
+
+    std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(xShapeInfoPointer, dimensionPointer, dimensionLength);
+    shape::TAD *tad = tadPack->tad;
+    //the offsets buffer keeps the int layout callers expect
+    for (int i = 0; i < tad->numTads; i++) {
+        if (tad->tadOffsets[i] > 2147483647LL) {
+            printf("TAD offset %lld does not fit an int; use tadOnlyShapeInfo64\n", (long long) tad->tadOffsets[i]);
+            return -1;
+        }
+    }
+
+    std::memcpy((void *) target, tad->tadOnlyShapeInfo, shape::shapeInfoLength(shape::rank(tad->tadOnlyShapeInfo)) * sizeof(int));
+    for (int i = 0; i < tad->numTads; i++)
+        offsets[i] = (int) tad->tadOffsets[i];
+    return 0;
+}
+
+void NativeOps::tadOnlyShapeInfo64(Nd4jPointer xShapeInfo, Nd4jPointer dimension, int dimensionLength, Nd4jPointer targetBuffer, Nd4jPointer offsetsBuffer) {
+    int *xShapeInfoPointer = reinterpret_cast<int *>(xShapeInfo);
+    int *dimensionPointer = reinterpret_cast<int *>(dimension);
+    int *target = reinterpret_cast<int *>(targetBuffer);
+    Nd4jIndex *offsets = reinterpret_cast<Nd4jIndex *>(offsetsBuffer);
+
+    std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(xShapeInfoPointer, dimensionPointer, dimensionLength);
+    shape::TAD *tad = tadPack->tad;
+    std::memcpy((void *) target, tad->tadOnlyShapeInfo, shape::shapeInfoLength(shape::rank(tad->tadOnlyShapeInfo)) * sizeof(int));
+    std::memcpy((void *) offsets, tad->tadOffsets, tad->numTads * sizeof(Nd4jIndex));
+}
+
+void NativeOps::setTadCacheLimits(int maxEntries, Nd4jIndex maxBytes) {
+    shape::TadCache::getInstance()->setLimits(maxEntries, maxBytes);
+}
+
+void NativeOps::purgeTadCache() {
+    shape::TadCache::getInstance()->purge();
+}
+
+Nd4jIndex NativeOps::getTadCacheHits() {
+    return shape::TadCache::getInstance()->getHits();
+}
+
+Nd4jIndex NativeOps::getTadCacheMisses() {
+    return shape::TadCache::getInstance()->getMisses();
+}
+
+Nd4jIndex NativeOps::getTadCacheEvictions() {
+    return shape::TadCache::getInstance()->getEvictions();
+}
+
+void NativeOps::setHostPoolLimits(Nd4jIndex maxCachedBytes, Nd4jIndex maxThreadCachedBytes) {
+    nd4j::HostMemoryPool::getInstance()->setLimits(maxCachedBytes, maxThreadCachedBytes);
+}
+
+void NativeOps::purgeHostPool() {
+    nd4j::HostMemoryPool::getInstance()->purge();
+}
+
+Nd4jIndex NativeOps::getHostPoolBytesInUse() {
+    return nd4j::HostMemoryPool::getInstance()->getBytesInUse();
+}
+
+Nd4jIndex NativeOps::getHostPoolBytesCached() {
+    return nd4j::HostMemoryPool::getInstance()->getBytesCached();
+}
+
+Nd4jIndex NativeOps::getHostPoolHits() {
+    return nd4j::HostMemoryPool::getInstance()->getHits();
+}
+
+Nd4jIndex NativeOps::getHostPoolMisses() {
+    return nd4j::HostMemoryPool::getInstance()->getMisses();
+}
+
+int NativeOps::getHostAlignment(Nd4jPointer pointer) {
+    return nd4j::HostMemoryPool::alignmentOf((void *) pointer);
+}
+
+void NativeOps::enableThreadPool(bool reallyEnable) {
+    nd4j::ThreadPool::setEnabled(reallyEnable);
+}
+
+void NativeOps::setThreadPoolConcurrency(int threads) {
+    nd4j::ThreadPool::getInstance()->setConcurrency(threads);
+}
+
+Nd4jPointer NativeOps::createExecutionContext(int threads, Nd4jPointer cores, int numCores) {
+    return reinterpret_cast<Nd4jPointer>(new nd4j::ExecutionContext(threads, reinterpret_cast<int *>(cores), numCores));
+}
+
+void NativeOps::destroyExecutionContext(Nd4jPointer context) {
+    delete nd4j::ExecutionContext::find(context);
+}
+
+int NativeOps::getNumaNodes() {
+    return (int) nd4j::numaNodes().size();
+}
+
+int NativeOps::bindThreadsToNumaNodes() {
+    return nd4j::bindThreadsToNodes();
+}
+
+int NativeOps::unbindThreadsFromNumaNodes() {
+    return nd4j::unbindThreadsFromNodes();
+}
+
+void NativeOps::enableOpProfiling(bool reallyEnable) {
+    nd4j::OpProfiler::setEnabled(reallyEnable);
+}
+
+void NativeOps::resetOpProfile() {
+    nd4j::OpProfiler::getInstance()->reset();
+}
+
+/**
+ * Copies text to buffer the way snprintf would
+ */
+static int copyText(const std::string &text, char *buffer, int length) {
+    if (buffer != nullptr && length > 0) {
+        size_t copied = std::min(text.size(), (size_t) length - 1);
+        std::memcpy(buffer, text.data(), copied);
+        buffer[copied] = '\0';
+    }
+    return (int) text.size();
+}
+
+int NativeOps::getOpProfile(char *buffer, int length, bool json) {
+    nd4j::OpProfiler *profiler = nd4j::OpProfiler::getInstance();
+    return copyText(json ? profiler->toJson() : profiler->toText(), buffer, length);
+}
+
+void NativeOps::enableOpTrace(bool reallyEnable) {
+    nd4j::OpTrace::setEnabled(reallyEnable);
+}
+
+void NativeOps::clearOpTrace() {
+    nd4j::OpTrace::getInstance()->clear();
+}
+
+int NativeOps::getOpTrace(char *buffer, int length) {
+    return copyText(nd4j::OpTrace::getInstance()->toChromeTrace(), buffer, length);
 }
 
 Nd4jPointer NativeOps::memcpyConstantAsync(Nd4jPointer dst, Nd4jPointer src, long size, int flags, Nd4jPointer reserved) {
@@ -14,6 +14,7 @@
 #include <scalar.h>
 #include <broadcasting.h>
 #include <summarystatsreduce.h>
+#include <tadcache.h>
 #include <thread>
 #include <map>
 #include <cuda.h>
@@ -290,7 +291,7 @@ dim3 getReduceLaunchParams(int deviceId, int *xShapeInfo, int *zShapeInfo, cudaF
 
 		if (tadLength == 1) {
 			if (debug && verbose)
-				printf("A xLength: [%i], zLength: [%i]\n", shape::length(xShapeInfo), shape::length(zShapeInfo));
+				printf("A xLength: [%lld], zLength: [%lld]\n", shape::length(xShapeInfo), shape::length(zShapeInfo));
 		}
 	} else{
 		// we have special case - reduction along all dimensions
@@ -304,7 +305,7 @@ dim3 getReduceLaunchParams(int deviceId, int *xShapeInfo, int *zShapeInfo, cudaF
 	dim3 launchDims = getBetterDimensions(deviceId, numTads, tadLength, xRank, funcAttr, dimensionLength, elementSize, reductionSize);
 
 	if ((debug && verbose ) ) { //|| launchDims.x == 1
-		printf("B xLength: [%i], numTads: [%i], tadLength: [%i], launchDims.x: [%i], launchDims.y: [%i]\n", shape::length(xShapeInfo), numTads, tadLength, launchDims.x, launchDims.y);
+		printf("B xLength: [%lld], numTads: [%i], tadLength: [%i], launchDims.x: [%i], launchDims.y: [%i]\n", shape::length(xShapeInfo), numTads, tadLength, launchDims.x, launchDims.y);
 		//shape::printShapeInfo(xShapeInfo);
 	}
 
@@ -614,6 +615,22 @@ void   NativeOps::execBroadcastDouble(Nd4jPointer *extraPointers,
 }
 
 
+/**
+ * PLEASE NOTE: This method is NOT supported yet and has NO effect in CUDA-based backend.
+ * Only broadcasting along dimensions is available on the device.
+ */
+void   NativeOps::execBroadcastDouble(Nd4jPointer *extraPointers,
+		int opNum,
+		Nd4jPointer x,
+		Nd4jPointer xShapeInfo,
+		Nd4jPointer y,
+		Nd4jPointer yShapeInfo,
+		Nd4jPointer result,
+		Nd4jPointer resultShapeInfo) {
+	// no-op
+}
+
+
 
 /**
  *
@@ -810,6 +827,24 @@ void NativeOps::execPairwiseTransformDouble(
 		checkCudaErrors(cudaStreamSynchronize(*stream));
 }
 
+/**
+ * PLEASE NOTE: This method is NOT supported yet and has NO effect in CUDA-based backend.
+ */
+void NativeOps::execTernaryTransformDouble(
+		Nd4jPointer *extraPointers,
+		int opNum,
+		Nd4jPointer dx,
+		Nd4jPointer xShapeInfo,
+		Nd4jPointer y,
+		Nd4jPointer yShapeInfo,
+		Nd4jPointer z,
+		Nd4jPointer zShapeInfo,
+		Nd4jPointer result,
+		Nd4jPointer resultShapeInfo,
+		Nd4jPointer extraParams) {
+	// no-op
+}
+
 /**
  *
  * @param opNum
@@ -1368,6 +1403,23 @@ void NativeOps::execScalarDouble(
 	if (debug)
 		checkCudaErrors(cudaStreamSynchronize(*stream));
 }
+
+/**
+ * PLEASE NOTE: This method is NOT supported yet and has NO effect in CUDA-based backend.
+ */
+void NativeOps::execScalarAlongDimensionDouble(
+		Nd4jPointer *extraPointers,
+		int opNum,
+		Nd4jPointer x,
+		Nd4jPointer xShapeInfo,
+		Nd4jPointer result,
+		Nd4jPointer resultShapeInfo,
+		Nd4jPointer scalars,
+		Nd4jPointer scalarsShapeInfo,
+		Nd4jPointer extraParams,
+		Nd4jPointer dimension, int dimensionLength) {
+	// no-op
+}
 /**
  *
  * @param opNum
@@ -2044,6 +2096,22 @@ void   NativeOps::execBroadcastFloat(
 }
 
 
+/**
+ * PLEASE NOTE: This method is NOT supported yet and has NO effect in CUDA-based backend.
+ * Only broadcasting along dimensions is available on the device.
+ */
+void   NativeOps::execBroadcastFloat(Nd4jPointer *extraPointers,
+		int opNum,
+		Nd4jPointer x,
+		Nd4jPointer xShapeInfo,
+		Nd4jPointer y,
+		Nd4jPointer yShapeInfo,
+		Nd4jPointer result,
+		Nd4jPointer resultShapeInfo) {
+	// no-op
+}
+
+
 
 /**
  *
@@ -2092,7 +2160,7 @@ void   NativeOps::execPairwiseTransformFloat(
 	dim3 launchDims = getFlatLaunchParams((int) extraPointers[2], hostXShapeInfo, nullptr, funcAttributes[11]);
 
 	if (verbose && launchDims.x == 1)
-		printf("AF4 opNum:[%i], xLength: [%i]\n", opNum, shape::length(hostXShapeInfo));
+		printf("AF4 opNum:[%i], xLength: [%lld]\n", opNum, shape::length(hostXShapeInfo));
 
 	pairWiseTransformStridedFloat<<<launchDims.x,launchDims.y, launchDims.z, *stream>>>(
 			opNum,
@@ -2254,6 +2322,24 @@ void NativeOps::execPairwiseTransformFloat(
 		checkCudaErrors(cudaStreamSynchronize(*stream));
 }
 
+/**
+ * PLEASE NOTE: This method is NOT supported yet and has NO effect in CUDA-based backend.
+ */
+void NativeOps::execTernaryTransformFloat(
+		Nd4jPointer *extraPointers,
+		int opNum,
+		Nd4jPointer dx,
+		Nd4jPointer xShapeInfo,
+		Nd4jPointer y,
+		Nd4jPointer yShapeInfo,
+		Nd4jPointer z,
+		Nd4jPointer zShapeInfo,
+		Nd4jPointer result,
+		Nd4jPointer resultShapeInfo,
+		Nd4jPointer extraParams) {
+	// no-op
+}
+
 /**
  *
  * @param opNum
@@ -2796,7 +2882,7 @@ void NativeOps::execScalarFloat(
 	dim3 launchDims = getFlatLaunchParams((int) extraPointers[2], hostXShapeInfo, hostZShapeInfo, funcAttributes[5]);
 
 	if (verbose && launchDims.x == 1)
-		printf("AF14 opNum:[%i], xLength:[%i]\n", opNum, shape::length(hostXShapeInfo));
+		printf("AF14 opNum:[%i], xLength:[%lld]\n", opNum, shape::length(hostXShapeInfo));
 
 	scalarFloat<<<launchDims.x, launchDims.y, launchDims.z, *stream>>>(
 			opNum,
@@ -2870,6 +2956,23 @@ void NativeOps::execScalarFloat(
 		checkCudaErrors(cudaStreamSynchronize(*stream));
 
 }
+
+/**
+ * PLEASE NOTE: This method is NOT supported yet and has NO effect in CUDA-based backend.
+ */
+void NativeOps::execScalarAlongDimensionFloat(
+		Nd4jPointer *extraPointers,
+		int opNum,
+		Nd4jPointer x,
+		Nd4jPointer xShapeInfo,
+		Nd4jPointer result,
+		Nd4jPointer resultShapeInfo,
+		Nd4jPointer scalars,
+		Nd4jPointer scalarsShapeInfo,
+		Nd4jPointer extraParams,
+		Nd4jPointer dimension, int dimensionLength) {
+	// no-op
+}
 /**
  *
  * @param opNum
@@ -3089,7 +3192,7 @@ void   NativeOps::execTransformFloat(
 	dim3 launchDims = getFlatLaunchParams((int) extraPointers[2], hostXShapeInfo, nullptr, funcAttributes[2]);
 
 	if (verbose && launchDims.x == 1)
-		printf("AF19 opNum:[%i], xLength: [%i]\n", opNum, shape::length(hostXShapeInfo));
+		printf("AF19 opNum:[%i], xLength: [%lld]\n", opNum, shape::length(hostXShapeInfo));
 
 	transformFloat<<<launchDims.x,launchDims.y,launchDims.z, *stream>>>(
 			opNum,
@@ -3426,7 +3529,7 @@ __device__ void flattenKernelGeneric(int dOffset,
 	int *yStride = shape::stride(inputShapeInfo);
 	char yOrder = shape::order(inputShapeInfo);
 
-	int len = shape::length(inputShapeInfo);
+	Nd4jIndex len = shape::length(inputShapeInfo);
 
 	int resultEWS = shape::elementWiseStride(resultShapeInfo);
 	int inputEWS = shape::elementWiseStride(inputShapeInfo);
@@ -3447,14 +3550,14 @@ __device__ void flattenKernelGeneric(int dOffset,
 			if(order == 'f') {
 				for(int i = tid; i < len; i+= gridDim.x * blockDim.x) {
 					shape::ind2sub(rank,yShape,i,coord);
-					int offset = shape::getOffset(0,yShape,yStride,coord,rank);
+					Nd4jIndex offset = shape::getOffset(0,yShape,yStride,coord,rank);
 					result[i + dOffset] = input[offset];
 				}
 			}
 			else {
 				for(int i = tid; i < len; i+= gridDim.x * blockDim.x) {
 					shape::ind2subC(rank,yShape,i,coord);
-					int offset = shape::getOffset(0,yShape,yStride,coord,rank);
+					Nd4jIndex offset = shape::getOffset(0,yShape,yStride,coord,rank);
 					result[i + dOffset] = input[offset];
 				}
 			}
@@ -3475,14 +3578,14 @@ __device__ void flattenKernelGeneric(int dOffset,
 		if(order == 'f') {
 			for(int i = tid; i < len; i+= gridDim.x * blockDim.x) {
 				shape::ind2sub(rank,yShape,i,coord);
-				int offset = shape::getOffset(0,yShape,yStride,coord,rank);
+				Nd4jIndex offset = shape::getOffset(0,yShape,yStride,coord,rank);
 				result[i+dOffset] = input[offset];
 			}
 		}
 		else {
 			for(int i = tid; i < len; i+= gridDim.x * blockDim.x) {
 				shape::ind2subC(rank,yShape,i,coord);
-				int offset = shape::getOffset(0,yShape,yStride,coord,rank);
+				Nd4jIndex offset = shape::getOffset(0,yShape,yStride,coord,rank);
 				result[i+dOffset] = input[offset];
 			}
 		}
@@ -3951,6 +4054,15 @@ Nd4jPointer NativeOps::destroyEvent(Nd4jPointer event) {
 	else return 1;
 }
 
+Nd4jPointer NativeOps::destroyStream(Nd4jPointer stream) {
+	cudaStream_t *pStream = reinterpret_cast<cudaStream_t *>(&stream);
+	cudaError_t result = cudaStreamDestroy(*pStream);
+	checkCudaErrors(result);
+	if (result != 0)
+		return 0L;
+	else return 1;
+}
+
 Nd4jPointer NativeOps::streamSynchronize(Nd4jPointer stream) {
 	cudaStream_t *pStream = reinterpret_cast<cudaStream_t *>(&stream);
 
@@ -4191,31 +4303,443 @@ void NativeOps::concatDouble(
 		checkCudaErrors(cudaStreamSynchronize(*stream));
 }
 
+/**
+ * PLEASE NOTE: This method is NOT supported yet and has NO effect in CUDA-based backend.
+ * Histograms are computed by the CPU backend only.
+ */
+void NativeOps::execHistogramFloat(Nd4jPointer *extraPointers,
+                                Nd4jPointer x,
+                                Nd4jPointer xShapeInfo,
+                                Nd4jPointer result,
+                                Nd4jPointer resultShapeInfo,
+                                int numBins,
+                                double min,
+                                double max,
+                                Nd4jPointer dimension,
+                                int dimensionLength) {
+	// no-op
+}
+
+/**
+ * PLEASE NOTE: This method is NOT supported yet and has NO effect in CUDA-based backend.
+ * Quantiles are computed by the CPU backend only.
+ */
+void NativeOps::execQuantilesFloat(Nd4jPointer *extraPointers,
+                                Nd4jPointer x,
+                                Nd4jPointer xShapeInfo,
+                                Nd4jPointer quantiles,
+                                int numQuantiles,
+                                double compression,
+                                Nd4jPointer result,
+                                Nd4jPointer resultShapeInfo,
+                                Nd4jPointer dimension,
+                                int dimensionLength) {
+	// no-op
+}
+
+/**
+ * PLEASE NOTE: This method is NOT supported yet and has NO effect in CUDA-based backend.
+ * Histograms are computed by the CPU backend only.
+ */
+void NativeOps::execHistogramDouble(Nd4jPointer *extraPointers,
+                                Nd4jPointer x,
+                                Nd4jPointer xShapeInfo,
+                                Nd4jPointer result,
+                                Nd4jPointer resultShapeInfo,
+                                int numBins,
+                                double min,
+                                double max,
+                                Nd4jPointer dimension,
+                                int dimensionLength) {
+	// no-op
+}
+
+/**
+ * PLEASE NOTE: This method is NOT supported yet and has NO effect in CUDA-based backend.
+ * Quantiles are computed by the CPU backend only.
+ */
+void NativeOps::execQuantilesDouble(Nd4jPointer *extraPointers,
+                                Nd4jPointer x,
+                                Nd4jPointer xShapeInfo,
+                                Nd4jPointer quantiles,
+                                int numQuantiles,
+                                double compression,
+                                Nd4jPointer result,
+                                Nd4jPointer resultShapeInfo,
+                                Nd4jPointer dimension,
+                                int dimensionLength) {
+	// no-op
+}
+
+/**
+ * PLEASE NOTE: Masks are NOT supported yet in CUDA-based backend,
+ * these methods have NO effect.
+ */
+void NativeOps::execCompareMaskFloat(Nd4jPointer *extraPointers,
+                                   int opNum,
+                                   Nd4jPointer x,
+                                   Nd4jPointer xShapeInfo,
+                                   Nd4jPointer y,
+                                   Nd4jPointer yShapeInfo,
+                                   Nd4jPointer extraParams,
+                                   Nd4jPointer mask,
+                                   int packed) {
+	// no-op
+}
+
+void NativeOps::execScalarCompareMaskFloat(Nd4jPointer *extraPointers,
+                                         int opNum,
+                                         Nd4jPointer x,
+                                         Nd4jPointer xShapeInfo,
+                                         double scalar,
+                                         Nd4jPointer extraParams,
+                                         Nd4jPointer mask,
+                                         int packed) {
+	// no-op
+}
+
+void NativeOps::execMaskedTransformFloat(Nd4jPointer *extraPointers,
+                                       int opNum,
+                                       Nd4jPointer x,
+                                       Nd4jPointer xShapeInfo,
+                                       Nd4jPointer result,
+                                       Nd4jPointer resultShapeInfo,
+                                       Nd4jPointer extraParams,
+                                       Nd4jPointer mask,
+                                       int packed) {
+	// no-op
+}
+
+float NativeOps::execMaskedReduceScalarFloat(Nd4jPointer *extraPointers,
+                                           int opNum,
+                                           Nd4jPointer x,
+                                           Nd4jPointer xShapeInfo,
+                                           Nd4jPointer extraParams,
+                                           Nd4jPointer mask,
+                                           int packed) {
+	return 0.0;
+}
+
+void NativeOps::execSelectFloat(Nd4jPointer *extraPointers,
+                              Nd4jPointer x,
+                              Nd4jPointer xShapeInfo,
+                              Nd4jPointer y,
+                              Nd4jPointer yShapeInfo,
+                              Nd4jPointer result,
+                              Nd4jPointer resultShapeInfo,
+                              Nd4jPointer mask,
+                              int packed) {
+	// no-op
+}
+
+/**
+ * PLEASE NOTE: Masks are NOT supported yet in CUDA-based backend,
+ * these methods have NO effect.
+ */
+void NativeOps::execCompareMaskDouble(Nd4jPointer *extraPointers,
+                                   int opNum,
+                                   Nd4jPointer x,
+                                   Nd4jPointer xShapeInfo,
+                                   Nd4jPointer y,
+                                   Nd4jPointer yShapeInfo,
+                                   Nd4jPointer extraParams,
+                                   Nd4jPointer mask,
+                                   int packed) {
+	// no-op
+}
+
+void NativeOps::execScalarCompareMaskDouble(Nd4jPointer *extraPointers,
+                                         int opNum,
+                                         Nd4jPointer x,
+                                         Nd4jPointer xShapeInfo,
+                                         double scalar,
+                                         Nd4jPointer extraParams,
+                                         Nd4jPointer mask,
+                                         int packed) {
+	// no-op
+}
+
+void NativeOps::execMaskedTransformDouble(Nd4jPointer *extraPointers,
+                                       int opNum,
+                                       Nd4jPointer x,
+                                       Nd4jPointer xShapeInfo,
+                                       Nd4jPointer result,
+                                       Nd4jPointer resultShapeInfo,
+                                       Nd4jPointer extraParams,
+                                       Nd4jPointer mask,
+                                       int packed) {
+	// no-op
+}
+
+double NativeOps::execMaskedReduceScalarDouble(Nd4jPointer *extraPointers,
+                                           int opNum,
+                                           Nd4jPointer x,
+                                           Nd4jPointer xShapeInfo,
+                                           Nd4jPointer extraParams,
+                                           Nd4jPointer mask,
+                                           int packed) {
+	return 0.0;
+}
+
+void NativeOps::execSelectDouble(Nd4jPointer *extraPointers,
+                              Nd4jPointer x,
+                              Nd4jPointer xShapeInfo,
+                              Nd4jPointer y,
+                              Nd4jPointer yShapeInfo,
+                              Nd4jPointer result,
+                              Nd4jPointer resultShapeInfo,
+                              Nd4jPointer mask,
+                              int packed) {
+	// no-op
+}
+
+void NativeOps::execBatchFloat(Nd4jPointer *extraPointers, Nd4jPointer descriptors, int numOps) {
+	// no-op
+}
+
+void NativeOps::execBatchDouble(Nd4jPointer *extraPointers, Nd4jPointer descriptors, int numOps) {
+	// no-op
+}
+
+/**
+ * Op graphs are not supported on this backend yet
+ */
+Nd4jPointer NativeOps::createGraphFloat() {
+	return 0L;
+}
+
+int NativeOps::graphInputFloat(Nd4jPointer graph, Nd4jPointer x, Nd4jPointer xShapeInfo) {
+	return -1;
+}
+
+int NativeOps::graphTransformFloat(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams) {
+	return -1;
+}
+
+int NativeOps::graphScalarFloat(Nd4jPointer graph, int opNum, int x, float scalar, Nd4jPointer extraParams) {
+	return -1;
+}
+
+int NativeOps::graphPairwiseFloat(Nd4jPointer graph, int opNum, int x, int y, Nd4jPointer extraParams) {
+	return -1;
+}
+
+int NativeOps::graphBroadcastFloat(Nd4jPointer graph, int opNum, int x, int y) {
+	return -1;
+}
+
+int NativeOps::graphReduceFloat(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams, Nd4jPointer result) {
+	return -1;
+}
+
+int NativeOps::graphOutputFloat(Nd4jPointer graph, int value, Nd4jPointer result, Nd4jPointer resultShapeInfo) {
+	return -1;
+}
+
+int NativeOps::execGraphFloat(Nd4jPointer *extraPointers, Nd4jPointer graph) {
+	// no-op
+	return 0;
+}
+
+void NativeOps::deleteGraphFloat(Nd4jPointer graph) {
+	// no-op
+}
+
+Nd4jPointer NativeOps::createGraphDouble() {
+	return 0L;
+}
+
+int NativeOps::graphInputDouble(Nd4jPointer graph, Nd4jPointer x, Nd4jPointer xShapeInfo) {
+	return -1;
+}
+
+int NativeOps::graphTransformDouble(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams) {
+	return -1;
+}
+
+int NativeOps::graphScalarDouble(Nd4jPointer graph, int opNum, int x, double scalar, Nd4jPointer extraParams) {
+	return -1;
+}
+
+int NativeOps::graphPairwiseDouble(Nd4jPointer graph, int opNum, int x, int y, Nd4jPointer extraParams) {
+	return -1;
+}
+
+int NativeOps::graphBroadcastDouble(Nd4jPointer graph, int opNum, int x, int y) {
+	return -1;
+}
+
+int NativeOps::graphReduceDouble(Nd4jPointer graph, int opNum, int x, Nd4jPointer extraParams, Nd4jPointer result) {
+	return -1;
+}
+
+int NativeOps::graphOutputDouble(Nd4jPointer graph, int value, Nd4jPointer result, Nd4jPointer resultShapeInfo) {
+	return -1;
+}
+
+int NativeOps::execGraphDouble(Nd4jPointer *extraPointers, Nd4jPointer graph) {
+	// no-op
+	return 0;
+}
+
+void NativeOps::deleteGraphDouble(Nd4jPointer graph) {
+	// no-op
+}
+
 /**
  * This method saves
  */
-void NativeOps::tadOnlyShapeInfo(Nd4jPointer xShapeInfo, Nd4jPointer dimension, int dimensionLength, Nd4jPointer targetBuffer, Nd4jPointer offsetsBuffer) {
+int NativeOps::tadOnlyShapeInfo(Nd4jPointer xShapeInfo, Nd4jPointer dimension, int dimensionLength, Nd4jPointer targetBuffer, Nd4jPointer offsetsBuffer) {
 	int *hostXShapeInfo = reinterpret_cast<int *>(xShapeInfo);
 	int *dimensionPointer = reinterpret_cast<int *>(dimension);
 	int *target = reinterpret_cast<int *>(targetBuffer);
 	int *offsets = reinterpret_cast<int *>(offsetsBuffer);
 
 
-	shape::TAD *tad = new shape::TAD();
-	tad->init(hostXShapeInfo, dimensionPointer, dimensionLength);
-	//tad->setOutputBuffer(target);
-	tad->createTadOnlyShapeInfo();
-	tad->createOffsets();
+	std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(hostXShapeInfo, dimensionPointer, dimensionLength);
+	shape::TAD *tad = tadPack->tad;
 
+	//the offsets buffer keeps the int layout callers expect
+	for (int i = 0; i < tad->numTads; i++) {
+		if (tad->tadOffsets[i] > 2147483647LL) {
+			printf("TAD offset %lld does not fit an int; use tadOnlyShapeInfo64\n", (long long) tad->tadOffsets[i]);
+			return -1;
+		}
+	}
 
 	std::memcpy((void *) target, tad->tadOnlyShapeInfo, (tad->tadOnlyShapeInfo[0] * 2 + 4) * sizeof(int));
-	std::memcpy((void *) offsets, tad->tadOffsets, tad->numTads * sizeof(int));
-/*
-	shape::printShapeInfoLinear(hostXShapeInfo);
-	shape::printShapeInfoLinear(tad->tadOnlyShapeInfo);
-	shape::printShapeInfoLinear(target);
-*/
-	delete tad;
+	for (int i = 0; i < tad->numTads; i++)
+		offsets[i] = (int) tad->tadOffsets[i];
+	return 0;
+}
+
+void NativeOps::tadOnlyShapeInfo64(Nd4jPointer xShapeInfo, Nd4jPointer dimension, int dimensionLength, Nd4jPointer targetBuffer, Nd4jPointer offsetsBuffer) {
+	int *hostXShapeInfo = reinterpret_cast<int *>(xShapeInfo);
+	int *dimensionPointer = reinterpret_cast<int *>(dimension);
+	int *target = reinterpret_cast<int *>(targetBuffer);
+	Nd4jIndex *offsets = reinterpret_cast<Nd4jIndex *>(offsetsBuffer);
+
+	std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(hostXShapeInfo, dimensionPointer, dimensionLength);
+	shape::TAD *tad = tadPack->tad;
+
+	std::memcpy((void *) target, tad->tadOnlyShapeInfo, (tad->tadOnlyShapeInfo[0] * 2 + 4) * sizeof(int));
+	std::memcpy((void *) offsets, tad->tadOffsets, tad->numTads * sizeof(Nd4jIndex));
+}
+
+void NativeOps::setTadCacheLimits(int maxEntries, Nd4jIndex maxBytes) {
+	shape::TadCache::getInstance()->setLimits(maxEntries, maxBytes);
+}
+
+void NativeOps::purgeTadCache() {
+	shape::TadCache::getInstance()->purge();
+}
+
+Nd4jIndex NativeOps::getTadCacheHits() {
+	return shape::TadCache::getInstance()->getHits();
+}
+
+Nd4jIndex NativeOps::getTadCacheMisses() {
+	return shape::TadCache::getInstance()->getMisses();
+}
+
+Nd4jIndex NativeOps::getTadCacheEvictions() {
+	return shape::TadCache::getInstance()->getEvictions();
+}
+
+/**
+ * Host memory comes from cudaHostAlloc here and is not pooled
+ */
+void NativeOps::setHostPoolLimits(Nd4jIndex maxCachedBytes, Nd4jIndex maxThreadCachedBytes) {
+	// no-op
+}
+
+void NativeOps::purgeHostPool() {
+	// no-op
+}
+
+Nd4jIndex NativeOps::getHostPoolBytesInUse() {
+	return 0L;
+}
+
+Nd4jIndex NativeOps::getHostPoolBytesCached() {
+	return 0L;
+}
+
+Nd4jIndex NativeOps::getHostPoolHits() {
+	return 0L;
+}
+
+Nd4jIndex NativeOps::getHostPoolMisses() {
+	return 0L;
+}
+
+int NativeOps::getHostAlignment(Nd4jPointer pointer) {
+	if (pointer == 0)
+		return 0;
+	//cudaHostAlloc hands out whole pages
+	return 4096;
+}
+
+void NativeOps::enableThreadPool(bool reallyEnable) {
+	// no-op
+}
+
+void NativeOps::setThreadPoolConcurrency(int threads) {
+	// no-op
+}
+
+Nd4jPointer NativeOps::createExecutionContext(int threads, Nd4jPointer cores, int numCores) {
+	// no-op
+	return 0L;
+}
+
+void NativeOps::destroyExecutionContext(Nd4jPointer context) {
+	// no-op
+}
+
+int NativeOps::getNumaNodes() {
+	// no-op
+	return 1;
+}
+
+int NativeOps::bindThreadsToNumaNodes() {
+	// no-op
+	return 0;
+}
+
+int NativeOps::unbindThreadsFromNumaNodes() {
+	// no-op
+	return 0;
+}
+
+void NativeOps::enableOpProfiling(bool reallyEnable) {
+	// no-op
+}
+
+void NativeOps::resetOpProfile() {
+	// no-op
+}
+
+int NativeOps::getOpProfile(char *buffer, int length, bool json) {
+	// no-op
+	if (buffer != nullptr && length > 0)
+		buffer[0] = '\0';
+	return 0;
+}
+
+void NativeOps::enableOpTrace(bool reallyEnable) {
+	// no-op
+}
+
+void NativeOps::clearOpTrace() {
+	// no-op
+}
+
+int NativeOps::getOpTrace(char *buffer, int length) {
+	// no-op
+	if (buffer != nullptr && length > 0)
+		buffer[0] = '\0';
+	return 0;
 }
 
 Nd4jPointer NativeOps::memcpyConstantAsync(Nd4jPointer dst, Nd4jPointer src, long size, int flags, Nd4jPointer reserved) {
@@ -14,6 +14,7 @@
 #include <templatemath.h>
 #include <helper_cuda.h>
 #include <pairwise_util.h>
+#include <tadcache.h>
 
 #ifdef __CUDACC__
 #include <cuda.h>
@@ -161,9 +162,8 @@ namespace functions {
 							  T *result,
 							  int *dimension,
 							  int dimensionLength) {
-				shape::TAD tad(xShapeInfo,dimension,dimensionLength);
-				tad.createTadOnlyShapeInfo();
-				tad.createOffsets();
+				std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(xShapeInfo, dimension, dimensionLength);
+				shape::TAD &tad = *tadPack->tad;
 				//decompose in to several sub tads after
 				//moving all dimensions (in sorted order)
 				//to the back.
@@ -173,16 +173,66 @@ namespace functions {
 				int *xShape = shape::shapeOf(tadShapeShapeInfo);
 				int *xStride = shape::stride(tadShapeShapeInfo);
 				int *resultStride = shape::stride(tadShapeShapeInfo);
+				int tadEWS = shape::elementWiseStride(tadShapeShapeInfo);
+				int yEWS = shape::elementWiseStride(yShapeInfo);
+
+				//y is consumed in the order the tad is traversed: linear element wise
+				//order agrees with it for vector tads and f ordered tads
+				int nonUnitDims = 0;
+				for (int i = 0; i < shape::rank(tadShapeShapeInfo); i++) {
+					if (xShape[i] != 1)
+						nonUnitDims++;
+				}
 
-				if (result == x) {
+				if (tadEWS >= 1 && yEWS >= 1 && (nonUnitDims <= 1 || shape::order(tadShapeShapeInfo) == 'f')) {
+					Nd4jIndex tadLength = shape::length(tadShapeShapeInfo);
+					if (tads >= omp_get_max_threads() || tadLength < 8000) {
+						//many (or short) tads: one tad per iteration, simd within the tad
+#pragma omp parallel for schedule(guided) if (tads * tadLength >= 8000)
+						for (int i = 0; i < tads; i++) {
+							T *xIter = x + tad.tadOffsets[i];
+							T *resultIter = result + tad.tadOffsets[i];
+							if (tadEWS == 1 && yEWS == 1) {
+#pragma omp simd
+								for (Nd4jIndex j = 0; j < tadLength; j++) {
+									resultIter[j] = this->op(xIter[j], y[j]);
+								}
+							}
+							else {
+#pragma omp simd
+								for (Nd4jIndex j = 0; j < tadLength; j++) {
+									resultIter[j * tadEWS] = this->op(xIter[j * tadEWS], y[j * yEWS]);
+								}
+							}
+						}
+					}
+					else {
+						//few long tads: split every tad across the threads instead
+						for (int i = 0; i < tads; i++) {
+							T *xIter = x + tad.tadOffsets[i];
+							T *resultIter = result + tad.tadOffsets[i];
+							if (tadEWS == 1 && yEWS == 1) {
+#pragma omp parallel for simd schedule(static)
+								for (Nd4jIndex j = 0; j < tadLength; j++) {
+									resultIter[j] = this->op(xIter[j], y[j]);
+								}
+							}
+							else {
+#pragma omp parallel for simd schedule(static)
+								for (Nd4jIndex j = 0; j < tadLength; j++) {
+									resultIter[j * tadEWS] = this->op(xIter[j * tadEWS], y[j * yEWS]);
+								}
+							}
+						}
+					}
+				}
+				else if (result == x) {
 #pragma omp  parallel  for
 					for (int i = 0; i < tads; i++) {
-						int offset = tad.tadOffsets[i];
+						Nd4jIndex offset = tad.tadOffsets[i];
 						T *xIter = x + offset;
 						T *resultIter = result + offset;
 						int shapeIter[MAX_RANK];
-						int coord[MAX_RANK];
-						int dim;
 						int xStridesIter[MAX_RANK];
 						int resultStridesIter[MAX_RANK];
 						int rank = shape::rank(tadShapeShapeInfo);
@@ -200,22 +250,14 @@ namespace functions {
 													  xStridesIter,
 													  &resultIter,
 													  resultStridesIter) >= 0) {
-							ND4J_RAW_ITER_START(dim, rank, coord, shapeIter);
-							{
+							auto kernel = [&](T *xIter, T *resultIter) {
 								/* Process the innermost dimension */
 								T val = this->op(xIter[0], y[vectorIdx]);
 								// printf("TAD %d x %f and y %f with vector idx %d and result %f\n",i,xIter[0],y[vectorIdx],vectorIdx,val);
 								xIter[0] = val;
 								vectorIdx += shape::elementWiseStride(yShapeInfo);
-							}
-							ND4J_RAW_ITER_TWO_NEXT(dim,
-												   rank,
-												   coord,
-												   shapeIter,
-												   xIter,
-												   xStridesIter,
-												   resultIter,
-												   resultStridesIter);
+							};
+							RawIterTwo(rank, shapeIter, xIter, xStridesIter, resultIter, resultStridesIter, kernel);
 
 
 						}
@@ -225,12 +267,10 @@ namespace functions {
 
 #pragma omp  parallel  for
 					for (int i = 0; i < tads; i++) {
-						int offset = tad.tadOffsets[i];
+						Nd4jIndex offset = tad.tadOffsets[i];
 						T *xIter = x + offset;
 						T *resultIter = result + offset;
 						int shapeIter[MAX_RANK];
-						int coord[MAX_RANK];
-						int dim;
 						int xStridesIter[MAX_RANK];
 						int resultStridesIter[MAX_RANK];
 						int rank = shape::rank(tadShapeShapeInfo);
@@ -247,21 +287,13 @@ namespace functions {
 													  xStridesIter,
 													  &resultIter,
 													  resultStridesIter) >= 0) {
-							ND4J_RAW_ITER_START(dim, rank, coord, shapeIter);
-							{
+							auto kernel = [&](T *xIter, T *resultIter) {
 								/* Process the innermost dimension */
 								T val = this->op(xIter[0], y[vectorIdx]);
 								resultIter[0] = val;
 								vectorIdx += shape::elementWiseStride(yShapeInfo);
-							}
-							ND4J_RAW_ITER_TWO_NEXT(dim,
-												   rank,
-												   coord,
-												   shapeIter,
-												   xIter,
-												   xStridesIter,
-												   resultIter,
-												   resultStridesIter);
+							};
+							RawIterTwo(rank, shapeIter, xIter, xStridesIter, resultIter, resultStridesIter, kernel);
 
 
 						}
@@ -276,6 +308,128 @@ namespace functions {
 
 			}
 
+
+			/**
+			 * CPU execution with NumPy style broadcasting:
+			 * x and y are each broadcast to the shape of the result
+			 * (trailing dimensions aligned, length 1 or missing
+			 * dimensions repeated) by reading them with zero strides,
+			 * so the smaller operand is never tiled in memory.
+			 * @param x the input
+			 * @param xShapeInfo the x shape information
+			 * @param y the y data
+			 * @param yShapeInfo the y shape information
+			 * @param result the result
+			 * @param resultShapeInfo the result shape information,
+			 * the broadcast shape of x and y
+			 */
+			virtual void exec(T *x,
+							  int *xShapeInfo,
+							  T *y,
+							  int *yShapeInfo,
+							  T *result,
+							  int *resultShapeInfo) {
+				int rank = shape::rank(resultShapeInfo);
+				int *resultShape = shape::shapeOf(resultShapeInfo);
+				int xStrides[MAX_RANK];
+				int yStrides[MAX_RANK];
+				if (BroadcastStrides(shape::rank(xShapeInfo), shape::shapeOf(xShapeInfo), shape::stride(xShapeInfo), rank, resultShape, xStrides) < 0 ||
+					BroadcastStrides(shape::rank(yShapeInfo), shape::shapeOf(yShapeInfo), shape::stride(yShapeInfo), rank, resultShape, yStrides) < 0) {
+					printf("Unable to broadcast x and y to the result shape\n");
+					return;
+				}
+
+				int ndim;
+				int iterShape[MAX_RANK];
+				int resultStridesIter[MAX_RANK];
+				int xStridesIter[MAX_RANK];
+				int yStridesIter[MAX_RANK];
+				CoalesceBroadcastIter(rank,
+									  resultShape,
+									  shape::stride(resultShapeInfo),
+									  xStrides,
+									  yStrides,
+									  &ndim,
+									  iterShape,
+									  resultStridesIter,
+									  xStridesIter,
+									  yStridesIter);
+
+				//innermost (coalesced) axis is run as a flat loop, the rest is the outer index
+				Nd4jIndex innerLength = iterShape[0];
+				Nd4jIndex outerLength = 1;
+				for (int i = 1; i < ndim; i++)
+					outerLength *= iterShape[i];
+				if (innerLength < 1)
+					return;
+
+				//split rows when there are too few of them to keep every thread busy
+				int threads = omp_get_max_threads();
+				Nd4jIndex length = innerLength * outerLength;
+				Nd4jIndex chunksPerRow = 1;
+				if (length >= 8000 && outerLength < threads) {
+					chunksPerRow = (threads + outerLength - 1) / outerLength;
+					Nd4jIndex maxChunks = innerLength / 1024;
+					if (chunksPerRow > maxChunks)
+						chunksPerRow = maxChunks < 1 ? 1 : maxChunks;
+				}
+
+				Nd4jIndex chunkLength = (innerLength + chunksPerRow - 1) / chunksPerRow;
+				Nd4jIndex items = outerLength * chunksPerRow;
+				int xInner = xStridesIter[0];
+				int yInner = yStridesIter[0];
+				int resultInner = resultStridesIter[0];
+
+#pragma omp parallel for schedule(static) if (length >= 8000)
+				for (Nd4jIndex item = 0; item < items; item++) {
+					Nd4jIndex row = item / chunksPerRow;
+					Nd4jIndex start = (item % chunksPerRow) * chunkLength;
+					Nd4jIndex end = start + chunkLength < innerLength ? start + chunkLength : innerLength;
+					Nd4jIndex xOffset = start * xInner;
+					Nd4jIndex yOffset = start * yInner;
+					Nd4jIndex resultOffset = start * resultInner;
+					Nd4jIndex remainder = row;
+					for (int i = 1; i < ndim; i++) {
+						Nd4jIndex coord = remainder % iterShape[i];
+						remainder /= iterShape[i];
+						xOffset += coord * xStridesIter[i];
+						yOffset += coord * yStridesIter[i];
+						resultOffset += coord * resultStridesIter[i];
+					}
+
+					T *xIter = x + xOffset;
+					T *yIter = y + yOffset;
+					T *resultIter = result + resultOffset;
+					Nd4jIndex n = end - start;
+					if (xInner == 1 && yInner == 1 && resultInner == 1) {
+#pragma omp simd
+						for (Nd4jIndex i = 0; i < n; i++) {
+							resultIter[i] = this->op(xIter[i], yIter[i]);
+						}
+					}
+					else if (xInner == 1 && yInner == 0 && resultInner == 1) {
+						T yVal = yIter[0];
+#pragma omp simd
+						for (Nd4jIndex i = 0; i < n; i++) {
+							resultIter[i] = this->op(xIter[i], yVal);
+						}
+					}
+					else if (xInner == 0 && yInner == 1 && resultInner == 1) {
+						T xVal = xIter[0];
+#pragma omp simd
+						for (Nd4jIndex i = 0; i < n; i++) {
+							resultIter[i] = this->op(xVal, yIter[i]);
+						}
+					}
+					else {
+#pragma omp simd
+						for (Nd4jIndex i = 0; i < n; i++) {
+							resultIter[i * resultInner] = this->op(xIter[i * xInner], yIter[i * yInner]);
+						}
+					}
+				}
+			}
+
 			virtual inline
 #ifdef __CUDACC__
 			__host__ __device__
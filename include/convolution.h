@@ -44,8 +44,8 @@ int opSize() {
             int * inShape = img.shape();
             int * inStride = img.stride();
 
-            int * outIndices = new int[6];
-            int * inIndices = new int[4];
+            int outIndices[6];
+            int inIndices[4];
 
             int inStride2 = inStride[2];
             int inStride3 = inStride[3];
@@ -190,8 +190,8 @@ private:
             int* inShape = col.shape();
             int* inStride = col.stride();
 
-            int* outIndices = new int[4];
-            int* inIndices = new int[6];
+            int outIndices[4];
+            int inIndices[6];
 
             int inStride2 = inStride[2];
             int inStride3 = inStride[3];
@@ -0,0 +1,248 @@
+/*
+ * cpustream.h
+ *
+ * Streams and events for the CPU backend, mirroring
+ * the CUDA ones NativeOps hands out on the GPU backend.
+ *
+ * A CpuStream owns one worker thread and runs the work
+ * enqueued on it in order; the calling thread returns as soon
+ * as the work is queued. A CpuEvent is recorded on a stream
+ * and completes once the stream has run everything queued
+ * before the record. An event only holds the stream's progress,
+ * not the stream, so it can be waited on or freed after the
+ * stream is destroyed.
+ *
+ * exec* calls pick up a stream the way the CUDA backend does:
+ * from extraPointers[1]. Only pointers returned by createStream
+ * and still alive are treated as streams, so callers that fill
+ * extraPointers with something else keep running synchronously.
+ * Like with CUDA, every buffer of an enqueued call (including
+ * the arrays of pointers some calls take, and its execution
+ * context) has to stay valid until the stream has run it.
+ */
+
+#ifndef CPUSTREAM_H_
+#define CPUSTREAM_H_
+#include <pointercast.h>
+#include <executioncontext.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace nd4j {
+
+    /**
+     * How far a stream has got; its lock also guards the stream's queue
+     */
+    struct StreamProgress {
+        std::mutex lock;
+        std::condition_variable changed;
+        Nd4jIndex finished = 0;
+
+        void waitFor(Nd4jIndex ticket) {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [&] { return finished >= ticket; });
+        }
+    };
+
+    class CpuStream {
+    public:
+        CpuStream() : progress(std::make_shared<StreamProgress>()) {
+            submitted = 0;
+            stopping = false;
+            worker = std::thread(&CpuStream::work, this);
+            std::lock_guard<std::mutex> lock(registryLock());
+            registry().insert(this);
+            liveStreams()++;
+        }
+
+        /**
+         * Runs everything still queued, then stops the worker
+         */
+        ~CpuStream() {
+            {
+                std::lock_guard<std::mutex> lock(registryLock());
+                registry().erase(this);
+                liveStreams()--;
+            }
+            {
+                std::lock_guard<std::mutex> lock(progress->lock);
+                stopping = true;
+            }
+            progress->changed.notify_all();
+            worker.join();
+        }
+
+        /**
+         * Queues a task behind everything enqueued before it.
+         * The task runs in the execution context current on
+         * the calling thread, if any.
+         * @return the ticket of the task, for waitFor
+         */
+        Nd4jIndex enqueue(std::function<void()> task) {
+            return enqueue(task, ExecutionContext::current());
+        }
+
+        /**
+         * Queues a task to run in the given
+         * execution context (nullptr for none)
+         * @return the ticket of the task, for waitFor
+         */
+        Nd4jIndex enqueue(std::function<void()> task, ExecutionContext *context) {
+            if (context != nullptr) {
+                std::function<void()> inner = task;
+                task = [context, inner] {
+                    ExecutionScope scope(context);
+                    inner();
+                };
+            }
+
+            Nd4jIndex ticket;
+            {
+                std::lock_guard<std::mutex> lock(progress->lock);
+                tasks.push_back(task);
+                ticket = ++submitted;
+            }
+            progress->changed.notify_all();
+            return ticket;
+        }
+
+        /**
+         * Blocks until the task with the given ticket
+         * (and so every task before it) has run
+         */
+        void waitFor(Nd4jIndex ticket) {
+            progress->waitFor(ticket);
+        }
+
+        /**
+         * The ticket of the task enqueued last
+         */
+        Nd4jIndex lastTicket() {
+            std::lock_guard<std::mutex> lock(progress->lock);
+            return submitted;
+        }
+
+        /**
+         * The stream's progress, which lives on after the stream
+         */
+        std::shared_ptr<StreamProgress> getProgress() {
+            return progress;
+        }
+
+        /**
+         * Blocks until everything enqueued so far has run
+         */
+        void synchronize() {
+            waitFor(lastTicket());
+        }
+
+        /**
+         * The live stream a pointer refers to, nullptr
+         * if it is not one returned by createStream
+         */
+        static CpuStream *find(Nd4jPointer pointer) {
+            if (pointer == 0 || liveStreams().load() == 0)
+                return nullptr;
+            CpuStream *stream = reinterpret_cast<CpuStream *>(pointer);
+            std::lock_guard<std::mutex> lock(registryLock());
+            return registry().count(stream) > 0 ? stream : nullptr;
+        }
+
+        /**
+         * The stream an exec* call was given in extraPointers[1], if any
+         */
+        static CpuStream *find(Nd4jPointer *extraPointers) {
+            if (extraPointers == nullptr || liveStreams().load() == 0)
+                return nullptr;
+            return find(extraPointers[1]);
+        }
+
+    private:
+        std::shared_ptr<StreamProgress> progress;
+        std::thread worker;
+        std::deque<std::function<void()>> tasks;
+        Nd4jIndex submitted;
+        bool stopping;
+
+        CpuStream(const CpuStream &other);
+        CpuStream &operator=(const CpuStream &other);
+
+        static std::mutex &registryLock() {
+            static std::mutex lock;
+            return lock;
+        }
+
+        static std::unordered_set<CpuStream *> &registry() {
+            static std::unordered_set<CpuStream *> streams;
+            return streams;
+        }
+
+        static std::atomic<int> &liveStreams() {
+            static std::atomic<int> count(0);
+            return count;
+        }
+
+        void work() {
+            std::unique_lock<std::mutex> lock(progress->lock);
+            while (true) {
+                progress->changed.wait(lock, [&] { return stopping || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+
+                std::function<void()> task = tasks.front();
+                tasks.pop_front();
+                lock.unlock();
+                task();
+                lock.lock();
+                progress->finished++;
+                progress->changed.notify_all();
+            }
+        }
+    };
+
+    class CpuEvent {
+    public:
+        CpuEvent() {
+            ticket = 0;
+        }
+
+        /**
+         * Marks the current end of the stream's queue;
+         * the event completes when the stream gets there
+         */
+        void record(CpuStream *stream) {
+            std::lock_guard<std::mutex> lock(eventLock);
+            this->progress = stream->getProgress();
+            this->ticket = stream->lastTicket();
+        }
+
+        /**
+         * Blocks until the last record has completed;
+         * an event never recorded is complete
+         */
+        void synchronize() {
+            std::shared_ptr<StreamProgress> progress;
+            Nd4jIndex ticket;
+            {
+                std::lock_guard<std::mutex> lock(eventLock);
+                progress = this->progress;
+                ticket = this->ticket;
+            }
+            if (progress)
+                progress->waitFor(ticket);
+        }
+
+    private:
+        std::mutex eventLock;
+        std::shared_ptr<StreamProgress> progress;
+        Nd4jIndex ticket;
+    };
+}
+
+#endif /* CPUSTREAM_H_ */
@@ -0,0 +1,375 @@
+/*
+ * executioncontext.h
+ *
+ * Per call execution settings for the CPU backend.
+ *
+ * setOmpNumThreads changes the thread count of the whole process,
+ * so callers running ops side by side cannot ask for different
+ * amounts of parallelism. An ExecutionContext carries a thread
+ * budget and, optionally, a set of cores for the calls it is
+ * handed to, in extraPointers[0] (a slot the CPU backend has no
+ * other use for). Only pointers returned by createExecutionContext
+ * and still alive are treated as contexts.
+ *
+ * While an ExecutionScope is open, the calling thread runs OpenMP
+ * regions with the budget as its team size (the OpenMP thread count
+ * is a per thread setting) and the team threads are pinned one to a
+ * core of the set. nd4j::parallelFor picks the context up from the
+ * calling thread for the thread pool as well, and CpuStream runs
+ * work queued under a context inside that context.
+ *
+ * Every thread remembers the core it was last pinned to, so pinning
+ * it there again costs nothing, and every calling thread remembers
+ * the context its OpenMP team was last pinned for. A scope only opens
+ * an extra parallel region to pin the team when that context changes
+ * (or the team grows); on close it unpins the calling thread alone and
+ * leaves the team pinned until a scope with another context, or none,
+ * needs it elsewhere. This counts on the runtime keeping a caller's
+ * team threads between regions, as libgomp and the LLVM runtime do;
+ * a thread it swaps in runs unpinned until the team is pinned again.
+ *
+ * Pinning is supported on Linux; elsewhere the core set is ignored.
+ */
+
+#ifndef EXECUTIONCONTEXT_H_
+#define EXECUTIONCONTEXT_H_
+#include <pointercast.h>
+#include <omp.h>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace nd4j {
+
+    class ExecutionContext {
+    public:
+        /**
+         * @param threads the most threads an op may use, 0 for no limit
+         * @param cores the cores to run on, nullptr for any
+         * @param numCores the length of cores
+         */
+        ExecutionContext(int threads, const int *cores, int numCores) {
+            this->threads = threads < 0 ? 0 : threads;
+            id = ++lastId();
+            for (int i = 0; cores != nullptr && i < numCores; i++)
+                this->cores.push_back(cores[i]);
+            processMask();
+            std::lock_guard<std::mutex> lock(registryLock());
+            registry().insert(this);
+            liveContexts()++;
+        }
+
+        ~ExecutionContext() {
+            std::lock_guard<std::mutex> lock(registryLock());
+            registry().erase(this);
+            liveContexts()--;
+        }
+
+        int getThreads() const {
+            return threads;
+        }
+
+        int numCores() const {
+            return (int) cores.size();
+        }
+
+        const int *getCores() const {
+            return cores.empty() ? nullptr : &cores[0];
+        }
+
+        /**
+         * A number naming this context, never reused by another
+         */
+        Nd4jIndex getId() const {
+            return id;
+        }
+
+        /**
+         * Pins the calling thread to core index (modulo
+         * the number of cores) of the set
+         * @return false if there is nothing to pin to
+         */
+        bool pin(int index) const {
+#if defined(__linux__)
+            if (cores.empty())
+                return false;
+            int core = cores[index % cores.size()];
+            if (pinnedCore() == core)
+                return true;
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            CPU_SET(core, &mask);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask) != 0)
+                return false;
+            pinnedCore() = core;
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * Lets the calling thread run on every core
+         * the process was allowed to start with
+         */
+        static void unpin() {
+#if defined(__linux__)
+            if (pinnedCore() < 0)
+                return;
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &processMask());
+            pinnedCore() = -1;
+#endif
+        }
+
+        /**
+         * The core the calling thread was last pinned
+         * to here, -1 while it may run on any
+         */
+        static int &pinnedCore() {
+            static thread_local int core = -1;
+            return core;
+        }
+
+        /**
+         * The live context a pointer refers to, nullptr
+         * if it is not one returned by createExecutionContext
+         */
+        static ExecutionContext *find(Nd4jPointer pointer) {
+            if (pointer == 0 || liveContexts().load() == 0)
+                return nullptr;
+            ExecutionContext *context = reinterpret_cast<ExecutionContext *>(pointer);
+            std::lock_guard<std::mutex> lock(registryLock());
+            return registry().count(context) > 0 ? context : nullptr;
+        }
+
+        /**
+         * The context an exec* call was given in extraPointers[0], if any
+         */
+        static ExecutionContext *find(Nd4jPointer *extraPointers) {
+            if (extraPointers == nullptr || liveContexts().load() == 0)
+                return nullptr;
+            return find(extraPointers[0]);
+        }
+
+        /**
+         * The context the calling thread is running in, if any
+         */
+        static ExecutionContext *&current() {
+            static thread_local ExecutionContext *context = nullptr;
+            return context;
+        }
+
+        /**
+         * The cores the process could run on before anything
+         * here pinned a thread; taken on first use, so code
+         * about to pin calls it first
+         */
+#if defined(__linux__)
+        static cpu_set_t &processMask() {
+            static cpu_set_t mask = initialMask();
+            return mask;
+        }
+#else
+        static void processMask() {
+        }
+#endif
+
+    private:
+        int threads;
+        std::vector<int> cores;
+        Nd4jIndex id;
+
+        ExecutionContext(const ExecutionContext &other);
+        ExecutionContext &operator=(const ExecutionContext &other);
+
+        static std::mutex &registryLock() {
+            static std::mutex lock;
+            return lock;
+        }
+
+        static std::unordered_set<ExecutionContext *> &registry() {
+            static std::unordered_set<ExecutionContext *> contexts;
+            return contexts;
+        }
+
+        static std::atomic<int> &liveContexts() {
+            static std::atomic<int> count(0);
+            return count;
+        }
+
+        static std::atomic<Nd4jIndex> &lastId() {
+            static std::atomic<Nd4jIndex> last(0);
+            return last;
+        }
+
+#if defined(__linux__)
+        static cpu_set_t initialMask() {
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            if (sched_getaffinity(0, sizeof(cpu_set_t), &mask) != 0) {
+                for (int i = 0; i < CPU_SETSIZE; i++)
+                    CPU_SET(i, &mask);
+            }
+            return mask;
+        }
+#endif
+    };
+
+    /**
+     * Makes a context current on the calling thread and its
+     * OpenMP team until the scope closes. A null context,
+     * or the one already current, leaves everything as is,
+     * apart from unpinning a team left pinned by an earlier scope.
+     */
+    class ExecutionScope {
+    public:
+        explicit ExecutionScope(Nd4jPointer *extraPointers) {
+            enter(ExecutionContext::find(extraPointers));
+        }
+
+        explicit ExecutionScope(ExecutionContext *context) {
+            enter(context);
+        }
+
+        /**
+         * Forgets the context the calling thread's team was last
+         * pinned for, without unpinning it: for code that placed
+         * the team itself (see bindThreadsToNodes)
+         */
+        static void forgetTeam() {
+            teamPinning() = TeamPinning();
+        }
+
+        ~ExecutionScope() {
+            if (context == nullptr)
+                return;
+            omp_set_num_threads(previousThreads);
+            ExecutionContext::current() = previous;
+            if (previous != nullptr)
+                placeTeam(previous, omp_get_max_threads());
+            else if (context->numCores() > 0)
+                ExecutionContext::unpin();
+        }
+
+    private:
+        ExecutionContext *context;
+        ExecutionContext *previous;
+        int previousThreads;
+
+        /**
+         * The context the calling thread's OpenMP team
+         * was last pinned for (0 for none) and its size then
+         */
+        struct TeamPinning {
+            Nd4jIndex context = 0;
+            int size = 0;
+        };
+
+        ExecutionScope(const ExecutionScope &other);
+        ExecutionScope &operator=(const ExecutionScope &other);
+
+        static TeamPinning &teamPinning() {
+            static thread_local TeamPinning pinning;
+            return pinning;
+        }
+
+        /**
+         * Lets the calling thread's team run anywhere again,
+         * if an earlier scope left it pinned
+         */
+        static void releaseTeam() {
+            TeamPinning &pinning = teamPinning();
+            if (pinning.context == 0)
+                return;
+#pragma omp parallel num_threads(pinning.size)
+            {
+                ExecutionContext::unpin();
+            }
+            pinning.context = 0;
+            pinning.size = 0;
+        }
+
+        /**
+         * Pins the calling thread's team to the cores of context,
+         * or releases it when context has none, opening a parallel
+         * region only if the team is not placed that way yet
+         */
+        static void placeTeam(ExecutionContext *context, int teamSize) {
+            if (context->numCores() == 0) {
+                releaseTeam();
+                return;
+            }
+
+            TeamPinning &pinning = teamPinning();
+            if (pinning.context == context->getId() && pinning.size >= teamSize) {
+                //the team kept its cores; only the caller may have been unpinned
+                context->pin(0);
+                return;
+            }
+#pragma omp parallel num_threads(teamSize)
+            {
+                context->pin(omp_get_thread_num());
+            }
+            pinning.context = context->getId();
+            pinning.size = teamSize;
+        }
+
+        void enter(ExecutionContext *context) {
+            previous = ExecutionContext::current();
+            if (context == nullptr || context == previous) {
+                this->context = nullptr;
+                if (previous == nullptr)
+                    releaseTeam();
+                return;
+            }
+
+            this->context = context;
+            ExecutionContext::current() = context;
+            previousThreads = omp_get_max_threads();
+            if (context->getThreads() > 0)
+                omp_set_num_threads(context->getThreads());
+            placeTeam(context, omp_get_max_threads());
+        }
+    };
+
+    /**
+     * Runs a thread that is not the caller's (a pool worker
+     * helping a loop) in a context: current and pinned, with
+     * OpenMP left alone, until the scope closes
+     */
+    class AffinityScope {
+    public:
+        AffinityScope(ExecutionContext *context, int index) {
+            previous = ExecutionContext::current();
+            this->context = context == previous ? nullptr : context;
+            pinned = false;
+            if (this->context == nullptr)
+                return;
+            ExecutionContext::current() = context;
+            pinned = context->pin(index);
+        }
+
+        ~AffinityScope() {
+            if (context == nullptr)
+                return;
+            if (pinned && (previous == nullptr || !previous->pin(0)))
+                ExecutionContext::unpin();
+            ExecutionContext::current() = previous;
+        }
+
+    private:
+        ExecutionContext *context;
+        ExecutionContext *previous;
+        bool pinned;
+
+        AffinityScope(const AffinityScope &other);
+        AffinityScope &operator=(const AffinityScope &other);
+    };
+}
+
+#endif /* EXECUTIONCONTEXT_H_ */
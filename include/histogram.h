@@ -0,0 +1,648 @@
+/*
+ * histogram.h
+ *
+ * Fixed bin histograms and mergeable quantile sketches (t-digest)
+ * computed natively, either over a whole array or per tensor along
+ * the given dimensions.
+ */
+
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+#include <dll.h>
+#include <omp.h>
+#include <algorithm>
+#include <shape.h>
+#include <templatemath.h>
+#include <pairwise_util.h>
+#include <tadcache.h>
+#include <pointercast.h>
+
+namespace functions {
+    namespace histogram {
+
+        /**
+         * Calls visitor(value) for every element of the given
+         * (possibly strided) buffer. Elements are visited in
+         * memory order, not in logical order.
+         * @param x the buffer
+         * @param shapeInfo the shape information for the buffer
+         * @param visitor the callable to apply to each element
+         */
+        template<typename T, typename Visitor>
+        inline void visitElements(T *x, int *shapeInfo, Visitor &visitor) {
+            Nd4jIndex length = shape::length(shapeInfo);
+            int elementWiseStride = shape::elementWiseStride(shapeInfo);
+            if (elementWiseStride >= 1) {
+                for (Nd4jIndex i = 0; i < length; i++) {
+                    visitor(x[i * elementWiseStride]);
+                }
+            }
+            else {
+                int shapeIter[MAX_RANK];
+                int xStridesIter[MAX_RANK];
+                int rank = shape::rank(shapeInfo);
+                if (PrepareOneRawArrayIter<T>(rank,
+                                              shape::shapeOf(shapeInfo),
+                                              x,
+                                              shape::stride(shapeInfo),
+                                              &rank,
+                                              shapeIter,
+                                              &x,
+                                              xStridesIter) >= 0) {
+                    rank = CoalesceRawArrayIter(rank, shapeIter, xStridesIter);
+                    auto kernel = [&](T *x) {
+                        visitor(x[0]);
+                    };
+                    RawIterOne(rank, shapeIter, x, xStridesIter, kernel);
+                }
+                else {
+                    printf("Unable to prepare array\n");
+                }
+            }
+        }
+
+        /**
+         * Running min/max, used for
+         * the fused auto range pre pass
+         */
+        template<typename T>
+        class RangeVisitor {
+        public:
+            T min;
+            T max;
+            bool empty = true;
+
+            inline void operator()(T value) {
+                //skip nans
+                if (value != value)
+                    return;
+                if (empty) {
+                    min = value;
+                    max = value;
+                    empty = false;
+                }
+                else {
+                    min = nd4j::math::nd4j_min<T>(min, value);
+                    max = nd4j::math::nd4j_max<T>(max, value);
+                }
+            }
+        };
+
+        /**
+         * Counts values in to numBins equal width
+         * bins over [min, max]. Values outside of
+         * the range (and nans) are ignored, max
+         * itself lands in the last bin.
+         */
+        template<typename T>
+        class BinVisitor {
+        public:
+            Nd4jIndex *bins;
+            int numBins;
+            T min;
+            T max;
+            T scale;
+
+            BinVisitor(Nd4jIndex *bins, int numBins, T min, T max) : bins(bins), numBins(numBins), min(min), max(max) {
+                scale = (T) numBins / (max - min);
+            }
+
+            inline void operator()(T value) {
+                if (!(value >= min && value <= max))
+                    return;
+                int idx = (int) ((value - min) * scale);
+                if (idx >= numBins)
+                    idx = numBins - 1;
+                bins[idx]++;
+            }
+        };
+
+        /**
+         * Fixed bin histogram
+         */
+        template<typename T>
+        class Histogram {
+        public:
+
+            /**
+             * Compute min and max of a buffer in one pass
+             * @param x the input
+             * @param xShapeInfo the shape information for the input
+             * @param min the minimum (output)
+             * @param max the maximum (output)
+             */
+            void range(T *x, int *xShapeInfo, T *min, T *max) {
+                Nd4jIndex length = shape::length(xShapeInfo);
+                int elementWiseStride = shape::elementWiseStride(xShapeInfo);
+                RangeVisitor<T> total;
+                if (elementWiseStride >= 1 && length >= 8000) {
+                    int threads = omp_get_max_threads();
+                    RangeVisitor<T> *locals = new RangeVisitor<T>[threads];
+#pragma omp parallel num_threads(threads)
+                    {
+                        RangeVisitor<T> &local = locals[omp_get_thread_num()];
+#pragma omp for schedule(static)
+                        for (Nd4jIndex i = 0; i < length; i++) {
+                            local(x[i * elementWiseStride]);
+                        }
+                    }
+
+                    for (int i = 0; i < threads; i++) {
+                        if (!locals[i].empty) {
+                            total(locals[i].min);
+                            total(locals[i].max);
+                        }
+                    }
+
+                    delete[] locals;
+                }
+                else {
+                    visitElements(x, xShapeInfo, total);
+                }
+
+                if (total.empty) {
+                    *min = 0.0;
+                    *max = 0.0;
+                }
+                else {
+                    *min = total.min;
+                    *max = total.max;
+                }
+            }
+
+            /**
+             * Histogram over the whole array
+             * @param x the input
+             * @param xShapeInfo the shape information for the input
+             * @param result the buffer to store the numBins counts in
+             * @param numBins the number of bins
+             * @param min the lower edge of the first bin
+             * @param max the upper edge of the last bin,
+             * pass min >= max to compute the range from the data
+             */
+            void exec(T *x, int *xShapeInfo, T *result, int numBins, T min, T max) {
+                if (numBins < 1)
+                    return;
+
+                if (min >= max)
+                    this->range(x, xShapeInfo, &min, &max);
+                this->adjustEmptyRange(&min, &max);
+
+                Nd4jIndex length = shape::length(xShapeInfo);
+                int elementWiseStride = shape::elementWiseStride(xShapeInfo);
+                Nd4jIndex *bins = new Nd4jIndex[numBins];
+                std::memset(bins, 0, sizeof(Nd4jIndex) * numBins);
+
+                if (elementWiseStride >= 1 && length >= 8000) {
+                    //per thread local bins, merged at the end
+                    int threads = omp_get_max_threads();
+                    Nd4jIndex *localBins = new Nd4jIndex[threads * numBins];
+                    std::memset(localBins, 0, sizeof(Nd4jIndex) * threads * numBins);
+#pragma omp parallel num_threads(threads)
+                    {
+                        BinVisitor<T> local(localBins + omp_get_thread_num() * numBins, numBins, min, max);
+#pragma omp for schedule(static)
+                        for (Nd4jIndex i = 0; i < length; i++) {
+                            local(x[i * elementWiseStride]);
+                        }
+                    }
+
+                    for (int t = 0; t < threads; t++) {
+                        for (int b = 0; b < numBins; b++) {
+                            bins[b] += localBins[t * numBins + b];
+                        }
+                    }
+
+                    delete[] localBins;
+                }
+                else {
+                    BinVisitor<T> visitor(bins, numBins, min, max);
+                    visitElements(x, xShapeInfo, visitor);
+                }
+
+                for (int b = 0; b < numBins; b++) {
+                    result[b] = (T) bins[b];
+                }
+
+                delete[] bins;
+            }
+
+            /**
+             * Histogram of each tensor along the given dimensions
+             * @param x the input
+             * @param xShapeInfo the shape information for the input
+             * @param result the result buffer, one row of numBins
+             * counts per tensor along dimension (c ordered)
+             * @param resultShapeInfo the shape information for the result
+             * @param numBins the number of bins
+             * @param min the lower edge of the first bin
+             * @param max the upper edge of the last bin,
+             * pass min >= max to compute the range of each tensor
+             * @param dimension the dimensions to compute the histogram along
+             * @param dimensionLength the length of the dimension buffer
+             */
+            void exec(T *x,
+                      int *xShapeInfo,
+                      T *result,
+                      int *resultShapeInfo,
+                      int numBins,
+                      T min,
+                      T max,
+                      int *dimension,
+                      int dimensionLength) {
+                if (dimension == nullptr || dimensionLength < 1 || dimensionLength >= shape::rank(xShapeInfo)) {
+                    exec(x, xShapeInfo, result, numBins, min, max);
+                    return;
+                }
+
+                std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(xShapeInfo, dimension, dimensionLength);
+                shape::TAD &tad = *tadPack->tad;
+                if (tad.wholeThing || tad.numTads == 1) {
+                    exec(x, xShapeInfo, result, numBins, min, max);
+                    return;
+                }
+
+                int tads = tad.numTads;
+                bool autoRange = min >= max;
+#pragma omp parallel for schedule(guided)
+                for (int i = 0; i < tads; i++) {
+                    T *tadX = x + tad.tadOffsets[i];
+                    T tadMin = min;
+                    T tadMax = max;
+                    if (autoRange) {
+                        RangeVisitor<T> rangeVisitor;
+                        visitElements(tadX, tad.tadOnlyShapeInfo, rangeVisitor);
+                        tadMin = rangeVisitor.empty ? 0.0 : rangeVisitor.min;
+                        tadMax = rangeVisitor.empty ? 0.0 : rangeVisitor.max;
+                    }
+                    this->adjustEmptyRange(&tadMin, &tadMax);
+
+                    Nd4jIndex *bins = new Nd4jIndex[numBins];
+                    std::memset(bins, 0, sizeof(Nd4jIndex) * numBins);
+                    BinVisitor<T> visitor(bins, numBins, tadMin, tadMax);
+                    visitElements(tadX, tad.tadOnlyShapeInfo, visitor);
+
+                    T *tadResult = result + i * numBins;
+                    for (int b = 0; b < numBins; b++) {
+                        tadResult[b] = (T) bins[b];
+                    }
+
+                    delete[] bins;
+                }
+            }
+
+        private:
+            //a range of width zero puts everything in the middle bin, same as numpy
+            inline void adjustEmptyRange(T *min, T *max) {
+                if (*min == *max) {
+                    *min -= 0.5;
+                    *max += 0.5;
+                }
+            }
+        };
+
+
+        /**
+         * Mergeable quantile sketch:
+         * the merging variant of Dunning's t-digest
+         * with the k1 (arcsine) scale function.
+         *
+         * Values are appended to an unmerged buffer
+         * which is folded in to the sorted centroids
+         * whenever it fills up. Two digests built over
+         * disjoint parts of the data merge in to one
+         * describing the union.
+         */
+        template<typename T>
+        class TDigest {
+        private:
+            struct Centroid {
+                T mean;
+                T weight;
+            };
+
+            T compression;
+            int centroidCapacity;
+            int bufferCapacity;
+            Centroid *centroids;
+            int numCentroids = 0;
+            //unmerged points followed by scratch space for compress()
+            Centroid *buffer;
+            int bufferSize = 0;
+            T totalWeight = 0;
+            T min = 0;
+            T max = 0;
+
+            static bool compareCentroids(const Centroid &a, const Centroid &b) {
+                return a.mean < b.mean;
+            }
+
+            //the k1 scale function and its inverse
+            inline T k(T q) {
+                return compression / (2 * M_PI) * nd4j::math::nd4j_asin<T>(2 * q - 1);
+            }
+
+            inline T kInverse(T kValue) {
+                return (nd4j::math::nd4j_sin<T>(kValue * 2 * M_PI / compression) + 1) / 2;
+            }
+
+            //the most weight the centroids up to the next one may hold, given
+            //the weight before it; k is capped at k(1), past which the sin
+            //in kInverse would wrap around and shrink the limit again
+            inline T weightLimit(T weightSoFar, T total) {
+                T q = nd4j::math::nd4j_min<T>(weightSoFar / total, 1);
+                return total * kInverse(nd4j::math::nd4j_min<T>(k(q) + 1, k(1)));
+            }
+
+            inline void append(T mean, T weight) {
+                if (bufferSize == bufferCapacity)
+                    compress();
+                buffer[bufferSize].mean = mean;
+                buffer[bufferSize].weight = weight;
+                bufferSize++;
+            }
+
+        public:
+            /**
+             * @param compression the accuracy/size trade off,
+             * the number of centroids is bounded by about compression / 2
+             */
+            TDigest(T compression = 100) {
+                this->compression = compression < 20 ? 20 : compression;
+                centroidCapacity = 2 * (int) nd4j::math::nd4j_ceil<T>(this->compression) + 10;
+                bufferCapacity = 5 * (int) nd4j::math::nd4j_ceil<T>(this->compression);
+                centroids = new Centroid[centroidCapacity];
+                buffer = new Centroid[bufferCapacity + centroidCapacity];
+            }
+
+            ~TDigest() {
+                delete[] centroids;
+                delete[] buffer;
+            }
+
+            /**
+             * Add a single value, nans are ignored
+             */
+            inline void add(T value) {
+                if (value != value)
+                    return;
+                if (totalWeight == 0 && bufferSize == 0) {
+                    min = value;
+                    max = value;
+                }
+                else {
+                    min = nd4j::math::nd4j_min<T>(min, value);
+                    max = nd4j::math::nd4j_max<T>(max, value);
+                }
+                append(value, 1);
+            }
+
+            inline void operator()(T value) {
+                add(value);
+            }
+
+            /**
+             * Fold another digest in to this one
+             * @param other the digest to merge, left unchanged
+             */
+            void merge(TDigest<T> &other) {
+                if (other.count() == 0)
+                    return;
+                if (count() == 0) {
+                    min = other.min;
+                    max = other.max;
+                }
+                else {
+                    min = nd4j::math::nd4j_min<T>(min, other.min);
+                    max = nd4j::math::nd4j_max<T>(max, other.max);
+                }
+
+                for (int i = 0; i < other.numCentroids; i++)
+                    append(other.centroids[i].mean, other.centroids[i].weight);
+                for (int i = 0; i < other.bufferSize; i++)
+                    append(other.buffer[i].mean, other.buffer[i].weight);
+            }
+
+            /**
+             * Merge the unmerged buffer in to the centroids
+             */
+            void compress() {
+                if (bufferSize == 0)
+                    return;
+
+                int n = bufferSize + numCentroids;
+                for (int i = 0; i < numCentroids; i++)
+                    buffer[bufferSize + i] = centroids[i];
+                std::sort(buffer, buffer + n, compareCentroids);
+
+                T total = 0;
+                for (int i = 0; i < n; i++)
+                    total += buffer[i].weight;
+
+                numCentroids = 0;
+                Centroid current = buffer[0];
+                T weightSoFar = 0;
+                T limit = weightLimit(0, total);
+                for (int i = 1; i < n; i++) {
+                    Centroid next = buffer[i];
+                    //the last free slot takes whatever is left
+                    if (weightSoFar + current.weight + next.weight <= limit ||
+                        numCentroids == centroidCapacity - 1) {
+                        T weight = current.weight + next.weight;
+                        current.mean += (next.mean - current.mean) * next.weight / weight;
+                        current.weight = weight;
+                    }
+                    else {
+                        weightSoFar += current.weight;
+                        centroids[numCentroids++] = current;
+                        limit = weightLimit(weightSoFar, total);
+                        current = next;
+                    }
+                }
+
+                centroids[numCentroids++] = current;
+                totalWeight = total;
+                bufferSize = 0;
+            }
+
+            /**
+             * The number of centroids as of the last compress(),
+             * never more than 2 * ceil(compression) + 10
+             */
+            inline int size() {
+                return numCentroids;
+            }
+
+            /**
+             * The number of values added so far
+             */
+            inline T count() {
+                T ret = totalWeight;
+                for (int i = 0; i < bufferSize; i++)
+                    ret += buffer[i].weight;
+                return ret;
+            }
+
+            /**
+             * Estimate the value at the given quantile
+             * @param q the quantile in [0, 1]
+             * @return the estimate, nan if nothing was added
+             */
+            T quantile(T q) {
+                compress();
+                if (numCentroids == 0)
+                    return (T) NAN;
+                if (numCentroids == 1 || q <= 0)
+                    return q <= 0 ? min : centroids[0].mean;
+                if (q >= 1)
+                    return max;
+
+                T index = q * totalWeight;
+                //left tail: interpolate between min and the first centroid
+                T firstHalf = centroids[0].weight / 2;
+                if (index < firstHalf)
+                    return min + (centroids[0].mean - min) * index / firstHalf;
+
+                T weightSoFar = firstHalf;
+                for (int i = 0; i < numCentroids - 1; i++) {
+                    T delta = (centroids[i].weight + centroids[i + 1].weight) / 2;
+                    if (weightSoFar + delta > index) {
+                        T fraction = (index - weightSoFar) / delta;
+                        return centroids[i].mean + fraction * (centroids[i + 1].mean - centroids[i].mean);
+                    }
+
+                    weightSoFar += delta;
+                }
+
+                //right tail: interpolate between the last centroid and max
+                T lastHalf = centroids[numCentroids - 1].weight / 2;
+                T fraction = (index - weightSoFar) / lastHalf;
+                if (fraction > 1)
+                    fraction = 1;
+                return centroids[numCentroids - 1].mean + fraction * (max - centroids[numCentroids - 1].mean);
+            }
+        };
+
+
+        /**
+         * Approximate quantiles computed with a t-digest
+         */
+        template<typename T>
+        class Quantiles {
+        public:
+
+            /**
+             * Build a digest over the whole array:
+             * each thread sketches a contiguous chunk and the
+             * per thread digests are merged at the end.
+             * @param x the input
+             * @param xShapeInfo the shape information for the input
+             * @param digest the digest to add the values to
+             */
+            void sketch(T *x, int *xShapeInfo, TDigest<T> &digest, T compression) {
+                Nd4jIndex length = shape::length(xShapeInfo);
+                int elementWiseStride = shape::elementWiseStride(xShapeInfo);
+                if (elementWiseStride >= 1 && length >= 8000) {
+                    int threads = omp_get_max_threads();
+                    //the team may be smaller than asked for, leaving slots null
+                    TDigest<T> **locals = new TDigest<T> *[threads]();
+#pragma omp parallel num_threads(threads)
+                    {
+                        TDigest<T> *local = new TDigest<T>(compression);
+                        locals[omp_get_thread_num()] = local;
+#pragma omp for schedule(static)
+                        for (Nd4jIndex i = 0; i < length; i++) {
+                            local->add(x[i * elementWiseStride]);
+                        }
+                    }
+
+                    for (int i = 0; i < threads; i++) {
+                        if (locals[i] == nullptr)
+                            continue;
+                        digest.merge(*locals[i]);
+                        delete locals[i];
+                    }
+
+                    delete[] locals;
+                }
+                else {
+                    visitElements(x, xShapeInfo, digest);
+                }
+            }
+
+            /**
+             * Quantiles over the whole array
+             * @param x the input
+             * @param xShapeInfo the shape information for the input
+             * @param probabilities the quantiles to estimate, each in [0, 1]
+             * @param numQuantiles the number of quantiles
+             * @param compression the t-digest compression (accuracy)
+             * @param result the buffer to store the numQuantiles estimates in
+             */
+            void exec(T *x, int *xShapeInfo, T *probabilities, int numQuantiles, T compression, T *result) {
+                TDigest<T> digest(compression);
+                sketch(x, xShapeInfo, digest, compression);
+                for (int i = 0; i < numQuantiles; i++) {
+                    result[i] = digest.quantile(probabilities[i]);
+                }
+            }
+
+            /**
+             * Quantiles of each tensor along the given dimensions
+             * @param x the input
+             * @param xShapeInfo the shape information for the input
+             * @param probabilities the quantiles to estimate, each in [0, 1]
+             * @param numQuantiles the number of quantiles
+             * @param compression the t-digest compression (accuracy)
+             * @param result the result buffer, one row of numQuantiles
+             * estimates per tensor along dimension (c ordered)
+             * @param resultShapeInfo the shape information for the result
+             * @param dimension the dimensions to compute the quantiles along
+             * @param dimensionLength the length of the dimension buffer
+             */
+            void exec(T *x,
+                      int *xShapeInfo,
+                      T *probabilities,
+                      int numQuantiles,
+                      T compression,
+                      T *result,
+                      int *resultShapeInfo,
+                      int *dimension,
+                      int dimensionLength) {
+                if (dimension == nullptr || dimensionLength < 1 || dimensionLength >= shape::rank(xShapeInfo)) {
+                    exec(x, xShapeInfo, probabilities, numQuantiles, compression, result);
+                    return;
+                }
+
+                std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(xShapeInfo, dimension, dimensionLength);
+                shape::TAD &tad = *tadPack->tad;
+                if (tad.wholeThing || tad.numTads == 1) {
+                    exec(x, xShapeInfo, probabilities, numQuantiles, compression, result);
+                    return;
+                }
+
+                int tads = tad.numTads;
+                if (tads < omp_get_max_threads()) {
+                    //few long tensors: split every tensor across the threads instead
+                    for (int i = 0; i < tads; i++) {
+                        exec(x + tad.tadOffsets[i], tad.tadOnlyShapeInfo, probabilities, numQuantiles, compression, result + i * numQuantiles);
+                    }
+
+                    return;
+                }
+
+#pragma omp parallel for schedule(guided)
+                for (int i = 0; i < tads; i++) {
+                    TDigest<T> digest(compression);
+                    visitElements(x + tad.tadOffsets[i], tad.tadOnlyShapeInfo, digest);
+                    T *tadResult = result + i * numQuantiles;
+                    for (int q = 0; q < numQuantiles; q++) {
+                        tadResult[q] = digest.quantile(probabilities[q]);
+                    }
+                }
+            }
+        };
+    }
+}
+
+#endif /* HISTOGRAM_H_ */
@@ -0,0 +1,161 @@
+/*
+ * hostcopy.h
+ *
+ * memcpy and memset for large host buffers.
+ *
+ * Buffers past PARALLEL_THRESHOLD bytes are cut in to cache line
+ * aligned ranges, one per OpenMP thread, since one core cannot
+ * saturate memory bandwidth on its own. Past NON_TEMPORAL_THRESHOLD
+ * the destination is written with streaming stores (on x86 with SSE2),
+ * which bypass the cache: a buffer that size would only evict
+ * everything else on its way through, and is not read back soon.
+ */
+
+#ifndef HOSTCOPY_H_
+#define HOSTCOPY_H_
+#include <pointercast.h>
+#include <omp.h>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace nd4j {
+
+    static const Nd4jIndex PARALLEL_THRESHOLD = 1024L * 1024L;
+    static const Nd4jIndex NON_TEMPORAL_THRESHOLD = 8L * 1024L * 1024L;
+
+    /**
+     * Copies bytes bytes with streaming stores where it can.
+     * The parts before the first and after the last 16 byte
+     * boundary of the destination are copied normally.
+     */
+    inline void streamingMemcpy(char *dst, const char *src, Nd4jIndex bytes) {
+#if defined(__SSE2__)
+        Nd4jIndex head = (16 - (Nd4jIndex) (reinterpret_cast<size_t>(dst) & 15)) & 15;
+        if (head > bytes)
+            head = bytes;
+        std::memcpy(dst, src, (size_t) head);
+
+        Nd4jIndex blocks = (bytes - head) / 64;
+        __m128i *out = reinterpret_cast<__m128i *>(dst + head);
+        const __m128i *in = reinterpret_cast<const __m128i *>(src + head);
+        for (Nd4jIndex i = 0; i < blocks; i++) {
+            __m128i a = _mm_loadu_si128(in);
+            __m128i b = _mm_loadu_si128(in + 1);
+            __m128i c = _mm_loadu_si128(in + 2);
+            __m128i d = _mm_loadu_si128(in + 3);
+            _mm_stream_si128(out, a);
+            _mm_stream_si128(out + 1, b);
+            _mm_stream_si128(out + 2, c);
+            _mm_stream_si128(out + 3, d);
+            in += 4;
+            out += 4;
+        }
+
+        Nd4jIndex done = head + blocks * 64;
+        std::memcpy(dst + done, src + done, (size_t) (bytes - done));
+        //streaming stores are weakly ordered
+        _mm_sfence();
+#else
+        std::memcpy(dst, src, (size_t) bytes);
+#endif
+    }
+
+    /**
+     * Sets bytes bytes to value with streaming stores where it can
+     */
+    inline void streamingMemset(char *dst, int value, Nd4jIndex bytes) {
+#if defined(__SSE2__)
+        Nd4jIndex head = (16 - (Nd4jIndex) (reinterpret_cast<size_t>(dst) & 15)) & 15;
+        if (head > bytes)
+            head = bytes;
+        std::memset(dst, value, (size_t) head);
+
+        Nd4jIndex blocks = (bytes - head) / 64;
+        __m128i fill = _mm_set1_epi8((char) value);
+        __m128i *out = reinterpret_cast<__m128i *>(dst + head);
+        for (Nd4jIndex i = 0; i < blocks; i++) {
+            _mm_stream_si128(out, fill);
+            _mm_stream_si128(out + 1, fill);
+            _mm_stream_si128(out + 2, fill);
+            _mm_stream_si128(out + 3, fill);
+            out += 4;
+        }
+
+        Nd4jIndex done = head + blocks * 64;
+        std::memset(dst + done, value, (size_t) (bytes - done));
+        _mm_sfence();
+#else
+        std::memset(dst, value, (size_t) bytes);
+#endif
+    }
+
+    /**
+     * The part of [0, bytes) thread part of parts handles:
+     * nearly equal ranges, cut on 64 byte boundaries of dst
+     */
+    inline void copyRange(char *dst, Nd4jIndex bytes, int part, int parts, Nd4jIndex *start, Nd4jIndex *end) {
+        Nd4jIndex misalignment = (Nd4jIndex) (reinterpret_cast<size_t>(dst) & 63);
+        Nd4jIndex lines = (bytes + misalignment + 63) / 64;
+        Nd4jIndex span = lines / parts;
+        Nd4jIndex extra = lines % parts;
+        Nd4jIndex first = part * span + (part < extra ? part : extra);
+        Nd4jIndex last = first + span + (part < extra ? 1 : 0);
+        *start = first * 64 - misalignment;
+        *end = last * 64 - misalignment;
+        if (*start < 0)
+            *start = 0;
+        if (*end > bytes)
+            *end = bytes;
+        if (*end < *start)
+            *end = *start;
+    }
+
+    /**
+     * memcpy for host buffers of any size
+     */
+    inline void hostMemcpy(void *dst, const void *src, Nd4jIndex bytes) {
+        if (bytes < PARALLEL_THRESHOLD) {
+            std::memcpy(dst, src, (size_t) bytes);
+            return;
+        }
+
+        char *out = reinterpret_cast<char *>(dst);
+        const char *in = reinterpret_cast<const char *>(src);
+        bool streaming = bytes >= NON_TEMPORAL_THRESHOLD;
+#pragma omp parallel
+        {
+            Nd4jIndex start, end;
+            copyRange(out, bytes, omp_get_thread_num(), omp_get_num_threads(), &start, &end);
+            if (streaming)
+                streamingMemcpy(out + start, in + start, end - start);
+            else
+                std::memcpy(out + start, in + start, (size_t) (end - start));
+        }
+    }
+
+    /**
+     * memset for host buffers of any size
+     */
+    inline void hostMemset(void *dst, int value, Nd4jIndex bytes) {
+        if (bytes < PARALLEL_THRESHOLD) {
+            std::memset(dst, value, (size_t) bytes);
+            return;
+        }
+
+        char *out = reinterpret_cast<char *>(dst);
+        bool streaming = bytes >= NON_TEMPORAL_THRESHOLD;
+#pragma omp parallel
+        {
+            Nd4jIndex start, end;
+            copyRange(out, bytes, omp_get_thread_num(), omp_get_num_threads(), &start, &end);
+            if (streaming)
+                streamingMemset(out + start, value, end - start);
+            else
+                std::memset(out + start, value, (size_t) (end - start));
+        }
+    }
+}
+
+#endif /* HOSTCOPY_H_ */
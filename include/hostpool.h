@@ -0,0 +1,506 @@
+/*
+ * hostpool.h
+ *
+ * Size class pool for host buffers handed out by
+ * NativeOps::mallocHost / freeHost.
+ *
+ * Requests are rounded up to one of a set of size classes (four
+ * per power of two, so at most 25% is wasted) and freed blocks are
+ * kept for reuse instead of going back to malloc. Each thread keeps
+ * a small private cache of blocks per class, so the common
+ * allocate / free / allocate cycle of one thread takes no lock;
+ * behind those sits a shared cache with one lock per class.
+ *
+ * The shared cache holds at most maxCachedBytes; anything freed past
+ * that goes straight back to the OS, as do requests larger than the
+ * largest size class. Every block carries a 64 byte header recording
+ * its class, so freeHost needs nothing but the pointer, and every
+ * buffer starts on a 64 byte boundary.
+ *
+ * Buffers asked for with huge page flags are mapped on their own,
+ * aligned to the huge page size, and unmapped when freed. The header
+ * has to sit right before the buffer, so such a mapping is one huge
+ * page longer than the buffer needs: worth it for large, long lived
+ * buffers rather than small ones. So are
+ * buffers asked for with a NUMA flag, page aligned, since a pooled
+ * block has long since been placed by whoever touched it first.
+ */
+
+#ifndef HOSTPOOL_H_
+#define HOSTPOOL_H_
+#include <pointercast.h>
+#include <numaplacement.h>
+#include <omp.h>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace nd4j {
+
+    /**
+     * mallocHost flags, which may be or'ed together
+     */
+    enum HostAllocFlags {
+        //64 byte alignment; every buffer has it, the flag documents the need
+        HOST_ALLOC_ALIGNED = 1,
+        //advise the kernel to back the buffer with transparent huge pages
+        HOST_ALLOC_HUGE_PAGE_ADVICE = 2,
+        //map the buffer from the explicit huge page pool, falling back to advice
+        HOST_ALLOC_HUGE_PAGES = 4,
+        //touch every page before returning, so the first pass over the buffer takes no page faults
+        HOST_ALLOC_PREFAULT = 8,
+        //pages go to the node of the thread first touching them; with HOST_ALLOC_PREFAULT
+        //the touch follows the kernels' split of loops over threads
+        HOST_ALLOC_NUMA_LOCAL = 16,
+        //pages round robin over every node
+        HOST_ALLOC_NUMA_INTERLEAVE = 32,
+        //every page on the node given in the bits from HOST_ALLOC_NUMA_NODE_SHIFT up
+        HOST_ALLOC_NUMA_BIND = 64,
+        HOST_ALLOC_NUMA_NODE_SHIFT = 16
+    };
+
+    class HostMemoryPool {
+    public:
+        static const int NUM_CLASSES = 81;
+        static const Nd4jIndex MIN_CLASS_SIZE = 64;
+        static const Nd4jIndex MAX_CLASS_SIZE = 64L * 1024L * 1024L;
+        static const int ALIGNMENT = 64;
+        static const Nd4jIndex HUGE_PAGE_SIZE = 2L * 1024L * 1024L;
+
+        /**
+         * The process wide pool. It is never destroyed so
+         * buffers can still be freed from static destructors
+         * and exiting threads.
+         */
+        static HostMemoryPool *getInstance() {
+            static HostMemoryPool *instance = new HostMemoryPool();
+            return instance;
+        }
+
+        /**
+         * The size class a request of the given number
+         * of bytes is served from, -1 past the largest class
+         */
+        static inline int sizeClass(Nd4jIndex bytes) {
+            if (bytes <= MIN_CLASS_SIZE)
+                return 0;
+            if (bytes > MAX_CLASS_SIZE)
+                return -1;
+
+            //2^power < bytes <= 2^(power + 1)
+            int power = 6;
+            while (((Nd4jIndex) 1 << (power + 1)) < bytes)
+                power++;
+            Nd4jIndex step = (Nd4jIndex) 1 << (power - 2);
+            Nd4jIndex steps = (bytes - ((Nd4jIndex) 1 << power) + step - 1) / step;
+            return (power - 6) * 4 + (int) steps;
+        }
+
+        /**
+         * The usable number of bytes of a size class
+         */
+        static inline Nd4jIndex classSize(int sizeClass) {
+            if (sizeClass == 0)
+                return MIN_CLASS_SIZE;
+            int power = 6 + (sizeClass - 1) / 4;
+            int steps = (sizeClass - 1) % 4 + 1;
+            return ((Nd4jIndex) 1 << power) + steps * ((Nd4jIndex) 1 << (power - 2));
+        }
+
+        /**
+         * Allocate at least bytes bytes
+         * @param bytes the number of bytes
+         * @param flags HostAllocFlags or'ed together
+         * @return the buffer, or nullptr if the OS refused
+         */
+        void *allocate(Nd4jIndex bytes, int flags = 0) {
+#ifndef _WIN32
+            if (flags & (HOST_ALLOC_HUGE_PAGE_ADVICE | HOST_ALLOC_HUGE_PAGES | NUMA_FLAGS)) {
+                misses++;
+                void *buffer;
+                if (flags & (HOST_ALLOC_HUGE_PAGE_ADVICE | HOST_ALLOC_HUGE_PAGES))
+                    buffer = mapHuge(bytes, (flags & HOST_ALLOC_HUGE_PAGES) != 0);
+                else
+                    buffer = mapPages(bytes);
+                place(buffer, bytes, flags);
+                return prefault(buffer, bytes, flags);
+            }
+#endif
+
+            int sc = sizeClass(bytes);
+            if (sc < 0) {
+                misses++;
+                return prefault(wrap(systemAllocate(bytes), DIRECT, bytes), bytes, flags);
+            }
+
+            Nd4jIndex size = classSize(sc);
+            ThreadCache &local = threadCache();
+            BlockHeader *block = local.heads[sc];
+            if (block != nullptr) {
+                local.heads[sc] = block->next;
+                local.bytes -= size;
+            }
+            else {
+                std::lock_guard<std::mutex> lock(classLocks[sc]);
+                block = heads[sc];
+                if (block != nullptr)
+                    heads[sc] = block->next;
+            }
+
+            if (block != nullptr) {
+                hits++;
+                bytesCached -= size;
+                bytesInUse += size;
+                return block + 1;
+            }
+
+            misses++;
+            return prefault(wrap(systemAllocate(size), sc, size), size, flags);
+        }
+
+        /**
+         * The alignment, in bytes, of a buffer obtained from
+         * allocate: the huge page size for huge page buffers,
+         * the page size for NUMA placed ones, ALIGNMENT
+         * for everything else, and 0 for nullptr
+         */
+        static int alignmentOf(void *pointer) {
+            if (pointer == nullptr)
+                return 0;
+            return (reinterpret_cast<BlockHeader *>(pointer) - 1)->alignment;
+        }
+
+        /**
+         * Return a buffer obtained from allocate
+         */
+        void release(void *pointer) {
+            if (pointer == nullptr)
+                return;
+
+            BlockHeader *block = reinterpret_cast<BlockHeader *>(pointer) - 1;
+            int sc = block->sizeClass;
+            Nd4jIndex size = block->size;
+            bytesInUse -= size;
+            if (sc == DIRECT) {
+                systemFree(block);
+                return;
+            }
+#ifndef _WIN32
+            if (sc == MAPPED) {
+                munmap(block->base, (size_t) block->mappedBytes);
+                return;
+            }
+#endif
+
+            ThreadCache &local = threadCache();
+            //the limit was lowered since this thread last freed
+            if (local.bytes > maxThreadCachedBytes.load())
+                flush(local, true);
+            if (local.bytes + size <= maxThreadCachedBytes.load()) {
+                block->next = local.heads[sc];
+                local.heads[sc] = block;
+                local.bytes += size;
+                bytesCached += size;
+                return;
+            }
+
+            if (bytesCached.load() + size > maxCachedBytes.load()) {
+                systemFree(block);
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(classLocks[sc]);
+            block->next = heads[sc];
+            heads[sc] = block;
+            bytesCached += size;
+        }
+
+        /**
+         * Limit the cached (free but not returned) memory.
+         * Lowering the limits releases the shared cache
+         * and the calling thread's cache to the OS; another
+         * thread over the new limit hands its cache to the
+         * shared cache (or the OS) the next time it frees.
+         * @param maxCachedBytes the maximum number of bytes cached overall
+         * @param maxThreadCachedBytes the maximum number of bytes
+         * each thread keeps to itself
+         */
+        void setLimits(Nd4jIndex maxCachedBytes, Nd4jIndex maxThreadCachedBytes) {
+            this->maxCachedBytes = maxCachedBytes;
+            this->maxThreadCachedBytes = maxThreadCachedBytes;
+            purge();
+        }
+
+        /**
+         * Release every cached block of the shared cache
+         * and of the calling thread's cache to the OS
+         */
+        void purge() {
+            flush(threadCache(), false);
+            for (int sc = 0; sc < NUM_CLASSES; sc++) {
+                BlockHeader *block;
+                {
+                    std::lock_guard<std::mutex> lock(classLocks[sc]);
+                    block = heads[sc];
+                    heads[sc] = nullptr;
+                }
+
+                while (block != nullptr) {
+                    BlockHeader *next = block->next;
+                    bytesCached -= block->size;
+                    systemFree(block);
+                    block = next;
+                }
+            }
+        }
+
+        /**
+         * Reset the hit and miss counters
+         */
+        void resetCounters() {
+            hits = 0;
+            misses = 0;
+        }
+
+        Nd4jIndex getBytesInUse() {
+            return bytesInUse.load();
+        }
+
+        Nd4jIndex getBytesCached() {
+            return bytesCached.load();
+        }
+
+        Nd4jIndex getHits() {
+            return hits.load();
+        }
+
+        Nd4jIndex getMisses() {
+            return misses.load();
+        }
+
+    private:
+        //sizeClass of blocks that bypass the size classes
+        static const int DIRECT = -1;
+        static const int MAPPED = -2;
+        static const int NUMA_FLAGS = HOST_ALLOC_NUMA_LOCAL | HOST_ALLOC_NUMA_INTERLEAVE | HOST_ALLOC_NUMA_BIND;
+
+        //sits right before the buffer, so it is as long as the alignment
+        struct BlockHeader {
+            //the usable size, which is the class size for pooled blocks
+            Nd4jIndex size;
+            int sizeClass;
+            int alignment;
+            //only meaningful while the block sits in a cache
+            BlockHeader *next;
+            //the mapping of MAPPED blocks
+            void *base;
+            Nd4jIndex mappedBytes;
+            char padding[ALIGNMENT - 2 * sizeof(Nd4jIndex) - 2 * sizeof(int) - 2 * sizeof(void *)];
+        };
+
+        struct ThreadCache {
+            BlockHeader *heads[NUM_CLASSES];
+            Nd4jIndex bytes;
+
+            ThreadCache() {
+                for (int i = 0; i < NUM_CLASSES; i++)
+                    heads[i] = nullptr;
+                bytes = 0;
+            }
+
+            ~ThreadCache() {
+                //hand the blocks of an exiting thread to the shared cache
+                HostMemoryPool::getInstance()->flush(*this, true);
+            }
+        };
+
+        std::mutex classLocks[NUM_CLASSES];
+        BlockHeader *heads[NUM_CLASSES];
+        std::atomic<Nd4jIndex> maxCachedBytes;
+        std::atomic<Nd4jIndex> maxThreadCachedBytes;
+        std::atomic<Nd4jIndex> bytesInUse;
+        std::atomic<Nd4jIndex> bytesCached;
+        std::atomic<Nd4jIndex> hits;
+        std::atomic<Nd4jIndex> misses;
+
+        HostMemoryPool() {
+            for (int i = 0; i < NUM_CLASSES; i++)
+                heads[i] = nullptr;
+            maxCachedBytes = 1024L * 1024L * 1024L;
+            maxThreadCachedBytes = 16L * 1024L * 1024L;
+            bytesInUse = 0;
+            bytesCached = 0;
+            hits = 0;
+            misses = 0;
+        }
+        HostMemoryPool(const HostMemoryPool &other);
+        HostMemoryPool &operator=(const HostMemoryPool &other);
+
+        static ThreadCache &threadCache() {
+            static thread_local ThreadCache cache;
+            return cache;
+        }
+
+        //header plus bytes, aligned to ALIGNMENT
+        static void *systemAllocate(Nd4jIndex bytes) {
+            size_t total = sizeof(BlockHeader) + (size_t) bytes;
+#ifdef _WIN32
+            return _aligned_malloc(total, ALIGNMENT);
+#else
+            void *memory = nullptr;
+            if (posix_memalign(&memory, ALIGNMENT, total) != 0)
+                return nullptr;
+            return memory;
+#endif
+        }
+
+        static void systemFree(void *memory) {
+#ifdef _WIN32
+            _aligned_free(memory);
+#else
+            std::free(memory);
+#endif
+        }
+
+        void *wrap(void *memory, int sc, Nd4jIndex size) {
+            if (memory == nullptr)
+                return nullptr;
+            BlockHeader *block = reinterpret_cast<BlockHeader *>(memory);
+            block->size = size;
+            block->sizeClass = sc;
+            block->alignment = ALIGNMENT;
+            block->next = nullptr;
+            bytesInUse += size;
+            return block + 1;
+        }
+
+#ifndef _WIN32
+        /**
+         * Maps a buffer starting on a huge page boundary,
+         * with the header in the slack before it. Explicit
+         * huge pages are tried first when asked for; otherwise,
+         * or when the huge page pool is empty, the mapping
+         * is ordinary memory with transparent huge page advice.
+         * An explicit mapping starts on a huge page boundary, so
+         * the 64 byte header takes a whole huge page of its own.
+         */
+        void *mapHuge(Nd4jIndex bytes, bool explicitPages) {
+            size_t length = (size_t) ((bytes + 2 * HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+            void *base = MAP_FAILED;
+#ifdef MAP_HUGETLB
+            //explicit huge page mappings start on a huge page boundary
+            if (explicitPages)
+                base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+            if (base == MAP_FAILED) {
+                //one more huge page of slack to align within
+                length += HUGE_PAGE_SIZE;
+                base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (base == MAP_FAILED)
+                    return nullptr;
+            }
+
+            size_t address = reinterpret_cast<size_t>(base) + sizeof(BlockHeader);
+            address = (address + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+            char *buffer = reinterpret_cast<char *>(address);
+#ifdef MADV_HUGEPAGE
+            madvise(buffer, (size_t) ((bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE), MADV_HUGEPAGE);
+#endif
+
+            BlockHeader *block = reinterpret_cast<BlockHeader *>(buffer) - 1;
+            block->size = bytes;
+            block->sizeClass = MAPPED;
+            block->alignment = (int) HUGE_PAGE_SIZE;
+            block->next = nullptr;
+            block->base = base;
+            block->mappedBytes = (Nd4jIndex) length;
+            bytesInUse += bytes;
+            return buffer;
+        }
+
+        /**
+         * Maps a buffer starting on a page boundary,
+         * with the header in the page before it
+         */
+        void *mapPages(Nd4jIndex bytes) {
+            size_t page = (size_t) sysconf(_SC_PAGESIZE);
+            size_t length = ((size_t) bytes + page - 1) / page * page + page;
+            void *base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (base == MAP_FAILED)
+                return nullptr;
+
+            char *buffer = reinterpret_cast<char *>(base) + page;
+            BlockHeader *block = reinterpret_cast<BlockHeader *>(buffer) - 1;
+            block->size = bytes;
+            block->sizeClass = MAPPED;
+            block->alignment = (int) page;
+            block->next = nullptr;
+            block->base = base;
+            block->mappedBytes = (Nd4jIndex) length;
+            bytesInUse += bytes;
+            return buffer;
+        }
+#endif
+
+        //applies the NUMA policy the flags ask for to fresh, untouched memory
+        static void place(void *buffer, Nd4jIndex bytes, int flags) {
+            if (flags & HOST_ALLOC_NUMA_BIND)
+                placeMemory(buffer, bytes, NUMA_BIND, flags >> HOST_ALLOC_NUMA_NODE_SHIFT);
+            else if (flags & HOST_ALLOC_NUMA_INTERLEAVE)
+                placeMemory(buffer, bytes, NUMA_INTERLEAVE, 0);
+            else if (flags & HOST_ALLOC_NUMA_LOCAL)
+                placeMemory(buffer, bytes, NUMA_LOCAL, 0);
+        }
+
+        //writes a byte to every page of fresh memory, spread over threads for large buffers
+        static void *prefault(void *buffer, Nd4jIndex bytes, int flags) {
+            if (buffer == nullptr || !(flags & HOST_ALLOC_PREFAULT))
+                return buffer;
+            if (flags & NUMA_FLAGS) {
+                //the touch decides placement, so it has to follow the kernels' split even for small buffers
+                firstTouch(buffer, bytes);
+                return buffer;
+            }
+
+            char *bytePointer = reinterpret_cast<char *>(buffer);
+            const Nd4jIndex page = 4096;
+            Nd4jIndex pages = (bytes + page - 1) / page;
+#pragma omp parallel for schedule(static) if (pages >= 8000)
+            for (Nd4jIndex i = 0; i < pages; i++)
+                bytePointer[i * page] = 0;
+            return buffer;
+        }
+
+        //empties a thread cache in to the shared cache (keep) or the OS
+        void flush(ThreadCache &cache, bool keep) {
+            for (int sc = 0; sc < NUM_CLASSES; sc++) {
+                BlockHeader *block = cache.heads[sc];
+                cache.heads[sc] = nullptr;
+                while (block != nullptr) {
+                    BlockHeader *next = block->next;
+                    if (keep && bytesCached.load() <= maxCachedBytes.load()) {
+                        std::lock_guard<std::mutex> lock(classLocks[sc]);
+                        block->next = heads[sc];
+                        heads[sc] = block;
+                    }
+                    else {
+                        bytesCached -= block->size;
+                        systemFree(block);
+                    }
+
+                    block = next;
+                }
+            }
+
+            cache.bytes = 0;
+        }
+    };
+}
+
+#endif /* HOSTPOOL_H_ */
@@ -24,6 +24,7 @@
 #include <jni.h>
 #endif
 #include <pairwise_util.h>
+#include <tadcache.h>
 
 namespace functions {
 	namespace indexreduce {
@@ -470,7 +471,7 @@ struct SharedIndexValue<double> {
 				IndexValue<T> startingIndex;
 				startingIndex.value = startingVal;
 				startingIndex.index = 0;
-				int length = shape::length(xShapeInfo);
+				Nd4jIndex length = shape::length(xShapeInfo);
 				int xElementWiseStride = shape::elementWiseStride(xShapeInfo);
 				if(xElementWiseStride < 1) {
 					int shapeIter[MAX_RANK];
@@ -516,7 +517,7 @@ struct SharedIndexValue<double> {
 					if (xElementWiseStride == 1) {
 						if(length < 8000) {
 #pragma omp simd
-							for (int i = 0; i < length; i++) {
+							for (Nd4jIndex i = 0; i < length; i++) {
 								IndexValue<T> curr;
 								curr.value = x[i];
 								curr.index = i;
@@ -576,7 +577,7 @@ struct SharedIndexValue<double> {
 
 					else {
 #pragma omp parallel for
-						for (int i = 0; i < length; i++) {
+						for (Nd4jIndex i = 0; i < length; i++) {
 							IndexValue<T> curr;
 							curr.value = x[i * xElementWiseStride];
 							curr.index = i;
@@ -656,11 +657,11 @@ struct SharedIndexValue<double> {
 				}
 
 
-				int resultLength = shape::length(resultShapeInfoBuffer);
+				Nd4jIndex resultLength = shape::length(resultShapeInfoBuffer);
 				IndexValue<T> *startingIndex = new IndexValue<T>[resultLength];
 
 #pragma omp parallel for
-				for (int i = 0; i < resultLength; i++) {
+				for (Nd4jIndex i = 0; i < resultLength; i++) {
 					IndexValue<T> val;
 					val.value = this->startingValue(x);
 					val.index = 0;
@@ -668,9 +669,8 @@ struct SharedIndexValue<double> {
 				}
 
 
-				shape::TAD tad(xShapeInfo,dimension,dimensionLength);
-				tad.createTadOnlyShapeInfo();
-				tad.createOffsets();
+				std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(xShapeInfo, dimension, dimensionLength);
+				shape::TAD &tad = *tadPack->tad;
                 if(tad.dimensionLength < 1)
                     return;
 				if(!(shape::elementWiseStride(tad.tadOnlyShapeInfo) > 0 && (tad.numTads == 1 || shape::isVector(tad.tadOnlyShapeInfo) ||
@@ -690,8 +690,8 @@ struct SharedIndexValue<double> {
 					int *xStride = shape::stride(tadShapeShapeInfo);
 					int rank = shape::rank(tadShapeShapeInfo);
 #pragma omp  parallel  for
-					for(int i = 0; i < resultLength; i++) {
-						int offset = tad.tadOffsets[i];
+					for(Nd4jIndex i = 0; i < resultLength; i++) {
+						Nd4jIndex offset = tad.tadOffsets[i];
 						int shapeIter[MAX_RANK];
 						int coord[MAX_RANK];
 						int dim;
@@ -735,14 +735,14 @@ struct SharedIndexValue<double> {
 
 				else {
 					int tadElementWiseStride = shape::elementWiseStride(tad.tadOnlyShapeInfo);
-					int tadLength = shape::length(tad.tadOnlyShapeInfo);
+					Nd4jIndex tadLength = shape::length(tad.tadOnlyShapeInfo);
 #pragma omp parallel for
-					for(int i = 0;  i < resultLength; i++) {
-						int baseOffset = tad.tadOffsets[i];
+					for(Nd4jIndex i = 0;  i < resultLength; i++) {
+						Nd4jIndex baseOffset = tad.tadOffsets[i];
 						IndexValue<T> indexValue;
 						indexValue.index = 0;
 						indexValue.value = x[baseOffset];
-						for(int j = 1; j < tadLength; j++) {
+						for(Nd4jIndex j = 1; j < tadLength; j++) {
 							IndexValue<T> comp;
 							comp.index = j;
 							comp.value = x[baseOffset + tadElementWiseStride * j];
@@ -0,0 +1,368 @@
+/*
+ * mask.h
+ *
+ * Boolean masks stored as one byte (0/1) or one bit per element,
+ * produced by the comparison ops and consumed by masked transforms,
+ * masked reductions and select.
+ *
+ * Mask element i refers to element i of the reference array
+ * (the first input, or the result for select) in that array's
+ * own ordering. Packed masks store element i in bit (i % 8) of
+ * byte i / 8, least significant bit first, and take
+ * (length + 7) / 8 bytes.
+ */
+
+#ifndef MASK_H_
+#define MASK_H_
+#include <dll.h>
+#include <omp.h>
+#include <shape.h>
+#include <pairwise_util.h>
+#include <pairwise_transform.h>
+#include <scalar.h>
+#include <transform.h>
+#include <reduce.h>
+#include <pointercast.h>
+
+namespace functions {
+    namespace mask {
+
+        /**
+         * The number of bytes a mask over length elements takes
+         * @param length the number of elements
+         * @param packed whether the mask is a bit mask
+         */
+        inline Nd4jIndex maskLength(Nd4jIndex length, bool packed) {
+            return packed ? (length + 7) / 8 : length;
+        }
+
+        /**
+         * Whether element i of the mask is set
+         */
+        inline bool isSet(unsigned char *mask, Nd4jIndex i, bool packed) {
+            if (packed)
+                return ((mask[i >> 3] >> (i & 7)) & 1) != 0;
+            return mask[i] != 0;
+        }
+
+        /**
+         * Maps linear indexes of a reference array
+         * (in its own order) to buffer offsets of up to
+         * three arrays of the same shape. Arrays that share
+         * the reference order and have an element wise stride
+         * are addressed directly, anything else goes through
+         * the coordinates.
+         */
+        class OffsetMapper {
+        public:
+            int *referenceShapeInfo;
+            int *shapeInfos[3];
+            int elementWiseStrides[3];
+            int numArrays;
+            bool direct;
+
+            OffsetMapper(int *referenceShapeInfo, int numArrays, int *a, int *b = nullptr, int *c = nullptr) {
+                this->referenceShapeInfo = referenceShapeInfo;
+                this->numArrays = numArrays;
+                shapeInfos[0] = a;
+                shapeInfos[1] = b;
+                shapeInfos[2] = c;
+                direct = true;
+                for (int i = 0; i < numArrays; i++) {
+                    elementWiseStrides[i] = shape::elementWiseStride(shapeInfos[i]);
+                    if (elementWiseStrides[i] < 1 || shape::order(shapeInfos[i]) != shape::order(referenceShapeInfo))
+                        direct = false;
+                }
+            }
+
+            /**
+             * Computes the offsets of linear index i
+             * @param i the linear index in the reference order
+             * @param offsets the offsets, one per array (output)
+             */
+            inline void offsets(Nd4jIndex i, Nd4jIndex *offsets) {
+                if (direct) {
+                    for (int a = 0; a < numArrays; a++)
+                        offsets[a] = i * elementWiseStrides[a];
+                    return;
+                }
+
+                int coord[MAX_RANK];
+                int rank = shape::rank(referenceShapeInfo);
+                shape::ind2subOrder(referenceShapeInfo, i, coord);
+                for (int a = 0; a < numArrays; a++) {
+                    offsets[a] = shape::getOffset(0, shape::shapeOf(shapeInfos[a]), shape::stride(shapeInfos[a]), coord, rank);
+                }
+            }
+        };
+
+        /**
+         * Writes a mask from a per element predicate.
+         * Packed masks are produced a byte (8 elements) at a time
+         * so no two threads ever write the same byte.
+         * @param length the number of elements
+         * @param mask the mask to write
+         * @param packed whether to write a bit mask
+         * @param predicate callable mapping a linear index to a bool
+         */
+        template<typename Predicate>
+        inline void writeMask(Nd4jIndex length, unsigned char *mask, bool packed, Predicate &predicate) {
+            if (packed) {
+                Nd4jIndex bytes = maskLength(length, true);
+#pragma omp parallel for schedule(static) if (length >= 8000)
+                for (Nd4jIndex b = 0; b < bytes; b++) {
+                    unsigned char bits = 0;
+                    Nd4jIndex start = b * 8;
+                    int count = length - start < 8 ? (int) (length - start) : 8;
+                    for (int bit = 0; bit < count; bit++) {
+                        if (predicate(start + bit))
+                            bits |= (unsigned char) (1 << bit);
+                    }
+
+                    mask[b] = bits;
+                }
+            }
+            else {
+#pragma omp parallel for simd schedule(static) if (length >= 8000)
+                for (Nd4jIndex i = 0; i < length; i++) {
+                    mask[i] = predicate(i) ? 1 : 0;
+                }
+            }
+        }
+
+        template<typename T>
+        class PairwisePredicate {
+        public:
+            functions::pairwise_transforms::PairWiseTransform<T> *op;
+            T *x;
+            T *y;
+            T *extraParams;
+            OffsetMapper *mapper;
+
+            inline bool operator()(Nd4jIndex i) {
+                Nd4jIndex offsets[2];
+                mapper->offsets(i, offsets);
+                return op->op(x[offsets[0]], y[offsets[1]], extraParams) != 0.0;
+            }
+        };
+
+        template<typename T>
+        class ScalarPredicate {
+        public:
+            functions::scalar::ScalarTransform<T> *op;
+            T *x;
+            T scalar;
+            T *extraParams;
+            OffsetMapper *mapper;
+
+            inline bool operator()(Nd4jIndex i) {
+                Nd4jIndex offset;
+                mapper->offsets(i, &offset);
+                return op->op(x[offset], scalar, extraParams) != 0.0;
+            }
+        };
+
+        /**
+         * Masks produced by, and applied through, the existing ops
+         */
+        template<typename T>
+        class Mask {
+        public:
+
+            /**
+             * Compare x and y elementwise with a pairwise comparison
+             * op (EqualTo, GreaterThan, LessThan, GreaterThanOrEqual,
+             * LessThanOrEqual, NotEqualTo, Epsilon) writing a mask
+             * instead of 0.0/1.0 values.
+             * @param op the comparison op
+             * @param x the first input (the reference array)
+             * @param xShapeInfo the shape information for x
+             * @param y the second input
+             * @param yShapeInfo the shape information for y
+             * @param extraParams the extra parameters for the op
+             * @param mask the mask to write
+             * @param packed whether to write a bit mask
+             */
+            void compare(functions::pairwise_transforms::PairWiseTransform<T> *op,
+                         T *x,
+                         int *xShapeInfo,
+                         T *y,
+                         int *yShapeInfo,
+                         T *extraParams,
+                         unsigned char *mask,
+                         bool packed) {
+                OffsetMapper mapper(xShapeInfo, 2, xShapeInfo, yShapeInfo);
+                PairwisePredicate<T> predicate;
+                predicate.op = op;
+                predicate.x = x;
+                predicate.y = y;
+                predicate.extraParams = extraParams;
+                predicate.mapper = &mapper;
+                writeMask(shape::length(xShapeInfo), mask, packed, predicate);
+            }
+
+            /**
+             * Compare x against a scalar with a scalar comparison
+             * op (LessThan, GreaterThan, Equals, LessThanOrEqual,
+             * NotEquals, GreaterThanOrEqual) writing a mask
+             * instead of 0.0/1.0 values.
+             * @param op the comparison op
+             * @param x the input (the reference array)
+             * @param xShapeInfo the shape information for x
+             * @param scalar the scalar to compare against
+             * @param extraParams the extra parameters for the op
+             * @param mask the mask to write
+             * @param packed whether to write a bit mask
+             */
+            void compare(functions::scalar::ScalarTransform<T> *op,
+                         T *x,
+                         int *xShapeInfo,
+                         T scalar,
+                         T *extraParams,
+                         unsigned char *mask,
+                         bool packed) {
+                OffsetMapper mapper(xShapeInfo, 1, xShapeInfo);
+                ScalarPredicate<T> predicate;
+                predicate.op = op;
+                predicate.x = x;
+                predicate.scalar = scalar;
+                predicate.extraParams = extraParams;
+                predicate.mapper = &mapper;
+                writeMask(shape::length(xShapeInfo), mask, packed, predicate);
+            }
+
+            /**
+             * Apply a transform only where the mask is set,
+             * result elements where it is not set are left untouched.
+             * @param op the transform
+             * @param x the input (the reference array)
+             * @param xShapeInfo the shape information for x
+             * @param result the result buffer
+             * @param resultShapeInfo the shape information for the result
+             * @param extraParams the extra parameters for the op
+             * @param mask the mask
+             * @param packed whether the mask is a bit mask
+             */
+            void transform(functions::transform::Transform<T> *op,
+                           T *x,
+                           int *xShapeInfo,
+                           T *result,
+                           int *resultShapeInfo,
+                           T *extraParams,
+                           unsigned char *mask,
+                           bool packed) {
+                Nd4jIndex length = shape::length(xShapeInfo);
+                OffsetMapper mapper(xShapeInfo, 2, xShapeInfo, resultShapeInfo);
+#pragma omp parallel for schedule(static) if (length >= 8000)
+                for (Nd4jIndex i = 0; i < length; i++) {
+                    if (!isSet(mask, i, packed))
+                        continue;
+                    Nd4jIndex offsets[2];
+                    mapper.offsets(i, offsets);
+                    result[offsets[1]] = op->op(x[offsets[0]], extraParams);
+                }
+            }
+
+            /**
+             * Reduce only the elements where the mask is set;
+             * the op sees the number of set elements as the length
+             * (so Mean is the mean of the selected elements).
+             * @param op the reduction
+             * @param x the input (the reference array)
+             * @param xShapeInfo the shape information for x
+             * @param extraParams the extra parameters for the op
+             * @param mask the mask
+             * @param packed whether the mask is a bit mask
+             * @return the reduction
+             */
+            T reduce(functions::reduce::ReduceFunction<T> *op,
+                     T *x,
+                     int *xShapeInfo,
+                     T *extraParams,
+                     unsigned char *mask,
+                     bool packed) {
+                Nd4jIndex length = shape::length(xShapeInfo);
+                OffsetMapper mapper(xShapeInfo, 1, xShapeInfo);
+                int threads = length >= 8000 ? omp_get_max_threads() : 1;
+                //threads the team turns out not to have leave their partials neutral
+                T *partials = new T[threads];
+                Nd4jIndex *counts = new Nd4jIndex[threads];
+                for (int i = 0; i < threads; i++) {
+                    partials[i] = op->startingValue(x);
+                    counts[i] = 0;
+                }
+
+#pragma omp parallel num_threads(threads)
+                {
+                    int tid = omp_get_thread_num();
+                    T local = op->startingValue(x);
+                    Nd4jIndex count = 0;
+#pragma omp for schedule(static)
+                    for (Nd4jIndex i = 0; i < length; i++) {
+                        if (!isSet(mask, i, packed))
+                            continue;
+                        Nd4jIndex offset;
+                        mapper.offsets(i, &offset);
+                        local = op->update(local, op->op(x[offset], extraParams), extraParams);
+                        count++;
+                    }
+
+                    partials[tid] = local;
+                    counts[tid] = count;
+                }
+
+                T reduction = partials[0];
+                Nd4jIndex count = counts[0];
+                for (int i = 1; i < threads; i++) {
+                    reduction = op->update(reduction, partials[i], extraParams);
+                    count += counts[i];
+                }
+
+                delete[] partials;
+                delete[] counts;
+                return op->postProcess(reduction, count, extraParams);
+            }
+
+            /**
+             * result = mask ? x : y, elementwise
+             * @param x the values where the mask is set
+             * @param xShapeInfo the shape information for x
+             * @param y the values where the mask is not set
+             * @param yShapeInfo the shape information for y
+             * @param result the result buffer (the reference array)
+             * @param resultShapeInfo the shape information for the result
+             * @param mask the mask
+             * @param packed whether the mask is a bit mask
+             */
+            void select(T *x,
+                        int *xShapeInfo,
+                        T *y,
+                        int *yShapeInfo,
+                        T *result,
+                        int *resultShapeInfo,
+                        unsigned char *mask,
+                        bool packed) {
+                Nd4jIndex length = shape::length(resultShapeInfo);
+                OffsetMapper mapper(resultShapeInfo, 3, resultShapeInfo, xShapeInfo, yShapeInfo);
+                if (mapper.direct && !packed &&
+                    mapper.elementWiseStrides[0] == 1 && mapper.elementWiseStrides[1] == 1 && mapper.elementWiseStrides[2] == 1) {
+#pragma omp parallel for simd schedule(static) if (length >= 8000)
+                    for (Nd4jIndex i = 0; i < length; i++) {
+                        result[i] = mask[i] ? x[i] : y[i];
+                    }
+
+                    return;
+                }
+
+#pragma omp parallel for schedule(static) if (length >= 8000)
+                for (Nd4jIndex i = 0; i < length; i++) {
+                    Nd4jIndex offsets[3];
+                    mapper.offsets(i, offsets);
+                    result[offsets[0]] = isSet(mask, i, packed) ? x[offsets[1]] : y[offsets[2]];
+                }
+            }
+        };
+    }
+}
+
+#endif /* MASK_H_ */
@@ -0,0 +1,248 @@
+/*
+ * numaplacement.h
+ *
+ * NUMA node placement for host buffers and the threads
+ * that work on them.
+ *
+ * A page lives on one node, and reading it from a core of another
+ * node costs a trip over the socket interconnect. Linux puts a page
+ * on the node of the thread that first writes it unless the range
+ * has a policy saying otherwise. placeMemory gives a range such
+ * a policy (with the mbind system call, so no libnuma is needed):
+ *
+ *  - NUMA_LOCAL: first touch, made explicit
+ *  - NUMA_INTERLEAVE: pages round robin over every node, for
+ *    buffers read by threads of every node in no particular order
+ *  - NUMA_BIND: every page on one node
+ *
+ * The CPU kernels split their loops in to contiguous static ranges,
+ * thread i of n taking the i-th n-th. firstTouch writes a buffer with
+ * that same split, so with NUMA_LOCAL each thread's range of the
+ * buffer lands on the node the thread runs on. For that to hold the
+ * threads must not wander between nodes: bindThreadsToNodes pins the
+ * OpenMP team of the calling thread so consecutive threads share a
+ * node, and the kernels' ranges follow the node boundaries, until
+ * unbindThreadsFromNodes lets them run anywhere again.
+ *
+ * Everything here is a no-op off Linux, and on machines with one node.
+ */
+
+#ifndef NUMAPLACEMENT_H_
+#define NUMAPLACEMENT_H_
+#include <pointercast.h>
+#include <executioncontext.h>
+#include <omp.h>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace nd4j {
+
+    enum NumaPolicy {
+        NUMA_DEFAULT = 0,
+        NUMA_LOCAL = 1,
+        NUMA_INTERLEAVE = 2,
+        NUMA_BIND = 3
+    };
+
+    /**
+     * Parses a sysfs list such as "0-3,8,10-11"
+     */
+    inline std::vector<int> parseNodeList(const char *list) {
+        std::vector<int> ids;
+        const char *position = list;
+        while (*position != '\0' && *position != '\n') {
+            char *next;
+            long first = std::strtol(position, &next, 10);
+            if (next == position)
+                break;
+            long last = first;
+            if (*next == '-') {
+                position = next + 1;
+                last = std::strtol(position, &next, 10);
+            }
+            for (long id = first; id <= last; id++)
+                ids.push_back((int) id);
+            position = *next == ',' ? next + 1 : next;
+        }
+        return ids;
+    }
+
+    /**
+     * Reads a sysfs list file, empty if it cannot be read
+     */
+    inline std::vector<int> readNodeList(const char *path) {
+        std::vector<int> ids;
+        FILE *file = std::fopen(path, "r");
+        if (file == nullptr)
+            return ids;
+        char line[4096];
+        if (std::fgets(line, sizeof(line), file) != nullptr)
+            ids = parseNodeList(line);
+        std::fclose(file);
+        return ids;
+    }
+
+    /**
+     * The ids of the online nodes; a machine
+     * without NUMA has node 0 alone
+     */
+    inline const std::vector<int> &numaNodes() {
+        static std::vector<int> nodes = [] {
+            std::vector<int> online = readNodeList("/sys/devices/system/node/online");
+            if (online.empty())
+                online.push_back(0);
+            return online;
+        }();
+        return nodes;
+    }
+
+    /**
+     * The cpus of a node, empty if it is not known
+     */
+    inline std::vector<int> numaNodeCpus(int node) {
+        char path[128];
+        std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        return readNodeList(path);
+    }
+
+    /**
+     * Gives the pages of [buffer, buffer + bytes) a placement policy.
+     * Only whole pages inside the range are covered, and pages
+     * already touched keep their place.
+     * @param policy a NumaPolicy
+     * @param node the node, for NUMA_BIND
+     * @return false if the policy could not be applied
+     */
+    inline bool placeMemory(void *buffer, Nd4jIndex bytes, int policy, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+        if (buffer == nullptr || policy == NUMA_DEFAULT)
+            return false;
+
+        //the kernel's modes, from linux/mempolicy.h
+        const int MPOL_PREFERRED_MODE = 1;
+        const int MPOL_BIND_MODE = 2;
+        const int MPOL_INTERLEAVE_MODE = 3;
+
+        const size_t maskBits = 1024;
+        unsigned long mask[maskBits / (8 * sizeof(unsigned long))] = {0};
+        const size_t bitsPerWord = 8 * sizeof(unsigned long);
+        int mode;
+        switch (policy) {
+            case NUMA_LOCAL:
+                //preferred with no nodes is the local node
+                mode = MPOL_PREFERRED_MODE;
+                break;
+            case NUMA_INTERLEAVE: {
+                mode = MPOL_INTERLEAVE_MODE;
+                const std::vector<int> &nodes = numaNodes();
+                for (size_t i = 0; i < nodes.size(); i++)
+                    if (nodes[i] >= 0 && (size_t) nodes[i] < maskBits)
+                        mask[nodes[i] / bitsPerWord] |= 1UL << (nodes[i] % bitsPerWord);
+            }
+                break;
+            case NUMA_BIND:
+                if (node < 0 || (size_t) node >= maskBits)
+                    return false;
+                mode = MPOL_BIND_MODE;
+                mask[node / bitsPerWord] |= 1UL << (node % bitsPerWord);
+                break;
+            default:
+                return false;
+        }
+
+        size_t page = (size_t) sysconf(_SC_PAGESIZE);
+        size_t start = (reinterpret_cast<size_t>(buffer) + page - 1) / page * page;
+        size_t end = (reinterpret_cast<size_t>(buffer) + (size_t) bytes) / page * page;
+        if (end <= start)
+            return false;
+        return syscall(SYS_mbind, start, end - start, mode, mode == MPOL_PREFERRED_MODE ? nullptr : mask, maskBits + 1, 0) == 0;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Writes a byte to every page of a buffer, splitting the pages
+     * over the OpenMP threads the way the kernels split their loops
+     */
+    inline void firstTouch(void *buffer, Nd4jIndex bytes) {
+        if (buffer == nullptr)
+            return;
+        char *bytePointer = reinterpret_cast<char *>(buffer);
+        const Nd4jIndex page = 4096;
+        Nd4jIndex pages = (bytes + page - 1) / page;
+#pragma omp parallel for schedule(static) if (pages >= 64)
+        for (Nd4jIndex i = 0; i < pages; i++)
+            bytePointer[i * page] = 0;
+    }
+
+    /**
+     * The node thread number thread of a team of threads
+     * runs on under bindThreadsToNodes: the team is cut in
+     * to one run of consecutive threads per node
+     */
+    inline int nodeOfThread(int thread, int threads) {
+        const std::vector<int> &nodes = numaNodes();
+        return nodes[(size_t) thread * nodes.size() / (size_t) threads];
+    }
+
+    /**
+     * Pins every thread of the calling thread's OpenMP team
+     * to the cpus of its node (see nodeOfThread). Stays in
+     * effect for later parallel regions of the calling thread
+     * until unbindThreadsFromNodes, or until an ExecutionScope
+     * pins the team to the cores of a context. It is not a
+     * pinning ExecutionContext::unpin undoes.
+     * @return the number of threads that could not be pinned
+     */
+    inline int bindThreadsToNodes() {
+        int failed = 0;
+#if defined(__linux__)
+        //taken before the first binding, for unbindThreadsFromNodes
+        ExecutionContext::processMask();
+        //the team leaves the cores of any context: no scope may
+        //think it still pinned, nor a thread its old core
+        ExecutionScope::forgetTeam();
+#pragma omp parallel reduction(+:failed)
+        {
+            ExecutionContext::pinnedCore() = -1;
+            std::vector<int> cpus = numaNodeCpus(nodeOfThread(omp_get_thread_num(), omp_get_num_threads()));
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            for (size_t i = 0; i < cpus.size(); i++)
+                if (cpus[i] >= 0 && cpus[i] < CPU_SETSIZE)
+                    CPU_SET(cpus[i], &mask);
+            if (cpus.empty() || pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask) != 0)
+                failed++;
+        }
+#endif
+        return failed;
+    }
+
+    /**
+     * Undoes bindThreadsToNodes: lets every thread of the calling
+     * thread's OpenMP team run on the cores the process started with
+     * @return the number of threads that could not be unbound
+     */
+    inline int unbindThreadsFromNodes() {
+        int failed = 0;
+#if defined(__linux__)
+#pragma omp parallel reduction(+:failed)
+        {
+            if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &ExecutionContext::processMask()) != 0)
+                failed++;
+            ExecutionContext::pinnedCore() = -1;
+        }
+#endif
+        return failed;
+    }
+}
+
+#endif /* NUMAPLACEMENT_H_ */
@@ -0,0 +1,206 @@
+/*
+ * opbatch.h
+ *
+ * Runs a list of ops handed over in one call.
+ *
+ * Every op is described by DESCRIPTOR_LENGTH consecutive
+ * Nd4jPointer slots, laid out as in OpDescriptorSlot; slots an
+ * op family does not use are ignored. The scalar of scalar ops
+ * travels as the bits of a double, whatever the data type.
+ *
+ * Ops run in order. An op flagged OP_INDEPENDENT may run at the
+ * same time as the op before it, so a run of independent ops is
+ * spread over the OpenMP threads, one op per thread; the caller
+ * guarantees such ops neither write what the others read nor
+ * write the same buffers.
+ */
+
+#ifndef OPBATCH_H_
+#define OPBATCH_H_
+#include <broadcasting.h>
+#include <indexreduce.h>
+#include <pairwise_transform.h>
+#include <reduce.h>
+#include <reduce3.h>
+#include <summarystatsreduce.h>
+#include <transform.h>
+#include <scalar.h>
+#include <ternary.h>
+#include <pointercast.h>
+#include <opcache.h>
+#include <opprofiler.h>
+#include <omp.h>
+#include <cstring>
+
+namespace nd4j {
+
+    /**
+     * A descriptor's DESC_FAMILY is an OpFamily from opfamily.h,
+     * one of OP_FAMILY_TRANSFORM to OP_FAMILY_SUMMARY_STATS. The
+     * reductions write a scalar to result[0] when the dimension
+     * slot is null.
+     */
+    enum OpDescriptorSlot {
+        DESC_FAMILY = 0,
+        DESC_OP_NUM = 1,
+        DESC_FLAGS = 2,
+        DESC_X = 3,
+        DESC_X_SHAPE = 4,
+        DESC_Y = 5,
+        DESC_Y_SHAPE = 6,
+        //the third input of ternary ops
+        DESC_Z = 7,
+        DESC_Z_SHAPE = 8,
+        DESC_RESULT = 9,
+        DESC_RESULT_SHAPE = 10,
+        DESC_EXTRA_PARAMS = 11,
+        DESC_DIMENSION = 12,
+        DESC_DIMENSION_LENGTH = 13,
+        DESC_SCALAR = 14,
+        DESCRIPTOR_LENGTH = 16
+    };
+
+    enum OpDescriptorFlags {
+        //may run at the same time as the op before it
+        OP_INDEPENDENT = 1,
+        //bias corrected variance for summary stats ops
+        OP_BIAS_CORRECTED = 2
+    };
+
+    /**
+     * Packs a scalar in to the DESC_SCALAR slot
+     */
+    inline Nd4jPointer packScalar(double scalar) {
+        Nd4jPointer bits;
+        std::memcpy(&bits, &scalar, sizeof(double));
+        return bits;
+    }
+
+    inline double unpackScalar(Nd4jPointer bits) {
+        double scalar;
+        std::memcpy(&scalar, &bits, sizeof(double));
+        return scalar;
+    }
+
+    template<typename T>
+    class OpBatch {
+    private:
+        OpCache<T> *ops = OpCache<T>::getInstance();
+
+    public:
+        /**
+         * Runs numOps ops
+         * @param descriptors numOps * DESCRIPTOR_LENGTH slots
+         * @param numOps the number of ops
+         */
+        void exec(Nd4jPointer *descriptors, int numOps) {
+            int start = 0;
+            while (start < numOps) {
+                //the ops after start that may run alongside it
+                int end = start + 1;
+                while (end < numOps && (descriptors[end * DESCRIPTOR_LENGTH + DESC_FLAGS] & OP_INDEPENDENT))
+                    end++;
+
+                if (end - start == 1)
+                    execOne(descriptors + start * DESCRIPTOR_LENGTH);
+                else {
+#pragma omp parallel for schedule(dynamic, 1)
+                    for (int i = start; i < end; i++)
+                        execOne(descriptors + i * DESCRIPTOR_LENGTH);
+                }
+
+                start = end;
+            }
+        }
+
+        /**
+         * Runs the op one descriptor describes
+         */
+        void execOne(Nd4jPointer *descriptor) {
+            int opNum = (int) descriptor[DESC_OP_NUM];
+            Nd4jPointer flags = descriptor[DESC_FLAGS];
+            T *x = reinterpret_cast<T *>(descriptor[DESC_X]);
+            int *xShapeInfo = reinterpret_cast<int *>(descriptor[DESC_X_SHAPE]);
+            T *y = reinterpret_cast<T *>(descriptor[DESC_Y]);
+            int *yShapeInfo = reinterpret_cast<int *>(descriptor[DESC_Y_SHAPE]);
+            T *z = reinterpret_cast<T *>(descriptor[DESC_Z]);
+            int *zShapeInfo = reinterpret_cast<int *>(descriptor[DESC_Z_SHAPE]);
+            T *result = reinterpret_cast<T *>(descriptor[DESC_RESULT]);
+            int *resultShapeInfo = reinterpret_cast<int *>(descriptor[DESC_RESULT_SHAPE]);
+            T *extraParams = reinterpret_cast<T *>(descriptor[DESC_EXTRA_PARAMS]);
+            int *dimension = reinterpret_cast<int *>(descriptor[DESC_DIMENSION]);
+            int dimensionLength = (int) descriptor[DESC_DIMENSION_LENGTH];
+
+            //slots the family does not use may hold anything, so only x is measured
+            OpProfileScope<T> profile((int) descriptor[DESC_FAMILY], opNum, xShapeInfo);
+            switch ((int) descriptor[DESC_FAMILY]) {
+                case OP_FAMILY_TRANSFORM: {
+                    functions::transform::Transform<T> *op = ops->transform(opNum);
+                    op->exec(x, xShapeInfo, result, resultShapeInfo, extraParams);
+                }
+                    break;
+                case OP_FAMILY_SCALAR: {
+                    T scalar = (T) unpackScalar(descriptor[DESC_SCALAR]);
+                    functions::scalar::ScalarTransform<T> *op = ops->scalar(opNum);
+                    op->transform(x, xShapeInfo, result, resultShapeInfo, scalar, extraParams);
+                }
+                    break;
+                case OP_FAMILY_PAIRWISE: {
+                    functions::pairwise_transforms::PairWiseTransform<T> *op = ops->pairwise(opNum);
+                    op->exec(x, xShapeInfo, y, yShapeInfo, result, resultShapeInfo, extraParams);
+                }
+                    break;
+                case OP_FAMILY_BROADCAST: {
+                    functions::broadcast::Broadcast<T> *op = ops->broadcast(opNum);
+                    if (dimension != nullptr)
+                        op->exec(x, xShapeInfo, y, yShapeInfo, result, dimension, dimensionLength);
+                    else
+                        op->exec(x, xShapeInfo, y, yShapeInfo, result, resultShapeInfo);
+                }
+                    break;
+                case OP_FAMILY_TERNARY: {
+                    functions::ternary::TernaryTransform<T> *op = ops->ternary(opNum);
+                    op->exec(x, xShapeInfo, y, yShapeInfo, z, zShapeInfo, result, resultShapeInfo, extraParams);
+                }
+                    break;
+                case OP_FAMILY_REDUCE: {
+                    functions::reduce::ReduceFunction<T> *op = ops->reduce(opNum);
+                    if (dimension != nullptr)
+                        op->exec(x, xShapeInfo, extraParams, result, resultShapeInfo, dimension, dimensionLength);
+                    else
+                        result[0] = op->execScalar(x, xShapeInfo, extraParams);
+                }
+                    break;
+                case OP_FAMILY_INDEX_REDUCE: {
+                    functions::indexreduce::IndexReduce<T> *op = ops->indexReduce(opNum);
+                    if (dimension != nullptr)
+                        op->exec(x, xShapeInfo, extraParams, result, resultShapeInfo, dimension, dimensionLength);
+                    else
+                        result[0] = op->execScalar(x, xShapeInfo, extraParams);
+                }
+                    break;
+                case OP_FAMILY_REDUCE3: {
+                    functions::reduce3::Reduce3<T> *op = ops->reduce3(opNum);
+                    if (dimension != nullptr)
+                        op->exec(x, xShapeInfo, extraParams, y, yShapeInfo, result, resultShapeInfo, dimension, dimensionLength);
+                    else
+                        result[0] = op->execScalar(x, xShapeInfo, extraParams, y, yShapeInfo);
+                }
+                    break;
+                case OP_FAMILY_SUMMARY_STATS: {
+                    functions::summarystats::SummaryStatsReduce<T> *op = ops->summaryStats(opNum, (flags & OP_BIAS_CORRECTED) != 0);
+                    if (dimension != nullptr)
+                        op->exec(x, xShapeInfo, extraParams, result, resultShapeInfo, dimension, dimensionLength);
+                    else
+                        result[0] = op->execScalar(x, xShapeInfo, extraParams);
+                }
+                    break;
+                default:
+                    printf("Unknown op family %d in batch\n", (int) descriptor[DESC_FAMILY]);
+                    break;
+            }
+        }
+    };
+}
+
+#endif /* OPBATCH_H_ */
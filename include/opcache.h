@@ -0,0 +1,128 @@
+/*
+ * opcache.h
+ *
+ * One instance of every op per data type, built once and
+ * shared by every call instead of created and deleted per call.
+ *
+ * Sharing is safe because ops are stateless: the few members they
+ * have (requiresSpecial, extraParamsLen, indexBased, biasCorrected)
+ * are set by their constructors and only read afterwards, and exec
+ * keeps everything else in locals or in buffers the caller passes.
+ * An op added later must keep to that, or stop being cached.
+ */
+
+#ifndef OPCACHE_H_
+#define OPCACHE_H_
+#include <broadcasting.h>
+#include <indexreduce.h>
+#include <pairwise_transform.h>
+#include <reduce.h>
+#include <reduce3.h>
+#include <summarystatsreduce.h>
+#include <transform.h>
+#include <scalar.h>
+#include <ternary.h>
+
+namespace nd4j {
+
+    template<typename T>
+    class OpCache {
+    public:
+        //past the highest op number of any family
+        static const int MAX_OPS = 64;
+
+        /**
+         * The ops for T, built on first use; C++11
+         * makes that first use safe from any thread
+         */
+        static OpCache<T> *getInstance() {
+            static OpCache<T> *instance = new OpCache<T>();
+            return instance;
+        }
+
+        /**
+         * The op of each family with the given number,
+         * nullptr if the family has no such op
+         */
+        functions::transform::Transform<T> *transform(int opNum) {
+            return valid(opNum) ? transforms[opNum] : nullptr;
+        }
+
+        functions::scalar::ScalarTransform<T> *scalar(int opNum) {
+            return valid(opNum) ? scalars[opNum] : nullptr;
+        }
+
+        functions::pairwise_transforms::PairWiseTransform<T> *pairwise(int opNum) {
+            return valid(opNum) ? pairwises[opNum] : nullptr;
+        }
+
+        functions::broadcast::Broadcast<T> *broadcast(int opNum) {
+            return valid(opNum) ? broadcasts[opNum] : nullptr;
+        }
+
+        functions::ternary::TernaryTransform<T> *ternary(int opNum) {
+            return valid(opNum) ? ternaries[opNum] : nullptr;
+        }
+
+        functions::reduce::ReduceFunction<T> *reduce(int opNum) {
+            return valid(opNum) ? reductions[opNum] : nullptr;
+        }
+
+        functions::indexreduce::IndexReduce<T> *indexReduce(int opNum) {
+            return valid(opNum) ? indexReductions[opNum] : nullptr;
+        }
+
+        functions::reduce3::Reduce3<T> *reduce3(int opNum) {
+            return valid(opNum) ? reduce3s[opNum] : nullptr;
+        }
+
+        functions::summarystats::SummaryStatsReduce<T> *summaryStats(int opNum, bool biasCorrected) {
+            return valid(opNum) ? summaryStatsReductions[biasCorrected ? 1 : 0][opNum] : nullptr;
+        }
+
+    private:
+        functions::transform::Transform<T> *transforms[MAX_OPS];
+        functions::scalar::ScalarTransform<T> *scalars[MAX_OPS];
+        functions::pairwise_transforms::PairWiseTransform<T> *pairwises[MAX_OPS];
+        functions::broadcast::Broadcast<T> *broadcasts[MAX_OPS];
+        functions::ternary::TernaryTransform<T> *ternaries[MAX_OPS];
+        functions::reduce::ReduceFunction<T> *reductions[MAX_OPS];
+        functions::indexreduce::IndexReduce<T> *indexReductions[MAX_OPS];
+        functions::reduce3::Reduce3<T> *reduce3s[MAX_OPS];
+        functions::summarystats::SummaryStatsReduce<T> *summaryStatsReductions[2][MAX_OPS];
+
+        OpCache() {
+            functions::transform::TransformOpFactory<T> transformOpFactory;
+            functions::scalar::ScalarOpFactory<T> scalarOpFactory;
+            functions::pairwise_transforms::PairWiseTransformOpFactory<T> pairWiseTransformOpFactory;
+            functions::broadcast::BroadcastOpFactory<T> broadcastOpFactory;
+            functions::ternary::TernaryOpFactory<T> ternaryOpFactory;
+            functions::reduce::ReduceOpFactory<T> reduceOpFactory;
+            functions::indexreduce::IndexReduceOpFactory<T> indexReduceOpFactory;
+            functions::reduce3::Reduce3OpFactory<T> reduce3OpFactory;
+            functions::summarystats::SummaryStatsReduceOpFactory<T> summaryStatsReduceOpFactory;
+
+            for (int i = 0; i < MAX_OPS; i++) {
+                transforms[i] = transformOpFactory.getOp(i);
+                scalars[i] = scalarOpFactory.getOp(i);
+                pairwises[i] = pairWiseTransformOpFactory.getOp(i);
+                broadcasts[i] = broadcastOpFactory.getOp(i);
+                ternaries[i] = ternaryOpFactory.getOp(i);
+                reductions[i] = reduceOpFactory.create(i);
+                indexReductions[i] = indexReduceOpFactory.getOp(i);
+                reduce3s[i] = reduce3OpFactory.getOp(i);
+                summaryStatsReductions[0][i] = summaryStatsReduceOpFactory.getOp(i, false);
+                summaryStatsReductions[1][i] = summaryStatsReduceOpFactory.getOp(i, true);
+            }
+        }
+
+        OpCache(const OpCache &other);
+        OpCache &operator=(const OpCache &other);
+
+        static inline bool valid(int opNum) {
+            return opNum >= 0 && opNum < MAX_OPS;
+        }
+    };
+}
+
+#endif /* OPCACHE_H_ */
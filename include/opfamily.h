@@ -0,0 +1,65 @@
+/*
+ * opfamily.h
+ *
+ * The op families and data types, as numbered in batch
+ * descriptors and in the profiling counters and trace.
+ */
+
+#ifndef OPFAMILY_H_
+#define OPFAMILY_H_
+
+namespace nd4j {
+
+    /**
+     * The op families. The numbers up to OP_FAMILY_SUMMARY_STATS
+     * are also those of OpBatch descriptors, so they must not change.
+     */
+    enum OpFamily {
+        OP_FAMILY_TRANSFORM = 0,
+        OP_FAMILY_SCALAR = 1,
+        OP_FAMILY_PAIRWISE = 2,
+        OP_FAMILY_BROADCAST = 3,
+        OP_FAMILY_TERNARY = 4,
+        OP_FAMILY_REDUCE = 5,
+        OP_FAMILY_INDEX_REDUCE = 6,
+        OP_FAMILY_REDUCE3 = 7,
+        OP_FAMILY_SUMMARY_STATS = 8,
+        OP_FAMILY_HISTOGRAM,
+        OP_FAMILY_QUANTILES,
+        OP_FAMILY_COMPARE_MASK,
+        OP_FAMILY_SCALAR_COMPARE_MASK,
+        OP_FAMILY_MASKED_TRANSFORM,
+        OP_FAMILY_MASKED_REDUCE,
+        OP_FAMILY_SELECT,
+        OP_FAMILIES
+    };
+
+    inline const char *opFamilyName(int family) {
+        static const char *names[OP_FAMILIES] = {
+                "transform", "scalar", "pairwise", "broadcast", "ternary",
+                "reduce", "indexreduce", "reduce3", "summarystats",
+                "histogram", "quantiles", "comparemask", "scalarcomparemask",
+                "maskedtransform", "maskedreduce", "select"
+        };
+        return family >= 0 && family < OP_FAMILIES ? names[family] : "unknown";
+    }
+
+    template<typename T>
+    struct DataTypeOf;
+
+    template<>
+    struct DataTypeOf<float> {
+        static const int index = 0;
+    };
+
+    template<>
+    struct DataTypeOf<double> {
+        static const int index = 1;
+    };
+
+    inline const char *dataTypeName(int dataType) {
+        return dataType == 0 ? "float" : "double";
+    }
+}
+
+#endif /* OPFAMILY_H_ */
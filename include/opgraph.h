@@ -0,0 +1,662 @@
+/*
+ * opgraph.h
+ *
+ * A lazily executed graph of elementwise ops with loop fusion.
+ *
+ * Transform, scalar, pairwise and broadcast ops (and full
+ * reductions) are recorded as nodes instead of being run. exec()
+ * cuts the recorded nodes in to groups of consecutive elementwise
+ * nodes of the same shape and runs each group as one loop: the
+ * elements are walked in tiles small enough to stay in L1, every
+ * node of the group computes its tile from the tiles of its operands,
+ * and a reduction at the end of the group folds the tiles as they
+ * are produced.
+ *
+ * A node's result is only written to memory when it was asked for
+ * through output() or a node of another group reads it. Ops that
+ * are not elementwise (requiresSpecial, like softmax) end the
+ * current group and run on their own through their regular exec.
+ *
+ * A node that cannot be run (an unknown op, an operand that is not
+ * a value of the graph, such as a reduction, a pairwise op on arrays
+ * of different shapes, a broadcast of an array that does not broadcast
+ * to x) is refused: adding it returns -1, nodes built on -1 are refused
+ * in turn, and exec() runs nothing and returns -1. So is an output
+ * whose shape is not that of its value.
+ */
+
+#ifndef OPGRAPH_H_
+#define OPGRAPH_H_
+#include <broadcasting.h>
+#include <pairwise_transform.h>
+#include <reduce.h>
+#include <transform.h>
+#include <scalar.h>
+#include <rawiterplan.h>
+#include <pointercast.h>
+#include <opcache.h>
+#include <omp.h>
+#include <vector>
+
+namespace nd4j {
+
+    template<typename T>
+    class OpGraph {
+    public:
+        //elements per tile
+        static const int TILE = 256;
+
+        OpGraph() {
+        }
+
+        ~OpGraph() {
+            clear();
+        }
+
+        /**
+         * Adds an existing array
+         * @return the id of the value, -1 if refused (the temporaries
+         * of its shape would have strides past an int)
+         */
+        int input(T *buffer, int *shapeInfo) {
+            if (!shape::stridesFit(shape::rank(shapeInfo), shape::shapeOf(shapeInfo), 'c'))
+                return refuse();
+            Node node(INPUT);
+            node.buffer = buffer;
+            node.shapeInfo = shapeInfo;
+            setShape(node, shapeInfo);
+            return add(node);
+        }
+
+        /**
+         * Adds transform opNum of x
+         * @return the id of the value, -1 if refused
+         */
+        int transform(int opNum, int x, T *extraParams) {
+            if (!isValue(x) || ops->transform(opNum) == nullptr)
+                return refuse();
+            Node node(TRANSFORM);
+            node.x = x;
+            node.extraParams = extraParams;
+            node.transform = ops->transform(opNum);
+            node.special = node.transform->isSpecial();
+            copyShape(node, nodes[x]);
+            return add(node);
+        }
+
+        /**
+         * Adds scalar op opNum of x and scalar
+         * @return the id of the value, -1 if refused
+         */
+        int scalar(int opNum, int x, T scalar, T *extraParams) {
+            if (!isValue(x) || ops->scalar(opNum) == nullptr)
+                return refuse();
+            Node node(SCALAR);
+            node.x = x;
+            node.scalar = scalar;
+            node.extraParams = extraParams;
+            node.scalarTransform = ops->scalar(opNum);
+            copyShape(node, nodes[x]);
+            return add(node);
+        }
+
+        /**
+         * Adds pairwise op opNum of x and y,
+         * which must have the same shape
+         * @return the id of the value, -1 if refused
+         */
+        int pairwise(int opNum, int x, int y, T *extraParams) {
+            if (!isValue(x) || !isValue(y) || ops->pairwise(opNum) == nullptr || !sameShape(nodes[x], nodes[y]))
+                return refuse();
+            Node node(PAIRWISE);
+            node.x = x;
+            node.y = y;
+            node.extraParams = extraParams;
+            node.pairwise = ops->pairwise(opNum);
+            node.special = node.pairwise->isSpecial();
+            copyShape(node, nodes[x]);
+            return add(node);
+        }
+
+        /**
+         * Adds broadcast op opNum of x and y, with y
+         * broadcast NumPy style to the shape of x: y has
+         * at most the rank of x, and each of its dimensions
+         * is 1 or that of x, counting from the last
+         * @return the id of the value, -1 if refused
+         */
+        int broadcast(int opNum, int x, int y) {
+            if (!isValue(x) || !isValue(y) || ops->broadcast(opNum) == nullptr || !broadcastsTo(nodes[y], nodes[x]))
+                return refuse();
+            Node node(BROADCAST);
+            node.x = x;
+            node.y = y;
+            node.broadcast = ops->broadcast(opNum);
+            copyShape(node, nodes[x]);
+            return add(node);
+        }
+
+        /**
+         * Adds reduction opNum over all of x,
+         * written to result[0] by exec
+         * @return the id of the node, -1 if refused
+         */
+        int reduce(int opNum, int x, T *extraParams, T *result) {
+            if (!isValue(x) || ops->reduce(opNum) == nullptr || result == nullptr)
+                return refuse();
+            Node node(REDUCE);
+            node.x = x;
+            node.extraParams = extraParams;
+            node.reduce = ops->reduce(opNum);
+            node.buffer = result;
+            copyShape(node, nodes[x]);
+            return add(node);
+        }
+
+        /**
+         * Asks for a value to be written to buffer by exec;
+         * shapeInfo must have the value's shape
+         * @return 0, or -1 if refused (an input, a reduction,
+         * or a shape other than the value's)
+         */
+        int output(int value, T *buffer, int *shapeInfo) {
+            if (!isValue(value) || nodes[value].kind == INPUT || buffer == nullptr ||
+                shapeInfo == nullptr || !hasShape(nodes[value], shapeInfo))
+                return refuse();
+            nodes[value].buffer = buffer;
+            nodes[value].shapeInfo = shapeInfo;
+            return 0;
+        }
+
+        /**
+         * The number of loops the last exec ran,
+         * counting ops that run on their own
+         */
+        int numGroups() {
+            return (int) groups.size();
+        }
+
+        /**
+         * Whether a node was refused since the last clear
+         */
+        bool hasRefused() {
+            return refused;
+        }
+
+        /**
+         * Runs the graph
+         * @return 0, or -1 without running anything if a node was refused
+         */
+        int exec() {
+            if (refused)
+                return -1;
+            plan();
+
+            std::vector<T *> temporaries;
+            std::vector<int *> temporaryShapes;
+            for (size_t i = 0; i < nodes.size(); i++) {
+                Node &node = nodes[i];
+                if (node.kind != INPUT && node.kind != REDUCE && node.materialize && node.buffer == nullptr) {
+                    node.buffer = new T[node.length];
+                    node.shapeInfo = shape::shapeBuffer(node.rank, node.shape);
+                    node.temporary = true;
+                    temporaries.push_back(node.buffer);
+                    temporaryShapes.push_back(node.shapeInfo);
+                }
+            }
+
+            for (size_t g = 0; g < groups.size(); g++) {
+                Group &group = groups[g];
+                if (group.special)
+                    execSpecial(nodes[group.nodes[0]]);
+                else
+                    execGroup(group);
+            }
+
+            //temporaries live for one exec only
+            for (size_t i = 0; i < nodes.size(); i++) {
+                if (nodes[i].temporary) {
+                    nodes[i].buffer = nullptr;
+                    nodes[i].shapeInfo = nullptr;
+                    nodes[i].temporary = false;
+                }
+            }
+            for (size_t i = 0; i < temporaries.size(); i++) {
+                delete[] temporaries[i];
+                delete[] temporaryShapes[i];
+            }
+            return 0;
+        }
+
+        /**
+         * Drops every node
+         */
+        void clear() {
+            nodes.clear();
+            groups.clear();
+            refused = false;
+        }
+
+    private:
+        enum NodeKind {
+            INPUT,
+            TRANSFORM,
+            SCALAR,
+            PAIRWISE,
+            BROADCAST,
+            REDUCE
+        };
+
+        struct Node {
+            NodeKind kind;
+            int x;
+            int y;
+            T scalar;
+            T *extraParams;
+            //shared instances from OpCache, not owned
+            functions::transform::Transform<T> *transform;
+            functions::scalar::ScalarTransform<T> *scalarTransform;
+            functions::pairwise_transforms::PairWiseTransform<T> *pairwise;
+            functions::broadcast::Broadcast<T> *broadcast;
+            functions::reduce::ReduceFunction<T> *reduce;
+            bool special;
+            //the array of an input, the output or temporary of a value, the result of a reduction
+            T *buffer;
+            int *shapeInfo;
+            bool materialize;
+            bool temporary;
+            int rank;
+            int shape[MAX_RANK];
+            Nd4jIndex length;
+            int group;
+
+            Node(NodeKind kind) {
+                this->kind = kind;
+                x = -1;
+                y = -1;
+                scalar = 0;
+                extraParams = nullptr;
+                transform = nullptr;
+                scalarTransform = nullptr;
+                pairwise = nullptr;
+                broadcast = nullptr;
+                reduce = nullptr;
+                special = false;
+                buffer = nullptr;
+                shapeInfo = nullptr;
+                materialize = false;
+                temporary = false;
+                rank = 0;
+                length = 1;
+                group = -1;
+            }
+        };
+
+        //how a tile of an array is read or written: c order over the group shape
+        struct View {
+            T *buffer;
+            Nd4jIndex strides[MAX_RANK];
+            bool linear;
+            Nd4jIndex step;
+        };
+
+        struct Group {
+            bool special;
+            int rank;
+            int shape[MAX_RANK];
+            Nd4jIndex length;
+            std::vector<int> nodes;
+            //values read from memory, with their views
+            std::vector<int> externals;
+            std::vector<bool> externalBroadcast;
+        };
+
+        OpCache<T> *ops = OpCache<T>::getInstance();
+        std::vector<Node> nodes;
+        std::vector<Group> groups;
+        bool refused = false;
+
+        OpGraph(const OpGraph &other);
+        OpGraph &operator=(const OpGraph &other);
+
+        //reductions are nodes but not values: their result lives outside the graph
+        bool isValue(int value) {
+            return value >= 0 && value < (int) nodes.size() && nodes[value].kind != REDUCE;
+        }
+
+        int refuse() {
+            refused = true;
+            return -1;
+        }
+
+        int add(Node &node) {
+            nodes.push_back(node);
+            return (int) nodes.size() - 1;
+        }
+
+        static void setShape(Node &node, int *shapeInfo) {
+            node.rank = shape::rank(shapeInfo);
+            node.length = 1;
+            for (int i = 0; i < node.rank; i++) {
+                node.shape[i] = shape::shapeOf(shapeInfo)[i];
+                node.length *= node.shape[i];
+            }
+        }
+
+        static void copyShape(Node &node, Node &from) {
+            node.rank = from.rank;
+            node.length = from.length;
+            for (int i = 0; i < from.rank; i++)
+                node.shape[i] = from.shape[i];
+        }
+
+        static bool sameShape(Node &a, Node &b) {
+            if (a.rank != b.rank)
+                return false;
+            for (int i = 0; i < a.rank; i++)
+                if (a.shape[i] != b.shape[i])
+                    return false;
+            return true;
+        }
+
+        static bool hasShape(Node &node, int *shapeInfo) {
+            if (shape::rank(shapeInfo) != node.rank)
+                return false;
+            int *arrayShape = shape::shapeOf(shapeInfo);
+            for (int i = 0; i < node.rank; i++)
+                if (arrayShape[i] != node.shape[i])
+                    return false;
+            return true;
+        }
+
+        static bool broadcastsTo(Node &y, Node &x) {
+            if (y.rank > x.rank)
+                return false;
+            for (int i = y.rank - 1, j = x.rank - 1; i >= 0; i--, j--)
+                if (y.shape[i] != 1 && y.shape[i] != x.shape[j])
+                    return false;
+            return true;
+        }
+
+        static bool sameShape(Group &group, Node &node) {
+            if (group.rank != node.rank)
+                return false;
+            for (int i = 0; i < node.rank; i++)
+                if (group.shape[i] != node.shape[i])
+                    return false;
+            return true;
+        }
+
+        /**
+         * Cuts the nodes in to groups and marks the
+         * values that have to be written to memory
+         */
+        void plan() {
+            groups.clear();
+            for (size_t i = 0; i < nodes.size(); i++) {
+                Node &node = nodes[i];
+                node.group = -1;
+                //special ops write through their regular exec, so they always need a buffer
+                node.materialize = (node.buffer != nullptr && node.kind != REDUCE) || node.special;
+                if (node.kind == INPUT)
+                    continue;
+
+                bool join = !node.special && !groups.empty() && !groups.back().special && sameShape(groups.back(), node);
+                if (!join) {
+                    Group group;
+                    group.special = node.special;
+                    group.rank = node.rank;
+                    group.length = node.length;
+                    for (int d = 0; d < node.rank; d++)
+                        group.shape[d] = node.shape[d];
+                    groups.push_back(group);
+                }
+
+                node.group = (int) groups.size() - 1;
+                groups.back().nodes.push_back((int) i);
+            }
+
+            //values read by another group are written out
+            for (size_t i = 0; i < nodes.size(); i++) {
+                Node &node = nodes[i];
+                int operands[2] = {node.x, node.y};
+                for (int o = 0; o < 2; o++) {
+                    if (operands[o] < 0)
+                        continue;
+                    Node &operand = nodes[operands[o]];
+                    if (operand.kind != INPUT && (operand.group != node.group || groups[node.group].special || groups[operand.group].special))
+                        operand.materialize = true;
+                }
+            }
+
+            //the values each fused group reads from memory
+            for (size_t g = 0; g < groups.size(); g++) {
+                Group &group = groups[g];
+                if (group.special)
+                    continue;
+                for (size_t n = 0; n < group.nodes.size(); n++) {
+                    Node &node = nodes[group.nodes[n]];
+                    int operands[2] = {node.x, node.y};
+                    for (int o = 0; o < 2; o++) {
+                        if (operands[o] < 0 || nodes[operands[o]].group == (int) g)
+                            continue;
+                        bool broadcastOperand = node.kind == BROADCAST && o == 1;
+                        bool known = false;
+                        for (size_t e = 0; e < group.externals.size(); e++)
+                            known |= group.externals[e] == operands[o] && group.externalBroadcast[e] == broadcastOperand;
+                        if (!known) {
+                            group.externals.push_back(operands[o]);
+                            group.externalBroadcast.push_back(broadcastOperand);
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * The view of an array over the group shape; broadcast
+         * arrays are aligned to the last dimension, with a zero
+         * stride along the dimensions they are broadcast over
+         */
+        static View viewOf(Group &group, T *buffer, int *shapeInfo, bool broadcastArray) {
+            View view;
+            view.buffer = buffer;
+            int rank = shape::rank(shapeInfo);
+            int *arrayShape = shape::shapeOf(shapeInfo);
+            int *arrayStride = shape::stride(shapeInfo);
+            for (int i = group.rank - 1, j = rank - 1; i >= 0; i--, j--) {
+                if (broadcastArray)
+                    view.strides[i] = j < 0 || arrayShape[j] == 1 ? 0 : arrayStride[j];
+                else
+                    view.strides[i] = arrayStride[i];
+            }
+
+            //c order with a constant step is walked without coordinates
+            view.step = 0;
+            for (int i = group.rank - 1; i >= 0; i--) {
+                if (group.shape[i] > 1) {
+                    view.step = view.strides[i];
+                    break;
+                }
+            }
+            view.linear = true;
+            Nd4jIndex cStride = 1;
+            for (int i = group.rank - 1; i >= 0; i--) {
+                if (group.shape[i] > 1 && view.strides[i] != view.step * cStride)
+                    view.linear = false;
+                cStride *= group.shape[i];
+            }
+            return view;
+        }
+
+        /**
+         * Calls func(k, offset) for elements [start, start + count)
+         * of the c order traversal of the group shape
+         */
+        template<typename Functor>
+        static inline void walk(Group &group, View &view, Nd4jIndex start, int count, Functor func) {
+            if (view.linear) {
+                for (int k = 0; k < count; k++)
+                    func(k, (start + k) * view.step);
+                return;
+            }
+
+            int coord[MAX_RANK];
+            Nd4jIndex offset = 0;
+            Nd4jIndex rest = start;
+            for (int i = group.rank - 1; i >= 0; i--) {
+                coord[i] = (int) (rest % group.shape[i]);
+                rest /= group.shape[i];
+                offset += coord[i] * view.strides[i];
+            }
+
+            for (int k = 0; k < count; k++) {
+                func(k, offset);
+                int i = group.rank - 1;
+                coord[i]++;
+                offset += view.strides[i];
+                while (i > 0 && coord[i] == group.shape[i]) {
+                    offset -= group.shape[i] * view.strides[i];
+                    coord[i] = 0;
+                    i--;
+                    coord[i]++;
+                    offset += view.strides[i];
+                }
+            }
+        }
+
+        void execGroup(Group &group) {
+            int numNodes = (int) group.nodes.size();
+            int numExternals = (int) group.externals.size();
+
+            std::vector<View> externalViews;
+            for (int e = 0; e < numExternals; e++) {
+                Node &value = nodes[group.externals[e]];
+                externalViews.push_back(viewOf(group, value.buffer, value.shapeInfo, group.externalBroadcast[e]));
+            }
+
+            //tile slots: one per node of the group, then one per external
+            std::vector<int> xSlots(numNodes), ySlots(numNodes);
+            std::vector<View> outputViews(numNodes);
+            std::vector<int> reductions;
+            for (int n = 0; n < numNodes; n++) {
+                Node &node = nodes[group.nodes[n]];
+                xSlots[n] = slotOf(group, node.x, false);
+                ySlots[n] = node.y >= 0 ? slotOf(group, node.y, node.kind == BROADCAST) : -1;
+                if (node.kind == REDUCE)
+                    reductions.push_back(n);
+                else if (node.materialize)
+                    outputViews[n] = viewOf(group, node.buffer, node.shapeInfo, false);
+            }
+
+            Nd4jIndex numTiles = (group.length + TILE - 1) / TILE;
+            int threads = group.length >= 8000 ? omp_get_max_threads() : 1;
+            int numReductions = (int) reductions.size();
+            std::vector<T> partials(threads * (numReductions > 0 ? numReductions : 1));
+            std::vector<char> started(threads * (numReductions > 0 ? numReductions : 1), 0);
+
+#pragma omp parallel num_threads(threads)
+            {
+                int tid = omp_get_thread_num();
+                std::vector<T> tiles((numNodes + numExternals) * TILE);
+                Nd4jIndex firstTile, lastTile;
+                RawIterPlan::splitRange(numTiles, tid, omp_get_num_threads(), &firstTile, &lastTile);
+
+                for (Nd4jIndex t = firstTile; t < lastTile; t++) {
+                    Nd4jIndex start = t * TILE;
+                    int count = (int) (group.length - start < TILE ? group.length - start : TILE);
+
+                    for (int e = 0; e < numExternals; e++) {
+                        T *tile = &tiles[(numNodes + e) * TILE];
+                        T *buffer = externalViews[e].buffer;
+                        walk(group, externalViews[e], start, count, [&](int k, Nd4jIndex offset) {
+                            tile[k] = buffer[offset];
+                        });
+                    }
+
+                    int r = 0;
+                    for (int n = 0; n < numNodes; n++) {
+                        Node &node = nodes[group.nodes[n]];
+                        T *out = &tiles[n * TILE];
+                        T *x = &tiles[xSlots[n] * TILE];
+                        T *y = ySlots[n] >= 0 ? &tiles[ySlots[n] * TILE] : nullptr;
+                        switch (node.kind) {
+                            case TRANSFORM:
+                                for (int k = 0; k < count; k++)
+                                    out[k] = node.transform->op(x[k], node.extraParams);
+                                break;
+                            case SCALAR:
+                                for (int k = 0; k < count; k++)
+                                    out[k] = node.scalarTransform->op(x[k], node.scalar, node.extraParams);
+                                break;
+                            case PAIRWISE:
+                                for (int k = 0; k < count; k++)
+                                    out[k] = node.pairwise->op(x[k], y[k], node.extraParams);
+                                break;
+                            case BROADCAST:
+                                for (int k = 0; k < count; k++)
+                                    out[k] = node.broadcast->op(x[k], y[k]);
+                                break;
+                            case REDUCE: {
+                                int index = tid * numReductions + r;
+                                T local = started[index] ? partials[index] : node.reduce->startingValue(x);
+                                for (int k = 0; k < count; k++)
+                                    local = node.reduce->update(local, node.reduce->op(x[k], node.extraParams), node.extraParams);
+                                partials[index] = local;
+                                started[index] = 1;
+                                r++;
+                            }
+                                break;
+                            default:
+                                break;
+                        }
+
+                        if (node.kind != REDUCE && node.materialize) {
+                            T *buffer = outputViews[n].buffer;
+                            walk(group, outputViews[n], start, count, [&](int k, Nd4jIndex offset) {
+                                buffer[offset] = out[k];
+                            });
+                        }
+                    }
+                }
+            }
+
+            for (int r = 0; r < numReductions; r++) {
+                Node &node = nodes[group.nodes[reductions[r]]];
+                bool any = false;
+                T reduction = 0;
+                for (int tid = 0; tid < threads; tid++) {
+                    int index = tid * numReductions + r;
+                    if (!started[index])
+                        continue;
+                    reduction = any ? node.reduce->update(reduction, partials[index], node.extraParams) : partials[index];
+                    any = true;
+                }
+                node.buffer[0] = node.reduce->postProcess(reduction, group.length, node.extraParams);
+            }
+        }
+
+        //the tile slot of an operand of a node of the group
+        int slotOf(Group &group, int value, bool broadcastOperand) {
+            for (size_t n = 0; n < group.nodes.size(); n++)
+                if (group.nodes[n] == value)
+                    return (int) n;
+            for (size_t e = 0; e < group.externals.size(); e++)
+                if (group.externals[e] == value && group.externalBroadcast[e] == broadcastOperand)
+                    return (int) (group.nodes.size() + e);
+            return -1;
+        }
+
+        void execSpecial(Node &node) {
+            Node &x = nodes[node.x];
+            if (node.kind == TRANSFORM)
+                node.transform->exec(x.buffer, x.shapeInfo, node.buffer, node.shapeInfo, node.extraParams);
+            else if (node.kind == PAIRWISE) {
+                Node &y = nodes[node.y];
+                node.pairwise->exec(x.buffer, x.shapeInfo, y.buffer, y.shapeInfo, node.buffer, node.shapeInfo, node.extraParams);
+            }
+        }
+    };
+}
+
+#endif /* OPGRAPH_H_ */
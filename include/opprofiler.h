@@ -0,0 +1,277 @@
+/*
+ * opprofiler.h
+ *
+ * Per op counters for finding the hot ops of a running
+ * process without attaching a native profiler.
+ *
+ * Calls are counted per (op family, op number, data type):
+ * how many, their total, shortest and longest wall time, the
+ * elements of their input and the bytes of every array they
+ * read or write. Counting is off until setEnabled(true); while
+ * it and OpTrace are off an op pays two relaxed atomic loads.
+ */
+
+#ifndef OPPROFILER_H_
+#define OPPROFILER_H_
+#include <pointercast.h>
+#include <opfamily.h>
+#include <optrace.h>
+#include <shape.h>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace nd4j {
+
+    /**
+     * The counters of one (family, op number, data type)
+     */
+    struct OpStats {
+        int family;
+        int opNum;
+        int dataType;
+        Nd4jIndex calls;
+        Nd4jIndex totalNanos;
+        Nd4jIndex minNanos;
+        Nd4jIndex maxNanos;
+        Nd4jIndex elements;
+        Nd4jIndex bytes;
+    };
+
+    class OpProfiler {
+    public:
+        static const int MAX_OPS = 64;
+        static const int DATA_TYPES = 2;
+
+        static OpProfiler *getInstance() {
+            static OpProfiler *instance = new OpProfiler();
+            return instance;
+        }
+
+        static bool isEnabled() {
+            return enabledFlag().load(std::memory_order_relaxed);
+        }
+
+        static void setEnabled(bool reallyEnable) {
+            enabledFlag().store(reallyEnable);
+        }
+
+        /**
+         * Counts one call; ops numbered outside [0, MAX_OPS) are dropped
+         */
+        void record(int family, int opNum, int dataType, Nd4jIndex nanos, Nd4jIndex elements, Nd4jIndex bytes) {
+            if (family < 0 || family >= OP_FAMILIES || opNum < 0 || opNum >= MAX_OPS || dataType < 0 || dataType >= DATA_TYPES)
+                return;
+            Counters &counters = table[family][dataType][opNum];
+            counters.calls.fetch_add(1, std::memory_order_relaxed);
+            counters.totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+            counters.elements.fetch_add(elements, std::memory_order_relaxed);
+            counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            Nd4jIndex seen = counters.minNanos.load(std::memory_order_relaxed);
+            while (nanos < seen && !counters.minNanos.compare_exchange_weak(seen, nanos, std::memory_order_relaxed));
+            seen = counters.maxNanos.load(std::memory_order_relaxed);
+            while (nanos > seen && !counters.maxNanos.compare_exchange_weak(seen, nanos, std::memory_order_relaxed));
+        }
+
+        /**
+         * Zeroes every counter. Calls finishing while
+         * this runs may be partly kept.
+         */
+        void reset() {
+            for (int family = 0; family < OP_FAMILIES; family++)
+                for (int dataType = 0; dataType < DATA_TYPES; dataType++)
+                    for (int opNum = 0; opNum < MAX_OPS; opNum++)
+                        table[family][dataType][opNum].clear();
+        }
+
+        /**
+         * The counters of every op called at least
+         * once, the most total time first
+         */
+        std::vector<OpStats> snapshot() {
+            std::vector<OpStats> stats;
+            for (int family = 0; family < OP_FAMILIES; family++) {
+                for (int dataType = 0; dataType < DATA_TYPES; dataType++) {
+                    for (int opNum = 0; opNum < MAX_OPS; opNum++) {
+                        Counters &counters = table[family][dataType][opNum];
+                        Nd4jIndex calls = counters.calls.load(std::memory_order_relaxed);
+                        if (calls == 0)
+                            continue;
+                        OpStats entry;
+                        entry.family = family;
+                        entry.opNum = opNum;
+                        entry.dataType = dataType;
+                        entry.calls = calls;
+                        entry.totalNanos = counters.totalNanos.load(std::memory_order_relaxed);
+                        entry.minNanos = counters.minNanos.load(std::memory_order_relaxed);
+                        entry.maxNanos = counters.maxNanos.load(std::memory_order_relaxed);
+                        entry.elements = counters.elements.load(std::memory_order_relaxed);
+                        entry.bytes = counters.bytes.load(std::memory_order_relaxed);
+                        stats.push_back(entry);
+                    }
+                }
+            }
+            std::stable_sort(stats.begin(), stats.end(), [](const OpStats &a, const OpStats &b) {
+                return a.totalNanos > b.totalNanos;
+            });
+            return stats;
+        }
+
+        /**
+         * The counters as a table, one op per line, times in microseconds
+         */
+        std::string toText() {
+            std::string text;
+            char line[256];
+            std::snprintf(line, sizeof(line), "%-18s %5s %-6s %10s %14s %12s %12s %12s %14s %16s\n",
+                          "family", "op", "type", "calls", "total us", "mean us", "min us", "max us", "elements", "bytes");
+            text += line;
+            std::vector<OpStats> stats = snapshot();
+            for (size_t i = 0; i < stats.size(); i++) {
+                const OpStats &entry = stats[i];
+                std::snprintf(line, sizeof(line), "%-18s %5d %-6s %10lld %14.1f %12.1f %12.1f %12.1f %14lld %16lld\n",
+                              opFamilyName(entry.family), entry.opNum, dataTypeName(entry.dataType),
+                              (long long) entry.calls,
+                              entry.totalNanos / 1e3,
+                              entry.totalNanos / 1e3 / entry.calls,
+                              entry.minNanos / 1e3,
+                              entry.maxNanos / 1e3,
+                              (long long) entry.elements,
+                              (long long) entry.bytes);
+                text += line;
+            }
+            return text;
+        }
+
+        /**
+         * The counters as a JSON array of objects, times in nanoseconds
+         */
+        std::string toJson() {
+            std::string json = "[";
+            char entryText[512];
+            std::vector<OpStats> stats = snapshot();
+            for (size_t i = 0; i < stats.size(); i++) {
+                const OpStats &entry = stats[i];
+                std::snprintf(entryText, sizeof(entryText),
+                              "%s{\"family\":\"%s\",\"opNum\":%d,\"dtype\":\"%s\",\"calls\":%lld,\"totalNanos\":%lld,"
+                              "\"minNanos\":%lld,\"maxNanos\":%lld,\"elements\":%lld,\"bytes\":%lld}",
+                              i == 0 ? "" : ",",
+                              opFamilyName(entry.family), entry.opNum, dataTypeName(entry.dataType),
+                              (long long) entry.calls,
+                              (long long) entry.totalNanos,
+                              (long long) entry.minNanos,
+                              (long long) entry.maxNanos,
+                              (long long) entry.elements,
+                              (long long) entry.bytes);
+                json += entryText;
+            }
+            json += "]";
+            return json;
+        }
+
+    private:
+        struct Counters {
+            std::atomic<Nd4jIndex> calls;
+            std::atomic<Nd4jIndex> totalNanos;
+            std::atomic<Nd4jIndex> minNanos;
+            std::atomic<Nd4jIndex> maxNanos;
+            std::atomic<Nd4jIndex> elements;
+            std::atomic<Nd4jIndex> bytes;
+
+            Counters() {
+                clear();
+            }
+
+            void clear() {
+                calls.store(0);
+                totalNanos.store(0);
+                minNanos.store(Nd4jIndex(~0ULL >> 1));
+                maxNanos.store(0);
+                elements.store(0);
+                bytes.store(0);
+            }
+        };
+
+        Counters table[OP_FAMILIES][DATA_TYPES][MAX_OPS];
+
+        OpProfiler() {}
+        OpProfiler(const OpProfiler &other);
+        OpProfiler &operator=(const OpProfiler &other);
+
+        static std::atomic<bool> &enabledFlag() {
+            static std::atomic<bool> enabled(false);
+            return enabled;
+        }
+    };
+
+    /**
+     * Times the enclosing op call and counts it on exit, when
+     * profiling is enabled, and adds its begin and end events
+     * to the OpTrace, when tracing is
+     */
+    template<typename T>
+    class OpProfileScope {
+    public:
+        /**
+         * For an op over arrays described by shape information (z is the
+         * third input of ternary ops); elements are those of x, bytes
+         * those of every array given
+         */
+        OpProfileScope(int family, int opNum, int *xShapeInfo, int *yShapeInfo = nullptr, int *resultShapeInfo = nullptr, int *zShapeInfo = nullptr)
+                : profiling(OpProfiler::isEnabled()), tracing(OpTrace::isEnabled()), family(family), opNum(opNum) {
+            if (tracing)
+                OpTrace::getInstance()->begin(family, opNum, DataTypeOf<T>::index, xShapeInfo);
+            if (!profiling)
+                return;
+            elements = lengthOf(xShapeInfo);
+            bytes = (Nd4jIndex) sizeof(T) * (elements + lengthOf(yShapeInfo) + lengthOf(resultShapeInfo) + lengthOf(zShapeInfo));
+            start = std::chrono::steady_clock::now();
+        }
+
+        /**
+         * For a strided op over length elements of each of arrays arrays
+         */
+        OpProfileScope(int family, int opNum, Nd4jIndex length, int arrays)
+                : profiling(OpProfiler::isEnabled()), tracing(OpTrace::isEnabled()), family(family), opNum(opNum) {
+            if (tracing)
+                OpTrace::getInstance()->begin(family, opNum, DataTypeOf<T>::index, length);
+            if (!profiling)
+                return;
+            elements = length;
+            bytes = (Nd4jIndex) sizeof(T) * length * arrays;
+            start = std::chrono::steady_clock::now();
+        }
+
+        ~OpProfileScope() {
+            if (profiling) {
+                Nd4jIndex nanos = (Nd4jIndex) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+                OpProfiler::getInstance()->record(family, opNum, DataTypeOf<T>::index, nanos, elements, bytes);
+            }
+            if (tracing)
+                OpTrace::getInstance()->end(family, opNum, DataTypeOf<T>::index);
+        }
+
+    private:
+        bool profiling;
+        //kept for the end event even if tracing is turned off meanwhile
+        bool tracing;
+        int family;
+        int opNum;
+        Nd4jIndex elements = 0;
+        Nd4jIndex bytes = 0;
+        std::chrono::steady_clock::time_point start;
+
+        OpProfileScope(const OpProfileScope &other);
+        OpProfileScope &operator=(const OpProfileScope &other);
+
+        static Nd4jIndex lengthOf(int *shapeInfo) {
+            return shapeInfo == nullptr ? 0 : (Nd4jIndex) shape::length(shapeInfo);
+        }
+    };
+}
+
+#endif /* OPPROFILER_H_ */
@@ -0,0 +1,265 @@
+/*
+ * optrace.h
+ *
+ * A timeline of native op calls, for seeing how the ops of
+ * different calling threads interleave and where a slow call
+ * spent its time.
+ *
+ * Each op call adds a begin and an end event to a fixed ring
+ * of CAPACITY events; once full, the oldest are overwritten.
+ * An event holds its time, the calling thread, the op family,
+ * number and data type, the OpenMP thread budget of the call
+ * and a summary of its shape. Adding one is an atomic increment
+ * and a few stores, and nothing is added while tracing is off.
+ *
+ * toChromeTrace writes what the ring holds in the Chrome trace
+ * event format, for chrome://tracing or Perfetto.
+ */
+
+#ifndef OPTRACE_H_
+#define OPTRACE_H_
+#include <pointercast.h>
+#include <opfamily.h>
+#include <shape.h>
+#include <omp.h>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace nd4j {
+
+    class OpTrace {
+    public:
+        //a power of 2
+        static const int CAPACITY = 1 << 16;
+        //the dimensions kept of an op's shape
+        static const int MAX_DIMS = 4;
+
+        static OpTrace *getInstance() {
+            static OpTrace *instance = new OpTrace();
+            return instance;
+        }
+
+        static bool isEnabled() {
+            return enabledFlag().load(std::memory_order_relaxed);
+        }
+
+        static void setEnabled(bool reallyEnable) {
+            enabledFlag().store(reallyEnable);
+        }
+
+        /**
+         * Adds the begin event of an op over an array
+         * described by shapeInfo (may be null)
+         */
+        void begin(int family, int opNum, int dataType, int *shapeInfo) {
+            Nd4jIndex claimed = claim();
+            Event &event = fill(claimed, 'B', family, opNum, dataType);
+            if (shapeInfo != nullptr) {
+                event.rank = shape::rank(shapeInfo);
+                int *shape = shape::shapeOf(shapeInfo);
+                for (int i = 0; i < event.rank && i < MAX_DIMS; i++)
+                    event.dims[i] = shape[i];
+            }
+            publish(event, claimed);
+        }
+
+        /**
+         * Adds the begin event of a strided op over length elements
+         */
+        void begin(int family, int opNum, int dataType, Nd4jIndex length) {
+            Nd4jIndex claimed = claim();
+            Event &event = fill(claimed, 'B', family, opNum, dataType);
+            event.rank = 1;
+            event.dims[0] = (int) length;
+            publish(event, claimed);
+        }
+
+        void end(int family, int opNum, int dataType) {
+            Nd4jIndex claimed = claim();
+            publish(fill(claimed, 'E', family, opNum, dataType), claimed);
+        }
+
+        /**
+         * Drops every event. Ops running while this
+         * runs may leave half their events behind.
+         */
+        void clear() {
+            for (int i = 0; i < CAPACITY; i++)
+                events[i].sequence.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * The events in the ring as a Chrome trace, oldest first.
+         * An end whose begin was overwritten is left out.
+         */
+        std::string toChromeTrace() {
+            std::vector<Event> held;
+            for (int i = 0; i < CAPACITY; i++) {
+                Event copy;
+                if (read(events[i], copy))
+                    held.push_back(copy);
+            }
+            std::sort(held.begin(), held.end(), [](const Event &a, const Event &b) {
+                return a.sequence.load(std::memory_order_relaxed) < b.sequence.load(std::memory_order_relaxed);
+            });
+
+            std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+            std::map<int, int> open;
+            char text[512];
+            bool first = true;
+            for (size_t i = 0; i < held.size(); i++) {
+                const Event &event = held[i];
+                if (event.phase == 'E') {
+                    if (open[event.thread] == 0)
+                        continue;
+                    open[event.thread]--;
+                    std::snprintf(text, sizeof(text),
+                                  "%s{\"name\":\"%s %d\",\"cat\":\"%s\",\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                                  first ? "" : ",",
+                                  opFamilyName(event.family), event.opNum, opFamilyName(event.family),
+                                  event.nanos / 1e3, event.thread);
+                } else {
+                    open[event.thread]++;
+                    std::snprintf(text, sizeof(text),
+                                  "%s{\"name\":\"%s %d\",\"cat\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,"
+                                  "\"args\":{\"dtype\":\"%s\",\"shape\":\"%s\",\"threads\":%d}}",
+                                  first ? "" : ",",
+                                  opFamilyName(event.family), event.opNum, opFamilyName(event.family),
+                                  event.nanos / 1e3, event.thread,
+                                  dataTypeName(event.dataType), shapeSummary(event).c_str(), event.threads);
+                }
+                json += text;
+                first = false;
+            }
+            json += "]}";
+            return json;
+        }
+
+        /**
+         * A small number naming the calling thread, the same for
+         * every event it adds; 1 for the first thread to ask
+         */
+        static int threadId() {
+            static std::atomic<int> threads(0);
+            static thread_local int id = ++threads;
+            return id;
+        }
+
+    private:
+        struct Event {
+            //1 + the number of the claim that wrote it, 0 while empty or being written
+            std::atomic<Nd4jIndex> sequence;
+            Nd4jIndex nanos;
+            int thread;
+            int threads;
+            int family;
+            int opNum;
+            int dataType;
+            int rank;
+            int dims[MAX_DIMS];
+            char phase;
+
+            Event() : sequence(0) {}
+
+            Event(const Event &other) : sequence(other.sequence.load(std::memory_order_relaxed)) {
+                copyFields(other);
+            }
+
+            Event &operator=(const Event &other) {
+                sequence.store(other.sequence.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                copyFields(other);
+                return *this;
+            }
+
+            void copyFields(const Event &other) {
+                nanos = other.nanos;
+                thread = other.thread;
+                threads = other.threads;
+                family = other.family;
+                opNum = other.opNum;
+                dataType = other.dataType;
+                rank = other.rank;
+                for (int i = 0; i < MAX_DIMS; i++)
+                    dims[i] = other.dims[i];
+                phase = other.phase;
+            }
+        };
+
+        Event *events;
+        std::atomic<Nd4jIndex> claims;
+        std::chrono::steady_clock::time_point epoch;
+
+        OpTrace() : events(new Event[CAPACITY]), claims(0), epoch(std::chrono::steady_clock::now()) {}
+        OpTrace(const OpTrace &other);
+        OpTrace &operator=(const OpTrace &other);
+
+        static std::atomic<bool> &enabledFlag() {
+            static std::atomic<bool> enabled(false);
+            return enabled;
+        }
+
+        /**
+         * Takes the next slot of the ring and marks it as being written
+         */
+        Nd4jIndex claim() {
+            Nd4jIndex claimed = claims.fetch_add(1, std::memory_order_relaxed);
+            events[claimed & (CAPACITY - 1)].sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            return claimed;
+        }
+
+        Event &fill(Nd4jIndex claimed, char phase, int family, int opNum, int dataType) {
+            Event &event = events[claimed & (CAPACITY - 1)];
+            event.phase = phase;
+            event.family = family;
+            event.opNum = opNum;
+            event.dataType = dataType;
+            event.thread = threadId();
+            event.threads = omp_get_max_threads();
+            event.rank = 0;
+            event.nanos = (Nd4jIndex) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - epoch).count();
+            return event;
+        }
+
+        void publish(Event &event, Nd4jIndex claimed) {
+            event.sequence.store(claimed + 1, std::memory_order_release);
+        }
+
+        /**
+         * Copies a published event, false if the slot is
+         * empty or was being written while it was copied
+         */
+        static bool read(const Event &event, Event &copy) {
+            Nd4jIndex before = event.sequence.load(std::memory_order_acquire);
+            if (before == 0)
+                return false;
+            copy.copyFields(event);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (event.sequence.load(std::memory_order_relaxed) != before)
+                return false;
+            copy.sequence.store(before, std::memory_order_relaxed);
+            return true;
+        }
+
+        static std::string shapeSummary(const Event &event) {
+            std::string summary = "[";
+            char dim[16];
+            for (int i = 0; i < event.rank && i < MAX_DIMS; i++) {
+                std::snprintf(dim, sizeof(dim), "%s%d", i == 0 ? "" : ",", event.dims[i]);
+                summary += dim;
+            }
+            if (event.rank > MAX_DIMS)
+                summary += ",...";
+            summary += "]";
+            return summary;
+        }
+    };
+}
+
+#endif /* OPTRACE_H_ */
@@ -16,6 +16,8 @@
 #include <helper_cuda.h>
 #include <shape.h>
 #include <pairwise_util.h>
+#include <rawiterplan.h>
+#include <threadpool.h>
 #include <dll.h>
 #include <stdio.h>
 
@@ -35,6 +37,14 @@ namespace functions {
         protected:
             bool requiresSpecial = false;
         public:
+            /**
+             * Whether the op is not elementwise
+             * and has to run through its own exec
+             */
+            bool isSpecial() {
+                return requiresSpecial;
+            }
+
             virtual
 #ifdef __CUDACC__
             inline __host__ __device__
@@ -451,109 +461,250 @@ namespace functions {
                 }
 
                 else if (sameShape) {
-                    int rank = shape::rank(xShapeBuffer);
-                    int *xShape = shape::shapeOf(xShapeBuffer);
-
-                    int *xStride = shape::stride(xShapeBuffer);
-                    int *yStride = shape::stride(yShapeBuffer);
-                    int *resultStride = shape::stride(resultShapeBuffer);
-
-                    int shapeIter[MAX_RANK];
-                    int coord[MAX_RANK];
-                    int dim;
-                    int xStridesIter[MAX_RANK];
-                    int yStridesIter[MAX_RANK];
-                    int resultStridesIter[MAX_RANK];
-                    if (PrepareThreeRawArrayIter<T>(rank,
-                                                    xShape,
-                                                    dx,
-                                                    xStride,
-                                                    y,
-                                                    yStride,
-                                                    result,
-                                                    resultStride,
-                                                    rank,
-                                                    shapeIter,
-                                                    &dx,
-                                                    xStridesIter,
-                                                    &y,
-                                                    yStridesIter,
-                                                    &result,
-                                                    resultStridesIter) >= 0) {
-                        ND4J_RAW_ITER_START(dim, rank, coord, shapeIter); {
-                                /* Process the innermost dimension */
-                                T *xIter = dx;
-                                T *yIter = y;
-                                T *resultIter = result;
-                                resultIter[0] = op(xIter[0], yIter[0], extraParams);
-                            }
-                        ND4J_RAW_ITER_THREE_NEXT(dim,
-                                                 rank,
-                                                 coord,
-                                                 shapeIter,
-                                                 dx,
-                                                 xStridesIter,
-                                                 y,
-                                                 yStridesIter,
-                                                 result,
-                                                 resultStridesIter);
-                    }
-                    else {
-                        printf("Unable to prepare array\n");
-                    }
-
+                    execTiled(dx,
+                              xShapeBuffer,
+                              y,
+                              yShapeBuffer,
+                              result,
+                              resultShapeBuffer,
+                              extraParams);
                 }
 
                 else {
-                    Nd4jIndex len = shape::length(xShapeBuffer);
+                    //the operands pair up by their c order index; when y and the
+                    //result can be viewed under the shape of x without a copy,
+                    //one plan walks all three in parallel
                     int xRank = shape::rank(xShapeBuffer);
-                    int yRank = shape::rank(yShapeBuffer);
-                    int resultRank = shape::rank(resultShapeBuffer);
-                    int *xCoord = new int[xRank];
-                    int *yCoord = new int[yRank];
-                    int *resultCoord = new int[resultRank];
-
                     int *xShape = shape::shapeOf(xShapeBuffer);
-                    int *xStride = shape::stride(xShapeBuffer);
-
-                    int *yShape = shape::shapeOf(yShapeBuffer);
-                    int *yStride = shape::stride(yShapeBuffer);
+                    int yView[MAX_RANK * 2 + 4];
+                    int resultView[MAX_RANK * 2 + 4];
+                    //no views when even c strides of the shape of x would overflow
+                    bool viewable = shape::shapeBuffer(xRank, xShape, yView) != nullptr &&
+                                    shape::shapeBuffer(xRank, xShape, resultView) != nullptr;
+                    viewable = viewable && ReshapeStridesC(shape::rank(yShapeBuffer), shape::shapeOf(yShapeBuffer),
+                                                    shape::stride(yShapeBuffer), xRank, xShape,
+                                                    shape::stride(yView)) == 0;
+                    if (viewable && dx == result) {
+                        int *xStride = shape::stride(xShapeBuffer);
+                        for (int i = 0; i < xRank; i++)
+                            shape::stride(resultView)[i] = xStride[i];
+                    }
+                    else if (viewable) {
+                        viewable = ReshapeStridesC(shape::rank(resultShapeBuffer), shape::shapeOf(resultShapeBuffer),
+                                                   shape::stride(resultShapeBuffer), xRank, xShape,
+                                                   shape::stride(resultView)) == 0;
+                    }
 
-                    int *resultShape = shape::shapeOf(resultShapeBuffer);
-                    if(dx == result) {
-                        for (Nd4jIndex i = 0; i < len; i++) {
-                            shape::ind2subC(xRank,xShape, i, xCoord);
-                            shape::ind2subC(yRank,yShape, i, yCoord);
-                            shape::ind2subC(resultRank,resultShape, i, resultCoord);
+                    if (viewable) {
+                        RawIterPlan plan(xShapeBuffer, yView, resultView);
+                        const Nd4jIndex xInner = plan.strides[0][0];
+                        const Nd4jIndex yInner = plan.strides[1][0];
+                        const Nd4jIndex resultInner = plan.strides[2][0];
+                        auto kernel = [&](Nd4jIndex *offsets, Nd4jIndex count) {
+                            T *xIter = dx + offsets[0];
+                            T *yIter = y + offsets[1];
+                            T *resultIter = result + offsets[2];
+                            for (Nd4jIndex i = 0; i < count; i++) {
+                                resultIter[i * resultInner] = op(xIter[i * xInner], yIter[i * yInner], extraParams);
+                            }
+                        };
+                        plan.runParallel(kernel);
+                        return;
+                    }
 
-                            Nd4jIndex xOffset = shape::getOffset(0, xShape, xStride, xCoord, xRank);
-                            Nd4jIndex yOffset = shape::getOffset(0, yShape, yStride, yCoord, yRank);
-                            result[xOffset] = op(dx[xOffset], y[yOffset], extraParams);
+                    execByIndex(dx, xShapeBuffer, y, yShapeBuffer, result, resultShapeBuffer, extraParams);
+                }
+            }
 
+            /**
+             * CPU execution for operands of different shapes,
+             * paired by their c order index, that cannot all be
+             * viewed under one shape; every element works out its
+             * own offsets, so ranges of indexes run in parallel
+             * @param dx the input data
+             * @param xShapeBuffer the shape information for x
+             * @param y the y data
+             * @param yShapeBuffer the shape information for y
+             * @param result the buffer to store the result in
+             * @param resultShapeBuffer the shape information for the result
+             * @param extraParams the extra parameters for the transform
+             */
+            void execByIndex(
+                    T *dx,
+                    int *xShapeBuffer,
+                    T *y,
+                    int *yShapeBuffer,
+                    T *result,
+                    int *resultShapeBuffer,
+                    T *extraParams) {
+                Nd4jIndex len = shape::length(xShapeBuffer);
+                int xRank = shape::rank(xShapeBuffer);
+                int yRank = shape::rank(yShapeBuffer);
+                int resultRank = shape::rank(resultShapeBuffer);
+
+                int *xShape = shape::shapeOf(xShapeBuffer);
+                int *xStride = shape::stride(xShapeBuffer);
+
+                int *yShape = shape::shapeOf(yShapeBuffer);
+                int *yStride = shape::stride(yShapeBuffer);
+
+                //in place, the result is laid out like x
+                bool inPlace = dx == result;
+                int *resultShape = shape::shapeOf(resultShapeBuffer);
+                int *resultStride = shape::stride(resultShapeBuffer);
+
+                nd4j::parallelFor(0, len, nd4j::ELEMENT_GRAIN, [&](Nd4jIndex start, Nd4jIndex end) {
+                    int xCoord[MAX_RANK];
+                    int yCoord[MAX_RANK];
+                    int resultCoord[MAX_RANK];
+                    for (Nd4jIndex i = start; i < end; i++) {
+                        shape::ind2subC(xRank, xShape, i, xCoord);
+                        shape::ind2subC(yRank, yShape, i, yCoord);
+
+                        Nd4jIndex xOffset = shape::getOffset(0, xShape, xStride, xCoord, xRank);
+                        Nd4jIndex yOffset = shape::getOffset(0, yShape, yStride, yCoord, yRank);
+                        Nd4jIndex resultOffset = xOffset;
+                        if (!inPlace) {
+                            shape::ind2subC(resultRank, resultShape, i, resultCoord);
+                            resultOffset = shape::getOffset(0, resultShape, resultStride, resultCoord, resultRank);
                         }
+                        result[resultOffset] = op(dx[xOffset], y[yOffset], extraParams);
                     }
-                    else {
-                        for (Nd4jIndex i = 0; i < len; i++) {
-                            shape::ind2subC(xRank,xShape, i, xCoord);
-                            shape::ind2subC(yRank,yShape, i, yCoord);
-                            shape::ind2subC(resultRank,resultShape, i, resultCoord);
+                });
+            }
 
-                            Nd4jIndex xOffset = shape::getOffset(0, xShape, xStride, xCoord, xRank);
-                            Nd4jIndex yOffset = shape::getOffset(0, yShape, yStride, yCoord, yRank);
-                            Nd4jIndex resultOffset = shape::getOffset(0, resultShape, resultShape, resultCoord, resultRank);
-                            result[resultOffset] = op(dx[xOffset], y[yOffset], extraParams);
+            /**
+             * CPU execution for same shaped operands
+             * whose layouts disagree (mixed c/f orders,
+             * views, transposes).
+             *
+             * The axis that is fastest for the result and the
+             * axis that is fastest for x (or y) are blocked in to
+             * square tiles, like a transpose, so every operand is
+             * read and written in cache sized pieces; the tiles
+             * (times every combination of the remaining axes)
+             * are spread over threads.
+             * @param dx the input data
+             * @param xShapeBuffer the shape information for x
+             * @param y the y data
+             * @param yShapeBuffer the shape information for y
+             * @param result the buffer to store the result in
+             * @param resultShapeBuffer the shape information for the result
+             * @param extraParams the extra parameters for the transform
+             */
+            void execTiled(
+                    T *dx,
+                    int *xShapeBuffer,
+                    T *y,
+                    int *yShapeBuffer,
+                    T *result,
+                    int *resultShapeBuffer,
+                    T *extraParams) {
+                const int tileSize = 32;
+                int rank = shape::rank(xShapeBuffer);
+                int *xShape = shape::shapeOf(xShapeBuffer);
+                int *xStride = shape::stride(xShapeBuffer);
+                int *yStride = shape::stride(yShapeBuffer);
+                int *resultStride = shape::stride(resultShapeBuffer);
+
+                //drop length 1 axes
+                int iterShape[MAX_RANK];
+                int xStridesIter[MAX_RANK];
+                int yStridesIter[MAX_RANK];
+                int resultStridesIter[MAX_RANK];
+                int ndim = 0;
+                for (int i = 0; i < rank; i++) {
+                    if (xShape[i] == 0)
+                        return;
+                    if (xShape[i] == 1)
+                        continue;
+                    iterShape[ndim] = xShape[i];
+                    xStridesIter[ndim] = xStride[i];
+                    yStridesIter[ndim] = yStride[i];
+                    resultStridesIter[ndim] = resultStride[i];
+                    ndim++;
+                }
+
+                if (ndim == 0) {
+                    result[0] = op(dx[0], y[0], extraParams);
+                    return;
+                }
 
-                        }
+                //the axis each operand walks fastest along
+                int resultAxis = 0;
+                int xAxis = 0;
+                int yAxis = 0;
+                for (int i = 1; i < ndim; i++) {
+                    if (nd4j::math::nd4j_abs<int>(resultStridesIter[i]) < nd4j::math::nd4j_abs<int>(resultStridesIter[resultAxis]))
+                        resultAxis = i;
+                    if (nd4j::math::nd4j_abs<int>(xStridesIter[i]) < nd4j::math::nd4j_abs<int>(xStridesIter[xAxis]))
+                        xAxis = i;
+                    if (nd4j::math::nd4j_abs<int>(yStridesIter[i]) < nd4j::math::nd4j_abs<int>(yStridesIter[yAxis]))
+                        yAxis = i;
+                }
+
+                //the second tiled axis: whichever input disagrees with the result
+                int otherAxis = xAxis != resultAxis ? xAxis : yAxis;
+                bool tiled = otherAxis != resultAxis;
+                Nd4jIndex innerLength = iterShape[resultAxis];
+                Nd4jIndex otherLength = tiled ? iterShape[otherAxis] : 1;
+                Nd4jIndex innerTile = tiled ? tileSize : innerLength;
+                Nd4jIndex otherTile = tiled ? tileSize : 1;
+                Nd4jIndex innerTiles = (innerLength + innerTile - 1) / innerTile;
+                Nd4jIndex otherTiles = (otherLength + otherTile - 1) / otherTile;
+
+                //every other axis is iterated as one flat outer index
+                int outerAxes[MAX_RANK];
+                int numOuterAxes = 0;
+                Nd4jIndex outerLength = 1;
+                for (int i = 0; i < ndim; i++) {
+                    if (i == resultAxis || (tiled && i == otherAxis))
+                        continue;
+                    outerAxes[numOuterAxes++] = i;
+                    outerLength *= iterShape[i];
+                }
+
+                Nd4jIndex items = outerLength * otherTiles * innerTiles;
+                Nd4jIndex n = shape::length(xShapeBuffer);
+                int xInner = xStridesIter[resultAxis];
+                int yInner = yStridesIter[resultAxis];
+                int resultInner = resultStridesIter[resultAxis];
+                int xOther = tiled ? xStridesIter[otherAxis] : 0;
+                int yOther = tiled ? yStridesIter[otherAxis] : 0;
+                int resultOther = tiled ? resultStridesIter[otherAxis] : 0;
+
+#pragma omp parallel for schedule(static) if (n >= 8000)
+                for (Nd4jIndex item = 0; item < items; item++) {
+                    Nd4jIndex innerStart = (item % innerTiles) * innerTile;
+                    Nd4jIndex otherStart = ((item / innerTiles) % otherTiles) * otherTile;
+                    Nd4jIndex outer = item / (innerTiles * otherTiles);
+                    Nd4jIndex innerEnd = innerStart + innerTile < innerLength ? innerStart + innerTile : innerLength;
+                    Nd4jIndex otherEnd = otherStart + otherTile < otherLength ? otherStart + otherTile : otherLength;
+
+                    Nd4jIndex xOffset = 0;
+                    Nd4jIndex yOffset = 0;
+                    Nd4jIndex resultOffset = 0;
+                    for (int i = 0; i < numOuterAxes; i++) {
+                        int axis = outerAxes[i];
+                        Nd4jIndex coord = outer % iterShape[axis];
+                        outer /= iterShape[axis];
+                        xOffset += coord * xStridesIter[axis];
+                        yOffset += coord * yStridesIter[axis];
+                        resultOffset += coord * resultStridesIter[axis];
                     }
 
-
-                    delete[] xCoord;
-                    delete[] yCoord;
-                    delete []resultCoord;
+                    for (Nd4jIndex j = otherStart; j < otherEnd; j++) {
+                        T *xIter = dx + xOffset + j * xOther;
+                        T *yIter = y + yOffset + j * yOther;
+                        T *resultIter = result + resultOffset + j * resultOther;
+#pragma omp simd
+                        for (Nd4jIndex i = innerStart; i < innerEnd; i++) {
+                            resultIter[i * resultInner] = op(xIter[i * xInner], yIter[i * yInner], extraParams);
+                        }
+                    }
                 }
             }
 
-
             /**
              * CPU operation execution
              * @param dx the input data
@@ -588,10 +739,12 @@ namespace functions {
 
                     }
                     else {
-#pragma omp parallel for
-                        for (Nd4jIndex i = 0; i < n; i++) {
-                            result[i] = op(dx[i], y[i], extraParams);
-                        }
+                        nd4j::parallelFor(0, n, nd4j::ELEMENT_GRAIN, [&](Nd4jIndex start, Nd4jIndex end) {
+#pragma omp simd
+                            for (Nd4jIndex i = start; i < end; i++) {
+                                result[i] = op(dx[i], y[i], extraParams);
+                            }
+                        });
                     }
 
 
@@ -607,11 +760,13 @@ namespace functions {
                         }
                     }
                     else {
-#pragma omp parallel for
-                        for (Nd4jIndex i = 0; i < n; i++) {
-                            result[i * resultStride] = op(dx[i * xStride],
-                                                          y[i * yStride], extraParams);
-                        }
+                        nd4j::parallelFor(0, n, nd4j::ELEMENT_GRAIN, [&](Nd4jIndex start, Nd4jIndex end) {
+#pragma omp simd
+                            for (Nd4jIndex i = start; i < end; i++) {
+                                result[i * resultStride] = op(dx[i * xStride],
+                                                              y[i * yStride], extraParams);
+                            }
+                        });
                     }
 
 
@@ -146,6 +146,230 @@ void quickSort(StridePermutation *arr, int elements);
 
 
 
+/*
+ * Rank specialized raw iteration.
+ *
+ * RankedRawIter<Dim> walks axes Dim..0 as plain nested loops,
+ * axis 0 innermost (the same order as the ND4J_RAW_ITER macros),
+ * with the per axis extents and strides hoisted out of the loops.
+ * Dim is a template parameter so the nesting is fully unrolled at
+ * compile time; the functor is called with a pointer in to each
+ * operand for every element.
+ */
+template <int Dim>
+struct RankedRawIter {
+    template <typename T, typename Functor>
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    static inline void one(int *shape, T *dataA, int *stridesA, Functor &func) {
+        const int n = shape[Dim];
+        const Nd4jIndex strideA = stridesA[Dim];
+        for (int i = 0; i < n; i++, dataA += strideA)
+            RankedRawIter<Dim - 1>::one(shape, dataA, stridesA, func);
+    }
+
+    template <typename T, typename Functor>
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    static inline void two(int *shape, T *dataA, int *stridesA, T *dataB, int *stridesB, Functor &func) {
+        const int n = shape[Dim];
+        const Nd4jIndex strideA = stridesA[Dim];
+        const Nd4jIndex strideB = stridesB[Dim];
+        for (int i = 0; i < n; i++, dataA += strideA, dataB += strideB)
+            RankedRawIter<Dim - 1>::two(shape, dataA, stridesA, dataB, stridesB, func);
+    }
+
+    template <typename T, typename Functor>
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    static inline void three(int *shape, T *dataA, int *stridesA, T *dataB, int *stridesB, T *dataC, int *stridesC, Functor &func) {
+        const int n = shape[Dim];
+        const Nd4jIndex strideA = stridesA[Dim];
+        const Nd4jIndex strideB = stridesB[Dim];
+        const Nd4jIndex strideC = stridesC[Dim];
+        for (int i = 0; i < n; i++, dataA += strideA, dataB += strideB, dataC += strideC)
+            RankedRawIter<Dim - 1>::three(shape, dataA, stridesA, dataB, stridesB, dataC, stridesC, func);
+    }
+
+    template <typename T, typename Functor>
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    static inline void four(int *shape, T *dataA, int *stridesA, T *dataB, int *stridesB, T *dataC, int *stridesC, T *dataD, int *stridesD, Functor &func) {
+        const int n = shape[Dim];
+        const Nd4jIndex strideA = stridesA[Dim];
+        const Nd4jIndex strideB = stridesB[Dim];
+        const Nd4jIndex strideC = stridesC[Dim];
+        const Nd4jIndex strideD = stridesD[Dim];
+        for (int i = 0; i < n; i++, dataA += strideA, dataB += strideB, dataC += strideC, dataD += strideD)
+            RankedRawIter<Dim - 1>::four(shape, dataA, stridesA, dataB, stridesB, dataC, stridesC, dataD, stridesD, func);
+    }
+};
+
+/* The innermost axis */
+template <>
+struct RankedRawIter<0> {
+    template <typename T, typename Functor>
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    static inline void one(int *shape, T *dataA, int *stridesA, Functor &func) {
+        const int n = shape[0];
+        const Nd4jIndex strideA = stridesA[0];
+        for (int i = 0; i < n; i++)
+            func(dataA + i * strideA);
+    }
+
+    template <typename T, typename Functor>
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    static inline void two(int *shape, T *dataA, int *stridesA, T *dataB, int *stridesB, Functor &func) {
+        const int n = shape[0];
+        const Nd4jIndex strideA = stridesA[0];
+        const Nd4jIndex strideB = stridesB[0];
+        for (int i = 0; i < n; i++)
+            func(dataA + i * strideA, dataB + i * strideB);
+    }
+
+    template <typename T, typename Functor>
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    static inline void three(int *shape, T *dataA, int *stridesA, T *dataB, int *stridesB, T *dataC, int *stridesC, Functor &func) {
+        const int n = shape[0];
+        const Nd4jIndex strideA = stridesA[0];
+        const Nd4jIndex strideB = stridesB[0];
+        const Nd4jIndex strideC = stridesC[0];
+        for (int i = 0; i < n; i++)
+            func(dataA + i * strideA, dataB + i * strideB, dataC + i * strideC);
+    }
+
+    template <typename T, typename Functor>
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    static inline void four(int *shape, T *dataA, int *stridesA, T *dataB, int *stridesB, T *dataC, int *stridesC, T *dataD, int *stridesD, Functor &func) {
+        const int n = shape[0];
+        const Nd4jIndex strideA = stridesA[0];
+        const Nd4jIndex strideB = stridesB[0];
+        const Nd4jIndex strideC = stridesC[0];
+        const Nd4jIndex strideD = stridesD[0];
+        for (int i = 0; i < n; i++)
+            func(dataA + i * strideA, dataB + i * strideB, dataC + i * strideC, dataD + i * strideD);
+    }
+};
+
+/*
+ * Runs func over every element of one raw array prepared by
+ * PrepareOneRawArrayIter. Ranks 1 to 4 are dispatched once to
+ * the unrolled RankedRawIter loops, anything higher goes through
+ * the generic ND4J_RAW_ITER macros.
+ */
+template <typename T, typename Functor>
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline void RawIterOne(int ndim, int *shape, T *dataA, int *stridesA, Functor &func) {
+    switch (ndim) {
+        case 0: func(dataA); return;
+        case 1: RankedRawIter<0>::one(shape, dataA, stridesA, func); return;
+        case 2: RankedRawIter<1>::one(shape, dataA, stridesA, func); return;
+        case 3: RankedRawIter<2>::one(shape, dataA, stridesA, func); return;
+        case 4: RankedRawIter<3>::one(shape, dataA, stridesA, func); return;
+        default: break;
+    }
+
+    int coord[MAX_RANK];
+    int dim;
+    ND4J_RAW_ITER_START(dim, ndim, coord, shape); {
+            func(dataA);
+        }
+    ND4J_RAW_ITER_ONE_NEXT(dim, ndim, coord, shape, dataA, stridesA);
+}
+
+/*
+ * The two array version of RawIterOne,
+ * for arrays prepared by PrepareTwoRawArrayIter
+ */
+template <typename T, typename Functor>
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline void RawIterTwo(int ndim, int *shape, T *dataA, int *stridesA, T *dataB, int *stridesB, Functor &func) {
+    switch (ndim) {
+        case 0: func(dataA, dataB); return;
+        case 1: RankedRawIter<0>::two(shape, dataA, stridesA, dataB, stridesB, func); return;
+        case 2: RankedRawIter<1>::two(shape, dataA, stridesA, dataB, stridesB, func); return;
+        case 3: RankedRawIter<2>::two(shape, dataA, stridesA, dataB, stridesB, func); return;
+        case 4: RankedRawIter<3>::two(shape, dataA, stridesA, dataB, stridesB, func); return;
+        default: break;
+    }
+
+    int coord[MAX_RANK];
+    int dim;
+    ND4J_RAW_ITER_START(dim, ndim, coord, shape); {
+            func(dataA, dataB);
+        }
+    ND4J_RAW_ITER_TWO_NEXT(dim, ndim, coord, shape, dataA, stridesA, dataB, stridesB);
+}
+
+/*
+ * The three array version of RawIterOne,
+ * for arrays prepared by PrepareThreeRawArrayIter
+ */
+template <typename T, typename Functor>
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline void RawIterThree(int ndim, int *shape, T *dataA, int *stridesA, T *dataB, int *stridesB, T *dataC, int *stridesC, Functor &func) {
+    switch (ndim) {
+        case 0: func(dataA, dataB, dataC); return;
+        case 1: RankedRawIter<0>::three(shape, dataA, stridesA, dataB, stridesB, dataC, stridesC, func); return;
+        case 2: RankedRawIter<1>::three(shape, dataA, stridesA, dataB, stridesB, dataC, stridesC, func); return;
+        case 3: RankedRawIter<2>::three(shape, dataA, stridesA, dataB, stridesB, dataC, stridesC, func); return;
+        case 4: RankedRawIter<3>::three(shape, dataA, stridesA, dataB, stridesB, dataC, stridesC, func); return;
+        default: break;
+    }
+
+    int coord[MAX_RANK];
+    int dim;
+    ND4J_RAW_ITER_START(dim, ndim, coord, shape); {
+            func(dataA, dataB, dataC);
+        }
+    ND4J_RAW_ITER_THREE_NEXT(dim, ndim, coord, shape, dataA, stridesA, dataB, stridesB, dataC, stridesC);
+}
+
+/*
+ * The four array version of RawIterOne,
+ * for arrays prepared by PrepareFourRawArrayIter
+ */
+template <typename T, typename Functor>
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline void RawIterFour(int ndim, int *shape, T *dataA, int *stridesA, T *dataB, int *stridesB, T *dataC, int *stridesC, T *dataD, int *stridesD, Functor &func) {
+    switch (ndim) {
+        case 0: func(dataA, dataB, dataC, dataD); return;
+        case 1: RankedRawIter<0>::four(shape, dataA, stridesA, dataB, stridesB, dataC, stridesC, dataD, stridesD, func); return;
+        case 2: RankedRawIter<1>::four(shape, dataA, stridesA, dataB, stridesB, dataC, stridesC, dataD, stridesD, func); return;
+        case 3: RankedRawIter<2>::four(shape, dataA, stridesA, dataB, stridesB, dataC, stridesC, dataD, stridesD, func); return;
+        case 4: RankedRawIter<3>::four(shape, dataA, stridesA, dataB, stridesB, dataC, stridesC, dataD, stridesD, func); return;
+        default: break;
+    }
+
+    int coord[MAX_RANK];
+    int dim;
+    ND4J_RAW_ITER_START(dim, ndim, coord, shape); {
+            func(dataA, dataB, dataC, dataD);
+        }
+    ND4J_RAW_ITER_FOUR_NEXT(dim, ndim, coord, shape, dataA, stridesA, dataB, stridesB, dataC, stridesC, dataD, stridesD);
+}
+
+
 /*NUMPY_API
  *
  * This function populates the first ndim elements
@@ -522,4 +746,377 @@ int  PrepareThreeRawArrayIter(int ndim, int shape[],
 }
 
 
+/**
+ * The same as PrepareOneRawArrayIter, but for four
+ * operands instead of one. Any broadcasting of the four operands
+ * should have already been done before calling this function,
+ * as the ndim and shape is only specified once for all operands.
+ *
+ * Only the strides of the first operand are used to reorder
+ * the dimensions, no attempt to consider all the strides together
+ * is made, as is done in the NpyIter object.
+ *
+ * You can use this together with ND4J_RAW_ITER_START and
+ * ND4J_RAW_ITER_FOUR_NEXT to handle the looping boilerplate of everything
+ * but the innermost loop (which is for idim == 0).
+ *
+ * Returns 0 on success, -1 on failure.
+ */
+template <typename T>
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+int  PrepareFourRawArrayIter(int ndim, int shape[],
+                             T *dataA, int *stridesA,
+                             T *dataB, int *stridesB,
+                             T *dataC, int *stridesC,
+                             T *dataD, int *stridesD,
+                             int &out_ndim, int *outShape,
+                             T **out_dataA, int outStridesA[],
+                             T **out_dataB, int outStridesB[],
+                             T **out_dataC, int outStridesC[],
+                             T **out_dataD, int outStridesD[])
+{
+
+    /* Special case 0 dimensions */
+    if (ndim == 0) {
+        out_ndim = 1;
+        *out_dataA = dataA;
+        *out_dataB = dataB;
+        *out_dataC = dataC;
+        *out_dataD = dataD;
+        outShape[0] = 1;
+        outStridesA[0] = 0;
+        outStridesB[0] = 0;
+        outStridesC[0] = 0;
+        outStridesD[0] = 0;
+        return 0;
+    }
+
+    for (int i = 0; i < ndim; ++i) {
+        outShape[i] = shape[i];
+        outStridesA[i] = stridesA[i];
+        outStridesB[i] = stridesB[i];
+        outStridesC[i] = stridesC[i];
+        outStridesD[i] = stridesD[i];
+    }
+
+    /* Reverse any negative strides of operand A */
+    for (int i = 0; i < ndim; ++i) {
+        int stride_entryA = outStridesA[i];
+        int stride_entryB = outStridesB[i];
+        int stride_entryC = outStridesC[i];
+        int stride_entryD = outStridesD[i];
+        int shape_entry = outShape[i];
+
+        if (stride_entryA < 0) {
+            dataA += stride_entryA * (shape_entry - 1);
+            dataB += stride_entryB * (shape_entry - 1);
+            dataC += stride_entryC * (shape_entry - 1);
+            dataD += stride_entryD * (shape_entry - 1);
+            outStridesA[i] = -stride_entryA;
+            outStridesB[i] = -stride_entryB;
+            outStridesC[i] = -stride_entryC;
+            outStridesD[i] = -stride_entryD;
+        }
+        /* Detect 0-size arrays here */
+        if (shape_entry == 0) {
+            out_ndim = 1;
+            *out_dataA = dataA;
+            *out_dataB = dataB;
+            *out_dataC = dataC;
+            *out_dataD = dataD;
+            outShape[0] = 0;
+            outStridesA[0] = 0;
+            outStridesB[0] = 0;
+            outStridesC[0] = 0;
+            outStridesD[0] = 0;
+            return 0;
+        }
+    }
+
+
+    *out_dataA = dataA;
+    *out_dataB = dataB;
+    *out_dataC = dataC;
+    *out_dataD = dataD;
+    out_ndim = ndim;
+    return 0;
+}
+
+/**
+ * Computes the strides an operand of the given shape
+ * is read with when broadcast (NumPy rules) to outShape:
+ * shapes are aligned at the trailing dimension, and
+ * missing or length 1 dimensions get a stride of zero.
+ *
+ * Returns 0 on success, -1 if the shapes are not
+ * broadcast compatible.
+ */
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline int BroadcastStrides(int rank, int *shape, int *strides,
+                            int outRank, int *outShape,
+                            int *outStrides) {
+    if (rank > outRank)
+        return -1;
+
+    int offset = outRank - rank;
+    for (int i = 0; i < outRank; i++) {
+        if (i < offset) {
+            outStrides[i] = 0;
+        }
+        else if (shape[i - offset] == outShape[i]) {
+            outStrides[i] = outShape[i] == 1 ? 0 : strides[i - offset];
+        }
+        else if (shape[i - offset] == 1) {
+            outStrides[i] = 0;
+        }
+        else {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Simplifies the shape and strides of up to four operands
+ * in place ahead of raw iteration: length 1 axes are dropped,
+ * the axes are sorted into FORTRAN order by the strides of
+ * the first operand and adjacent axes are merged wherever
+ * every operand is contiguous across them, as long as the
+ * merged extent still fits an int. Views that are
+ * really one or two contiguous runs come out as rank 1 or 2.
+ *
+ * The order elements are visited in changes, so this is only
+ * for callers that neither count elements nor read the
+ * per axis coordinates. Zero strides merge with zero strides,
+ * so broadcast operands do not block merging.
+ *
+ * Axis 0 of the result is the innermost one.
+ * @param ndim the number of dimensions
+ * @param shape the shape, overwritten
+ * @param numOperands the number of operands (1 to 4)
+ * @param strides the strides of each operand, overwritten
+ * @return the new number of dimensions (at least 1)
+ */
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline int CoalesceRawArrayIter(int ndim, int *shape, int numOperands, int **strides) {
+    StridePermutation perm[MAX_RANK];
+    int kept = 0;
+    for (int i = 0; i < ndim; i++) {
+        /* Detect 0-size arrays here */
+        if (shape[i] == 0) {
+            shape[0] = 0;
+            for (int a = 0; a < numOperands; a++)
+                strides[a][0] = 0;
+            return 1;
+        }
+
+        if (shape[i] == 1)
+            continue;
+        perm[kept].perm = i;
+        perm[kept].stride = strides[0][i] < 0 ? -strides[0][i] : strides[0][i];
+        kept++;
+    }
+
+    if (kept == 0) {
+        shape[0] = 1;
+        for (int a = 0; a < numOperands; a++)
+            strides[a][0] = 0;
+        return 1;
+    }
+
+    quickSort(perm, kept);
+
+    int inShape[MAX_RANK];
+    int inStrides[4][MAX_RANK];
+    for (int i = 0; i < ndim; i++) {
+        inShape[i] = shape[i];
+        for (int a = 0; a < numOperands; a++)
+            inStrides[a][i] = strides[a][i];
+    }
+
+    int rank = 0;
+    for (int i = 0; i < kept; i++) {
+        int axis = perm[i].perm;
+        if (rank > 0) {
+            int prev = rank - 1;
+            //extents stay ints, so axes whose product would not fit stay apart
+            Nd4jIndex merged = (Nd4jIndex) shape[prev] * inShape[axis];
+            bool mergeable = merged <= 2147483647LL;
+            for (int a = 0; a < numOperands && mergeable; a++)
+                mergeable = inStrides[a][axis] == (Nd4jIndex) strides[a][prev] * shape[prev];
+            if (mergeable) {
+                shape[prev] = (int) merged;
+                continue;
+            }
+        }
+
+        shape[rank] = inShape[axis];
+        for (int a = 0; a < numOperands; a++)
+            strides[a][rank] = inStrides[a][axis];
+        rank++;
+    }
+
+    return rank;
+}
+
+/*
+ * CoalesceRawArrayIter for the outputs of
+ * PrepareOneRawArrayIter
+ */
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline int CoalesceRawArrayIter(int ndim, int *shape, int *stridesA) {
+    int *strides[1] = {stridesA};
+    return CoalesceRawArrayIter(ndim, shape, 1, strides);
+}
+
+/*
+ * CoalesceRawArrayIter for the outputs of
+ * PrepareTwoRawArrayIter
+ */
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline int CoalesceRawArrayIter(int ndim, int *shape, int *stridesA, int *stridesB) {
+    int *strides[2] = {stridesA, stridesB};
+    return CoalesceRawArrayIter(ndim, shape, 2, strides);
+}
+
+/*
+ * CoalesceRawArrayIter for the outputs of
+ * PrepareThreeRawArrayIter
+ */
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline int CoalesceRawArrayIter(int ndim, int *shape, int *stridesA, int *stridesB, int *stridesC) {
+    int *strides[3] = {stridesA, stridesB, stridesC};
+    return CoalesceRawArrayIter(ndim, shape, 3, strides);
+}
+
+/*
+ * CoalesceRawArrayIter for the outputs of
+ * PrepareFourRawArrayIter
+ */
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline int CoalesceRawArrayIter(int ndim, int *shape, int *stridesA, int *stridesB, int *stridesC, int *stridesD) {
+    int *strides[4] = {stridesA, stridesB, stridesC, stridesD};
+    return CoalesceRawArrayIter(ndim, shape, 4, strides);
+}
+
+/**
+ * Finds strides that view a strided array under a new
+ * shape of the same length without copying it, element
+ * i of the new shape in c order being element i of the
+ * old one in c order (numpy's no copy reshape).
+ *
+ * Only axes the old strides lay out contiguously can be
+ * merged or split, so this fails for some views.
+ * @param ndim the number of old dimensions
+ * @param shape the old shape
+ * @param stride the old strides
+ * @param newNdim the number of new dimensions
+ * @param newShape the new shape
+ * @param newStride the new strides (output)
+ * @return 0 on success, -1 when the view needs a copy
+ */
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline int ReshapeStridesC(int ndim, int *shape, int *stride,
+                           int newNdim, int *newShape, int *newStride) {
+    int oldShape[MAX_RANK];
+    int oldStride[MAX_RANK];
+    int oldNdim = 0;
+    for (int i = 0; i < ndim; i++) {
+        if (shape[i] == 0)
+            return -1;
+        if (shape[i] != 1) {
+            oldShape[oldNdim] = shape[i];
+            oldStride[oldNdim] = stride[i];
+            oldNdim++;
+        }
+    }
+
+    int oi = 0, oj = 1, ni = 0, nj = 1;
+    while (ni < newNdim && oi < oldNdim) {
+        Nd4jIndex np = newShape[ni];
+        Nd4jIndex op = oldShape[oi];
+        while (np != op) {
+            if (np < op) {
+                if (nj >= newNdim)
+                    return -1;
+                np *= newShape[nj++];
+            }
+            else {
+                if (oj >= oldNdim)
+                    return -1;
+                op *= oldShape[oj++];
+            }
+        }
+
+        //the old axes being merged must be contiguous
+        for (int ok = oi; ok < oj - 1; ok++) {
+            if (oldStride[ok] != oldShape[ok + 1] * oldStride[ok + 1])
+                return -1;
+        }
+
+        newStride[nj - 1] = oldStride[oj - 1];
+        for (int nk = nj - 1; nk > ni; nk--)
+            newStride[nk - 1] = newStride[nk] * newShape[nk];
+
+        ni = nj++;
+        oi = oj++;
+    }
+
+    if (oi < oldNdim)
+        return -1;
+    //the trailing length 1 axes
+    for (int nk = ni; nk < newNdim; nk++) {
+        if (newShape[nk] != 1)
+            return -1;
+        newStride[nk] = 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Prepares three already broadcast operands (zero strides
+ * allowed) for raw iteration with CoalesceRawArrayIter,
+ * leaving the inputs untouched.
+ *
+ * Axis 0 of the output is the innermost one.
+ *
+ * Returns 0 on success, -1 on failure.
+ */
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline int CoalesceBroadcastIter(int ndim, int *shape,
+                                 int *stridesA, int *stridesB, int *stridesC,
+                                 int *out_ndim, int *outShape,
+                                 int *outStridesA, int *outStridesB, int *outStridesC) {
+    for (int i = 0; i < ndim; i++) {
+        outShape[i] = shape[i];
+        outStridesA[i] = stridesA[i];
+        outStridesB[i] = stridesB[i];
+        outStridesC[i] = stridesC[i];
+    }
+
+    *out_ndim = CoalesceRawArrayIter(ndim, outShape, outStridesA, outStridesB, outStridesC);
+    return 0;
+}
+
+
 #endif //NATIVEOPERATIONS_PAIRWISE_UTIL_H
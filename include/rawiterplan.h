@@ -0,0 +1,171 @@
+/*
+ * rawiterplan.h
+ *
+ * A reusable plan for walking 1 to 4 same shaped strided arrays.
+ *
+ * The ND4J_RAW_ITER macros (and RawIterOne..Four) can only run
+ * a traversal from start to end on one thread. A RawIterPlan
+ * holds the coalesced shape and the strides of every operand,
+ * and can start from any linear position of the traversal,
+ * so the traversal can be cut in to equal ranges and spread
+ * over threads.
+ *
+ * Positions count elements in the plan's own order: axis 0
+ * (the smallest stride of the first operand, after coalescing)
+ * fastest. That order is not the c or f order of the arrays,
+ * so plans are for work that does not depend on visiting order.
+ */
+
+#ifndef RAWITERPLAN_H_
+#define RAWITERPLAN_H_
+#include <omp.h>
+#include <shape.h>
+#include <pairwise_util.h>
+#include <pointercast.h>
+#include <threadpool.h>
+
+class RawIterPlan {
+public:
+    int rank;
+    int numOperands;
+    Nd4jIndex length;
+    int shape[MAX_RANK];
+    Nd4jIndex strides[4][MAX_RANK];
+
+    /**
+     * Plan a traversal of up to four arrays
+     * with the shape of the first one
+     * @param shapeInfoA the shape information for the first operand
+     * @param shapeInfoB the shape information for the second operand, if any
+     * @param shapeInfoC the shape information for the third operand, if any
+     * @param shapeInfoD the shape information for the fourth operand, if any
+     */
+    RawIterPlan(int *shapeInfoA, int *shapeInfoB = nullptr, int *shapeInfoC = nullptr, int *shapeInfoD = nullptr) {
+        int *shapeInfos[4] = {shapeInfoA, shapeInfoB, shapeInfoC, shapeInfoD};
+        numOperands = 1;
+        while (numOperands < 4 && shapeInfos[numOperands] != nullptr)
+            numOperands++;
+
+        int inRank = shape::rank(shapeInfoA);
+        int *inShape = shape::shapeOf(shapeInfoA);
+        int intStrides[4][MAX_RANK];
+        int *stridePointers[4];
+        for (int a = 0; a < numOperands; a++) {
+            int *stride = shape::stride(shapeInfos[a]);
+            for (int i = 0; i < inRank; i++)
+                intStrides[a][i] = stride[i];
+            stridePointers[a] = intStrides[a];
+        }
+
+        for (int i = 0; i < inRank; i++)
+            shape[i] = inShape[i];
+
+        rank = CoalesceRawArrayIter(inRank, shape, numOperands, stridePointers);
+        length = 1;
+        for (int i = 0; i < rank; i++) {
+            length *= shape[i];
+            for (int a = 0; a < numOperands; a++)
+                strides[a][i] = intStrides[a][i];
+        }
+    }
+
+    /**
+     * Computes the coordinates and operand offsets
+     * of the given position of the traversal
+     * @param position the linear position
+     * @param coord the coordinates (output)
+     * @param offsets the offset of every operand (output)
+     */
+    inline void seek(Nd4jIndex position, int *coord, Nd4jIndex *offsets) const {
+        for (int a = 0; a < numOperands; a++)
+            offsets[a] = 0;
+        for (int i = 0; i < rank; i++) {
+            coord[i] = (int) (position % shape[i]);
+            position /= shape[i];
+            for (int a = 0; a < numOperands; a++)
+                offsets[a] += coord[i] * strides[a][i];
+        }
+    }
+
+    /**
+     * Moves the coordinates and offsets
+     * count positions forward along axis 0,
+     * carrying in to the outer axes. count may not
+     * take axis 0 past its end.
+     */
+    inline void advance(Nd4jIndex count, int *coord, Nd4jIndex *offsets) const {
+        coord[0] += (int) count;
+        for (int a = 0; a < numOperands; a++)
+            offsets[a] += count * strides[a][0];
+
+        for (int i = 0; i < rank - 1 && coord[i] >= shape[i]; i++) {
+            coord[i] = 0;
+            coord[i + 1]++;
+            for (int a = 0; a < numOperands; a++)
+                offsets[a] += strides[a][i + 1] - (Nd4jIndex) shape[i] * strides[a][i];
+        }
+    }
+
+    /**
+     * Runs positions [start, end) of the traversal.
+     * func is called once per run along axis 0 as
+     * func(offsets, count): offsets are those of the
+     * first element of the run, and the following elements
+     * are strides[a][0] apart in every operand.
+     * @param start the first position
+     * @param end one past the last position
+     * @param func the callable
+     */
+    template<typename Functor>
+    inline void run(Nd4jIndex start, Nd4jIndex end, Functor &func) const {
+        if (start >= end)
+            return;
+
+        int coord[MAX_RANK];
+        Nd4jIndex offsets[4];
+        seek(start, coord, offsets);
+        Nd4jIndex position = start;
+        while (position < end) {
+            Nd4jIndex count = shape[0] - coord[0];
+            if (count > end - position)
+                count = end - position;
+            func(offsets, count);
+            position += count;
+            advance(count, coord, offsets);
+        }
+    }
+
+    /**
+     * Splits length positions in to parts nearly equal ranges
+     * @param length the number of positions
+     * @param part the range wanted
+     * @param parts the number of ranges
+     * @param start the first position of the range (output)
+     * @param end one past the last position of the range (output)
+     */
+    static inline void splitRange(Nd4jIndex length, int part, int parts, Nd4jIndex *start, Nd4jIndex *end) {
+        Nd4jIndex span = length / parts;
+        Nd4jIndex extra = length % parts;
+        *start = part * span + (part < extra ? part : extra);
+        *end = *start + span + (part < extra ? 1 : 0);
+    }
+
+    /**
+     * Runs the whole traversal, split in to ranges
+     * over the threads of nd4j::parallelFor when it
+     * is long enough to be worth it
+     * @param func the callable, as for run
+     */
+    template<typename Functor>
+    inline void runParallel(Functor &func) const {
+        if (length < 8000) {
+            run(0, length, func);
+            return;
+        }
+        nd4j::parallelFor(0, length, nd4j::ELEMENT_GRAIN, [&](Nd4jIndex start, Nd4jIndex end) {
+            run(start, end, func);
+        });
+    }
+};
+
+#endif /* RAWITERPLAN_H_ */
@@ -9,6 +9,8 @@
 #include <helper_cuda.h>
 #include <nd4jmalloc.h>
 #include <pairwise_util.h>
+#include <tadcache.h>
+#include <rawiterplan.h>
 #pragma once
 #ifdef __CUDACC__
 #include <cuda.h>
@@ -639,45 +641,37 @@ namespace functions {
                     return execScalar(x, xElementWiseStride, length, extraParams);
                 }
                 else {
-                    int shapeIter[MAX_RANK];
-                    int coord[MAX_RANK];
-                    int dim;
-                    int xStridesIter[MAX_RANK];
-
-                    int *xShape = shape::shapeOf(xShapeInfo);
-                    int *xStride = shape::stride(xShapeInfo);
-                    T start = this->startingValue(x);
-                    int rank = shape::rank(xShapeInfo);
-
-                    if (PrepareOneRawArrayIter<T>(rank,
-                                                  xShape,
-                                                  x,
-                                                  xStride,
-                                                  &rank,
-                                                  shapeIter,
-                                                  &x,
-                                                  xStridesIter) >= 0) {
-
-                        ND4J_RAW_ITER_START(dim, rank, coord, shapeIter); {
-                                /* Process the innermost dimension */
-                                const T *xIter = x;
-                                start = update(start, op(xIter[0], extraParams), extraParams);
+                    RawIterPlan plan(xShapeInfo);
+                    const Nd4jIndex xInner = plan.strides[0][0];
+                    int threads = length >= 8000 ? omp_get_max_threads() : 1;
+                    T *partials = new T[threads];
+                    for (int i = 0; i < threads; i++)
+                        partials[i] = this->startingValue(x);
+
+#pragma omp parallel num_threads(threads)
+                    {
+                        int tid = omp_get_thread_num();
+                        T local = this->startingValue(x);
+                        auto kernel = [&](Nd4jIndex *offsets, Nd4jIndex count) {
+                            T *xIter = x + offsets[0];
+                            for (Nd4jIndex i = 0; i < count; i++) {
+                                local = update(local, op(xIter[i * xInner], extraParams), extraParams);
                             }
-                        ND4J_RAW_ITER_ONE_NEXT(dim,
-                                               rank,
-                                               coord,
-                                               shapeIter,
-                                               x,
-                                               xStridesIter);
-                        start = postProcess(start, shape::length(xShapeInfo), extraParams);
-                    }
-                    else {
-                        printf("Unable to prepare array\n");
-                    }
+                        };
 
-                    return start;
+                        Nd4jIndex start, end;
+                        RawIterPlan::splitRange(length, tid, omp_get_num_threads(), &start, &end);
+                        plan.run(start, end, kernel);
+                        partials[tid] = local;
+                    }
 
+                    T start = partials[0];
+                    for (int i = 1; i < threads; i++) {
+                        start = update(start, partials[i], extraParams);
+                    }
 
+                    delete[] partials;
+                    return postProcess(start, length, extraParams);
                 }
 
             }
@@ -704,14 +698,13 @@ namespace functions {
                       int *resultShapeInfoBuffer,
                       int *dimension,
                       int dimensionLength) {
-                shape::TAD tad(xShapeInfo, dimension, dimensionLength);
-                tad.createTadOnlyShapeInfo();
-                tad.createOffsets();
+                std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(xShapeInfo, dimension, dimensionLength);
+                shape::TAD &tad = *tadPack->tad;
                 if(tad.dimensionLength < 1)
                     return;
 
 
-                int resultLength = shape::length(resultShapeInfoBuffer);
+                Nd4jIndex resultLength = shape::length(resultShapeInfoBuffer);
 
                 //pre squeezed: this is for keeping the pointer to the original
                 //shape information for tad offset
@@ -725,7 +718,7 @@ namespace functions {
 
                 if(tad.wholeThing) {
                     T start = this->startingValue(x);
-                    for(int i = 0; i < shape::length(tad.tadOnlyShapeInfo); i++) {
+                    for(Nd4jIndex i = 0; i < shape::length(tad.tadOnlyShapeInfo); i++) {
                         start = update(start, op(x[i], extraParams), extraParams);
                     }
 
@@ -736,20 +729,20 @@ namespace functions {
                                                                                shape::isScalar(tad.tadOnlyShapeInfo) || tad.wholeThing)) {
 
 #pragma omp parallel for
-                    for(int i = 0; i < resultLength; i++) {
+                    for(Nd4jIndex i = 0; i < resultLength; i++) {
                         T *iter = x + tad.tadOffsets[i];
                         T start = this->startingValue(iter);
                         int eleStride = shape::elementWiseStride(tad.tadOnlyShapeInfo);
                         if(eleStride == 1) {
 #pragma omp simd
-                            for(int j = 0; j < shape::length(tad.tadOnlyShapeInfo); j++) {
+                            for(Nd4jIndex j = 0; j < shape::length(tad.tadOnlyShapeInfo); j++) {
                                 start = update(start, op(iter[j], extraParams), extraParams);
 
                             }
                         }
                         else {
 #pragma omp simd
-                            for(int j = 0; j < shape::length(tad.tadOnlyShapeInfo); j++) {
+                            for(Nd4jIndex j = 0; j < shape::length(tad.tadOnlyShapeInfo); j++) {
                                 start = update(start, op(iter[j * eleStride], extraParams), extraParams);
                             }
                         }
@@ -760,11 +753,9 @@ namespace functions {
                 }
                 else {
 #pragma omp  parallel  for
-                    for (int i = 0; i <  resultLength; i++) {
-                        int offset = tad.tadOffsets[i];
+                    for (Nd4jIndex i = 0; i <  resultLength; i++) {
+                        Nd4jIndex offset = tad.tadOffsets[i];
                         int shapeIter[MAX_RANK];
-                        int coord[MAX_RANK];
-                        int dim;
                         int rankIter = shape::rank(tad.tadOnlyShapeInfo);
                         int xStridesIter[MAX_RANK];
                         T *xPointer = x + offset;
@@ -777,18 +768,12 @@ namespace functions {
                                                       shapeIter,
                                                       &xPointer,
                                                       xStridesIter) >= 0) {
-                            ND4J_RAW_ITER_START(dim, shape::rank(tad.tadOnlyShapeInfo), coord, shapeIter); {
-                                    /* Process the innermost dimension */
-                                    if(xPointer > 0)
-                                        start = update(start, op(xPointer[0], extraParams), extraParams);
-                                    else printf("Xpointer is < 0\n");
-                                }
-                            ND4J_RAW_ITER_ONE_NEXT(dim,
-                                                   rankIter,
-                                                   coord,
-                                                   shapeIter,
-                                                   xPointer,
-                                                   xStridesIter);
+                            rankIter = CoalesceRawArrayIter(rankIter, shapeIter, xStridesIter);
+                            auto kernel = [&](T *xPointer) {
+                                /* Process the innermost dimension */
+                                start = update(start, op(xPointer[0], extraParams), extraParams);
+                            };
+                            RawIterOne(rankIter, shapeIter, xPointer, xStridesIter, kernel);
                             start = postProcess(start, shape::length(tad.tadOnlyShapeInfo), extraParams);
                         }
                         else {
@@ -618,7 +618,7 @@ namespace functions {
 					if (xElementWiseStride == 1 && yElementWiseStride == 1) {
 						if(length < 8000) {
 #pragma omp simd
-							for(int i = 0; i < length; i++) {
+							for(Nd4jIndex i = 0; i < length; i++) {
 								startingVal = update(startingVal,op(x[i],y[i],&extraParamsVals),&extraParamsVals);
 							}
 
@@ -643,7 +643,7 @@ namespace functions {
 					else {
 						if(length < 8000) {
 #pragma omp simd
-							for(int i = 0; i < length; i++) {
+							for(Nd4jIndex i = 0; i < length; i++) {
 								startingVal = update(startingVal,op(x[i * xElementWiseStride],y[i * yElementWiseStride],&extraParamsVals),&extraParamsVals);
 
 
@@ -674,8 +674,6 @@ namespace functions {
 					T startingVal = this->startingValue(x);
 					Nd4jIndex n = shape::length(xShapeInfo);
 					int shapeIter[MAX_RANK];
-					int coord[MAX_RANK];
-					int dim;
 					int xStridesIter[MAX_RANK];
 					int yStridesIter[MAX_RANK];
 					int rank = shape::rank(xShapeInfo);
@@ -691,19 +689,14 @@ namespace functions {
 												 xStridesIter,
 												 &y,
 												 yStridesIter) >= 0) {
-						ND4J_RAW_ITER_START(dim, rank, coord, shapeIter); {
-								/* Process the innermost dimension */
-								T *xIter = x;
-								T *yIter = y;
-								startingVal = update(startingVal, op(xIter[0],yIter[0],&extraParamsVals),&extraParamsVals);
-							} ND4J_RAW_ITER_TWO_NEXT(dim,
-													 rank,
-													 coord,
-													 shapeIter,
-													 x,
-													 xStridesIter,
-													 y,
-													 yStridesIter);
+						rank = CoalesceRawArrayIter(rank, shapeIter, xStridesIter, yStridesIter);
+						auto kernel = [&](T *x, T *y) {
+							/* Process the innermost dimension */
+							T *xIter = x;
+							T *yIter = y;
+							startingVal = update(startingVal, op(xIter[0],yIter[0],&extraParamsVals),&extraParamsVals);
+						};
+						RawIterTwo(rank, shapeIter, x, xStridesIter, y, yStridesIter, kernel);
 
 						return postProcess(startingVal,n,&extraParamsVals);
 					}
@@ -881,7 +874,7 @@ namespace functions {
                      * along long which to iterate.
                      */
 					int tadElementWiseStride = shape::elementWiseStride(xTad.tadOnlyShapeInfo);
-					int tadLength = shape::length(xTad.tadOnlyShapeInfo);
+					Nd4jIndex tadLength = shape::length(xTad.tadOnlyShapeInfo);
 #pragma omp parallel for
 					for(Nd4jIndex i = 0; i < resultLength; i++) {
 						T *localExtraParams = nullptr;
@@ -893,7 +886,7 @@ namespace functions {
 
 						Nd4jIndex offset = xTad.tadOffsets[i];
 						result[i] = op(x[offset], y[offset],&localExtraParams);
-						for(int j = 1; j < tadLength; j++) {
+						for(Nd4jIndex j = 1; j < tadLength; j++) {
 							result[i] =  update(result[i],op(x[offset + tadElementWiseStride * j],y[offset + tadElementWiseStride * j], &localExtraParams), &localExtraParams);
 						}
 
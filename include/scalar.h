@@ -14,6 +14,8 @@
 #endif
 #include <op.h>
 #include <templatemath.h>
+#include <tadcache.h>
+#include <rawiterplan.h>
 #ifdef __CUDACC__
 #include <cuda.h>
 #include <cuda_runtime.h>
@@ -252,45 +254,17 @@ namespace functions {
                 int xElementWiseStride = shape::elementWiseStride(xShapeInfo);
                 int resultElementWiseStride = shape::elementWiseStride(resultShapeInfo);
                 if(xOrdering != resultOrdering || xElementWiseStride < 1 || resultElementWiseStride < 0) {
-                    int shapeIter[MAX_RANK];
-                    int coord[MAX_RANK];
-                    int dim;
-                    int xStridesIter[MAX_RANK];
-                    int resultStridesIter[MAX_RANK];
-                    int *xShape = shape::shapeOf(xShapeInfo);
-                    int *xStride = shape::stride(xShapeInfo);
-                    int *resultStride = shape::stride(resultShapeInfo);
-                    int rank = shape::rank(xShapeInfo);
-                    if(PrepareTwoRawArrayIter<T>(rank,
-                                                 xShape,
-                                                 x,
-                                                 xStride,
-                                                 result,
-                                                 resultStride,
-                                                 &rank,
-                                                 shapeIter,
-                                                 &x,
-                                                 xStridesIter,
-                                                 &result,
-                                                 resultStridesIter) >= 0) {
-                        ND4J_RAW_ITER_START(dim, rank, coord, shapeIter); {
-                                /* Process the innermost dimension */
-                                T *xIter = x;
-                                T *resultIter = result;
-                                resultIter[0] = op(xIter[0],scalar,extraParams);
-                            } ND4J_RAW_ITER_TWO_NEXT(dim,
-                                                     rank,
-                                                     coord,
-                                                     shapeIter,
-                                                     x,
-                                                     xStridesIter,
-                                                     result,
-                                                     resultStridesIter);
-                    }
-                    else {
-                        printf("Unable to prepare array\n");
-                    }
-
+                    RawIterPlan plan(xShapeInfo, resultShapeInfo);
+                    const Nd4jIndex xInner = plan.strides[0][0];
+                    const Nd4jIndex resultInner = plan.strides[1][0];
+                    auto kernel = [&](Nd4jIndex *offsets, Nd4jIndex count) {
+                        T *xIter = x + offsets[0];
+                        T *resultIter = result + offsets[1];
+                        for (Nd4jIndex i = 0; i < count; i++) {
+                            resultIter[i * resultInner] = op(xIter[i * xInner], scalar, extraParams);
+                        }
+                    };
+                    plan.runParallel(kernel);
                 }
                 else {
                     Nd4jIndex n = shape::length(xShapeInfo);
@@ -313,15 +287,14 @@ namespace functions {
 
 #pragma omp parallel for
                         for (Nd4jIndex i = 0; i < n; i++) {
-                            int *xIdx = shape::ind2sub(xRank, xShape, i);
-                            int *resultIdx = shape::ind2sub(resultRank, resultShape, i);
-                            int xOffset2 = shape::getOffset(xOffset, xShape, xStride, xIdx, xRank);
-                            int resultOffset2 = shape::getOffset(resultOffset, resultShape, resultStride, resultIdx, resultRank);
+                            int xIdx[MAX_RANK];
+                            int resultIdx[MAX_RANK];
+                            shape::ind2sub(xRank, xShape, i, xIdx);
+                            shape::ind2sub(resultRank, resultShape, i, resultIdx);
+                            Nd4jIndex xOffset2 = shape::getOffset(xOffset, xShape, xStride, xIdx, xRank);
+                            Nd4jIndex resultOffset2 = shape::getOffset(resultOffset, resultShape, resultStride, resultIdx, resultRank);
                             result[resultOffset2] = op(x[xOffset2], scalar,extraParams);
 
-                            delete[] xIdx;
-                            delete[] resultIdx;
-
                         }
 
                     }
@@ -345,22 +318,139 @@ namespace functions {
             void transform(T *x, int xStride, T *result, int resultStride,
                            T scalar, T *extraParams,  Nd4jIndex n) {
                 if (xStride == 1 && resultStride == 1) {
-#pragma omp parallel for
-                    for (Nd4jIndex i = 0; i < n; i++) {
-                        result[i] = op(x[i], scalar, extraParams);
-                    }
+                    nd4j::parallelFor(0, n, nd4j::ELEMENT_GRAIN, [&](Nd4jIndex start, Nd4jIndex end) {
+#pragma omp simd
+                        for (Nd4jIndex i = start; i < end; i++) {
+                            result[i] = op(x[i], scalar, extraParams);
+                        }
+                    });
                 }
 
                 else {
-#pragma omp parallel for
-                    for (Nd4jIndex i = 0; i < n; i++) {
-                        result[i * resultStride] = op(x[i * xStride], scalar,
-                                                      extraParams);
+                    nd4j::parallelFor(0, n, nd4j::ELEMENT_GRAIN, [&](Nd4jIndex start, Nd4jIndex end) {
+#pragma omp simd
+                        for (Nd4jIndex i = start; i < end; i++) {
+                            result[i * resultStride] = op(x[i * xStride], scalar,
+                                                          extraParams);
 
-                    }
+                        }
+                    });
                 }
 
             }
+            /**
+             * CPU implementation of scalar operation
+             * along dimension: every tensor along dimension
+             * i gets its own scalar, scalars[i].
+             * @param x the input
+             * @param xShapeInfo the shape information for the input
+             * @param result the result buffer
+             * @param resultShapeInfo the shape information for the result
+             * @param scalars the scalars, one per tensor along dimension
+             * @param scalarsShapeInfo the shape information for the scalars
+             * @param extraParams the extra parameters where
+             * neccssary
+             * @param dimension the dimensions to apply the scalars along
+             * @param dimensionLength the length of the dimension buffer
+             */
+            void transform(T *x,
+                           int *xShapeInfo,
+                           T *result,
+                           int *resultShapeInfo,
+                           T *scalars,
+                           int *scalarsShapeInfo,
+                           T *extraParams,
+                           int *dimension,
+                           int dimensionLength) {
+                std::shared_ptr<shape::TadPack> xTadPack = shape::TadCache::getInstance()->get(xShapeInfo, dimension, dimensionLength);
+                shape::TAD &xTad = *xTadPack->tad;
+
+                std::shared_ptr<shape::TadPack> resultTadPack = shape::TadCache::getInstance()->get(resultShapeInfo, dimension, dimensionLength);
+                shape::TAD &resultTad = *resultTadPack->tad;
+
+                int tads = xTad.numTads;
+                Nd4jIndex tadLength = shape::length(xTad.tadOnlyShapeInfo);
+                int xTadEWS = shape::elementWiseStride(xTad.tadOnlyShapeInfo);
+                int resultTadEWS = shape::elementWiseStride(resultTad.tadOnlyShapeInfo);
+                int scalarsEWS = shape::elementWiseStride(scalarsShapeInfo);
+                bool sameOrder = shape::order(xTad.tadOnlyShapeInfo) == shape::order(resultTad.tadOnlyShapeInfo);
+                if (scalarsEWS < 1)
+                    scalarsEWS = 1;
+
+                if (xTadEWS >= 1 && resultTadEWS >= 1 && sameOrder) {
+                    if (tads >= omp_get_max_threads() || tadLength < 8000) {
+#pragma omp parallel for schedule(guided) if (tads * tadLength >= 8000)
+                        for (int i = 0; i < tads; i++) {
+                            T *xIter = x + xTad.tadOffsets[i];
+                            T *resultIter = result + resultTad.tadOffsets[i];
+                            T scalar = scalars[i * scalarsEWS];
+                            if (xTadEWS == 1 && resultTadEWS == 1) {
+#pragma omp simd
+                                for (Nd4jIndex j = 0; j < tadLength; j++) {
+                                    resultIter[j] = op(xIter[j], scalar, extraParams);
+                                }
+                            }
+                            else {
+#pragma omp simd
+                                for (Nd4jIndex j = 0; j < tadLength; j++) {
+                                    resultIter[j * resultTadEWS] = op(xIter[j * xTadEWS], scalar, extraParams);
+                                }
+                            }
+                        }
+                    }
+                    else {
+                        //few long tads: split every tad across the threads instead
+                        for (int i = 0; i < tads; i++) {
+                            transform(x + xTad.tadOffsets[i],
+                                      xTadEWS,
+                                      result + resultTad.tadOffsets[i],
+                                      resultTadEWS,
+                                      scalars[i * scalarsEWS],
+                                      extraParams,
+                                      tadLength);
+                        }
+                    }
+                }
+                else {
+                    int *xShape = shape::shapeOf(xTad.tadOnlyShapeInfo);
+                    int *xStride = shape::stride(xTad.tadOnlyShapeInfo);
+                    int *resultStride = shape::stride(resultTad.tadOnlyShapeInfo);
+                    int tadRank = shape::rank(xTad.tadOnlyShapeInfo);
+#pragma omp parallel for schedule(guided) if (tads * tadLength >= 8000)
+                    for (int i = 0; i < tads; i++) {
+                        int shapeIter[MAX_RANK];
+                        int xStridesIter[MAX_RANK];
+                        int resultStridesIter[MAX_RANK];
+                        int rank = tadRank;
+                        T *xIter = x + xTad.tadOffsets[i];
+                        T *resultIter = result + resultTad.tadOffsets[i];
+                        T scalar = scalars[i * scalarsEWS];
+                        if (PrepareTwoRawArrayIter<T>(rank,
+                                                      xShape,
+                                                      xIter,
+                                                      xStride,
+                                                      resultIter,
+                                                      resultStride,
+                                                      &rank,
+                                                      shapeIter,
+                                                      &xIter,
+                                                      xStridesIter,
+                                                      &resultIter,
+                                                      resultStridesIter) >= 0) {
+                            rank = CoalesceRawArrayIter(rank, shapeIter, xStridesIter, resultStridesIter);
+                            auto kernel = [&](T *xIter, T *resultIter) {
+                                /* Process the innermost dimension */
+                                resultIter[0] = op(xIter[0], scalar, extraParams);
+                            };
+                            RawIterTwo(rank, shapeIter, xIter, xStridesIter, resultIter, resultStridesIter, kernel);
+                        }
+                        else {
+                            printf("Unable to prepare array\n");
+                        }
+                    }
+                }
+            }
+
             virtual inline
 #ifdef __CUDACC__
             __host__ __device__
@@ -1047,6 +1137,8 @@ namespace functions {
              * 13: set
              * 14: mod
              * 15: rmod
+             * 16: greater than or equal
+             * 17: set val or less
              * @return the op
              */
 #ifdef __CUDACC__
@@ -1156,6 +1248,12 @@ namespace functions {
                     return new(buffer) functions::scalar::ops::GreaterThanOrEqual<T>();
 #else
                     return new functions::scalar::ops::GreaterThanOrEqual<T>();
+#endif
+                else if (op == 17)
+#ifdef __CUDACC__
+                    return new(buffer) functions::scalar::ops::SetValOrLess<T>();
+#else
+                    return new functions::scalar::ops::SetValOrLess<T>();
 #endif
                 return nullptr;
             }
@@ -104,9 +104,20 @@ namespace shape {
 #endif
 
     inline int tadIndexForLinear(int linearIndex, int tadLength);
+
+/**
+ * Whether the packed strides of the given shape
+ * in the given order ('c' or 'f') fit an int
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline bool stridesFit(int rank, int *shape, char order);
+
 /**
  * Get the shape info buffer
- * for the given rank and shape.
+ * for the given rank and shape,
+ * nullptr if its strides would not fit an int
  */
 #ifdef __CUDACC__
     __host__ __device__
@@ -120,13 +131,19 @@ namespace shape {
 
     /**
  * Get the shape info buffer
- * for the given rank and shape.
+ * for the given rank and shape,
+ * nullptr if its strides would not fit an int
  */
 #ifdef __CUDACC__
     __host__ __device__
 #endif
     inline int *shapeBufferFortran(int rank, int *shape);
 
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int *shapeBufferFortran(int rank, int *shape, int *buffer);
+
 #ifdef __CUDACC__
     __host__ __device__
 #endif
@@ -195,6 +212,31 @@ namespace shape {
 #endif
     inline int* calcStrides(int *shape, int rank, int startNum);
 
+/**
+ * The variants of the stride calculations above
+ * writing in to ret (at least max(rank, 2) ints)
+ * instead of allocating
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int* calcStrides(int *shape, int rank, int *ret);
+
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int* calcStrides(int *shape, int rank, int startNum, int *ret);
+
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int* calcStridesFortran(int *shape, int rank, int *ret);
+
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int* calcStridesFortran(int *shape, int rank, int startNum, int *ret);
+
 /**
  * @param toCopy the shape to copy
  * @return a copy of the original struct
@@ -259,6 +301,12 @@ namespace shape {
 
     inline int *doPermuteSwap(int length, int *shape, int *rearrange);
 
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+
+    inline int *doPermuteSwap(int length, int *shape, int *rearrange, int *ret);
+
 
 
 
@@ -317,6 +365,11 @@ namespace shape {
 #endif
     inline int *createPermuteIndexes(int originalRank,int *dimension,int dimensionLength);
 
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int *createPermuteIndexes(int originalRank,int *dimension,int dimensionLength, int *ret);
+
 
 /**
  * Get the ordering for the device
@@ -471,6 +524,11 @@ namespace shape {
 
     inline int *permutedStrides(int *toPermute, int shapeRank, int *rearrange);
 
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int *permutedStrides(int *toPermute, int shapeRank, int *rearrange, int *ret);
+
 /**
  * Return the slice (shape + 1 in pointer arithmetic)
  * @param shape the shape to take the slice of
@@ -539,7 +597,7 @@ namespace shape {
     __host__ __device__
 #endif
 
-    int length(int *shapeInfo);
+    Nd4jIndex length(int *shapeInfo);
 
 /***
  * Returns the offset portion of an information buffer
@@ -639,6 +697,11 @@ namespace shape {
 #endif
     inline int* everyIndexBut(int *indexes,int indexesLength,int begin,int end);
 
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int* everyIndexBut(int *indexes,int indexesLength,int begin,int end, int *ret);
+
 /**
  * Computes the offset for accessing
  * a global element given the shape information
@@ -663,6 +726,11 @@ namespace shape {
 
     inline int* ensureVectorShape(int *shape);
 
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int* ensureVectorShape(int *shape, int dimension, int *ret);
+
 #ifdef __CUDACC__
     __host__ __device__
 #endif
@@ -685,6 +753,12 @@ namespace shape {
 
     inline int *range(int from, int to, int increment);
 
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+
+    inline int *range(int from, int to, int increment, int *ret);
+
 /**
  * Range between from and two with an
  * increment of 1
@@ -705,6 +779,12 @@ namespace shape {
 
     inline int *keep(volatile int *data, int *index, int indexLength, int dataLength);
 
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+
+    inline int *keep(volatile int *data, int *index, int indexLength, int dataLength, int *ret);
+
 /**
  * Generate reverse copy of the data
  * @param data
@@ -740,6 +820,12 @@ namespace shape {
 
     inline int *concat(int *arr1, int arr1Length, int *arr2, int arr2Length);
 
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+
+    inline int *concat(int *arr1, int arr1Length, int *arr2, int arr2Length, int *ret);
+
 /**
  *
  * @param numArrays
@@ -869,6 +955,11 @@ namespace shape {
 
     inline int *toShapeBuffer( ShapeInformation *info);
 
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int *toShapeBuffer( ShapeInformation *info, int *ret);
+
 /**
  * Returns the number of elements per thread
  */
@@ -976,7 +1067,7 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int prodLong( int *data, int length);
+    inline Nd4jIndex prodLong( int *data, int length);
 
     /**
      * Returns the rear most left over item not present in
@@ -1012,7 +1103,7 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int getOffset(int baseOffset,  int *shape,  int *stride,  int *indices,int rank);
+    inline Nd4jIndex getOffset(Nd4jIndex baseOffset,  int *shape,  int *stride,  int *indices,int rank);
 #ifdef __CUDACC__
     __host__ __device__
 #endif
@@ -1034,13 +1125,13 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int* ind2sub(int rank,  int *shape,int index,int numIndices);
+    inline int* ind2sub(int rank,  int *shape,Nd4jIndex index,Nd4jIndex numIndices);
 
 
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int *ind2sub(int rank,  int *shape,int index);
+    inline int *ind2sub(int rank,  int *shape,Nd4jIndex index);
 
     /**
      * Convert a linear index to
@@ -1053,7 +1144,7 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    void  ind2sub(int rank,int *shape,int index,int numIndices,int *out);
+    void  ind2sub(int rank,int *shape,Nd4jIndex index,Nd4jIndex numIndices,int *out);
 
 /**
      * Convert a linear index to
@@ -1067,7 +1158,7 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    void ind2sub(int rank, int *shape, int index, int *out);
+    void ind2sub(int rank, int *shape, Nd4jIndex index, int *out);
 
     /**
   * Convert a linear index to
@@ -1080,7 +1171,7 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int* ind2subC(int rank, int *shape, int index);
+    inline int* ind2subC(int rank, int *shape, Nd4jIndex index);
     /**
   * Convert a linear index to
   * the equivalent nd index
@@ -1092,7 +1183,7 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int* ind2subC(int rank, int *shape, int index, int numIndices);
+    inline int* ind2subC(int rank, int *shape, Nd4jIndex index, Nd4jIndex numIndices);
 
     /**
    * Convert a linear index to
@@ -1105,7 +1196,7 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline void  ind2subC(int rank, int *shape, int index, int numIndices, int *out);
+    inline void  ind2subC(int rank, int *shape, Nd4jIndex index, Nd4jIndex numIndices, int *out);
 
 /**
      * Convert a linear index to
@@ -1119,7 +1210,7 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline void ind2subC(int rank, int *shape, int index, int *out);
+    inline void ind2subC(int rank, int *shape, Nd4jIndex index, int *out);
 
     /**
   * Convert the given index (such as 1,1)
@@ -1132,7 +1223,7 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    int sub2Ind(int rank, int *shape, int *indices);
+    Nd4jIndex sub2Ind(int rank, int *shape, int *indices);
 
     /**
    * Compute the real linear indices for the given shape and stride
@@ -1163,7 +1254,7 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    void  ind2subOrder(int *shapeInfo,int index,int numIndices,int *out);
+    void  ind2subOrder(int *shapeInfo,Nd4jIndex index,Nd4jIndex numIndices,int *out);
 
     /**
  * Convert a linear index to
@@ -1176,7 +1267,7 @@ namespace shape {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    void  ind2subOrder(int *shapeInfo,int index,int *out);
+    void  ind2subOrder(int *shapeInfo,Nd4jIndex index,int *out);
 
 
 #ifdef __CUDACC__
@@ -1232,7 +1323,7 @@ namespace shape {
         int numTads = 0;
         int *tadShape = nullptr;
         int *tadStride = nullptr;
-        int *tadOffsets = nullptr;
+        Nd4jIndex *tadOffsets = nullptr;
         int tadOffsetForBlock = 0;
         int rank = 0;
         int numOnes = 0;
@@ -1367,7 +1458,7 @@ namespace shape {
             }
             else {
                 for (int i = 0; i <  numTads; i++) {
-                    int offset = tadOffsets[i];
+                    Nd4jIndex offset = tadOffsets[i];
                     // printf("Offsets for %d is %d\n",i,offset);
                     int shapeIter[MAX_RANK];
                     int coord[MAX_RANK];
@@ -1634,7 +1725,7 @@ namespace shape {
 #ifdef __CUDACC__
         __host__ __device__
 #endif
-        inline int tadOffset(int index) {
+        inline Nd4jIndex tadOffset(int index) {
             if(tadOnlyShapeInfo == nullptr) {
                 this->createTadOnlyShapeInfo();
             }
@@ -1645,7 +1736,7 @@ namespace shape {
             if(dimensionLength > 1) {
                 int *tad2Sub = this->tad2Sub(index,ptrManager);
 
-                int ret = shape::getOffset(0,shape::shapeOf(shapeInfo),shape::stride(shapeInfo),tad2Sub,shape::rank(shapeInfo));
+                Nd4jIndex ret = shape::getOffset(0,shape::shapeOf(shapeInfo),shape::stride(shapeInfo),tad2Sub,shape::rank(shapeInfo));
 
                 if(ret < 0) {
                     if (ptrManager == nullptr)
@@ -1661,7 +1752,7 @@ namespace shape {
             else {
                 int *tad2Sub = this->tad2Sub(index,ptrManager);
 
-                int ret = shape::getOffset(0,shape::shapeOf(shapeInfo),shape::stride(shapeInfo),tad2Sub,shape::rank(shapeInfo));
+                Nd4jIndex ret = shape::getOffset(0,shape::shapeOf(shapeInfo),shape::stride(shapeInfo),tad2Sub,shape::rank(shapeInfo));
 
                 if (ptrManager == nullptr)
                     delete[] tad2Sub;
@@ -1772,7 +1863,7 @@ namespace shape {
         void createOffsets() {
             traceNew(1);
 
-            this->tadOffsets = new int[this->numTads];
+            this->tadOffsets = new Nd4jIndex[this->numTads];
             for(int i = 0; i < this->numTads; i++) {
                 this->tadOffsets[i] = this->tadOffset(i);
 
@@ -2397,29 +2488,39 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
     __host__ __device__
 #endif
     inline int * calcStridesFortran(int *shape, int rank, int startNum) {
-        if (isVector(shape, rank)) {
+        traceNew(6);
 
-            traceNew(5);
+        int *stride = new int[rank > 2 ? rank : 2];
+        return calcStridesFortran(shape, rank, startNum, stride);
+    }
 
-            int *ret = new int[2];
+/**
+ * Computes the standard packed array strides for a given shape
+ * in to a caller provided buffer.
+ *
+ * @param shape    the shape of a matrix:
+ * @param startNum the start number for the strides
+ * @param ret      the buffer for the strides (at least max(rank, 2) ints)
+ * @return ret
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int * calcStridesFortran(int *shape, int rank, int startNum, int *ret) {
+        if (isVector(shape, rank)) {
             for (int i = 0; i < 2; i++)
                 ret[i] = 1;
             return ret;
 
         }
 
-        int dimensions = rank;
-
-        traceNew(6);
-
-        int *stride = new int[dimensions];
         int st = startNum;
         for (int j = 0; j < rank; j++) {
-            stride[j] = st;
+            ret[j] = st;
             st *= shape[j];
         }
 
-        return stride;
+        return ret;
     }
 
 /**
@@ -2436,22 +2537,37 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 
         traceNew(7);
 
-        int *stride = new int[rank];
+        int *stride = new int[rank > 2 ? rank : 2];
+        return calcStrides(shape, rank, startNum, stride);
+    }
 
+/**
+ * Computes the standard packed array strides for a given shape
+ * in to a caller provided buffer.
+ *
+ * @param shape    the shape of a matrix:
+ * @param startNum the start number for the strides
+ * @param ret      the buffer for the strides (at least max(rank, 2) ints)
+ * @return ret
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int * calcStrides(int *shape, int rank, int startNum, int *ret) {
         if (shape::isVector(shape, rank)) {
             for (int i = 0; i < 2; i++)
-                stride[i] = 1;
-            return stride;
+                ret[i] = 1;
+            return ret;
 
         }
 
         int st = startNum;
         for (int j = rank - 1; j >= 0; j--) {
-            stride[j] = st;
+            ret[j] = st;
             st *= shape[j];
         }
 
-        return stride;
+        return ret;
     }
 
 /**
@@ -2468,6 +2584,21 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
         return calcStridesFortran(shape, rank, 1);
     }
 
+/**
+ * Computes the standard packed array strides for a given shape
+ * in to a caller provided buffer.
+ *
+ * @param shape    the shape of a matrix:
+ * @param ret      the buffer for the strides (at least max(rank, 2) ints)
+ * @return ret
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int * calcStridesFortran(int *shape, int rank, int *ret) {
+        return calcStridesFortran(shape, rank, 1, ret);
+    }
+
 /**
  * Computes the standard packed array strides for a given shape.
  *
@@ -2482,6 +2613,21 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
         return calcStrides(shape, rank, 1);
     }
 
+/**
+ * Computes the standard packed array strides for a given shape
+ * in to a caller provided buffer.
+ *
+ * @param shape    the shape of a matrix:
+ * @param ret      the buffer for the strides (at least max(rank, 2) ints)
+ * @return ret
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int* calcStrides(int *shape, int rank, int *ret) {
+        return calcStrides(shape, rank, 1, ret);
+    }
+
 /**
  * @param toCopy the shape to copy
  * @return a copy of the original struct
@@ -2522,18 +2668,16 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 
         else {
             int oldnd;
-            int *olddims = shape::copyOf(rank, shape);
-            int *oldstrides = shape::copyOf(rank, stride);
+            int olddims[MAX_RANK];
+            int oldstrides[MAX_RANK];
             int np, op, last_stride;
             int oi, oj, ok, ni, nj, nk;
 
-            traceNew(10);
-
-            int *newStrides = new int[rank];
+            int newStrides[MAX_RANK];
             oldnd = 0;
             //set the shape to be 1 x length
             int newShapeRank = 2;
-            int *newShape = new int[newShapeRank];
+            int newShape[2];
             newShape[0] = 1;
             newShape[1] = shape::prodLong(shape, rank);
 
@@ -2634,12 +2778,7 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
                 newStrides[nk] = last_stride;
             }
 //returns the last element of the new stride array
-            int ret = last_stride;
-            delete[] newStrides;
-            delete[] newShape;
-            delete[] oldstrides;
-            delete[] olddims;
-            return ret;
+            return last_stride;
         }
 
 
@@ -2657,79 +2796,111 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 
     }
 
+/**
+ * Whether the packed strides of the given shape
+ * in the given order ('c' or 'f') fit an int
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline bool stridesFit(int rank, int *shape, char order) {
+        //the largest stride is the product of every dimension but the slowest
+        Nd4jIndex largest = 1;
+        for (int i = 0; i < rank - 1; i++)
+            largest *= shape[order == 'f' ? i : i + 1];
+        return largest <= 2147483647LL;
+    }
+
 /**
  * Get the shape info buffer
- * for the given rank and shape.
+ * for the given rank and shape,
+ * nullptr if its strides would not fit an int
  */
 #ifdef __CUDACC__
     __host__ __device__
 #endif
     inline int *shapeBuffer(int rank, int *shape) {
-        int *stride = shape::calcStrides(shape, rank);
+        if (!shape::stridesFit(rank, shape, 'c'))
+            return nullptr;
 
         traceNew(11);
 
-        shape::ShapeInformation * shapeInfo = new shape::ShapeInformation();
-        shapeInfo->shape = shape;
-        shapeInfo->stride = stride;
-        shapeInfo->offset = 0;
-        shapeInfo->rank = rank;
-        int elementWiseStride = shape::computeElementWiseStride(rank, shape, stride,
-                                                                0);
-        shapeInfo->order = 'c';
-        shapeInfo->elementWiseStride = elementWiseStride;
-        int *shapeInfoBuffer = shape::toShapeBuffer(shapeInfo);
-        delete stride;
-        delete shapeInfo;
-        return shapeInfoBuffer;
+        int *shapeInfoBuffer = new int[shapeInfoLength(rank)];
+        return shape::shapeBuffer(rank, shape, shapeInfoBuffer);
     }
 
-    /**
-     * This is special method, it returns ONLY 2D shapebuffer.
-     *
-     * This method is used only for SoftMax
-     */
+/**
+ * Write the c ordered shape info buffer
+ * for the given rank and shape in to buffer
+ * (shapeInfoLength(rank) ints) without allocating;
+ * nullptr, leaving buffer alone, if its strides
+ * would not fit an int
+ */
 #ifdef __CUDACC__
     __host__ __device__
 #endif
     inline int *shapeBuffer(int rank, int *shape, int *buffer) {
+        if (!shape::stridesFit(rank, shape, 'c'))
+            return nullptr;
+        int stride[MAX_RANK];
+        shape::calcStrides(shape, rank, stride);
 
         buffer[0] = rank;
-        buffer[1] = shape[0];
-        buffer[2] = 1;
-        buffer[3] = 1;
-        buffer[4] = 1;
-        buffer[5] = 0;
-        buffer[6] = 1;
-        buffer[7] = 99;
+        for (int i = 0; i < rank; i++) {
+            buffer[i + 1] = shape[i];
+            buffer[i + 1 + rank] = stride[i];
+        }
 
+        buffer[2 * rank + 1] = 0;
+        buffer[2 * rank + 2] = shape::computeElementWiseStride(rank, shape, stride, 0);
+        buffer[2 * rank + 3] = 'c';
         return buffer;
     }
 
 /**
 * Get the shape info buffer
-* for the given rank and shape.
+* for the given rank and shape,
+* nullptr if its strides would not fit an int
 */
 #ifdef __CUDACC__
     __host__ __device__
 #endif
     inline int *shapeBufferFortran(int rank, int *shape) {
-        int *stride = shape::calcStridesFortran(shape,rank);
+        if (!shape::stridesFit(rank, shape, 'f'))
+            return nullptr;
 
         traceNew(12);
 
-        shape::ShapeInformation * shapeInfo = new shape::ShapeInformation();
-        shapeInfo->shape = shape;
-        shapeInfo->stride = stride;
-        shapeInfo->offset = 0;
-        shapeInfo->rank = rank;
-        int elementWiseStride = shape::computeElementWiseStride(rank, shape, stride,
-                                                                0);
-        shapeInfo->order = 'f';
-        shapeInfo->elementWiseStride = elementWiseStride;
-        int *shapeInfoBuffer = shape::toShapeBuffer(shapeInfo);
-        delete shapeInfo;
-        return shapeInfoBuffer;
+        int *shapeInfoBuffer = new int[shapeInfoLength(rank)];
+        return shape::shapeBufferFortran(rank, shape, shapeInfoBuffer);
+    }
+
+/**
+ * Write the f ordered shape info buffer
+ * for the given rank and shape in to buffer
+ * (shapeInfoLength(rank) ints) without allocating;
+ * nullptr, leaving buffer alone, if its strides
+ * would not fit an int
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int *shapeBufferFortran(int rank, int *shape, int *buffer) {
+        if (!shape::stridesFit(rank, shape, 'f'))
+            return nullptr;
+        int stride[MAX_RANK];
+        shape::calcStridesFortran(shape, rank, stride);
+
+        buffer[0] = rank;
+        for (int i = 0; i < rank; i++) {
+            buffer[i + 1] = shape[i];
+            buffer[i + 1 + rank] = stride[i];
+        }
+
+        buffer[2 * rank + 1] = 0;
+        buffer[2 * rank + 2] = shape::computeElementWiseStride(rank, shape, stride, 0);
+        buffer[2 * rank + 3] = 'f';
+        return buffer;
     }
 
 
@@ -2776,9 +2947,9 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int sub2Ind(int rank, int *shape, int *indices) {
-        int index = 0;
-        int shift = 1;
+    inline Nd4jIndex sub2Ind(int rank, int *shape, int *indices) {
+        Nd4jIndex index = 0;
+        Nd4jIndex shift = 1;
 
         for(int i = 0; i < rank; i++) {
             index += shift * indices[i];
@@ -2798,7 +2969,7 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int* ind2sub(int rank,  int *shape, int index,int numIndices) {
+    inline int* ind2sub(int rank,  int *shape, Nd4jIndex index,Nd4jIndex numIndices) {
 
         traceNew(14);
 
@@ -2819,7 +2990,7 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int* ind2sub(int rank,  int *shape, int index) {
+    inline int* ind2sub(int rank,  int *shape, Nd4jIndex index) {
         return ind2sub(rank,shape, index,shape::prodLong(shape,rank));
     }
 
@@ -2834,8 +3005,8 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline void  ind2sub(int rank, int *shape, int index, int numIndices, int *ret) {
-        int denom = numIndices;
+    inline void  ind2sub(int rank, int *shape, Nd4jIndex index, Nd4jIndex numIndices, int *ret) {
+        Nd4jIndex denom = numIndices;
 
         for(int i = rank - 1; i >= 0; i--) {
             denom /= shape[i];
@@ -2856,7 +3027,7 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline void ind2sub(int rank,int *shape,int index, int *out) {
+    inline void ind2sub(int rank,int *shape,Nd4jIndex index, int *out) {
         ind2sub(rank,shape, index,shape::prodLong(shape,rank),out);
     }
 
@@ -2871,7 +3042,7 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int * ind2subC(int rank, int *shape, int index, int numIndices) {
+    inline int * ind2subC(int rank, int *shape, Nd4jIndex index, Nd4jIndex numIndices) {
 
         traceNew(15);
 
@@ -2892,7 +3063,7 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int *ind2subC(int rank, int *shape, int index) {
+    inline int *ind2subC(int rank, int *shape, Nd4jIndex index) {
         return ind2subC(rank,shape, index, shape::prodLong(shape,rank));
     }
 
@@ -2907,8 +3078,8 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline void ind2subC(int rank, int *shape, int index, int numIndices, int *ret) {
-        int denom = numIndices;
+    inline void ind2subC(int rank, int *shape, Nd4jIndex index, Nd4jIndex numIndices, int *ret) {
+        Nd4jIndex denom = numIndices;
         for(int i = 0; i < rank; i++) {
             denom /= shape[i];
             if(denom > 0) {
@@ -2934,7 +3105,7 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline void ind2subC(int rank, int *shape, int index, int *out) {
+    inline void ind2subC(int rank, int *shape, Nd4jIndex index, int *out) {
         ind2subC(rank,shape, index,shape::prodLong(shape,rank),out);
     }
 
@@ -2949,7 +3120,7 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline void  ind2subOrder(int *shapeInfo, int index, int numIndices,int *out) {
+    inline void  ind2subOrder(int *shapeInfo, Nd4jIndex index, Nd4jIndex numIndices,int *out) {
         if(shape::order(shapeInfo) == 'f') {
             shape::ind2sub(
                     shape::rank(shapeInfo),
@@ -2980,7 +3151,7 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline void ind2subOrder(int *shapeInfo, int index, int *out) {
+    inline void ind2subOrder(int *shapeInfo, Nd4jIndex index, int *out) {
         ind2subOrder(shapeInfo,index,shape::length(shapeInfo),out);
     }
 
@@ -3011,6 +3182,22 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
         traceNew(16);
 
         int *ret = new int[length];
+        return doPermuteSwap(length, shape, rearrange, ret);
+    }
+
+/**
+ * doPermuteSwap in to a caller provided buffer
+ * @param length
+ * @param shape
+ * @param rearrange
+ * @param ret the buffer (length ints, not shape)
+ * @return ret
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+
+    inline int *doPermuteSwap(int length, int *shape, int *rearrange, int *ret) {
         for (int i = 0; i < length; i++) {
             ret[i] = shape[rearrange[i]];
         }
@@ -3073,17 +3260,8 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #endif
 
     inline void doPermuteShapeBuffer(int *shapeBuffer,int *rearrange) {
-        int *shapeRef = shapeBuffer;
-        //rank of the rearrange array == rank of shape buffer
-        int rearrageRank = shape::rank(shapeRef);
-        int *shape = shape::shapeOf(shapeRef);
-        int *stride = shape::stride(shapeRef);
-        int *rearrangeCopy1 = shape::copyOf(rearrageRank,rearrange);
-        shape::doPermuteSwap(rearrageRank,&shape,rearrangeCopy1);
-        delete[] rearrangeCopy1;
-        int *rearrangeCopy2 = shape::copyOf(rearrageRank,rearrange);
-        shape::doPermuteSwap(rearrageRank,&stride,rearrangeCopy2);
-        delete[] rearrangeCopy2;
+        int tmpBuffer[MAX_RANK];
+        doPermuteShapeBuffer(shapeBuffer, rearrange, tmpBuffer);
     }
 
 #ifdef __CUDACC__
@@ -3109,18 +3287,8 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 #endif
 
     inline void doPermuteShapeBuffer(int rank,int *shapeBuffer,int *rearrange) {
-        int *shapeRef = shapeBuffer;
-        //rank of the rearrange array == rank of shape buffer
-        int rearrageRank = rank;
-        int *shape = shape::shapeOf(shapeRef);
-        int *stride = shape::stride(shapeRef);
-        int *rearrangeCopy1 = shape::copyOf(rearrageRank,rearrange);
-        shape::doPermuteSwap(rearrageRank,&shape,rearrangeCopy1);
-        delete[] rearrangeCopy1;
-        int *rearrangeCopy2 = shape::copyOf(rearrageRank,rearrange);
-        shape::doPermuteSwap(rearrageRank,&stride,rearrangeCopy2);
-        shapeBuffer[shape::shapeInfoLength(rank) - 1] = shape::getOrder(rank,shape,stride,1);
-        delete[] rearrangeCopy2;
+        int tmpBuffer[MAX_RANK];
+        doPermuteShapeBuffer(rank, shapeBuffer, rearrange, tmpBuffer);
     }
 
 #ifdef __CUDACC__
@@ -3146,11 +3314,18 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
     __host__ __device__
 #endif
     inline int *createPermuteIndexes(int originalRank,int *dimension,int dimensionLength) {
-        int delta = originalRank - dimensionLength;
 
         traceNew(17);
 
         int *ret = new int[originalRank];
+        return createPermuteIndexes(originalRank, dimension, dimensionLength, ret);
+    }
+
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int *createPermuteIndexes(int originalRank,int *dimension,int dimensionLength, int *ret) {
+        int delta = originalRank - dimensionLength;
         for(int i = 0; i < delta; i++) {
             ret[i] = i + dimensionLength;
         }
@@ -3430,11 +3605,20 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
     __host__ __device__
 #endif
     inline int *permutedStrides(int *toPermute, int shapeRank, int *rearrange) {
-        int *strideCopy = copyOf(shapeRank, toPermute);
+        int *newStride = new int[shapeRank];
+        return permutedStrides(toPermute, shapeRank, rearrange, newStride);
+    }
+
+/**
+ * permutedStrides in to a caller provided buffer
+ * (shapeRank ints, not toPermute)
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int *permutedStrides(int *toPermute, int shapeRank, int *rearrange, int *ret) {
         checkArrangeArray(rearrange, shapeRank, shapeRank);
-        int *newStride = doPermuteSwap(shapeRank, strideCopy, rearrange);
-        delete[] strideCopy;
-        return newStride;
+        return doPermuteSwap(shapeRank, toPermute, rearrange, ret);
     }
 
 /**
@@ -3534,7 +3718,7 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
     __host__ __device__
 #endif
 
-    inline int length(int *shapeInfo) {
+    inline Nd4jIndex length(int *shapeInfo) {
         return shape::prodLong(shape::shapeOf(shapeInfo), shape::rank(shapeInfo));
     }
 
@@ -3737,6 +3921,13 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
         traceNew(20);
 
         int *ret = new int[len];
+        return everyIndexBut(indexes, indexesLength, begin, end, ret);
+    }
+
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+    inline int* everyIndexBut(int *indexes,int indexesLength,int begin,int end, int *ret) {
         int retIdx = 0;
         //not here that we do 0 based indexing for end - this assumes things like:
         //0 to 4 are specified
@@ -3790,7 +3981,18 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
         traceNew(21);
 
         int *ret = new int[2];
+        return ensureVectorShape(shape, dimension, ret);
+    }
+
+/**
+ * ensureVectorShape in to a caller provided
+ * buffer of 2 ints
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
 
+    inline int *ensureVectorShape(int *shape, int dimension, int *ret) {
         if (dimension == 0) {
             ret[0] = 1;
             ret[1] = shape[0];
@@ -3830,7 +4032,6 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
 
     inline int *range(int from, int to, int increment) {
         int diff = nd4j::math::nd4j_abs<int>(from - to);
-        int retLength = diff / increment;
         int *ret;
 
         traceNew(22);
@@ -3839,6 +4040,20 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
             ret = new int[1];
         else
             ret = new int[diff / increment];
+        return range(from, to, increment, ret);
+    }
+
+/**
+ * range in to a caller provided buffer
+ * of at least max(|from - to| / increment, 1) ints
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+
+    inline int *range(int from, int to, int increment, int *ret) {
+        int diff = nd4j::math::nd4j_abs<int>(from - to);
+        int retLength = diff / increment;
         if (from < to) {
             int count = 0;
             for (int i = from; i < to; i += increment) {
@@ -3891,6 +4106,18 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
         traceNew(23);
 
         int *ret = new int[indexLength];
+        return keep(data, index, indexLength, dataLength, ret);
+    }
+
+/**
+ * keep in to a caller provided buffer
+ * of indexLength ints
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+
+    inline int *keep(volatile int *data, int *index, int indexLength, int dataLength, int *ret) {
         int count = 0;
         for (int i = 0; i < dataLength; i++) {
             int contains = 0;
@@ -3978,6 +4205,18 @@ __device__ inline int *cuMalloc(int *buffer, long size) {
         traceNew(25);
 
         int *ret = new int[arr1Length + arr2Length];
+        return concat(arr1, arr1Length, arr2, arr2Length, ret);
+    }
+
+/**
+ * concat in to a caller provided buffer
+ * of arr1Length + arr2Length ints
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+
+    inline int *concat(int *arr1, int arr1Length, int *arr2, int arr2Length, int *ret) {
         std::memcpy(ret, arr1, arr1Length * sizeof(int));
         std::memcpy(ret + arr1Length, arr2, arr2Length * sizeof(int));
         return ret;
@@ -4133,8 +4372,8 @@ __device__ int tadOffset(int *xInfo, int offset) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    int getOffset(int baseOffset,  int *shape,  int *stride,  int *indices, int rank) {
-        int offset = baseOffset;
+    Nd4jIndex getOffset(Nd4jIndex baseOffset,  int *shape,  int *stride,  int *indices, int rank) {
+        Nd4jIndex offset = baseOffset;
         for(int i = 0; i < rank; i++) {
             if(indices[i] >= shape[i] && shape[i] != 1) {
                 printf("Index %d [%d] must not be >= shape[%d].\n", i,indices[i],shape[i]);
@@ -4142,7 +4381,7 @@ __device__ int tadOffset(int *xInfo, int offset) {
             }
 
             if(shape[i] != 1) {
-                offset += (int) indices[i] * stride[i];
+                offset += (Nd4jIndex) indices[i] * stride[i];
             }
         }
 
@@ -4192,6 +4431,18 @@ __device__ int tadOffset(int *xInfo, int offset) {
         traceNew(29);
 
         int *ret = new int[shapeInfoLength(info->rank)];
+        return toShapeBuffer(info, ret);
+    }
+
+/**
+ * toShapeBuffer in to a caller provided buffer
+ * of shapeInfoLength(info->rank) ints
+ */
+#ifdef __CUDACC__
+    __host__ __device__
+#endif
+
+    inline int *toShapeBuffer( ShapeInformation *info, int *ret) {
         int count = 1;
         int rank = info->rank;
 
@@ -4415,8 +4666,8 @@ __device__ int tadOffset(int *xInfo, int offset) {
 #ifdef __CUDACC__
     __host__ __device__
 #endif
-    inline int prodLong( int *data, int length) {
-        int prod = 1;
+    inline Nd4jIndex prodLong( int *data, int length) {
+        Nd4jIndex prod = 1;
         for (int i = 0; i < length; i++) {
             prod *= data[i];
         }
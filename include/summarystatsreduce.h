@@ -12,6 +12,7 @@
 
 #include <shape.h>
 #include <op.h>
+#include <tadcache.h>
 #ifdef __CUDACC__
 #include <cuda.h>
 #include <cuda_runtime.h>
@@ -879,11 +880,11 @@ struct SharedSummaryStatsData<double> {
                          T *extraParams) {
                 SummaryStatsData<T> startingIndex;
                 startingIndex.initialize();
-                int length = shape::length(xShapeInfo);
+                Nd4jIndex length = shape::length(xShapeInfo);
                 int xElementWiseStride = shape::elementWiseStride(xShapeInfo);
                 if (xElementWiseStride == 1) {
 #pragma omp parallel for shared(startingIndex)
-                    for (int i = 0; i < length; i++) {
+                    for (Nd4jIndex i = 0; i < length; i++) {
                         SummaryStatsData<T> curr;
                         curr.initWithValue(x[i]);
 #pragma omp critical
@@ -899,7 +900,7 @@ struct SharedSummaryStatsData<double> {
                 } else {
 
 #pragma omp parallel for shared(startingIndex)
-                    for (int i = 0; i < length; i++) {
+                    for (Nd4jIndex i = 0; i < length; i++) {
                         SummaryStatsData<T> curr;
                         curr.initWithValue(x[i]);
 #pragma omp critical
@@ -947,16 +948,15 @@ struct SharedSummaryStatsData<double> {
                 }
 
 
-                shape::TAD tad(xShapeInfo,dimension,dimensionLength);
-                tad.createTadOnlyShapeInfo();
-                tad.createOffsets();
+                std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(xShapeInfo, dimension, dimensionLength);
+                shape::TAD &tad = *tadPack->tad;
 
                 //no-op
                 if(tad.dimensionLength < 1)
                     return;
 
 
-                int resultLength = shape::length(resultShapeInfoBuffer);
+                Nd4jIndex resultLength = shape::length(resultShapeInfoBuffer);
                 //pre squeezed: this is for keeping the pointer to the original
                 //shape information for tad offset
                 //the squeezed information doesn't render the right strides for
@@ -985,11 +985,9 @@ struct SharedSummaryStatsData<double> {
                     int *xStride = shape::stride(tadShapeShapeInfo);
                     int rank = shape::rank(tadShapeShapeInfo);
 #pragma omp  parallel  for
-                    for (int i = 0; i < resultLength; i++) {
-                        int offset = tad.tadOffsets[i];
+                    for (Nd4jIndex i = 0; i < resultLength; i++) {
+                        Nd4jIndex offset = tad.tadOffsets[i];
                         int shapeIter[MAX_RANK];
-                        int coord[MAX_RANK];
-                        int dim;
                         int rankIter = rank;
                         int xStridesIter[MAX_RANK];
                         T *xPointer = x + offset;
@@ -1003,17 +1001,14 @@ struct SharedSummaryStatsData<double> {
                                                      shapeIter,
                                                      &xPointer,
                                                      xStridesIter) >= 0) {
-                            ND4J_RAW_ITER_START(dim, rank, coord, shapeIter); {
+                            rankIter = CoalesceRawArrayIter(rankIter, shapeIter, xStridesIter);
+                            auto kernel = [&](T *xPointer) {
                                 /* Process the innermost dimension */
                                 SummaryStatsData<T> comp2;
                                 comp2.initWithValue(xPointer[0]);
                                 comp = update(comp, comp2, extraParams);
-                            } ND4J_RAW_ITER_ONE_NEXT(dim,
-                                                     rank,
-                                                     coord,
-                                                     shapeIter,
-                                                     xPointer,
-                                                     xStridesIter);
+                            };
+                            RawIterOne(rankIter, shapeIter, xPointer, xStridesIter, kernel);
                         }
                         else {
                             printf("Unable to prepare array\n");
@@ -1024,14 +1019,14 @@ struct SharedSummaryStatsData<double> {
                 }
                 else {
                     int tadElementWiseStride = shape::elementWiseStride(tad.tadOnlyShapeInfo);
-                    int tadLength = shape::length(tad.tadOnlyShapeInfo);
+                    Nd4jIndex tadLength = shape::length(tad.tadOnlyShapeInfo);
 #pragma omp parallel for
-                    for(int i = 0;  i < resultLength; i++) {
-                        int baseOffset = tad.tadOffsets[i];
+                    for(Nd4jIndex i = 0;  i < resultLength; i++) {
+                        Nd4jIndex baseOffset = tad.tadOffsets[i];
                         SummaryStatsData<T> comp;
                         comp.initWithValue(x[baseOffset]);
 #pragma omp simd
-                        for(int j = 1; j < tadLength; j++) {
+                        for(Nd4jIndex j = 1; j < tadLength; j++) {
                             SummaryStatsData<T> comp2;
                             comp2.initWithValue(x[baseOffset + tadElementWiseStride * j]);
                             comp = update(comp, comp2, extraParams);
@@ -0,0 +1,245 @@
+/*
+ * tadcache.h
+ *
+ * Tensor along dimension (TAD) information is a pure function of
+ * the shape information and the dimensions, yet building it
+ * (createTadOnlyShapeInfo + createOffsets) costs more than small
+ * reductions themselves. TadCache keeps the finished shape::TAD
+ * for recently used (shapeInfo contents, dimensions) keys and hands
+ * out shared references to it.
+ *
+ * Entries are evicted least recently used first once either the
+ * entry limit or the byte limit is exceeded. Evicted entries stay
+ * alive until the last caller holding them lets go.
+ */
+
+#ifndef TADCACHE_H_
+#define TADCACHE_H_
+#include <shape.h>
+#include <pointercast.h>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace shape {
+
+    /**
+     * A finished TAD along with private copies of the
+     * shape information and dimensions it points in to
+     */
+    class TadPack {
+    public:
+        int *shapeInfo;
+        int *dimension;
+        int dimensionLength;
+        TAD *tad;
+        Nd4jIndex bytes;
+
+        TadPack(int *shapeInfo, int *dimension, int dimensionLength) {
+            int shapeInfoLength = shape::shapeInfoLength(shape::rank(shapeInfo));
+            this->shapeInfo = new int[shapeInfoLength];
+            std::memcpy(this->shapeInfo, shapeInfo, shapeInfoLength * sizeof(int));
+            this->dimensionLength = dimensionLength;
+            this->dimension = new int[dimensionLength > 0 ? dimensionLength : 1];
+            if (dimensionLength > 0)
+                std::memcpy(this->dimension, dimension, dimensionLength * sizeof(int));
+
+            tad = new TAD(this->shapeInfo, this->dimension, dimensionLength);
+            tad->createTadOnlyShapeInfo();
+            tad->createOffsets();
+
+            bytes = (shapeInfoLength + dimensionLength) * sizeof(int);
+            if (tad->tadOnlyShapeInfo != nullptr)
+                bytes += shape::shapeInfoLength(shape::rank(tad->tadOnlyShapeInfo)) * sizeof(int);
+            if (tad->tadOffsets != nullptr)
+                bytes += tad->numTads * sizeof(Nd4jIndex);
+        }
+
+        ~TadPack() {
+            //the tad may point in to the copies, so it goes first
+            delete tad;
+            delete[] dimension;
+            delete[] shapeInfo;
+        }
+
+    private:
+        TadPack(const TadPack &other);
+        TadPack &operator=(const TadPack &other);
+    };
+
+    /**
+     * Thread safe LRU cache of TADs keyed by
+     * shape information contents and dimensions
+     */
+    class TadCache {
+    public:
+        /**
+         * The process wide cache
+         */
+        static TadCache *getInstance() {
+            static TadCache instance;
+            return &instance;
+        }
+
+        /**
+         * The TAD for the given shape and dimensions,
+         * built (and cached) on a miss.
+         * @param shapeInfo the shape information of the array
+         * @param dimension the dimensions to do the TAD along
+         * @param dimensionLength the number of dimensions
+         * @return a shared reference to the finished TAD
+         */
+        std::shared_ptr<TadPack> get(int *shapeInfo, int *dimension, int dimensionLength) {
+            std::vector<int> key = makeKey(shapeInfo, dimension, dimensionLength);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (maxEntries > 0) {
+                    auto found = index.find(key);
+                    if (found != index.end()) {
+                        hits++;
+                        //move to the front: most recently used
+                        entries.splice(entries.begin(), entries, found->second);
+                        return found->second->second;
+                    }
+                }
+
+                misses++;
+            }
+
+            //build outside the lock; a racing miss on the same key just builds twice
+            std::shared_ptr<TadPack> pack(new TadPack(shapeInfo, dimension, dimensionLength));
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (maxEntries < 1 || pack->bytes > maxBytes)
+                return pack;
+
+            auto found = index.find(key);
+            if (found != index.end()) {
+                entries.splice(entries.begin(), entries, found->second);
+                return found->second->second;
+            }
+
+            entries.push_front(std::make_pair(key, pack));
+            index[key] = entries.begin();
+            bytes += pack->bytes;
+            evict();
+            return pack;
+        }
+
+        /**
+         * Limit the cache size, evicting entries if needed.
+         * A maxEntries of 0 disables caching.
+         * @param maxEntries the maximum number of cached TADs
+         * @param maxBytes the maximum number of bytes held by cached TADs
+         */
+        void setLimits(int maxEntries, Nd4jIndex maxBytes) {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->maxEntries = maxEntries;
+            this->maxBytes = maxBytes;
+            evict();
+        }
+
+        /**
+         * Drop every cached entry, counters are kept
+         */
+        void purge() {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.clear();
+            index.clear();
+            bytes = 0;
+        }
+
+        /**
+         * Reset the hit, miss and eviction counters
+         */
+        void resetCounters() {
+            std::lock_guard<std::mutex> lock(mutex);
+            hits = 0;
+            misses = 0;
+            evictions = 0;
+        }
+
+        Nd4jIndex getHits() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return hits;
+        }
+
+        Nd4jIndex getMisses() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return misses;
+        }
+
+        Nd4jIndex getEvictions() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return evictions;
+        }
+
+        Nd4jIndex getSize() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return (Nd4jIndex) entries.size();
+        }
+
+        Nd4jIndex getBytes() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return bytes;
+        }
+
+    private:
+        struct KeyHash {
+            size_t operator()(const std::vector<int> &key) const {
+                //FNV-1a over the key ints
+                size_t hash = 14695981039346656037ULL;
+                for (size_t i = 0; i < key.size(); i++) {
+                    hash ^= (size_t) (unsigned int) key[i];
+                    hash *= 1099511628211ULL;
+                }
+
+                return hash;
+            }
+        };
+
+        typedef std::pair<std::vector<int>, std::shared_ptr<TadPack> > Entry;
+
+        std::mutex mutex;
+        std::list<Entry> entries;
+        std::unordered_map<std::vector<int>, std::list<Entry>::iterator, KeyHash> index;
+        int maxEntries = 1024;
+        Nd4jIndex maxBytes = 64L * 1024L * 1024L;
+        Nd4jIndex bytes = 0;
+        Nd4jIndex hits = 0;
+        Nd4jIndex misses = 0;
+        Nd4jIndex evictions = 0;
+
+        TadCache() {}
+        TadCache(const TadCache &other);
+        TadCache &operator=(const TadCache &other);
+
+        static std::vector<int> makeKey(int *shapeInfo, int *dimension, int dimensionLength) {
+            int shapeInfoLength = shape::shapeInfoLength(shape::rank(shapeInfo));
+            std::vector<int> key;
+            key.reserve(shapeInfoLength + dimensionLength + 1);
+            key.insert(key.end(), shapeInfo, shapeInfo + shapeInfoLength);
+            key.push_back(dimensionLength);
+            if (dimensionLength > 0)
+                key.insert(key.end(), dimension, dimension + dimensionLength);
+            return key;
+        }
+
+        //callers hold the lock
+        void evict() {
+            while (!entries.empty() && ((int) entries.size() > maxEntries || bytes > maxBytes)) {
+                Entry &last = entries.back();
+                bytes -= last.second->bytes;
+                index.erase(last.first);
+                entries.pop_back();
+                evictions++;
+            }
+        }
+    };
+}
+
+#endif /* TADCACHE_H_ */
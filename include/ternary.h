@@ -0,0 +1,408 @@
+/*
+ * ternary.h
+ *
+ * Elementwise transforms involving 3 input arrays:
+ * result = op(x, y, z)
+ */
+
+#ifndef TERNARY_H_
+#define TERNARY_H_
+#ifdef __JNI__
+#include <jni.h>
+#endif
+#include <op.h>
+#include <omp.h>
+#include <templatemath.h>
+#include <shape.h>
+#include <pairwise_util.h>
+#include <threadpool.h>
+#include <dll.h>
+#include <stdio.h>
+#ifdef __CUDACC__
+#include <cuda.h>
+#include <cuda_runtime.h>
+#endif
+
+namespace functions {
+    namespace ternary {
+
+/**
+ * Transforms involving 3 arrays
+ */
+        template<typename T>
+        class TernaryTransform : public virtual functions::ops::Op<T> {
+        public:
+            virtual
+#ifdef __CUDACC__
+            inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+            T op(T d1, T d2, T d3, T *params) = 0;
+
+
+            /**
+             * CPU operation execution
+             * @param dx the input data
+             * @param xShapeBuffer the shape information for x
+             * @param y the y data
+             * @param yShapeBuffer the shape information for y
+             * @param z the z data
+             * @param zShapeBuffer the shape information for z
+             * @param result the buffer
+             * to store the result in
+             * @param resultShapeBuffer the shape information for the result
+             * @param extraParams the extra parameters for the transform
+             */
+            virtual void exec(
+                    T *dx,
+                    int *xShapeBuffer,
+                    T *y,
+                    int *yShapeBuffer,
+                    T *z,
+                    int *zShapeBuffer,
+                    T *result,
+                    int *resultShapeBuffer,
+                    T *extraParams) {
+                Nd4jIndex n = shape::length(xShapeBuffer);
+                int xElementWiseStride = shape::elementWiseStride(xShapeBuffer);
+                int yElementWiseStride = shape::elementWiseStride(yShapeBuffer);
+                int zElementWiseStride = shape::elementWiseStride(zShapeBuffer);
+                int resultElementWiseStride = shape::elementWiseStride(resultShapeBuffer);
+                char xOrder = shape::order(xShapeBuffer);
+
+                if (xElementWiseStride >= 1 &&
+                    yElementWiseStride >= 1 &&
+                    zElementWiseStride >= 1 &&
+                    resultElementWiseStride >= 1 &&
+                    shape::order(yShapeBuffer) == xOrder &&
+                    shape::order(zShapeBuffer) == xOrder &&
+                    shape::order(resultShapeBuffer) == xOrder) {
+                    exec(dx,
+                         xElementWiseStride,
+                         y,
+                         yElementWiseStride,
+                         z,
+                         zElementWiseStride,
+                         result,
+                         resultElementWiseStride,
+                         extraParams,
+                         n);
+                }
+                else {
+                    int rank = shape::rank(xShapeBuffer);
+                    int *xShape = shape::shapeOf(xShapeBuffer);
+
+                    int *xStride = shape::stride(xShapeBuffer);
+                    int *yStride = shape::stride(yShapeBuffer);
+                    int *zStride = shape::stride(zShapeBuffer);
+                    int *resultStride = shape::stride(resultShapeBuffer);
+
+                    int shapeIter[MAX_RANK];
+                    int xStridesIter[MAX_RANK];
+                    int yStridesIter[MAX_RANK];
+                    int zStridesIter[MAX_RANK];
+                    int resultStridesIter[MAX_RANK];
+                    if (PrepareFourRawArrayIter<T>(rank,
+                                                   xShape,
+                                                   dx,
+                                                   xStride,
+                                                   y,
+                                                   yStride,
+                                                   z,
+                                                   zStride,
+                                                   result,
+                                                   resultStride,
+                                                   rank,
+                                                   shapeIter,
+                                                   &dx,
+                                                   xStridesIter,
+                                                   &y,
+                                                   yStridesIter,
+                                                   &z,
+                                                   zStridesIter,
+                                                   &result,
+                                                   resultStridesIter) >= 0) {
+                        rank = CoalesceRawArrayIter(rank, shapeIter, xStridesIter, yStridesIter, zStridesIter, resultStridesIter);
+                        auto kernel = [&](T *dx, T *y, T *z, T *result) {
+                            /* Process the innermost dimension */
+                            result[0] = op(dx[0], y[0], z[0], extraParams);
+                        };
+                        RawIterFour(rank, shapeIter, dx, xStridesIter, y, yStridesIter, z, zStridesIter, result, resultStridesIter, kernel);
+                    }
+                    else {
+                        printf("Unable to prepare array\n");
+                    }
+                }
+            }
+
+
+            /**
+             * CPU operation execution
+             * @param dx the input data
+             * @param xStride the stride to iterate over
+             * the x input
+             * @param y the y data
+             * @param yStride the stride to iterate
+             * over the y buffer
+             * @param z the z data
+             * @param zStride the stride to iterate
+             * over the z buffer
+             * @param result the buffer
+             * to store the result in
+             * @param resultStride the stride for the buffer
+             * @param extraParams the extra parameters for the transform
+             * @param n the length of the input
+             */
+            virtual void exec(T *dx,
+                              Nd4jIndex xStride,
+                              T *y,
+                              Nd4jIndex yStride,
+                              T *z,
+                              Nd4jIndex zStride,
+                              T *result,
+                              Nd4jIndex resultStride,
+                              T *extraParams,
+                              Nd4jIndex n) {
+                if (xStride == 1 && yStride == 1 && zStride == 1 && resultStride == 1) {
+                    if (n < 8000) {
+#pragma omp simd
+                        for (Nd4jIndex i = 0; i < n; i++) {
+                            result[i] = op(dx[i], y[i], z[i], extraParams);
+                        }
+                    }
+                    else {
+                        nd4j::parallelFor(0, n, nd4j::ELEMENT_GRAIN, [&](Nd4jIndex start, Nd4jIndex end) {
+#pragma omp simd
+                            for (Nd4jIndex i = start; i < end; i++) {
+                                result[i] = op(dx[i], y[i], z[i], extraParams);
+                            }
+                        });
+                    }
+                }
+                else {
+                    if (n < 8000) {
+#pragma omp simd
+                        for (Nd4jIndex i = 0; i < n; i++) {
+                            result[i * resultStride] = op(dx[i * xStride], y[i * yStride], z[i * zStride], extraParams);
+                        }
+                    }
+                    else {
+                        nd4j::parallelFor(0, n, nd4j::ELEMENT_GRAIN, [&](Nd4jIndex start, Nd4jIndex end) {
+#pragma omp simd
+                            for (Nd4jIndex i = start; i < end; i++) {
+                                result[i * resultStride] = op(dx[i * xStride], y[i * yStride], z[i * zStride], extraParams);
+                            }
+                        });
+                    }
+                }
+            }
+
+            virtual inline
+#ifdef __CUDACC__
+            __host__ __device__
+#endif
+            void aggregateExtraParams(T **extraParamsTotal,T **extraParamsLocal) {
+                //no extra params aggregation needs to happen
+            }
+#ifdef __CUDACC__
+            inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+            virtual ~TernaryTransform() {
+            }
+#ifdef __CUDACC__
+            inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+            TernaryTransform() {
+            }
+
+        };
+
+        namespace ops {
+/**
+ * x * y + z
+ */
+            template<typename T>
+            class FusedMultiplyAdd: public virtual TernaryTransform<T> {
+            public:
+                virtual
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                T op(T d1, T d2, T d3, T *params) {
+                    return d1 * d2 + d3;
+                }
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                virtual ~FusedMultiplyAdd() {
+                }
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                FusedMultiplyAdd() {
+                }
+            };
+
+/**
+ * a * x + b * y + c * z
+ * with a, b, c = params[0], params[1], params[2]
+ */
+            template<typename T>
+            class Axpby: public virtual TernaryTransform<T> {
+            public:
+                virtual
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                T op(T d1, T d2, T d3, T *params) {
+                    return params[0] * d1 + params[1] * d2 + params[2] * d3;
+                }
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                virtual ~Axpby() {
+                }
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                Axpby() {
+                    this->extraParamsLen = 3;
+                }
+            };
+
+/**
+ * where(x, y, z): y where x is non zero, z otherwise
+ */
+            template<typename T>
+            class Select: public virtual TernaryTransform<T> {
+            public:
+                virtual
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                T op(T d1, T d2, T d3, T *params) {
+                    return d1 != 0.0 ? d2 : d3;
+                }
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                virtual ~Select() {
+                }
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                Select() {
+                }
+            };
+
+/**
+ * x clamped to [y, z] elementwise
+ */
+            template<typename T>
+            class Clamp: public virtual TernaryTransform<T> {
+            public:
+                virtual
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                T op(T d1, T d2, T d3, T *params) {
+                    return nd4j::math::nd4j_min<T>(nd4j::math::nd4j_max<T>(d1, d2), d3);
+                }
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                virtual ~Clamp() {
+                }
+#ifdef __CUDACC__
+                inline __host__ __device__
+#elif defined(__GNUC__)
+
+#endif
+                Clamp() {
+                }
+            };
+        }
+
+        template<typename T>
+        class TernaryOpFactory {
+        public:
+
+#ifdef __CUDACC__
+            __host__ __device__
+#endif
+            TernaryOpFactory() {
+            }
+
+            /**
+             * Create an operation
+             * @param op the op number
+             * 0: fused multiply add (x * y + z)
+             * 1: axpby (a * x + b * y + c * z)
+             * 2: select (x != 0 ? y : z)
+             * 3: clamp (x clamped to [y, z])
+             * @return the operation based on the op number
+             */
+#ifdef __CUDACC__
+            __inline__ __device__
+            TernaryTransform<T> * getOp(int op, unsigned char *buffer) {
+#else
+            TernaryTransform<T> * getOp(int op) {
+#endif
+                if (op == 0)
+#ifdef __CUDACC__
+                    return new(buffer) ternary::ops::FusedMultiplyAdd<T>();
+#else
+                    return new ternary::ops::FusedMultiplyAdd<T>();
+#endif
+                else if (op == 1)
+#ifdef __CUDACC__
+                    return new(buffer) ternary::ops::Axpby<T>();
+#else
+                    return new ternary::ops::Axpby<T>();
+#endif
+                else if (op == 2)
+#ifdef __CUDACC__
+                    return new(buffer) ternary::ops::Select<T>();
+#else
+                    return new ternary::ops::Select<T>();
+#endif
+                else if (op == 3)
+#ifdef __CUDACC__
+                    return new(buffer) ternary::ops::Clamp<T>();
+#else
+                    return new ternary::ops::Clamp<T>();
+#endif
+                return nullptr;
+            }
+        };
+    }
+}
+
+#endif /* TERNARY_H_ */
@@ -0,0 +1,390 @@
+/*
+ * threadpool.h
+ *
+ * A work stealing thread pool the CPU kernels can run on
+ * in place of OpenMP.
+ *
+ * Every worker owns a deque of tasks: it pushes and pops at the
+ * back and, when its own deque runs dry, steals from the front of
+ * the others. Threads outside the pool share one more deque.
+ * A thread waiting on a TaskGroup runs queued tasks until the
+ * group is done instead of blocking, so a task may start and wait
+ * on groups of its own (nested parallelism) without deadlocking.
+ *
+ * parallelFor hands chunks of at least grain iterations to the
+ * caller and to helper tasks. The helpers are drawn from one
+ * concurrency budget shared by every caller in the process: when
+ * several threads call in at once they split the budget instead of
+ * each starting a full team of threads, as OpenMP would, and a
+ * caller that finds the budget used up runs its loop by itself.
+ *
+ * nd4j::parallelFor is what the kernels call: it runs on the pool
+ * when the pool is enabled, with enableThreadPool or by building
+ * with ND4J_THREAD_POOL defined, and on OpenMP otherwise. Either way
+ * it keeps to the thread budget and cores of the ExecutionContext
+ * current on the calling thread.
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+#include <pointercast.h>
+#include <executioncontext.h>
+#include <omp.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nd4j {
+
+    /**
+     * The fewest iterations of an elementwise loop
+     * worth handing to another thread
+     */
+    static const Nd4jIndex ELEMENT_GRAIN = 1024;
+
+    class ThreadPool {
+    public:
+        /**
+         * A set of tasks that can be waited on together
+         */
+        class TaskGroup {
+        public:
+            explicit TaskGroup(ThreadPool *pool) {
+                this->pool = pool;
+                pending = 0;
+            }
+
+            ~TaskGroup() {
+                wait();
+            }
+
+            /**
+             * Queues a task; any thread of the pool may run it
+             */
+            void run(std::function<void()> func) {
+                pending++;
+                pool->push(new Task(func, this));
+            }
+
+            /**
+             * Runs queued tasks, this group's or others',
+             * until every task of this group has run
+             */
+            void wait() {
+                while (pending.load() > 0) {
+                    if (!pool->runOne(pool->ownQueue()))
+                        std::this_thread::yield();
+                }
+            }
+
+        private:
+            friend class ThreadPool;
+            ThreadPool *pool;
+            std::atomic<int> pending;
+
+            TaskGroup(const TaskGroup &other);
+            TaskGroup &operator=(const TaskGroup &other);
+        };
+
+        /**
+         * @param workers the number of worker threads
+         */
+        explicit ThreadPool(int workers) {
+            if (workers < 1)
+                workers = 1;
+            queued = 0;
+            helpersInUse = 0;
+            helperLimit = workers;
+            stopping = false;
+            //queue 0 is for threads outside the pool
+            for (int i = 0; i <= workers; i++)
+                queues.push_back(new Queue());
+            for (int i = 1; i <= workers; i++)
+                threads.push_back(std::thread(&ThreadPool::work, this, i));
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(sleepLock);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (size_t i = 0; i < threads.size(); i++)
+                threads[i].join();
+            for (size_t i = 0; i < queues.size(); i++) {
+                for (size_t j = 0; j < queues[i]->tasks.size(); j++)
+                    delete queues[i]->tasks[j];
+                delete queues[i];
+            }
+        }
+
+        /**
+         * The pool the kernels run on: one worker
+         * per hardware thread but the caller's
+         */
+        static ThreadPool *getInstance() {
+            //leaked on purpose: workers must not be joined during static destruction
+            static ThreadPool *pool = new ThreadPool((int) std::thread::hardware_concurrency() - 1);
+            return pool;
+        }
+
+        /**
+         * Whether nd4j::parallelFor runs on the pool (true) or on OpenMP
+         */
+        static bool isEnabled() {
+            return enabledFlag().load();
+        }
+
+        static void setEnabled(bool reallyEnable) {
+            enabledFlag().store(reallyEnable);
+        }
+
+        int numWorkers() {
+            return (int) threads.size();
+        }
+
+        /**
+         * Caps the number of workers helping parallelFor
+         * callers at any one time, over all callers together.
+         * 0 leaves every caller to run its loops alone.
+         * @param threads the most workers busy with parallelFor
+         */
+        void setConcurrency(int threads) {
+            helperLimit = threads < 0 ? 0 : threads;
+        }
+
+        int getConcurrency() {
+            return helperLimit.load();
+        }
+
+        /**
+         * Calls func(chunkStart, chunkEnd) on ranges covering
+         * [start, end), from the calling thread and from as many
+         * workers as the concurrency budget allows
+         * @param start the first iteration
+         * @param end one past the last iteration
+         * @param grain the fewest iterations in a range
+         * @param func the callable
+         * @param maxThreads the most threads to use, caller included; 0 for no limit
+         * @param context the context helpers run in, if any
+         */
+        template<typename Functor>
+        void parallelFor(Nd4jIndex start, Nd4jIndex end, Nd4jIndex grain, Functor &func, int maxThreads = 0, ExecutionContext *context = nullptr) {
+            Nd4jIndex length = end - start;
+            if (length <= 0)
+                return;
+            if (grain < 1)
+                grain = 1;
+
+            Nd4jIndex ranges = (length + grain - 1) / grain;
+            int wanted = ranges - 1 < numWorkers() ? (int) (ranges - 1) : numWorkers();
+            if (maxThreads > 0 && wanted > maxThreads - 1)
+                wanted = maxThreads - 1;
+            int helpers = acquireHelpers(wanted);
+            if (helpers == 0) {
+                func(start, end);
+                return;
+            }
+
+            //a few ranges per thread, so threads that start late or run slow even out
+            Nd4jIndex chunk = length / ((helpers + 1) * 4);
+            if (chunk < grain)
+                chunk = grain;
+
+            std::atomic<Nd4jIndex> next(start);
+            auto drain = [&]() {
+                while (true) {
+                    Nd4jIndex chunkStart = next.fetch_add(chunk);
+                    if (chunkStart >= end)
+                        return;
+                    func(chunkStart, chunkStart + chunk < end ? chunkStart + chunk : end);
+                }
+            };
+
+            TaskGroup group(this);
+            for (int i = 0; i < helpers; i++) {
+                group.run([&, i] {
+                    AffinityScope scope(context, i + 1);
+                    drain();
+                });
+            }
+            drain();
+            group.wait();
+            releaseHelpers(helpers);
+        }
+
+    private:
+        struct Task {
+            Task(std::function<void()> func, TaskGroup *group) : func(func), group(group) {}
+            std::function<void()> func;
+            TaskGroup *group;
+        };
+
+        struct Queue {
+            std::mutex lock;
+            std::deque<Task *> tasks;
+        };
+
+        std::vector<Queue *> queues;
+        std::vector<std::thread> threads;
+        std::atomic<int> queued;
+        std::atomic<int> helpersInUse;
+        std::atomic<int> helperLimit;
+        std::mutex sleepLock;
+        std::condition_variable wake;
+        bool stopping;
+
+        ThreadPool(const ThreadPool &other);
+        ThreadPool &operator=(const ThreadPool &other);
+
+        static std::atomic<bool> &enabledFlag() {
+#ifdef ND4J_THREAD_POOL
+            static std::atomic<bool> enabled(true);
+#else
+            static std::atomic<bool> enabled(false);
+#endif
+            return enabled;
+        }
+
+        /**
+         * The pool the calling thread works for, if any, and its queue there
+         */
+        static ThreadPool *&currentPool() {
+            static thread_local ThreadPool *pool = nullptr;
+            return pool;
+        }
+
+        static int &currentQueue() {
+            static thread_local int queue = 0;
+            return queue;
+        }
+
+        int ownQueue() {
+            return currentPool() == this ? currentQueue() : 0;
+        }
+
+        int acquireHelpers(int wanted) {
+            if (wanted <= 0)
+                return 0;
+            int used = helpersInUse.load();
+            while (true) {
+                int available = helperLimit.load() - used;
+                if (available <= 0)
+                    return 0;
+                int taken = wanted < available ? wanted : available;
+                if (helpersInUse.compare_exchange_weak(used, used + taken))
+                    return taken;
+            }
+        }
+
+        void releaseHelpers(int helpers) {
+            helpersInUse -= helpers;
+        }
+
+        void push(Task *task) {
+            Queue *queue = queues[ownQueue()];
+            {
+                std::lock_guard<std::mutex> lock(queue->lock);
+                queue->tasks.push_back(task);
+            }
+            queued++;
+            //taking the lock orders the push before the check of a worker about to sleep
+            {
+                std::lock_guard<std::mutex> lock(sleepLock);
+            }
+            wake.notify_one();
+        }
+
+        /**
+         * Runs one task: the newest of queue self,
+         * or else the oldest of another queue
+         * @return false if there was nothing to run
+         */
+        bool runOne(int self) {
+            Task *task = nullptr;
+            int numQueues = (int) queues.size();
+            for (int i = 0; i < numQueues && task == nullptr; i++) {
+                Queue *queue = queues[(self + i) % numQueues];
+                std::lock_guard<std::mutex> lock(queue->lock);
+                if (queue->tasks.empty())
+                    continue;
+                if (i == 0) {
+                    task = queue->tasks.back();
+                    queue->tasks.pop_back();
+                }
+                else {
+                    task = queue->tasks.front();
+                    queue->tasks.pop_front();
+                }
+            }
+
+            if (task == nullptr)
+                return false;
+
+            queued--;
+            task->func();
+            task->group->pending--;
+            delete task;
+            return true;
+        }
+
+        void work(int index) {
+            currentPool() = this;
+            currentQueue() = index;
+            while (true) {
+                if (runOne(index))
+                    continue;
+                std::unique_lock<std::mutex> lock(sleepLock);
+                wake.wait(lock, [&] { return stopping || queued.load() > 0; });
+                if (stopping)
+                    return;
+            }
+        }
+    };
+
+    /**
+     * Calls func(chunkStart, chunkEnd) on ranges covering [start, end)
+     * in parallel, on the thread pool when it is enabled and on the
+     * OpenMP threads otherwise. Ranges hold at least grain iterations.
+     */
+    template<typename Functor>
+    inline void parallelFor(Nd4jIndex start, Nd4jIndex end, Nd4jIndex grain, Functor func) {
+        if (ThreadPool::isEnabled()) {
+            ExecutionContext *context = ExecutionContext::current();
+            int maxThreads = context != nullptr ? context->getThreads() : 0;
+            ThreadPool::getInstance()->parallelFor(start, end, grain, func, maxThreads, context);
+            return;
+        }
+
+        Nd4jIndex length = end - start;
+        if (grain < 1)
+            grain = 1;
+        Nd4jIndex ranges = (length + grain - 1) / grain;
+        int threads = omp_get_max_threads();
+        if (ranges < threads)
+            threads = (int) ranges;
+        if (threads <= 1) {
+            if (length > 0)
+                func(start, end);
+            return;
+        }
+
+#pragma omp parallel num_threads(threads)
+        {
+            int parts = omp_get_num_threads();
+            int part = omp_get_thread_num();
+            Nd4jIndex span = length / parts;
+            Nd4jIndex extra = length % parts;
+            Nd4jIndex first = start + part * span + (part < extra ? part : extra);
+            Nd4jIndex last = first + span + (part < extra ? 1 : 0);
+            if (first < last)
+                func(first, last);
+        }
+    }
+}
+
+#endif /* THREADPOOL_H_ */
@@ -13,6 +13,7 @@
 #include <op.h>
 #include <omp.h>
 #include <pairwise_util.h>
+#include <rawiterplan.h>
 #include <dll.h>
 #include "reduce.h"
 #include "scalar.h"
@@ -41,6 +42,14 @@ namespace functions {
             bool requiresSpecial = false;
 
         public:
+            /**
+             * Whether the op is not elementwise
+             * and has to run through its own exec
+             */
+            bool isSpecial() {
+                return requiresSpecial;
+            }
+
 
             /**
              *
@@ -231,9 +240,9 @@ namespace functions {
                     int *resultShapeInfo,
                     T *extraParams,
                     Nd4jIndex *indexes) {
-                int n = shape::length(xShapeInfo);
+                Nd4jIndex n = shape::length(xShapeInfo);
 #pragma omp simd
-                for (int i = 0; i < n; i++) {
+                for (Nd4jIndex i = 0; i < n; i++) {
                     result[indexes[i]] = op(dx[indexes[i]], extraParams);
                 }
             }
@@ -256,9 +265,9 @@ namespace functions {
                     T *extraParams,
                      Nd4jIndex *indexes,
                     Nd4jIndex *resultIndexes) {
-                int n = shape::length(xShapeInfo);
+                Nd4jIndex n = shape::length(xShapeInfo);
 #pragma omp parallel for
-                for (int i = 0; i < n; i++) {
+                for (Nd4jIndex i = 0; i < n; i++) {
                     result[resultIndexes[i]] = op(dx[indexes[i]], extraParams);
                 }
             }
@@ -286,52 +295,24 @@ namespace functions {
                     return;
                 }
 
-                int n = shape::length(xShapeInfo);
+                Nd4jIndex n = shape::length(xShapeInfo);
                 int xElementWiseStride = shape::elementWiseStride(xShapeInfo);
                 int resultElementWiseStride = shape::elementWiseStride(resultShapeInfo);
                 if(xElementWiseStride >= 1 && resultElementWiseStride >= 1 && shape::order(xShapeInfo) == shape::order(resultShapeInfo)) {
                     exec(dx,xElementWiseStride,result,resultElementWiseStride,extraParams,n);
                 }
                 else {
-                    int shapeIter[MAX_RANK];
-                    int coord[MAX_RANK];
-                    int dim;
-                    int xStridesIter[MAX_RANK];
-                    int resultStridesIter[MAX_RANK];
-                    int *xShape = shape::shapeOf(xShapeInfo);
-                    int *xStride = shape::stride(xShapeInfo);
-                    int *resultStride = shape::stride(resultShapeInfo);
-                    int rank = shape::rank(xShapeInfo);
-                    if(PrepareTwoRawArrayIter<T>(rank,
-                                                 xShape,
-                                                 dx,
-                                                 xStride,
-                                                 result,
-                                                 resultStride,
-                                                 &rank,
-                                                 shapeIter,
-                                                 &dx,
-                                                 xStridesIter,
-                                                 &result,
-                                                 resultStridesIter) >= 0) {
-                        ND4J_RAW_ITER_START(dim, rank, coord, shapeIter);
-                        {
-                            /* Process the innermost dimension */
-                            T *xIter = dx;
-                            T *resultIter = result;
-                            resultIter[0] = op(xIter[0], extraParams);
+                    RawIterPlan plan(xShapeInfo, resultShapeInfo);
+                    const Nd4jIndex xInner = plan.strides[0][0];
+                    const Nd4jIndex resultInner = plan.strides[1][0];
+                    auto kernel = [&](Nd4jIndex *offsets, Nd4jIndex count) {
+                        T *xIter = dx + offsets[0];
+                        T *resultIter = result + offsets[1];
+                        for (Nd4jIndex i = 0; i < count; i++) {
+                            resultIter[i * resultInner] = op(xIter[i * xInner], extraParams);
                         }
-                        ND4J_RAW_ITER_TWO_NEXT(dim,
-                                               rank,
-                                               coord,
-                                               shapeIter,
-                                               dx,
-                                               xStridesIter,
-                                               result,
-                                               resultStridesIter);
-
-                    }
-
+                    };
+                    plan.runParallel(kernel);
                 }
 
             }
@@ -348,23 +329,25 @@ namespace functions {
              * @param n the number of elements to iterate on
              */
             virtual void exec(T *dx,
-                              int xStride,
+                              Nd4jIndex xStride,
                               T *result,
-                              int resultStride,
+                              Nd4jIndex resultStride,
                               T *extraParams,
-                              int n) {
+                              Nd4jIndex n) {
                 if (xStride == 1 && resultStride == 1) {
                     if(n < 8000) {
 #pragma omp simd
-                        for (int i = 0; i < n; i++) {
+                        for (Nd4jIndex i = 0; i < n; i++) {
                             result[i] = op(dx[i], extraParams);
                         }
                     }
                     else {
-#pragma omp parallel  for
-                        for (int i = 0; i < n; i++) {
-                            result[i] = op(dx[i], extraParams);
-                        }
+                        nd4j::parallelFor(0, n, nd4j::ELEMENT_GRAIN, [&](Nd4jIndex start, Nd4jIndex end) {
+#pragma omp simd
+                            for (Nd4jIndex i = start; i < end; i++) {
+                                result[i] = op(dx[i], extraParams);
+                            }
+                        });
                     }
 
                 }
@@ -373,17 +356,19 @@ namespace functions {
                 else {
                     if(n < 8000) {
 #pragma omp simd
-                        for (int i = 0; i < n; i++) {
+                        for (Nd4jIndex i = 0; i < n; i++) {
                             result[i * resultStride] = op(dx[i * xStride],
                                                           extraParams);
                         }
                     }
                     else {
-#pragma omp parallel for
-                        for (int i = 0; i < n; i++) {
-                            result[i * resultStride] = op(dx[i * xStride],
-                                                          extraParams);
-                        }
+                        nd4j::parallelFor(0, n, nd4j::ELEMENT_GRAIN, [&](Nd4jIndex start, Nd4jIndex end) {
+#pragma omp simd
+                            for (Nd4jIndex i = start; i < end; i++) {
+                                result[i * resultStride] = op(dx[i * xStride],
+                                                              extraParams);
+                            }
+                        });
                     }
 
                 }
@@ -3297,8 +3282,8 @@ namespace functions {
                     int xOutTo = this->outSize(inShape[3], kernelWidth, strideX, padWidth, coverAll);
 
 
-                    int *outIndices = new int[6];
-                    int *inIndices = new int[4];
+                    int outIndices[6];
+                    int inIndices[4];
 
                     int inStride2 = inStride[2];
                     int inStride3 = inStride[3];
@@ -3407,8 +3392,6 @@ namespace functions {
                         }
                     }
 
-                    delete[] inIndices;
-                    delete[] outIndices;
 
                 }
 
@@ -3627,8 +3610,8 @@ namespace functions {
                     int *outStride = shape::stride(resultShapeBuffer);
 
 
-                    int *outIndices = new int[4];
-                    int *inIndices = new int[6];
+                    int outIndices[4];
+                    int inIndices[6];
 
                     int inStride2 = inStride[2];
                     int inStride3 = inStride[3];
@@ -3733,8 +3716,6 @@ namespace functions {
                     }
 
 
-                    delete[] outIndices;
-                    delete[] inIndices;
                 }
 
 
@@ -3940,7 +3921,8 @@ namespace functions {
                         for (int i = 0; i < shape[0]; i++)
                             maxResult[i] = 0.0;
                         int maxShape[2] = {shape[0], 1};
-                        int *maxResultShapeBuffer = shape::shapeBuffer(2, maxShape);
+                        int maxResultShapeBuffer[8];
+                        shape::shapeBuffer(2, maxShape, maxResultShapeBuffer);
                         max->exec(dx, xShapeBuffer, extraParams, maxResult.data(), maxResultShapeBuffer, maxDimension, 1);
 
                         //subtract max of each row
@@ -3965,37 +3947,35 @@ namespace functions {
                         delete sum;
                         delete max;
                         delete div;
-
-                        delete[] maxResultShapeBuffer;
                     }
                     else if (shape::isVector(xShapeBuffer)) {
                         T max = 0;
                         T sum = 0;
                         int elementWiseStride = shape::elementWiseStride(xShapeBuffer);
                         int resultElementWiseStride = shape::elementWiseStride(resultShapeBuffer);
-                        int length = shape::length(xShapeBuffer);
+                        Nd4jIndex length = shape::length(xShapeBuffer);
                         if (elementWiseStride >= 1 && resultElementWiseStride >= 1) {
                             if (elementWiseStride == 1 && resultElementWiseStride == 1) {
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     max = nd4j::math::nd4j_max<T>(max, dx[i]);
                                 }
 
 
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     result[i] = dx[i] - max;
                                 }
 
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     result[i] = nd4j::math::nd4j_exp<T>(result[i]);
                                 }
 
 
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     sum += result[i];
                                 }
 
 
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     result[i] /= sum;
                                 }
 
@@ -4003,20 +3983,20 @@ namespace functions {
                             }
                             else {
 
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     max = nd4j::math::nd4j_max<T>(max, dx[i * elementWiseStride]);
                                 }
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     result[i * resultElementWiseStride] = dx[i * elementWiseStride] - max;
                                 }
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     result[i * resultElementWiseStride] = nd4j::math::nd4j_exp<T>(
                                             result[i * resultElementWiseStride]);
                                 }
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     sum += result[i * resultElementWiseStride];
                                 }
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     result[i * resultElementWiseStride] /= sum;
                                 }
                             }
@@ -4197,7 +4177,8 @@ namespace functions {
                         for (int i = 0; i < shape[0]; i++)
                             maxResult[i] = 0.0;
                         int maxShape[2] = {shape[0], 1};
-                        int *maxResultShapeBuffer = shape::shapeBuffer(2, maxShape);
+                        int maxResultShapeBuffer[8];
+                        shape::shapeBuffer(2, maxShape, maxResultShapeBuffer);
                         max->exec(dx, xShapeBuffer, extraParams, maxResult.data(), maxResultShapeBuffer, maxDimension, 1);
 
                         //subtract max of each row
@@ -4225,18 +4206,16 @@ namespace functions {
                         delete max;
                         delete div;
                         delete log;
-
-                        delete[] maxResultShapeBuffer;
                     }
                     else if (shape::isVector(xShapeBuffer, 2)) {
                         T max = 0;
                         T sum = 0;
 
                         int elementWiseStride = shape::elementWiseStride(xShapeBuffer);
-                        int length = shape::length(xShapeBuffer);
+                        Nd4jIndex length = shape::length(xShapeBuffer);
                         if (elementWiseStride == 1) {
 #pragma omp parallel for shared(max)
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
 #pragma omp critical
                                 {
                                     max = nd4j::math::nd4j_max<T>(max, result[i]);
@@ -4244,17 +4223,17 @@ namespace functions {
                                 }
                             }
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i] -= max;
                             }
 
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i] = nd4j::math::nd4j_exp<T>(result[i]);
                             }
 
 #pragma omp parallel for shared(sum)
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
 #pragma omp critical
                                 {
                                     sum += result[i];
@@ -4263,7 +4242,7 @@ namespace functions {
                             }
 
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i] /= sum;
                                 result[i] = nd4j::math::nd4j_log<T>(result[i]);
                             }
@@ -4271,26 +4250,26 @@ namespace functions {
                         }
                         else {
 
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 max = nd4j::math::nd4j_max<T>(max, result[i * elementWiseStride]);
                             }
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i * elementWiseStride] -= max;
                             }
 
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i * elementWiseStride] = nd4j::math::nd4j_exp<T>(result[i * elementWiseStride]);
                             }
 
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 sum += result[i * elementWiseStride];
 
                             }
 
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i * elementWiseStride] /= sum;
                                 result[i * elementWiseStride] = nd4j::math::nd4j_log<T>(result[i * elementWiseStride]);
                             }
@@ -4480,7 +4459,7 @@ namespace functions {
                         //iterate along rows
                         int dimension[1] = {0};
                         int maxDimension[1] = {1};
-                        int len = shape::length(xShapeBuffer);
+                        Nd4jIndex len = shape::length(xShapeBuffer);
                         //compute the row wise maxes
                         functions::reduce::ops::Max<T> *max = new functions::reduce::ops::Max<T>();
                         std::vector <T> maxResult(shape[0]);
@@ -4488,7 +4467,8 @@ namespace functions {
                         for (int i = 0; i < shape[0]; i++)
                             maxResult[i] = 0.0;
                         int maxShape[2] = {shape[0], 1};
-                        int *maxResultShapeBuffer = shape::shapeBuffer(2, maxShape);
+                        int maxResultShapeBuffer[8];
+                        shape::shapeBuffer(2, maxShape, maxResultShapeBuffer);
                         max->exec(dx, xShapeBuffer, extraParams, maxResult.data(), maxResultShapeBuffer, maxDimension, 1);
 
                         //subtract max of each row
@@ -4511,14 +4491,14 @@ namespace functions {
                         if (resultEleStide >= 1) {
                             if (resultEleStide == 1) {
 #pragma omp parallel for
-                                for (int i = 0; i < len; i++) {
+                                for (Nd4jIndex i = 0; i < len; i++) {
                                     result[i] = result[i] * (1 - result[i]);
                                 }
 
                             }
                             else {
 #pragma omp parallel for
-                                for (int i = 0; i < len; i++) {
+                                for (Nd4jIndex i = 0; i < len; i++) {
                                     result[i * resultEleStide] = result[i * resultEleStide] * (1 - result[i * resultEleStide]);
                                 }
 
@@ -4535,37 +4515,35 @@ namespace functions {
                         delete sum;
                         delete max;
                         delete div;
-
-                        delete[] maxResultShapeBuffer;
                     }
                     else if (shape::isVector(xShapeBuffer, 2)) {
                         T max = 0;
                         T sum = 0;
 
                         int elementWiseStride = shape::elementWiseStride(xShapeBuffer);
-                        int length = shape::length(xShapeBuffer);
+                        Nd4jIndex length = shape::length(xShapeBuffer);
                         if (elementWiseStride == 1) {
 #pragma omp parallel for shared(max)
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 max = nd4j::math::nd4j_max<T>(max, result[i]);
                             }
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i] -= max;
                             }
 
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i] = nd4j::math::nd4j_exp<T>(result[i]);
                             }
 
 #pragma omp parallel for shared(sum)
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 sum += result[i];
                             }
 
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i] /= sum;
                             }
 
@@ -4573,7 +4551,7 @@ namespace functions {
                         else {
 
 #pragma omp parallel for shared(max)
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
 #pragma omp critical
                                 {
                                     max = nd4j::math::nd4j_max<T>(max, result[i * elementWiseStride]);
@@ -4581,17 +4559,17 @@ namespace functions {
                                 }
                             }
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i * elementWiseStride] -= max;
                             }
 
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i * elementWiseStride] = nd4j::math::nd4j_exp<T>(result[i * elementWiseStride]);
                             }
 
 #pragma omp parallel for shared(sum)
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
 #pragma omp critical
                                 {
                                     sum += result[i * elementWiseStride];
@@ -4599,7 +4577,7 @@ namespace functions {
                             }
 
 #pragma omp parallel for
-                            for (int i = 0; i < length; i++) {
+                            for (Nd4jIndex i = 0; i < length; i++) {
                                 result[i * elementWiseStride] /= sum;
                             }
 
@@ -4719,7 +4697,7 @@ namespace functions {
                         T *result,
                         int *resultShapeBuffer,
                         T *extraParams) {
-                    int length = shape::length(xShapeBuffer);
+                    Nd4jIndex length = shape::length(xShapeBuffer);
                     int eleStride = shape::elementWiseStride(xShapeBuffer);
                     int resultEleStride = shape::elementWiseStride(resultShapeBuffer);
                     char xOrder = shape::order(xShapeBuffer);
@@ -4730,7 +4708,7 @@ namespace functions {
                                 int maxIdx = 0;
                                 T currMax = dx[0];
 #pragma omp simd
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     if (currMax < dx[i]) {
                                         currMax = dx[i];
                                         maxIdx = i;
@@ -4747,7 +4725,7 @@ namespace functions {
                                 int maxIdx = 0;
                                 T currMax = dx[0];
 #pragma omp parallel for shared(maxIdx,currMax)
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     if (currMax < dx[i]) {
                                         currMax = dx[i];
                                         maxIdx = i;
@@ -4765,7 +4743,7 @@ namespace functions {
                                 int maxIdx = 0;
                                 T currMax = dx[0];
 #pragma omp simd
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     result[i * resultEleStride] = 0.0;
                                     if (currMax < dx[i * eleStride]) {
                                         currMax = dx[i * eleStride];
@@ -4780,7 +4758,7 @@ namespace functions {
                                 int maxIdx = 0;
                                 T currMax = dx[0];
 #pragma omp parallel for shared(maxIdx,currMax)
-                                for (int i = 0; i < length; i++) {
+                                for (Nd4jIndex i = 0; i < length; i++) {
                                     result[i * resultEleStride] = 0.0;
                                     if (currMax < dx[i * eleStride]) {
                                         currMax = dx[i * eleStride];
@@ -4797,8 +4775,6 @@ namespace functions {
 
                     else {
                         int shapeIter[MAX_RANK];
-                        int coord[MAX_RANK];
-                        int dim;
                         int xStridesIter[MAX_RANK];
                         int resultStridesIter[MAX_RANK];
                         int *xShape = shape::shapeOf(xShapeBuffer);
@@ -4821,25 +4797,15 @@ namespace functions {
                             T value = dx[0];
                             int idx = 0;
                             int maxIdx = 0;
-                            ND4J_RAW_ITER_START(dim, rank, coord, shapeIter); {
+                            auto kernel = [&](T *dx, T *result) {
                                 if(dx[0] > value) {
                                     value = dx[0];
                                     maxIdx = idx;
                                 }
-
                                 idx++;
                                 result[0] = 0.0;
-
-                            }
-                            ND4J_RAW_ITER_TWO_NEXT(
-                                    dim,
-                                    rank,
-                                    coord,
-                                    shapeIter,
-                                    dx,
-                                    xStridesIter,
-                                    result,
-                                    resultStridesIter);
+                            };
+                            RawIterTwo(rank, shapeIter, dx, xStridesIter, result, resultStridesIter, kernel);
 
                             //pointer to where max value would be
                             if(shape::order(resultShapeBuffer) == 'c' || (shape::order(resultShapeBuffer) == 'f' &&
@@ -4940,19 +4906,22 @@ namespace functions {
                         T *result,
                         int *resultShapeBuffer,
                         T *extraParams) {
+                    //no array has more than MAX_RANK dimensions to take the max along,
+                    //so a longer (or negative) count is taken as the whole array
                     if (extraParams == nullptr || extraParams[0] == 0 ||
-                        (extraParams[0] == 1 && extraParams[1] == MAX_DIMENSION)) {
+                        (extraParams[0] == 1 && extraParams[1] == MAX_DIMENSION) ||
+                        extraParams[0] < 0 || extraParams[0] > MAX_RANK) {
                         this->doAll(dx, xShapeBuffer, result, resultShapeBuffer, extraParams);
                     }
                     else if(shape::isVector(xShapeBuffer)) {
                         int dimensionLength = (int) extraParams[0];
-                        int *dimension = new int[dimensionLength];
-                        int length = shape::length(xShapeBuffer);
+                        int dimension[MAX_RANK];
+                        Nd4jIndex length = shape::length(xShapeBuffer);
                         for (int i = 0; i < dimensionLength; i++) {
                             dimension[i] = (int) extraParams[i + 1];
                         }
                         if (shape::shapeOf(xShapeBuffer)[dimension[0]] == 1) {
-                            for(int i = 0; i < length; i++) {
+                            for(Nd4jIndex i = 0; i < length; i++) {
                                 result[i] = 1.0;
                             }
                         }
@@ -4963,7 +4932,7 @@ namespace functions {
                                 T currMax = dx[0];
                                 if (length < 8000) {
 #pragma omp simd
-                                    for (int i = 0; i < length; i++) {
+                                    for (Nd4jIndex i = 0; i < length; i++) {
                                         if (currMax < dx[i]) {
                                             currMax = dx[i];
                                             maxIdx = i;
@@ -4975,7 +4944,7 @@ namespace functions {
                                 }
                                 else {
 #pragma omp parallel for shared(maxIdx,currMax)
-                                    for (int i = 0; i < length; i++) {
+                                    for (Nd4jIndex i = 0; i < length; i++) {
                                         if (currMax < dx[i]) {
                                             currMax = dx[i];
                                             maxIdx = i;
@@ -4996,7 +4965,7 @@ namespace functions {
                                 T currMax = dx[0];
                                 if (length < 8000) {
 #pragma omp simd
-                                    for (int i = 0; i < length; i++) {
+                                    for (Nd4jIndex i = 0; i < length; i++) {
                                         if (currMax < dx[i * eleStride]) {
                                             currMax = dx[i * eleStride];
                                             maxIdx = i;
@@ -5008,7 +4977,7 @@ namespace functions {
                                 }
                                 else {
 #pragma omp parallel for shared(maxIdx,currMax)
-                                    for (int i = 0; i < length; i++) {
+                                    for (Nd4jIndex i = 0; i < length; i++) {
                                         if (currMax < dx[i * eleStride]) {
                                             currMax = dx[i * eleStride];
                                             maxIdx = i;
@@ -5028,7 +4997,7 @@ namespace functions {
                     }
                     else {
                         int dimensionLength = (int) extraParams[0];
-                        int *dimension = (int *) malloc(sizeof(int) *dimensionLength);
+                        int dimension[MAX_RANK];
                         for (int i = 0; i < dimensionLength; i++) {
                             dimension[i] = (int) extraParams[i + 1];
                         }
@@ -5047,10 +5016,8 @@ namespace functions {
                         int *tadShapeShapeInfo = tad.tadOnlyShapeInfo;
 #pragma omp  parallel  for
                         for (int i = 0; i < tads; i++) {
-                            int offset = tad.tadOffsets[i];
+                            Nd4jIndex offset = tad.tadOffsets[i];
                             int shapeIter[MAX_RANK];
-                            int coord[MAX_RANK];
-                            int dim;
                             int xStridesIter[MAX_RANK];
                             int resultStridesIter[MAX_RANK];
                             int *xShape = shape::shapeOf(tadShapeShapeInfo);
@@ -5075,23 +5042,15 @@ namespace functions {
                                                           xStridesIter,
                                                           &resultPointer,
                                                           resultStridesIter) >= 0) {
-                                ND4J_RAW_ITER_START(dim, rank, coord, shapeIter); {
+                                auto kernel = [&](T *xPointer, T *resultPointer) {
                                     if (maxValue < xPointer[0]) {
                                         maxCursor = resultPointer;
                                         maxCursorLong = reinterpret_cast<Nd4jPointer>(resultPointer);
                                         maxValue = xPointer[0];
                                     }
-
                                     resultPointer[0] = 0.0;
-                                }
-                                ND4J_RAW_ITER_TWO_NEXT(dim,
-                                                       rank,
-                                                       coord,
-                                                       shapeIter,
-                                                       xPointer,
-                                                       xStridesIter,
-                                                       resultPointer,
-                                                       resultStridesIter);
+                                };
+                                RawIterTwo(rank, shapeIter, xPointer, xStridesIter, resultPointer, resultStridesIter, kernel);
                                 maxCursor = reinterpret_cast<T *>(maxCursorLong);
                                 maxCursor[0] = 1.0;
                             }
@@ -9,6 +9,23 @@
 #include <indexreducetests.h>
 #include <summarystatsreducetest.h>
 #include <pairwiseutiltests.h>
+#include <histogramtests.h>
+#include <ternarytests.h>
+#include <masktests.h>
+#include <tadcachetests.h>
+#include <rawiterplantests.h>
+#include <hostpooltests.h>
+#include <cpustreamtests.h>
+#include <hostcopytests.h>
+#include <opbatchtests.h>
+#include <opgraphtests.h>
+#include <threadpooltests.h>
+#include <executioncontexttests.h>
+#include <numatests.h>
+#include <opcachetests.h>
+#include <opprofilertests.h>
+#include <optracetests.h>
+#include <shapeindextests.h>
 int main(int ac, char** av) {
 #ifdef __CUDACC__
 	cudaDeviceSetLimit(cudaLimitStackSize,40000);
@@ -26,4 +43,21 @@ IMPORT_TEST_GROUP(Reduce3);
 IMPORT_TEST_GROUP(IndexReduce);
 IMPORT_TEST_GROUP(SummaryStatsReduce);
 IMPORT_TEST_GROUP(PairWiseUtil);
+IMPORT_TEST_GROUP(Histogram);
+IMPORT_TEST_GROUP(TernaryTransform);
+IMPORT_TEST_GROUP(Mask);
+IMPORT_TEST_GROUP(TadCache);
+IMPORT_TEST_GROUP(RawIterPlan);
+IMPORT_TEST_GROUP(HostPool);
+IMPORT_TEST_GROUP(CpuStream);
+IMPORT_TEST_GROUP(HostCopy);
+IMPORT_TEST_GROUP(OpBatch);
+IMPORT_TEST_GROUP(OpGraph);
+IMPORT_TEST_GROUP(ThreadPool);
+IMPORT_TEST_GROUP(ExecutionContext);
+IMPORT_TEST_GROUP(Numa);
+IMPORT_TEST_GROUP(OpCache);
+IMPORT_TEST_GROUP(OpProfiler);
+IMPORT_TEST_GROUP(OpTrace);
+IMPORT_TEST_GROUP(ShapeIndex);
 
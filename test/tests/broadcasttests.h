@@ -355,3 +355,102 @@ TEST(BroadCasting,ObjectOrientedFloatCopy) {
         delete data;
         delete test;
 }
+
+
+TEST(BroadCasting,NumpyStyleAddition) {
+        //[2,1,3] + [4,1] -> [2,4,3]
+        int xShape[3] = {2,1,3};
+        int yShape[2] = {4,1};
+        int resultShape[3] = {2,4,3};
+        int *xShapeInfo = shape::shapeBuffer(3,xShape);
+        int *yShapeInfo = shape::shapeBuffer(2,yShape);
+        double x[6] = {0,1,2,3,4,5};
+        double y[4] = {10,20,30,40};
+        double result[24];
+        char orders[2] = {'c','f'};
+        functions::broadcast::Broadcast<double> *op = opFactory3->getOp(0);
+        for(int o = 0; o < 2; o++) {
+                int *resultShapeInfo = orders[o] == 'c' ? shape::shapeBuffer(3,resultShape) : shape::shapeBufferFortran(3,resultShape);
+                int *resultStride = shape::stride(resultShapeInfo);
+                op->exec(x,xShapeInfo,y,yShapeInfo,result,resultShapeInfo);
+                for(int i = 0; i < 2; i++)
+                        for(int j = 0; j < 4; j++)
+                                for(int k = 0; k < 3; k++)
+                                        DOUBLES_EQUAL(x[i * 3 + k] + y[j],result[i * resultStride[0] + j * resultStride[1] + k * resultStride[2]],1e-6);
+                delete[] resultShapeInfo;
+        }
+
+        delete op;
+        delete[] xShapeInfo;
+        delete[] yShapeInfo;
+}
+
+TEST(BroadCasting,NumpyStyleLarge) {
+        //a row vector over a tall matrix and a column vector over a wide one
+        int rows[2] = {1000,3};
+        int columns[2] = {64,5000};
+        functions::broadcast::Broadcast<double> *op = opFactory3->getOp(5);
+        for(int t = 0; t < 2; t++) {
+                int xShape[2] = {rows[t],columns[t]};
+                int yShape[2] = {t == 0 ? 1 : rows[t],t == 0 ? columns[t] : 1};
+                int *xShapeInfo = shape::shapeBuffer(2,xShape);
+                int *yShapeInfo = shape::shapeBuffer(2,yShape);
+                int length = rows[t] * columns[t];
+                int yLength = shape::length(yShapeInfo);
+                double *x = new double[length];
+                double *y = new double[yLength];
+                double *result = new double[length];
+                for(int i = 0; i < length; i++)
+                        x[i] = i;
+                for(int i = 0; i < yLength; i++)
+                        y[i] = 2 * i;
+                op->exec(x,xShapeInfo,y,yShapeInfo,result,xShapeInfo);
+                for(int i = 0; i < rows[t]; i++)
+                        for(int j = 0; j < columns[t]; j++)
+                                DOUBLES_EQUAL(y[t == 0 ? j : i] - x[i * columns[t] + j],result[i * columns[t] + j],1e-6);
+                delete[] x;
+                delete[] y;
+                delete[] result;
+                delete[] xShapeInfo;
+                delete[] yShapeInfo;
+        }
+
+        delete op;
+}
+
+TEST(BroadCasting,ContiguousRowVector) {
+        //bias add: many short rows, then few long rows
+        int rows[2] = {300,3};
+        int columns[2] = {64,10000};
+        int dimension[1] = {1};
+        functions::broadcast::Broadcast<double> *op = opFactory3->getOp(0);
+        for(int t = 0; t < 2; t++) {
+                int xShape[2] = {rows[t],columns[t]};
+                int yShape[2] = {1,columns[t]};
+                int *xShapeInfo = shape::shapeBuffer(2,xShape);
+                int *yShapeInfo = shape::shapeBuffer(2,yShape);
+                int length = rows[t] * columns[t];
+                double *x = new double[length];
+                double *y = new double[columns[t]];
+                double *result = new double[length];
+                for(int i = 0; i < length; i++)
+                        x[i] = i;
+                for(int i = 0; i < columns[t]; i++)
+                        y[i] = -i;
+                op->exec(x,xShapeInfo,y,yShapeInfo,result,dimension,1);
+                for(int i = 0; i < rows[t]; i++)
+                        for(int j = 0; j < columns[t]; j++)
+                                DOUBLES_EQUAL(i * columns[t],result[i * columns[t] + j],1e-6);
+                //in place
+                op->exec(x,xShapeInfo,y,yShapeInfo,x,dimension,1);
+                for(int i = 0; i < length; i++)
+                        DOUBLES_EQUAL(result[i],x[i],1e-6);
+                delete[] x;
+                delete[] y;
+                delete[] result;
+                delete[] xShapeInfo;
+                delete[] yShapeInfo;
+        }
+
+        delete op;
+}
@@ -0,0 +1,146 @@
+//
+// CPU stream and event tests
+//
+
+#ifndef NATIVEOPERATIONS_CPUSTREAMTESTS_H
+#define NATIVEOPERATIONS_CPUSTREAMTESTS_H
+#include "testhelpers.h"
+#include <cpustream.h>
+#include <transform.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+TEST_GROUP(CpuStream) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+
+    }
+    void teardown() {
+    }
+};
+
+TEST(CpuStream,RunsInOrder) {
+    nd4j::CpuStream *stream = new nd4j::CpuStream();
+    std::vector<int> order;
+    for (int i = 0; i < 100; i++)
+        stream->enqueue([&order, i] { order.push_back(i); });
+    stream->synchronize();
+
+    CHECK_EQUAL(100, (int) order.size());
+    for (int i = 0; i < 100; i++)
+        CHECK_EQUAL(i, order[i]);
+    delete stream;
+}
+
+TEST(CpuStream,EnqueueDoesNotBlock) {
+    nd4j::CpuStream *stream = new nd4j::CpuStream();
+    std::atomic<bool> release(false);
+    std::atomic<int> ran(0);
+    stream->enqueue([&] {
+        while (!release.load())
+            std::this_thread::yield();
+        ran++;
+    });
+    stream->enqueue([&] { ran++; });
+
+    //both are queued behind the blocked task while this thread carries on
+    CHECK_EQUAL(0, ran.load());
+    release = true;
+    stream->synchronize();
+    CHECK_EQUAL(2, ran.load());
+    delete stream;
+}
+
+TEST(CpuStream,EventsCoverWorkBeforeTheRecord) {
+    nd4j::CpuStream *stream = new nd4j::CpuStream();
+    nd4j::CpuEvent event;
+    std::atomic<bool> release(false);
+    std::atomic<int> ran(0);
+
+    stream->enqueue([&] { ran++; });
+    event.record(stream);
+    stream->enqueue([&] {
+        while (!release.load())
+            std::this_thread::yield();
+        ran++;
+    });
+
+    //returns although the task after the record is still blocked
+    event.synchronize();
+    CHECK(ran.load() >= 1);
+    release = true;
+    stream->synchronize();
+    CHECK_EQUAL(2, ran.load());
+
+    //never recorded events are complete
+    nd4j::CpuEvent idle;
+    idle.synchronize();
+    delete stream;
+}
+
+TEST(CpuStream,EventsOutliveTheirStream) {
+    nd4j::CpuStream *stream = new nd4j::CpuStream();
+    nd4j::CpuEvent *event = new nd4j::CpuEvent();
+    std::atomic<int> ran(0);
+    stream->enqueue([&] { ran++; });
+    event->record(stream);
+    stream->enqueue([&] { ran++; });
+
+    //drains the queue before the worker stops
+    delete stream;
+    CHECK_EQUAL(2, ran.load());
+    event->synchronize();
+    delete event;
+}
+
+TEST(CpuStream,FindsLiveStreamsOnly) {
+    nd4j::CpuStream *stream = new nd4j::CpuStream();
+    Nd4jPointer pointer = reinterpret_cast<Nd4jPointer>(stream);
+    CHECK(nd4j::CpuStream::find(pointer) == stream);
+
+    Nd4jPointer extraPointers[2] = {0, pointer};
+    CHECK(nd4j::CpuStream::find(extraPointers) == stream);
+    CHECK(nd4j::CpuStream::find((Nd4jPointer *) nullptr) == nullptr);
+
+    Nd4jPointer other = 12345;
+    CHECK(nd4j::CpuStream::find(other) == nullptr);
+
+    delete stream;
+    CHECK(nd4j::CpuStream::find(pointer) == nullptr);
+}
+
+TEST(CpuStream,QueuedTransform) {
+    const int length = 20000;
+    double *x = new double[length];
+    double *result = new double[length];
+    for (int i = 0; i < length; i++)
+        x[i] = -i;
+    int shape[2] = {1, length};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+
+    nd4j::CpuStream *stream = new nd4j::CpuStream();
+    functions::transform::TransformOpFactory<double> *opFactory = new functions::transform::TransformOpFactory<double>();
+    functions::transform::Transform<double> *op = opFactory->getOp(0);
+    stream->enqueue([=] { op->exec(x, shapeInfo, result, shapeInfo, nullptr); });
+    nd4j::CpuEvent event;
+    event.record(stream);
+    event.synchronize();
+    for (int i = 0; i < length; i++)
+        CHECK_EQUAL(i, result[i]);
+
+    delete stream;
+    delete op;
+    delete opFactory;
+    delete[] x;
+    delete[] result;
+    delete[] shapeInfo;
+}
+
+#endif //NATIVEOPERATIONS_CPUSTREAMTESTS_H
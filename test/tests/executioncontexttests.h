@@ -0,0 +1,165 @@
+//
+// Per call execution context tests
+//
+
+#ifndef NATIVEOPERATIONS_EXECUTIONCONTEXTTESTS_H
+#define NATIVEOPERATIONS_EXECUTIONCONTEXTTESTS_H
+#include "testhelpers.h"
+#include <executioncontext.h>
+#include <threadpool.h>
+#include <cpustream.h>
+#include <mutex>
+#include <set>
+#include <thread>
+
+TEST_GROUP(ExecutionContext) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+
+    }
+    void teardown() {
+        nd4j::ThreadPool::setEnabled(false);
+    }
+};
+
+TEST(ExecutionContext,OnlyLiveContextsAreFound) {
+    nd4j::ExecutionContext *context = new nd4j::ExecutionContext(2, nullptr, 0);
+    int notAContext = 5;
+    Nd4jPointer extraPointers[2] = {reinterpret_cast<Nd4jPointer>(context), 0};
+    CHECK(context == nd4j::ExecutionContext::find(extraPointers));
+    CHECK(nullptr == nd4j::ExecutionContext::find(reinterpret_cast<Nd4jPointer>(&notAContext)));
+    CHECK(nullptr == nd4j::ExecutionContext::find((Nd4jPointer *) nullptr));
+    delete context;
+    CHECK(nullptr == nd4j::ExecutionContext::find(extraPointers));
+}
+
+TEST(ExecutionContext,ScopeSetsThreadBudget) {
+    int threads = omp_get_max_threads();
+    nd4j::ExecutionContext context(1, nullptr, 0);
+    {
+        nd4j::ExecutionScope scope(&context);
+        CHECK(&context == nd4j::ExecutionContext::current());
+        CHECK_EQUAL(1, omp_get_max_threads());
+        int teamSize = 0;
+#pragma omp parallel
+        {
+#pragma omp master
+            teamSize = omp_get_num_threads();
+        }
+        CHECK_EQUAL(1, teamSize);
+    }
+    CHECK(nullptr == nd4j::ExecutionContext::current());
+    CHECK_EQUAL(threads, omp_get_max_threads());
+}
+
+TEST(ExecutionContext,PoolKeepsToThreadBudget) {
+    nd4j::ThreadPool::setEnabled(true);
+    nd4j::ExecutionContext context(2, nullptr, 0);
+    std::mutex lock;
+    std::set<std::thread::id> seen;
+    auto record = [&](Nd4jIndex start, Nd4jIndex end) {
+        std::lock_guard<std::mutex> guard(lock);
+        seen.insert(std::this_thread::get_id());
+    };
+    size_t most = 0;
+    {
+        nd4j::ExecutionScope scope(&context);
+        for (int i = 0; i < 20; i++) {
+            seen.clear();
+            nd4j::parallelFor(0, 1000000, 1, record);
+            if (seen.size() > most)
+                most = seen.size();
+        }
+    }
+    CHECK(most <= 2);
+}
+
+#if defined(__linux__)
+TEST(ExecutionContext,ScopePinsTeamAndRestores) {
+    cpu_set_t before;
+    sched_getaffinity(0, sizeof(cpu_set_t), &before);
+    int core = 0;
+    while (!CPU_ISSET(core, &before))
+        core++;
+
+    nd4j::ExecutionContext context(2, &core, 1);
+    {
+        nd4j::ExecutionScope scope(&context);
+        int unpinned = 0;
+#pragma omp parallel reduction(+:unpinned)
+        {
+            cpu_set_t mask;
+            pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask);
+            unpinned += CPU_COUNT(&mask) != 1 || !CPU_ISSET(core, &mask);
+        }
+        CHECK_EQUAL(0, unpinned);
+    }
+
+    cpu_set_t after;
+    sched_getaffinity(0, sizeof(cpu_set_t), &after);
+    CHECK(CPU_EQUAL(&before, &after));
+}
+
+TEST(ExecutionContext,TeamStaysPinnedUntilAnotherScope) {
+    cpu_set_t before;
+    sched_getaffinity(0, sizeof(cpu_set_t), &before);
+    int core = 0;
+    while (!CPU_ISSET(core, &before))
+        core++;
+
+    nd4j::ExecutionContext context(2, &core, 1);
+    for (int i = 0; i < 3; i++) {
+        nd4j::ExecutionScope scope(&context);
+        CHECK_EQUAL(core, nd4j::ExecutionContext::pinnedCore());
+    }
+    //the caller is let go at once, its team when a call without a context comes
+    CHECK_EQUAL(-1, nd4j::ExecutionContext::pinnedCore());
+    {
+        nd4j::ExecutionScope scope((nd4j::ExecutionContext *) nullptr);
+    }
+    int pinned = 0;
+#pragma omp parallel num_threads(2) reduction(+:pinned)
+    {
+        cpu_set_t mask;
+        pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask);
+        pinned += !CPU_EQUAL(&mask, &before);
+    }
+    CHECK_EQUAL(0, pinned);
+}
+#endif
+
+TEST(ExecutionContext,StreamRunsInEnqueuingContext) {
+    nd4j::ExecutionContext context(1, nullptr, 0);
+    nd4j::CpuStream stream;
+    nd4j::ExecutionContext *seen = nullptr;
+    int threads = 0;
+    {
+        nd4j::ExecutionScope scope(&context);
+        stream.enqueue([&] {
+            seen = nd4j::ExecutionContext::current();
+            threads = omp_get_max_threads();
+        });
+    }
+    stream.enqueue([] {});
+    stream.synchronize();
+    CHECK(&context == seen);
+    CHECK_EQUAL(1, threads);
+}
+
+TEST(ExecutionContext,StreamRunsInGivenContext) {
+    nd4j::ExecutionContext context(1, nullptr, 0);
+    nd4j::CpuStream stream;
+    nd4j::ExecutionContext *seen = nullptr;
+    stream.enqueue([&] { seen = nd4j::ExecutionContext::current(); }, &context);
+    stream.synchronize();
+    CHECK(&context == seen);
+    CHECK(nullptr == nd4j::ExecutionContext::current());
+}
+
+#endif //NATIVEOPERATIONS_EXECUTIONCONTEXTTESTS_H
@@ -0,0 +1,154 @@
+//
+// Histogram and quantile sketch tests
+//
+
+#ifndef NATIVEOPERATIONS_HISTOGRAMTESTS_H
+#define NATIVEOPERATIONS_HISTOGRAMTESTS_H
+#include "testhelpers.h"
+#include <histogram.h>
+
+TEST_GROUP(Histogram) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+
+    }
+    void teardown() {
+    }
+};
+
+
+TEST(Histogram,FixedRange) {
+    int shape[2] = {2,5};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    double data[10] = {0,1,2,3,4,5,6,7,8,-1};
+    double result[4];
+    functions::histogram::Histogram<double> histogram;
+    histogram.exec(data,shapeInfo,result,4,0.0,8.0);
+    //-1 is out of range, 8 lands in the last bin
+    double assertion[4] = {2,2,2,3};
+    for(int i = 0; i < 4; i++)
+        DOUBLES_EQUAL(assertion[i],result[i],1e-6);
+    delete[] shapeInfo;
+}
+
+TEST(Histogram,AutoRangeParallel) {
+    int length = 100000;
+    int shape[2] = {1,length};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    float *data = new float[length];
+    for(int i = 0; i < length; i++)
+        data[i] = i % 10;
+    float result[10];
+    functions::histogram::Histogram<float> histogram;
+    histogram.exec(data,shapeInfo,result,10,0.0f,0.0f);
+    for(int i = 0; i < 10; i++)
+        DOUBLES_EQUAL(length / 10,result[i],1e-6);
+    delete[] data;
+    delete[] shapeInfo;
+}
+
+TEST(Histogram,AlongDimension) {
+    int shape[2] = {2,4};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    double data[8] = {0,1,2,3,10,10,10,30};
+    double result[4];
+    int dimension[1] = {1};
+    int resultShape[2] = {2,2};
+    int *resultShapeInfo = shape::shapeBuffer(2,resultShape);
+    functions::histogram::Histogram<double> histogram;
+    histogram.exec(data,shapeInfo,result,resultShapeInfo,2,0.0,0.0,dimension,1);
+    double assertion[4] = {2,2,3,1};
+    for(int i = 0; i < 4; i++)
+        DOUBLES_EQUAL(assertion[i],result[i],1e-6);
+    delete[] shapeInfo;
+    delete[] resultShapeInfo;
+}
+
+TEST(Histogram,Quantiles) {
+    int length = 100001;
+    int shape[2] = {1,length};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    double *data = new double[length];
+    //shuffled 0..length - 1
+    for(int i = 0; i < length; i++)
+        data[i] = (i * 7919L) % length;
+    double probabilities[5] = {0.0,0.01,0.5,0.99,1.0};
+    double result[5];
+    functions::histogram::Quantiles<double> quantiles;
+    quantiles.exec(data,shapeInfo,probabilities,5,100.0,result);
+    DOUBLES_EQUAL(0,result[0],1e-6);
+    DOUBLES_EQUAL(1000,result[1],100);
+    DOUBLES_EQUAL(50000,result[2],500);
+    DOUBLES_EQUAL(99000,result[3],100);
+    DOUBLES_EQUAL(100000,result[4],1e-6);
+    delete[] data;
+    delete[] shapeInfo;
+}
+
+TEST(Histogram,QuantilesOfMillions) {
+    //past a million points the upper tail used to get a centroid per point
+    functions::histogram::TDigest<double> digest(100);
+    unsigned long long state = 12345;
+    for(int i = 0; i < 5000000; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        digest.add((state >> 11) * (1.0 / 9007199254740992.0));
+    }
+    DOUBLES_EQUAL(0.5,digest.quantile(0.5),0.01);
+    DOUBLES_EQUAL(0.999,digest.quantile(0.999),0.001);
+    CHECK(digest.size() <= 2 * 100 + 10);
+}
+
+TEST(Histogram,QuantilesAlongDimension) {
+    int shape[2] = {3,101};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    double data[303];
+    for(int i = 0; i < 3; i++)
+        for(int j = 0; j < 101; j++)
+            data[i * 101 + j] = (i + 1) * j;
+    double probabilities[2] = {0.5,1.0};
+    double result[6];
+    int dimension[1] = {1};
+    int resultShape[2] = {3,2};
+    int *resultShapeInfo = shape::shapeBuffer(2,resultShape);
+    functions::histogram::Quantiles<double> quantiles;
+    quantiles.exec(data,shapeInfo,probabilities,2,100.0,result,resultShapeInfo,dimension,1);
+    for(int i = 0; i < 3; i++) {
+        DOUBLES_EQUAL((i + 1) * 50,result[i * 2],(i + 1));
+        DOUBLES_EQUAL((i + 1) * 100,result[i * 2 + 1],1e-6);
+    }
+    delete[] shapeInfo;
+    delete[] resultShapeInfo;
+}
+
+TEST(Histogram,QuantilesInSmallerTeam) {
+    int length = 20000;
+    int shape[2] = {1,length};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    double *data = new double[length];
+    for(int i = 0; i < length; i++)
+        data[i] = i;
+    double probabilities[2] = {0.0,1.0};
+    int threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+    int wrong = 0;
+    //nested, so each sketch gets a team of one while asking for four
+#pragma omp parallel num_threads(2) reduction(+:wrong)
+    {
+        double result[2];
+        functions::histogram::Quantiles<double> quantiles;
+        quantiles.exec(data,shapeInfo,probabilities,2,100.0,result);
+        wrong += result[0] != 0 || result[1] != length - 1;
+    }
+    omp_set_num_threads(threads);
+    CHECK_EQUAL(0,wrong);
+    delete[] data;
+    delete[] shapeInfo;
+}
+
+#endif //NATIVEOPERATIONS_HISTOGRAMTESTS_H
@@ -0,0 +1,75 @@
+//
+// Large host copy tests
+//
+
+#ifndef NATIVEOPERATIONS_HOSTCOPYTESTS_H
+#define NATIVEOPERATIONS_HOSTCOPYTESTS_H
+#include "testhelpers.h"
+#include <hostcopy.h>
+
+TEST_GROUP(HostCopy) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+
+    }
+    void teardown() {
+    }
+};
+
+TEST(HostCopy,RangesCoverOnLineBoundaries) {
+    char *base = new char[1024];
+    for (int offset = 0; offset < 64; offset += 13) {
+        Nd4jIndex bytes = 700 - offset;
+        Nd4jIndex previousEnd = 0;
+        for (int part = 0; part < 5; part++) {
+            Nd4jIndex start, end;
+            nd4j::copyRange(base + offset, bytes, part, 5, &start, &end);
+            CHECK_EQUAL(previousEnd, start);
+            if (start > 0 && start < bytes)
+                CHECK_EQUAL(0, ((size_t) (base + offset + start)) % 64);
+            previousEnd = end;
+        }
+        CHECK_EQUAL(bytes, previousEnd);
+    }
+    delete[] base;
+}
+
+TEST(HostCopy,CopiesAndSetsAtEverySize) {
+    //below, between and above both thresholds, from and to unaligned addresses
+    Nd4jIndex sizes[4] = {1000, nd4j::PARALLEL_THRESHOLD + 77, nd4j::NON_TEMPORAL_THRESHOLD + 13, 5};
+    for (int i = 0; i < 4; i++) {
+        Nd4jIndex bytes = sizes[i];
+        unsigned char *src = new unsigned char[bytes + 3];
+        unsigned char *dst = new unsigned char[bytes + 5];
+        for (Nd4jIndex j = 0; j < bytes + 3; j++)
+            src[j] = (unsigned char) (j * 7);
+        dst[0] = 0xAB;
+        dst[bytes + 2] = 0xCD;
+
+        nd4j::hostMemcpy(dst + 1, src + 3, bytes - 1);
+        CHECK_EQUAL(0xAB, dst[0]);
+        Nd4jIndex mismatches = 0;
+        for (Nd4jIndex j = 0; j < bytes - 1; j++)
+            mismatches += dst[j + 1] != src[j + 3];
+        CHECK_EQUAL(0, mismatches);
+        CHECK_EQUAL(0xCD, dst[bytes + 2]);
+
+        nd4j::hostMemset(dst + 1, 0x5A, bytes);
+        CHECK_EQUAL(0xAB, dst[0]);
+        for (Nd4jIndex j = 1; j <= bytes; j++)
+            mismatches += dst[j] != 0x5A;
+        CHECK_EQUAL(0, mismatches);
+        CHECK_EQUAL(0xCD, dst[bytes + 2]);
+
+        delete[] src;
+        delete[] dst;
+    }
+}
+
+#endif //NATIVEOPERATIONS_HOSTCOPYTESTS_H
@@ -0,0 +1,175 @@
+//
+// Host memory pool tests
+//
+
+#ifndef NATIVEOPERATIONS_HOSTPOOLTESTS_H
+#define NATIVEOPERATIONS_HOSTPOOLTESTS_H
+#include "testhelpers.h"
+#include <hostpool.h>
+#include <thread>
+
+TEST_GROUP(HostPool) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+        nd4j::HostMemoryPool::getInstance()->purge();
+        nd4j::HostMemoryPool::getInstance()->resetCounters();
+    }
+    void teardown() {
+        nd4j::HostMemoryPool::getInstance()->setLimits(1024L * 1024L * 1024L, 16L * 1024L * 1024L);
+        nd4j::HostMemoryPool::getInstance()->resetCounters();
+    }
+};
+
+TEST(HostPool,SizeClasses) {
+    CHECK_EQUAL(0, nd4j::HostMemoryPool::sizeClass(1));
+    CHECK_EQUAL(0, nd4j::HostMemoryPool::sizeClass(64));
+    CHECK_EQUAL(1, nd4j::HostMemoryPool::sizeClass(65));
+    CHECK_EQUAL(80, nd4j::HostMemoryPool::sizeClass(nd4j::HostMemoryPool::MAX_CLASS_SIZE));
+    CHECK_EQUAL(-1, nd4j::HostMemoryPool::sizeClass(nd4j::HostMemoryPool::MAX_CLASS_SIZE + 1));
+
+    //every size fits its class, wasting at most a quarter
+    for (Nd4jIndex bytes = 1; bytes < 100000; bytes += 7) {
+        int sc = nd4j::HostMemoryPool::sizeClass(bytes);
+        Nd4jIndex size = nd4j::HostMemoryPool::classSize(sc);
+        CHECK(size >= bytes);
+        if (sc > 0) {
+            CHECK(nd4j::HostMemoryPool::classSize(sc - 1) < bytes);
+            CHECK(size - bytes <= bytes / 4 + 1);
+        }
+    }
+}
+
+TEST(HostPool,ReuseAndStatistics) {
+    nd4j::HostMemoryPool *pool = nd4j::HostMemoryPool::getInstance();
+    Nd4jIndex inUse = pool->getBytesInUse();
+
+    double *first = (double *) pool->allocate(1000 * sizeof(double));
+    CHECK(first != nullptr);
+    CHECK_EQUAL(0, ((size_t) first) % 16);
+    for (int i = 0; i < 1000; i++)
+        first[i] = i;
+    Nd4jIndex size = nd4j::HostMemoryPool::classSize(nd4j::HostMemoryPool::sizeClass(1000 * sizeof(double)));
+    CHECK_EQUAL(inUse + size, pool->getBytesInUse());
+    CHECK_EQUAL(1, pool->getMisses());
+
+    pool->release(first);
+    CHECK_EQUAL(inUse, pool->getBytesInUse());
+    CHECK_EQUAL(size, pool->getBytesCached());
+
+    //a request of the same class gets the same block back
+    double *second = (double *) pool->allocate(990 * sizeof(double));
+    CHECK(first == second);
+    CHECK_EQUAL(1, pool->getHits());
+    CHECK_EQUAL(0, pool->getBytesCached());
+
+    pool->release(second);
+    pool->purge();
+    CHECK_EQUAL(0, pool->getBytesCached());
+}
+
+TEST(HostPool,LargeBlocksBypass) {
+    nd4j::HostMemoryPool *pool = nd4j::HostMemoryPool::getInstance();
+    Nd4jIndex bytes = nd4j::HostMemoryPool::MAX_CLASS_SIZE + 1;
+    char *big = (char *) pool->allocate(bytes);
+    CHECK(big != nullptr);
+    big[bytes - 1] = 1;
+    pool->release(big);
+    CHECK_EQUAL(0, pool->getBytesCached());
+    CHECK_EQUAL(1, pool->getMisses());
+}
+
+TEST(HostPool,RetentionLimit) {
+    nd4j::HostMemoryPool *pool = nd4j::HostMemoryPool::getInstance();
+    //no thread cache and room for two 4k blocks in the shared cache
+    pool->setLimits(8192, 0);
+
+    void *blocks[4];
+    for (int i = 0; i < 4; i++)
+        blocks[i] = pool->allocate(4096);
+    for (int i = 0; i < 4; i++)
+        pool->release(blocks[i]);
+    CHECK_EQUAL(8192, pool->getBytesCached());
+
+    pool->resetCounters();
+    for (int i = 0; i < 4; i++)
+        blocks[i] = pool->allocate(4096);
+    CHECK_EQUAL(2, pool->getHits());
+    CHECK_EQUAL(2, pool->getMisses());
+    for (int i = 0; i < 4; i++)
+        pool->release(blocks[i]);
+}
+
+TEST(HostPool,LoweredLimitTrimsOtherThreads) {
+    nd4j::HostMemoryPool *pool = nd4j::HostMemoryPool::getInstance();
+    pool->release(pool->allocate(4096));
+    //this thread's cache keeps the block until it frees past the new limit
+    std::thread limiter([pool]() {
+        pool->setLimits(1024L * 1024L * 1024L, 0);
+    });
+    limiter.join();
+    pool->release(pool->allocate(100));
+
+    Nd4jIndex hits = 0;
+    std::thread worker([pool, &hits]() {
+        pool->release(pool->allocate(4096));
+        hits = pool->getHits();
+    });
+    worker.join();
+    CHECK_EQUAL(1, (int) hits);
+}
+
+TEST(HostPool,ExitingThreadsHandBlocksOver) {
+    nd4j::HostMemoryPool *pool = nd4j::HostMemoryPool::getInstance();
+    std::thread worker([pool]() {
+        pool->release(pool->allocate(3000));
+    });
+    worker.join();
+    Nd4jIndex size = nd4j::HostMemoryPool::classSize(nd4j::HostMemoryPool::sizeClass(3000));
+    CHECK_EQUAL(size, pool->getBytesCached());
+
+    void *block = pool->allocate(3000);
+    CHECK_EQUAL(1, pool->getHits());
+    pool->release(block);
+}
+
+TEST(HostPool,AlignedBuffers) {
+    nd4j::HostMemoryPool *pool = nd4j::HostMemoryPool::getInstance();
+    Nd4jIndex sizes[5] = {1, 100, 4097, 1000000, nd4j::HostMemoryPool::MAX_CLASS_SIZE + 1};
+    for (int i = 0; i < 5; i++) {
+        void *buffer = pool->allocate(sizes[i], nd4j::HOST_ALLOC_ALIGNED | nd4j::HOST_ALLOC_PREFAULT);
+        CHECK_EQUAL(0, ((size_t) buffer) % 64);
+        CHECK_EQUAL(64, nd4j::HostMemoryPool::alignmentOf(buffer));
+        pool->release(buffer);
+    }
+    CHECK_EQUAL(0, nd4j::HostMemoryPool::alignmentOf(nullptr));
+}
+
+TEST(HostPool,HugePageBuffers) {
+    nd4j::HostMemoryPool *pool = nd4j::HostMemoryPool::getInstance();
+    Nd4jIndex inUse = pool->getBytesInUse();
+    Nd4jIndex bytes = 5L * 1024L * 1024L + 3;
+    int flags[2] = {nd4j::HOST_ALLOC_HUGE_PAGE_ADVICE | nd4j::HOST_ALLOC_PREFAULT, nd4j::HOST_ALLOC_HUGE_PAGES};
+    for (int i = 0; i < 2; i++) {
+        //explicit huge pages fall back to advice when none are reserved
+        char *buffer = (char *) pool->allocate(bytes, flags[i]);
+        CHECK(buffer != nullptr);
+        CHECK_EQUAL(0, ((size_t) buffer) % (2 * 1024 * 1024));
+        CHECK_EQUAL(2 * 1024 * 1024, nd4j::HostMemoryPool::alignmentOf(buffer));
+        buffer[0] = 1;
+        buffer[bytes - 1] = 1;
+        CHECK_EQUAL(inUse + bytes, pool->getBytesInUse());
+        pool->release(buffer);
+        CHECK_EQUAL(inUse, pool->getBytesInUse());
+    }
+
+    //huge page buffers are never cached
+    CHECK_EQUAL(0, pool->getBytesCached());
+}
+
+#endif //NATIVEOPERATIONS_HOSTPOOLTESTS_H
@@ -0,0 +1,181 @@
+//
+// Mask tests
+//
+
+#ifndef NATIVEOPERATIONS_MASKTESTS_H
+#define NATIVEOPERATIONS_MASKTESTS_H
+#include "testhelpers.h"
+#include <mask.h>
+
+static functions::mask::Mask<double> *maskOps = 0;
+
+TEST_GROUP(Mask) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+        maskOps = new functions::mask::Mask<double>();
+    }
+    void teardown() {
+        delete maskOps;
+    }
+};
+
+
+TEST(Mask,ScalarCompare) {
+    //greater than 4 over 0..9, as bytes and as bits
+    int shape[2] = {2,5};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    double x[10];
+    for(int i = 0; i < 10; i++)
+        x[i] = i;
+
+    functions::scalar::ScalarOpFactory<double> *opFactory = new functions::scalar::ScalarOpFactory<double>();
+    functions::scalar::ScalarTransform<double> *op = opFactory->getOp(8);
+    unsigned char bytes[10];
+    unsigned char bits[2];
+    maskOps->compare(op,x,shapeInfo,4.0,nullptr,bytes,false);
+    maskOps->compare(op,x,shapeInfo,4.0,nullptr,bits,true);
+    for(int i = 0; i < 10; i++) {
+        CHECK_EQUAL(i > 4 ? 1 : 0,bytes[i]);
+        CHECK_EQUAL(i > 4,functions::mask::isSet(bits,i,true));
+    }
+
+    CHECK_EQUAL(0xE0,bits[0]);
+    CHECK_EQUAL(0x03,bits[1]);
+    CHECK_EQUAL(2,functions::mask::maskLength(10,true));
+
+    delete op;
+    delete opFactory;
+    delete[] shapeInfo;
+}
+
+TEST(Mask,PairwiseCompareMixedOrders) {
+    //x less than y with x c ordered and y f ordered, the mask follows x
+    int shape[2] = {3,4};
+    int *cShapeInfo = shape::shapeBuffer(2,shape);
+    int *fShapeInfo = shape::shapeBufferFortran(2,shape);
+    double x[12];
+    double y[12];
+    for(int i = 0; i < 12; i++) {
+        x[i] = i;
+        y[i] = 12 - i;
+    }
+
+    functions::pairwise_transforms::PairWiseTransformOpFactory<double> *opFactory = new functions::pairwise_transforms::PairWiseTransformOpFactory<double>();
+    functions::pairwise_transforms::PairWiseTransform<double> *op = opFactory->getOp(5);
+    unsigned char mask[12];
+    maskOps->compare(op,x,cShapeInfo,y,fShapeInfo,nullptr,mask,false);
+    for(int i = 0; i < 3; i++)
+        for(int j = 0; j < 4; j++)
+            CHECK_EQUAL(x[i * 4 + j] < y[j * 3 + i] ? 1 : 0,mask[i * 4 + j]);
+
+    delete op;
+    delete opFactory;
+    delete[] cShapeInfo;
+    delete[] fShapeInfo;
+}
+
+TEST(Mask,MaskedTransform) {
+    //abs only where the mask is set, everything else keeps its old value
+    int shape[2] = {1,9};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    double x[9] = {-1,-2,-3,-4,-5,-6,-7,-8,-9};
+    double result[9];
+    unsigned char bits[2] = {0x55,0x01};
+    for(int i = 0; i < 9; i++)
+        result[i] = 100;
+
+    functions::transform::TransformOpFactory<double> *opFactory = new functions::transform::TransformOpFactory<double>();
+    functions::transform::Transform<double> *op = opFactory->getOp(0);
+    maskOps->transform(op,x,shapeInfo,result,shapeInfo,nullptr,bits,true);
+    for(int i = 0; i < 9; i++)
+        DOUBLES_EQUAL(i % 2 == 0 ? i + 1 : 100,result[i],1e-6);
+
+    delete op;
+    delete opFactory;
+    delete[] shapeInfo;
+}
+
+TEST(Mask,MaskedReduce) {
+    int shape[2] = {1,6};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    double x[6] = {1,2,3,4,5,6};
+    unsigned char mask[6] = {0,1,0,1,0,1};
+    double extraParams[3] = {0,0,0};
+
+    functions::reduce::ReduceOpFactory<double> *opFactory = new functions::reduce::ReduceOpFactory<double>();
+    functions::reduce::ReduceFunction<double> *mean = opFactory->create(0);
+    functions::reduce::ReduceFunction<double> *sum = opFactory->create(1);
+    DOUBLES_EQUAL(12,maskOps->reduce(sum,x,shapeInfo,extraParams,mask,false),1e-6);
+    DOUBLES_EQUAL(4,maskOps->reduce(mean,x,shapeInfo,extraParams,mask,false),1e-6);
+
+    delete mean;
+    delete sum;
+    delete opFactory;
+    delete[] shapeInfo;
+}
+
+TEST(Mask,MaskedReduceInSmallerTeam) {
+    const int length = 10000;
+    int shape[2] = {1,length};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    double *x = new double[length];
+    unsigned char *mask = new unsigned char[length];
+    for(int i = 0; i < length; i++) {
+        x[i] = 1;
+        mask[i] = i % 2;
+    }
+    double extraParams[3] = {0,0,0};
+
+    functions::reduce::ReduceOpFactory<double> *opFactory = new functions::reduce::ReduceOpFactory<double>();
+    functions::reduce::ReduceFunction<double> *mean = opFactory->create(0);
+    int threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+    int wrong = 0;
+    //nested, so each reduction gets a team of one while asking for four
+#pragma omp parallel num_threads(2) reduction(+:wrong)
+    {
+        functions::mask::Mask<double> masks;
+        wrong += masks.reduce(mean,x,shapeInfo,extraParams,mask,false) != 1.0;
+    }
+    omp_set_num_threads(threads);
+    CHECK_EQUAL(0,wrong);
+
+    delete mean;
+    delete opFactory;
+    delete[] mask;
+    delete[] x;
+    delete[] shapeInfo;
+}
+
+TEST(Mask,Select) {
+    //result f ordered, x c ordered, y contiguous f ordered
+    int shape[2] = {2,3};
+    int *cShapeInfo = shape::shapeBuffer(2,shape);
+    int *fShapeInfo = shape::shapeBufferFortran(2,shape);
+    double x[6] = {1,2,3,4,5,6};
+    double y[6] = {-1,-2,-3,-4,-5,-6};
+    double result[6];
+    unsigned char mask[6] = {1,1,0,0,1,0};
+
+    maskOps->select(x,cShapeInfo,y,fShapeInfo,result,fShapeInfo,mask,false);
+    for(int i = 0; i < 2; i++)
+        for(int j = 0; j < 3; j++) {
+            int f = j * 2 + i;
+            DOUBLES_EQUAL(mask[f] ? x[i * 3 + j] : y[f],result[f],1e-6);
+        }
+
+    maskOps->select(x,cShapeInfo,y,cShapeInfo,result,cShapeInfo,mask,false);
+    for(int i = 0; i < 6; i++)
+        DOUBLES_EQUAL(mask[i] ? x[i] : y[i],result[i],1e-6);
+
+    delete[] cShapeInfo;
+    delete[] fShapeInfo;
+}
+
+#endif //NATIVEOPERATIONS_MASKTESTS_H
@@ -0,0 +1,134 @@
+//
+// NUMA placement tests
+//
+
+#ifndef NATIVEOPERATIONS_NUMATESTS_H
+#define NATIVEOPERATIONS_NUMATESTS_H
+#include "testhelpers.h"
+#include <numaplacement.h>
+#include <hostpool.h>
+#include <executioncontext.h>
+
+TEST_GROUP(Numa) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+
+    }
+    void teardown() {
+    }
+};
+
+TEST(Numa,ParsesNodeLists) {
+    std::vector<int> ids = nd4j::parseNodeList("0-2,5,7-8\n");
+    int assertion[6] = {0, 1, 2, 5, 7, 8};
+    CHECK_EQUAL(6, (int) ids.size());
+    for (int i = 0; i < 6; i++)
+        CHECK_EQUAL(assertion[i], ids[i]);
+    CHECK_EQUAL(0, (int) nd4j::parseNodeList("").size());
+}
+
+TEST(Numa,ThreadsSplitIntoRunsPerNode) {
+    const std::vector<int> &nodes = nd4j::numaNodes();
+    CHECK(nodes.size() >= 1);
+    CHECK_EQUAL(nodes[0], nd4j::nodeOfThread(0, 8));
+    CHECK_EQUAL(nodes[nodes.size() - 1], nd4j::nodeOfThread(7, 8));
+    int previous = 0;
+    for (int thread = 0; thread < 8; thread++) {
+        int index = 0;
+        while (nodes[index] != nd4j::nodeOfThread(thread, 8))
+            index++;
+        CHECK(index >= previous);
+        previous = index;
+    }
+}
+
+TEST(Numa,PlacedBuffersArePageAlignedAndUsable) {
+    nd4j::HostMemoryPool *pool = nd4j::HostMemoryPool::getInstance();
+    Nd4jIndex inUse = pool->getBytesInUse();
+    int node = nd4j::numaNodes()[0];
+    int flags[3] = {
+            nd4j::HOST_ALLOC_NUMA_LOCAL | nd4j::HOST_ALLOC_PREFAULT,
+            nd4j::HOST_ALLOC_NUMA_INTERLEAVE,
+            nd4j::HOST_ALLOC_NUMA_BIND | (node << nd4j::HOST_ALLOC_NUMA_NODE_SHIFT)
+    };
+    const Nd4jIndex length = 300000;
+    for (int i = 0; i < 3; i++) {
+        double *buffer = reinterpret_cast<double *>(pool->allocate(length * sizeof(double), flags[i]));
+        CHECK(buffer != nullptr);
+        CHECK_EQUAL(0, (int) (reinterpret_cast<size_t>(buffer) % 4096));
+        CHECK(nd4j::HostMemoryPool::alignmentOf(buffer) >= 4096);
+        for (Nd4jIndex j = 0; j < length; j++)
+            buffer[j] = (double) j;
+        double sum = 0;
+        for (Nd4jIndex j = 0; j < length; j++)
+            sum += buffer[j];
+        DOUBLES_EQUAL(0.5 * length * (length - 1), sum, 1e-3);
+        pool->release(buffer);
+    }
+    CHECK_EQUAL(inUse, pool->getBytesInUse());
+}
+
+#if defined(__linux__)
+TEST(Numa,BindingPinsTeamToItsNode) {
+    CHECK_EQUAL(0, nd4j::bindThreadsToNodes());
+    int outside = 0;
+#pragma omp parallel reduction(+:outside)
+    {
+        std::vector<int> cpus = nd4j::numaNodeCpus(nd4j::nodeOfThread(omp_get_thread_num(), omp_get_num_threads()));
+        cpu_set_t mask;
+        pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask);
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (!CPU_ISSET(cpu, &mask))
+                continue;
+            bool onNode = false;
+            for (size_t i = 0; i < cpus.size(); i++)
+                onNode = onNode || cpus[i] == cpu;
+            outside += !onNode;
+        }
+    }
+    CHECK_EQUAL(0, outside);
+    CHECK_EQUAL(0, nd4j::unbindThreadsFromNodes());
+}
+
+TEST(Numa,UnbindingRestoresProcessMask) {
+    //a team left pinned by a scope must not keep a stale record
+    int core = 0;
+    nd4j::ExecutionContext context(0, &core, 1);
+    {
+        nd4j::ExecutionScope scope(&context);
+    }
+    CHECK_EQUAL(0, nd4j::bindThreadsToNodes());
+    CHECK_EQUAL(0, nd4j::unbindThreadsFromNodes());
+    int restricted = 0;
+#pragma omp parallel reduction(+:restricted)
+    {
+        cpu_set_t mask;
+        pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask);
+        restricted += !CPU_EQUAL(&mask, &nd4j::ExecutionContext::processMask());
+        restricted += nd4j::ExecutionContext::pinnedCore() != -1;
+    }
+    CHECK_EQUAL(0, restricted);
+
+    //and a scope pins the team again rather than trusting that record
+    {
+        nd4j::ExecutionScope scope(&context);
+        int elsewhere = 0;
+#pragma omp parallel reduction(+:elsewhere)
+        {
+            cpu_set_t mask;
+            pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask);
+            elsewhere += CPU_COUNT(&mask) != 1 || !CPU_ISSET(0, &mask);
+        }
+        CHECK_EQUAL(0, elsewhere);
+    }
+    nd4j::ExecutionScope release((nd4j::ExecutionContext *) nullptr);
+}
+#endif
+
+#endif //NATIVEOPERATIONS_NUMATESTS_H
@@ -0,0 +1,102 @@
+//
+// Op batch tests
+//
+
+#ifndef NATIVEOPERATIONS_OPBATCHTESTS_H
+#define NATIVEOPERATIONS_OPBATCHTESTS_H
+#include "testhelpers.h"
+#include <opbatch.h>
+
+TEST_GROUP(OpBatch) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+
+    }
+    void teardown() {
+    }
+};
+
+static void describe(Nd4jPointer *descriptor, int family, int opNum, double *x, int *xShapeInfo, double *y, int *yShapeInfo, double *result, int *resultShapeInfo) {
+    for (int i = 0; i < nd4j::DESCRIPTOR_LENGTH; i++)
+        descriptor[i] = 0;
+    descriptor[nd4j::DESC_FAMILY] = family;
+    descriptor[nd4j::DESC_OP_NUM] = opNum;
+    descriptor[nd4j::DESC_X] = reinterpret_cast<Nd4jPointer>(x);
+    descriptor[nd4j::DESC_X_SHAPE] = reinterpret_cast<Nd4jPointer>(xShapeInfo);
+    descriptor[nd4j::DESC_Y] = reinterpret_cast<Nd4jPointer>(y);
+    descriptor[nd4j::DESC_Y_SHAPE] = reinterpret_cast<Nd4jPointer>(yShapeInfo);
+    descriptor[nd4j::DESC_RESULT] = reinterpret_cast<Nd4jPointer>(result);
+    descriptor[nd4j::DESC_RESULT_SHAPE] = reinterpret_cast<Nd4jPointer>(resultShapeInfo);
+}
+
+TEST(OpBatch,DependentChain) {
+    const int length = 1000;
+    int shape[2] = {1, length};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    double *x = new double[length];
+    double *a = new double[length];
+    double *b = new double[length];
+    double *c = new double[length];
+    double sum[1] = {0};
+    double extraParams[3] = {0,0,0};
+    for (int i = 0; i < length; i++)
+        x[i] = -(i + 1);
+
+    Nd4jPointer descriptors[4 * nd4j::DESCRIPTOR_LENGTH];
+    //a = abs(x), b = a + 1, c = a + b, sum = sum(c)
+    describe(descriptors, nd4j::OP_FAMILY_TRANSFORM, 0, x, shapeInfo, nullptr, nullptr, a, shapeInfo);
+    describe(descriptors + nd4j::DESCRIPTOR_LENGTH, nd4j::OP_FAMILY_SCALAR, 0, a, shapeInfo, nullptr, nullptr, b, shapeInfo);
+    descriptors[nd4j::DESCRIPTOR_LENGTH + nd4j::DESC_SCALAR] = nd4j::packScalar(1.0);
+    describe(descriptors + 2 * nd4j::DESCRIPTOR_LENGTH, nd4j::OP_FAMILY_PAIRWISE, 0, a, shapeInfo, b, shapeInfo, c, shapeInfo);
+    describe(descriptors + 3 * nd4j::DESCRIPTOR_LENGTH, nd4j::OP_FAMILY_REDUCE, 1, c, shapeInfo, nullptr, nullptr, sum, nullptr);
+    descriptors[3 * nd4j::DESCRIPTOR_LENGTH + nd4j::DESC_EXTRA_PARAMS] = reinterpret_cast<Nd4jPointer>(extraParams);
+
+    nd4j::OpBatch<double> batch;
+    batch.exec(descriptors, 4);
+    for (int i = 0; i < length; i++)
+        CHECK_EQUAL(2 * (i + 1) + 1, c[i]);
+    DOUBLES_EQUAL(length * (length + 1) + length, sum[0], 1e-6);
+
+    delete[] x;
+    delete[] a;
+    delete[] b;
+    delete[] c;
+    delete[] shapeInfo;
+}
+
+TEST(OpBatch,IndependentOps) {
+    const int numOps = 8;
+    const int length = 500;
+    int shape[2] = {1, length};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    double *buffers[numOps];
+    Nd4jPointer descriptors[numOps * nd4j::DESCRIPTOR_LENGTH];
+    for (int op = 0; op < numOps; op++) {
+        buffers[op] = new double[length];
+        for (int i = 0; i < length; i++)
+            buffers[op][i] = i;
+        //buffers[op] *= op, in place
+        describe(descriptors + op * nd4j::DESCRIPTOR_LENGTH, nd4j::OP_FAMILY_SCALAR, 2, buffers[op], shapeInfo, nullptr, nullptr, buffers[op], shapeInfo);
+        descriptors[op * nd4j::DESCRIPTOR_LENGTH + nd4j::DESC_SCALAR] = nd4j::packScalar(op);
+        if (op > 0)
+            descriptors[op * nd4j::DESCRIPTOR_LENGTH + nd4j::DESC_FLAGS] = nd4j::OP_INDEPENDENT;
+    }
+
+    nd4j::OpBatch<double> batch;
+    batch.exec(descriptors, numOps);
+    for (int op = 0; op < numOps; op++) {
+        for (int i = 0; i < length; i++)
+            CHECK_EQUAL(i * op, buffers[op][i]);
+        delete[] buffers[op];
+    }
+
+    delete[] shapeInfo;
+}
+
+#endif //NATIVEOPERATIONS_OPBATCHTESTS_H
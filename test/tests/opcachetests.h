@@ -0,0 +1,97 @@
+//
+// Cached op instance tests
+//
+
+#ifndef NATIVEOPERATIONS_OPCACHETESTS_H
+#define NATIVEOPERATIONS_OPCACHETESTS_H
+#include "testhelpers.h"
+#include <opcache.h>
+#include <atomic>
+#include <thread>
+
+TEST_GROUP(OpCache) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+
+    }
+    void teardown() {
+    }
+};
+
+TEST(OpCache,ConcurrentFirstUseSeesOneCache) {
+    nd4j::OpCache<float> *seen[8];
+    std::thread threads[8];
+    for (int i = 0; i < 8; i++)
+        threads[i] = std::thread([&seen, i] { seen[i] = nd4j::OpCache<float>::getInstance(); });
+    for (int i = 0; i < 8; i++)
+        threads[i].join();
+    int different = 0;
+    for (int i = 1; i < 8; i++)
+        different += seen[i] != seen[0];
+    CHECK_EQUAL(0, different);
+}
+
+TEST(OpCache,HoldsOneInstancePerOp) {
+    nd4j::OpCache<double> *ops = nd4j::OpCache<double>::getInstance();
+    CHECK(ops->transform(0) != nullptr);
+    CHECK(ops->transform(0) == ops->transform(0));
+    CHECK(ops->transform(-1) == nullptr);
+    CHECK(ops->transform(nd4j::OpCache<double>::MAX_OPS) == nullptr);
+    CHECK(ops->scalar(0) != nullptr);
+    CHECK(ops->pairwise(0) != nullptr);
+    CHECK(ops->broadcast(0) != nullptr);
+    CHECK(ops->ternary(0) != nullptr);
+    CHECK(ops->reduce(1) != nullptr);
+    CHECK(ops->indexReduce(0) != nullptr);
+    CHECK(ops->reduce3(0) != nullptr);
+    CHECK(ops->summaryStats(0, true) != nullptr);
+    CHECK(ops->summaryStats(0, true) != ops->summaryStats(0, false));
+    //the factories answer nullptr for numbers they do not know, and so does the cache
+    functions::transform::TransformOpFactory<double> factory;
+    int mismatches = 0;
+    for (int i = 0; i < nd4j::OpCache<double>::MAX_OPS; i++) {
+        functions::transform::Transform<double> *op = factory.getOp(i);
+        mismatches += (op == nullptr) != (ops->transform(i) == nullptr);
+        delete op;
+    }
+    CHECK_EQUAL(0, mismatches);
+}
+
+TEST(OpCache,SharedInstanceServesConcurrentCalls) {
+    const int length = 20000;
+    int shape[2] = {1, length};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    double *x = new double[length];
+    for (int i = 0; i < length; i++)
+        x[i] = i % 7;
+    double expected = 0;
+    for (int i = 0; i < length; i++)
+        expected += x[i];
+
+    functions::reduce::ReduceFunction<double> *sum = nd4j::OpCache<double>::getInstance()->reduce(1);
+    std::atomic<int> wrong(0);
+    std::thread threads[8];
+    for (int i = 0; i < 8; i++) {
+        threads[i] = std::thread([&] {
+            for (int j = 0; j < 20; j++) {
+                double extraParams[3] = {0, 0, 0};
+                if (sum->execScalar(x, shapeInfo, extraParams) != expected)
+                    wrong++;
+            }
+        });
+    }
+    for (int i = 0; i < 8; i++)
+        threads[i].join();
+    CHECK_EQUAL(0, wrong.load());
+
+    delete[] x;
+    delete[] shapeInfo;
+}
+
+#endif //NATIVEOPERATIONS_OPCACHETESTS_H
@@ -0,0 +1,233 @@
+//
+// Lazy op graph tests
+//
+
+#ifndef NATIVEOPERATIONS_OPGRAPHTESTS_H
+#define NATIVEOPERATIONS_OPGRAPHTESTS_H
+#include "testhelpers.h"
+#include <opgraph.h>
+
+TEST_GROUP(OpGraph) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+
+    }
+    void teardown() {
+    }
+};
+
+TEST(OpGraph,FusedChainEndingInReduction) {
+    const int length = 20000;
+    int shape[2] = {1, length};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    double *x = new double[length];
+    double *c = new double[length];
+    double sum[1] = {0};
+    double extraParams[3] = {0,0,0};
+    for (int i = 0; i < length; i++)
+        x[i] = -(i + 1);
+
+    nd4j::OpGraph<double> graph;
+    int in = graph.input(x, shapeInfo);
+    //a = abs(x), b = a + 1, c = a + b, sum = sum(c)
+    int a = graph.transform(0, in, nullptr);
+    int b = graph.scalar(0, a, 1.0, nullptr);
+    int cValue = graph.pairwise(0, a, b, nullptr);
+    graph.reduce(1, cValue, extraParams, sum);
+    graph.output(cValue, c, shapeInfo);
+    graph.exec();
+
+    CHECK_EQUAL(1, graph.numGroups());
+    for (int i = 0; i < length; i++)
+        CHECK_EQUAL(2 * (i + 1) + 1, c[i]);
+    DOUBLES_EQUAL((double) length * (length + 1) + length, sum[0], 1e-3);
+
+    //the graph can run again, here on new data
+    for (int i = 0; i < length; i++)
+        x[i] = 1;
+    graph.exec();
+    DOUBLES_EQUAL(3.0 * length, sum[0], 1e-6);
+
+    delete[] x;
+    delete[] c;
+    delete[] shapeInfo;
+}
+
+TEST(OpGraph,BroadcastAndStridedArrays) {
+    const int rows = 3;
+    const int cols = 4;
+    //x is every other column of a rows x 2 cols buffer
+    double *xBuffer = new double[rows * cols * 2];
+    for (int i = 0; i < rows * cols * 2; i++)
+        xBuffer[i] = i;
+    int xShape[2] = {rows, cols};
+    int *xShapeInfo = shape::shapeBuffer(2, xShape);
+    shape::stride(xShapeInfo)[0] = 2 * cols;
+    shape::stride(xShapeInfo)[1] = 2;
+    xShapeInfo[shape::shapeInfoLength(2) - 2] = -1;
+
+    double row[cols] = {100, 200, 300, 400};
+    int rowShape[2] = {1, cols};
+    int *rowShapeInfo = shape::shapeBuffer(2, rowShape);
+
+    //an f ordered result
+    double *result = new double[rows * cols];
+    int *resultShapeInfo = shape::shapeBufferFortran(2, xShape);
+
+    nd4j::OpGraph<double> graph;
+    int in = graph.input(xBuffer, xShapeInfo);
+    int bias = graph.input(row, rowShapeInfo);
+    int sum = graph.broadcast(0, in, bias);
+    graph.output(sum, result, resultShapeInfo);
+    graph.exec();
+
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++)
+            CHECK_EQUAL(xBuffer[i * 2 * cols + j * 2] + row[j], result[j * rows + i]);
+    }
+
+    delete[] xBuffer;
+    delete[] xShapeInfo;
+    delete[] rowShapeInfo;
+    delete[] result;
+    delete[] resultShapeInfo;
+}
+
+TEST(OpGraph,SpecialOpsRunOnTheirOwn) {
+    int shape[2] = {2, 3};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    double x[6] = {1, 2, 3, 4, 5, 6};
+    double total[1] = {0};
+    double extraParams[3] = {0,0,0};
+
+    nd4j::OpGraph<double> graph;
+    int in = graph.input(x, shapeInfo);
+    int scaled = graph.scalar(2, in, 0.5, nullptr);
+    //softmax along the rows, then the sum of every probability
+    int probabilities = graph.transform(38, scaled, nullptr);
+    graph.reduce(1, probabilities, extraParams, total);
+    graph.exec();
+
+    CHECK_EQUAL(3, graph.numGroups());
+    DOUBLES_EQUAL(2.0, total[0], 1e-6);
+    delete[] shapeInfo;
+}
+
+TEST(OpGraph,SpecialOpWithoutReaderGetsABuffer) {
+    int shape[2] = {2, 3};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    double x[6] = {1, 2, 3, 4, 5, 6};
+
+    nd4j::OpGraph<double> graph;
+    int in = graph.input(x, shapeInfo);
+    //softmax that nothing reads or asks for
+    graph.transform(38, in, nullptr);
+    CHECK_EQUAL(0, graph.exec());
+    CHECK_EQUAL(1, graph.numGroups());
+    delete[] shapeInfo;
+}
+
+TEST(OpGraph,RefusesPairwiseOfDifferentShapes) {
+    int xShape[2] = {2, 3};
+    int yShape[2] = {3, 2};
+    int *xShapeInfo = shape::shapeBuffer(2, xShape);
+    int *yShapeInfo = shape::shapeBuffer(2, yShape);
+    double x[6] = {1, 2, 3, 4, 5, 6};
+    double y[6] = {1, 2, 3, 4, 5, 6};
+    double result[6] = {0, 0, 0, 0, 0, 0};
+
+    nd4j::OpGraph<double> graph;
+    int a = graph.input(x, xShapeInfo);
+    int b = graph.input(y, yShapeInfo);
+    int sum = graph.pairwise(0, a, b, nullptr);
+    CHECK_EQUAL(-1, sum);
+    //refusal carries over to whatever is built on it
+    CHECK_EQUAL(-1, graph.transform(0, sum, nullptr));
+    graph.output(sum, result, xShapeInfo);
+    CHECK(graph.hasRefused());
+    CHECK_EQUAL(-1, graph.exec());
+    CHECK_EQUAL(0, graph.numGroups());
+    DOUBLES_EQUAL(0.0, result[0], 1e-9);
+
+    graph.clear();
+    CHECK(!graph.hasRefused());
+    delete[] xShapeInfo;
+    delete[] yShapeInfo;
+}
+
+TEST(OpGraph,RefusesBroadcastThatDoesNotFit) {
+    int xShape[2] = {3, 4};
+    int yShape[2] = {1, 3};
+    int rowShape[1] = {4};
+    int *xShapeInfo = shape::shapeBuffer(2, xShape);
+    int *yShapeInfo = shape::shapeBuffer(2, yShape);
+    int *rowShapeInfo = shape::shapeBuffer(1, rowShape);
+    double x[12];
+    double y[4] = {1, 2, 3, 4};
+
+    nd4j::OpGraph<double> graph;
+    int a = graph.input(x, xShapeInfo);
+    int b = graph.input(y, yShapeInfo);
+    CHECK_EQUAL(-1, graph.broadcast(0, a, b));
+    CHECK_EQUAL(-1, graph.broadcast(0, b, a));
+    CHECK_EQUAL(-1, graph.exec());
+
+    //a rank 1 row broadcasts along the last dimension
+    graph.clear();
+    a = graph.input(x, xShapeInfo);
+    b = graph.input(y, rowShapeInfo);
+    CHECK(graph.broadcast(0, a, b) >= 0);
+    CHECK(!graph.hasRefused());
+    delete[] xShapeInfo;
+    delete[] yShapeInfo;
+    delete[] rowShapeInfo;
+}
+
+TEST(OpGraph,RefusesReductionsAsValues) {
+    int shape[2] = {3, 4};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    double x[12];
+    for (int i = 0; i < 12; i++)
+        x[i] = i;
+    double total[1] = {0};
+    double result[12];
+
+    nd4j::OpGraph<double> graph;
+    int in = graph.input(x, shapeInfo);
+    int sum = graph.reduce(1, in, nullptr, total);
+    CHECK(sum >= 0);
+    CHECK_EQUAL(-1, graph.scalar(0, sum, 1.0, nullptr));
+    CHECK_EQUAL(-1, graph.output(sum, result, shapeInfo));
+    CHECK_EQUAL(-1, graph.exec());
+    delete[] shapeInfo;
+}
+
+TEST(OpGraph,RefusesOutputOfAnotherShape) {
+    int shape[2] = {3, 4};
+    int otherShape[2] = {4, 3};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    int *otherShapeInfo = shape::shapeBuffer(2, otherShape);
+    double x[12];
+    double result[12];
+
+    nd4j::OpGraph<double> graph;
+    int in = graph.input(x, shapeInfo);
+    int doubled = graph.scalar(2, in, 2.0, nullptr);
+    CHECK_EQUAL(-1, graph.output(doubled, result, otherShapeInfo));
+    CHECK_EQUAL(-1, graph.exec());
+
+    graph.clear();
+    in = graph.input(x, shapeInfo);
+    doubled = graph.scalar(2, in, 2.0, nullptr);
+    CHECK_EQUAL(0, graph.output(doubled, result, shapeInfo));
+    delete[] shapeInfo;
+    delete[] otherShapeInfo;
+}
+
+#endif //NATIVEOPERATIONS_OPGRAPHTESTS_H
@@ -0,0 +1,104 @@
+//
+// Per op profiling counter tests
+//
+
+#ifndef NATIVEOPERATIONS_OPPROFILERTESTS_H
+#define NATIVEOPERATIONS_OPPROFILERTESTS_H
+#include "testhelpers.h"
+#include <opprofiler.h>
+#include <opcache.h>
+#include <string>
+
+TEST_GROUP(OpProfiler) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+        nd4j::OpProfiler::getInstance()->reset();
+    }
+    void teardown() {
+        nd4j::OpProfiler::setEnabled(false);
+        nd4j::OpProfiler::getInstance()->reset();
+    }
+};
+
+TEST(OpProfiler,DisabledCountsNothing) {
+    nd4j::OpProfiler::setEnabled(false);
+    int shape[2] = {1, 100};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    {
+        nd4j::OpProfileScope<float> profile(nd4j::OP_FAMILY_TRANSFORM, 0, shapeInfo, nullptr, shapeInfo);
+    }
+    CHECK_EQUAL(0, (int) nd4j::OpProfiler::getInstance()->snapshot().size());
+    delete[] shapeInfo;
+}
+
+TEST(OpProfiler,CountsPerFamilyOpAndType) {
+    nd4j::OpProfiler::setEnabled(true);
+    const int length = 100;
+    int shape[2] = {1, length};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    float x[length];
+    float result[length];
+    for (int i = 0; i < length; i++)
+        x[i] = -i;
+
+    functions::transform::Transform<float> *abs = nd4j::OpCache<float>::getInstance()->transform(0);
+    for (int i = 0; i < 3; i++) {
+        nd4j::OpProfileScope<float> profile(nd4j::OP_FAMILY_TRANSFORM, 0, shapeInfo, nullptr, shapeInfo);
+        abs->exec(x, shapeInfo, result, shapeInfo, nullptr);
+    }
+    {
+        nd4j::OpProfileScope<double> profile(nd4j::OP_FAMILY_TRANSFORM, 0, length, 2);
+    }
+    {
+        nd4j::OpProfileScope<float> profile(nd4j::OP_FAMILY_SCALAR, 1, length, 2);
+    }
+    //out of range op numbers are dropped
+    nd4j::OpProfiler::getInstance()->record(nd4j::OP_FAMILY_REDUCE, nd4j::OpProfiler::MAX_OPS, 0, 1, 1, 1);
+
+    std::vector<nd4j::OpStats> stats = nd4j::OpProfiler::getInstance()->snapshot();
+    CHECK_EQUAL(3, (int) stats.size());
+    int found = 0;
+    for (size_t i = 0; i < stats.size(); i++) {
+        const nd4j::OpStats &entry = stats[i];
+        if (entry.family != nd4j::OP_FAMILY_TRANSFORM || entry.dataType != nd4j::DataTypeOf<float>::index)
+            continue;
+        found++;
+        CHECK_EQUAL(0, entry.opNum);
+        CHECK_EQUAL(3, (int) entry.calls);
+        CHECK_EQUAL(3 * length, (int) entry.elements);
+        CHECK_EQUAL(3 * 2 * length * (int) sizeof(float), (int) entry.bytes);
+        CHECK(entry.minNanos <= entry.maxNanos);
+        CHECK(entry.maxNanos <= entry.totalNanos);
+    }
+    CHECK_EQUAL(1, found);
+    for (size_t i = 1; i < stats.size(); i++)
+        CHECK(stats[i - 1].totalNanos >= stats[i].totalNanos);
+
+    nd4j::OpProfiler::getInstance()->reset();
+    CHECK_EQUAL(0, (int) nd4j::OpProfiler::getInstance()->snapshot().size());
+    delete[] shapeInfo;
+}
+
+TEST(OpProfiler,DumpsTextAndJson) {
+    nd4j::OpProfiler *profiler = nd4j::OpProfiler::getInstance();
+    profiler->record(nd4j::OP_FAMILY_REDUCE3, 2, nd4j::DataTypeOf<double>::index, 5000, 10, 160);
+    profiler->record(nd4j::OP_FAMILY_REDUCE3, 2, nd4j::DataTypeOf<double>::index, 1000, 10, 160);
+
+    std::string json = profiler->toJson();
+    std::string expected = "[{\"family\":\"reduce3\",\"opNum\":2,\"dtype\":\"double\",\"calls\":2,\"totalNanos\":6000,"
+            "\"minNanos\":1000,\"maxNanos\":5000,\"elements\":20,\"bytes\":320}]";
+    CHECK(expected == json);
+
+    std::string text = profiler->toText();
+    CHECK(text.find("family") == 0);
+    CHECK(text.find("reduce3") != std::string::npos);
+    CHECK(text.find("double") != std::string::npos);
+}
+
+#endif //NATIVEOPERATIONS_OPPROFILERTESTS_H
@@ -0,0 +1,114 @@
+//
+// Op timeline tests
+//
+
+#ifndef NATIVEOPERATIONS_OPTRACETESTS_H
+#define NATIVEOPERATIONS_OPTRACETESTS_H
+#include "testhelpers.h"
+#include <optrace.h>
+#include <opprofiler.h>
+#include <string>
+#include <thread>
+
+TEST_GROUP(OpTrace) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+        nd4j::OpTrace::getInstance()->clear();
+    }
+    void teardown() {
+        nd4j::OpTrace::setEnabled(false);
+        nd4j::OpTrace::getInstance()->clear();
+    }
+
+    int occurrences(const std::string &text, const std::string &part) {
+        int count = 0;
+        for (size_t position = text.find(part); position != std::string::npos; position = text.find(part, position + 1))
+            count++;
+        return count;
+    }
+};
+
+TEST(OpTrace,DisabledAddsNothing) {
+    nd4j::OpTrace::setEnabled(false);
+    {
+        nd4j::OpProfileScope<float> profile(nd4j::OP_FAMILY_TRANSFORM, 0, 100, 2);
+    }
+    CHECK(std::string("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[]}") == nd4j::OpTrace::getInstance()->toChromeTrace());
+}
+
+TEST(OpTrace,RecordsBeginAndEndOfEachCall) {
+    nd4j::OpTrace::setEnabled(true);
+    int shape[2] = {2, 3};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    {
+        nd4j::OpProfileScope<float> profile(nd4j::OP_FAMILY_TRANSFORM, 4, shapeInfo, nullptr, shapeInfo);
+    }
+    {
+        nd4j::OpProfileScope<double> profile(nd4j::OP_FAMILY_REDUCE, 1, 50, 1);
+    }
+    std::string trace = nd4j::OpTrace::getInstance()->toChromeTrace();
+    char tid[32];
+    snprintf(tid, sizeof(tid), "\"tid\":%d", nd4j::OpTrace::threadId());
+
+    CHECK_EQUAL(2, occurrences(trace, "\"ph\":\"B\""));
+    CHECK_EQUAL(2, occurrences(trace, "\"ph\":\"E\""));
+    CHECK_EQUAL(4, occurrences(trace, tid));
+    CHECK_EQUAL(2, occurrences(trace, "\"name\":\"transform 4\""));
+    CHECK_EQUAL(1, occurrences(trace, "\"dtype\":\"float\",\"shape\":\"[2,3]\""));
+    CHECK_EQUAL(1, occurrences(trace, "\"dtype\":\"double\",\"shape\":\"[50]\""));
+    CHECK(trace.find("\"name\":\"transform 4\",\"cat\":\"transform\",\"ph\":\"B\"") <
+          trace.find("\"name\":\"transform 4\",\"cat\":\"transform\",\"ph\":\"E\""));
+    CHECK(trace.find("\"name\":\"transform 4\",\"cat\":\"transform\",\"ph\":\"E\"") <
+          trace.find("\"name\":\"reduce 1\",\"cat\":\"reduce\",\"ph\":\"B\""));
+    delete[] shapeInfo;
+}
+
+TEST(OpTrace,EachThreadHasItsOwnId) {
+    nd4j::OpTrace::setEnabled(true);
+    int ids[4];
+    std::thread threads[4];
+    for (int i = 0; i < 4; i++) {
+        threads[i] = std::thread([&ids, i] {
+            nd4j::OpProfileScope<float> profile(nd4j::OP_FAMILY_SCALAR, i, 10, 2);
+            ids[i] = nd4j::OpTrace::threadId();
+        });
+    }
+    for (int i = 0; i < 4; i++)
+        threads[i].join();
+
+    std::string trace = nd4j::OpTrace::getInstance()->toChromeTrace();
+    int same = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int j = i + 1; j < 4; j++)
+            same += ids[i] == ids[j];
+        char tid[32];
+        snprintf(tid, sizeof(tid), "\"tid\":%d", ids[i]);
+        CHECK_EQUAL(2, occurrences(trace, tid));
+    }
+    CHECK_EQUAL(0, same);
+}
+
+TEST(OpTrace,FullRingDropsOldestEvents) {
+    nd4j::OpTrace::setEnabled(true);
+    nd4j::OpTrace *trace = nd4j::OpTrace::getInstance();
+    trace->begin(nd4j::OP_FAMILY_TRANSFORM, 7, nd4j::DataTypeOf<float>::index, (Nd4jIndex) 1);
+    for (int i = 0; i < nd4j::OpTrace::CAPACITY / 2; i++) {
+        nd4j::OpProfileScope<float> profile(nd4j::OP_FAMILY_TRANSFORM, 1, 10, 2);
+    }
+    //its begin has been overwritten
+    trace->end(nd4j::OP_FAMILY_TRANSFORM, 7, nd4j::DataTypeOf<float>::index);
+
+    std::string json = trace->toChromeTrace();
+    CHECK_EQUAL(0, occurrences(json, "\"name\":\"transform 7\""));
+    int begins = occurrences(json, "\"ph\":\"B\"");
+    CHECK_EQUAL(begins, occurrences(json, "\"ph\":\"E\""));
+    CHECK(begins >= nd4j::OpTrace::CAPACITY / 2 - 1);
+}
+
+#endif //NATIVEOPERATIONS_OPTRACETESTS_H
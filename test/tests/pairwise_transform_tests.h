@@ -489,4 +489,94 @@ TEST(PairWiseTransform,ObjectOrientedFloatSubtraction) {
 
 }
 
+TEST(PairWiseTransform,MixedOrders) {
+	//c + f in to c and f results, large enough for the parallel path
+	int shape[3] = {3,70,110};
+	int length = 3 * 70 * 110;
+	double *x = new double[length];
+	double *y = new double[length];
+	double *result = new double[length];
+	for(int i = 0; i < length; i++) {
+		x[i] = i;
+		y[i] = 2 * i;
+	}
+
+	int *cShapeInfo = shape::shapeBuffer(3,shape);
+	int *fShapeInfo = shape::shapeBufferFortran(3,shape);
+	int *cStride = shape::stride(cShapeInfo);
+	int *fStride = shape::stride(fShapeInfo);
+	functions::pairwise_transforms::PairWiseTransform<double> *op = opFactory2->getOp(0);
+	for(int o = 0; o < 2; o++) {
+		int *resultShapeInfo = o == 0 ? cShapeInfo : fShapeInfo;
+		int *resultStride = shape::stride(resultShapeInfo);
+		op->exec(x,cShapeInfo,y,fShapeInfo,result,resultShapeInfo,nullptr);
+		for(int i = 0; i < 3; i++)
+			for(int j = 0; j < 70; j++)
+				for(int k = 0; k < 110; k++) {
+					int xOffset = i * cStride[0] + j * cStride[1] + k * cStride[2];
+					int yOffset = i * fStride[0] + j * fStride[1] + k * fStride[2];
+					int resultOffset = i * resultStride[0] + j * resultStride[1] + k * resultStride[2];
+					DOUBLES_EQUAL(x[xOffset] + y[yOffset],result[resultOffset],1e-6);
+				}
+	}
+
+	delete op;
+	delete[] cShapeInfo;
+	delete[] fShapeInfo;
+	delete[] x;
+	delete[] y;
+	delete[] result;
+}
+
+TEST(PairWiseTransform,DifferentShapesStrided) {
+	//x is a c ordered 100 x 120 array, y every other element of a
+	//c ordered 120 x 200 array and the result f ordered: all three
+	//pair up by c order index and run through one plan
+	int xShape[2] = {100,120};
+	int yShape[2] = {120,100};
+	int *xShapeBuffer = shape::shapeBuffer(2, xShape);
+	int *yShapeBuffer = shape::shapeBuffer(2, yShape);
+	int *resultShapeBuffer = shape::shapeBufferFortran(2, xShape);
+	shape::stride(yShapeBuffer)[0] = 200;
+	shape::stride(yShapeBuffer)[1] = 2;
+	yShapeBuffer[shape::shapeInfoLength(2) - 2] = 2;
+	const int length = 100 * 120;
+	double *x = new double[length];
+	double *y = new double[2 * length];
+	double *result = new double[length];
+	for (int i = 0; i < length; i++)
+		x[i] = i;
+	for (int i = 0; i < 2 * length; i++)
+		y[i] = 0.5 * i;
+
+	functions::pairwise_transforms::PairWiseTransform<double> *add = opFactory2->getOp(0);
+	add->exec(x, xShapeBuffer, y, yShapeBuffer, result, resultShapeBuffer, nullptr);
+	int wrong = 0;
+	for (int i = 0; i < length; i++) {
+		int row = i / 120;
+		int column = i % 120;
+		wrong += result[column * 100 + row] != x[i] + y[2 * i];
+	}
+	CHECK_EQUAL(0, wrong);
+
+	//an f ordered y cannot be viewed as 100 x 120 and goes element by element
+	delete[] yShapeBuffer;
+	yShapeBuffer = shape::shapeBufferFortran(2, yShape);
+	add->exec(x, xShapeBuffer, y, yShapeBuffer, x, xShapeBuffer, nullptr);
+	for (int i = 0; i < length; i++) {
+		int row = i / 100;
+		int column = i % 100;
+		wrong += x[i] != i + y[column * 120 + row];
+	}
+	CHECK_EQUAL(0, wrong);
+
+	delete add;
+	delete[] x;
+	delete[] y;
+	delete[] result;
+	delete[] xShapeBuffer;
+	delete[] yShapeBuffer;
+	delete[] resultShapeBuffer;
+}
+
 #endif //NATIVEOPERATIONS_PAIRWISE_TRANSFORM_TESTS_H
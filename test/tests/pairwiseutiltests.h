@@ -248,4 +248,133 @@ TEST(PairWiseUtil,IterationTwo) {
 }
 
 
+TEST(PairWiseUtil,RankedIteration) {
+    //ranks 1 to 4 take the unrolled kernels, 5 the generic macros
+    int fullShape[5] = {3,2,4,2,3};
+    for(int rank = 1; rank <= 5; rank++) {
+        int shape[5];
+        int cStrides[5];
+        int fStrides[5];
+        int length = 1;
+        for(int i = 0; i < rank; i++) {
+            shape[i] = fullShape[i];
+            length *= shape[i];
+        }
+
+        cStrides[rank - 1] = 1;
+        for(int i = rank - 2; i >= 0; i--)
+            cStrides[i] = cStrides[i + 1] * shape[i + 1];
+        fStrides[0] = 1;
+        for(int i = 1; i < rank; i++)
+            fStrides[i] = fStrides[i - 1] * shape[i - 1];
+
+        double *x = new double[length];
+        double *result = new double[length];
+        for(int i = 0; i < length; i++) {
+            x[i] = i;
+            result[i] = -1;
+        }
+
+        int visits = 0;
+        auto kernel = [&](double *xIter, double *resultIter) {
+            resultIter[0] = xIter[0];
+            visits++;
+        };
+        RawIterTwo(rank, shape, x, cStrides, result, fStrides, kernel);
+        CHECK_EQUAL(length, visits);
+
+        int coord[5];
+        for(int i = 0; i < length; i++) {
+            int rem = i;
+            int xOffset = 0;
+            int resultOffset = 0;
+            for(int j = rank - 1; j >= 0; j--) {
+                coord[j] = rem % shape[j];
+                rem /= shape[j];
+                xOffset += coord[j] * cStrides[j];
+                resultOffset += coord[j] * fStrides[j];
+            }
+
+            CHECK_EQUAL(x[xOffset], result[resultOffset]);
+        }
+
+        delete[] x;
+        delete[] result;
+    }
+}
+
+TEST(PairWiseUtil,CoalesceContiguous) {
+    //a c ordered 4 x 1 x 3 x 5 view, contiguous: one run
+    int shape[4] = {4,1,3,5};
+    int stridesA[4] = {15,15,5,1};
+    int stridesB[4] = {15,15,5,1};
+    int rank = CoalesceRawArrayIter(4, shape, stridesA, stridesB);
+    CHECK_EQUAL(1, rank);
+    CHECK_EQUAL(60, shape[0]);
+    CHECK_EQUAL(1, stridesA[0]);
+    CHECK_EQUAL(1, stridesB[0]);
+}
+
+TEST(PairWiseUtil,CoalesceTwoLevel) {
+    //columns 0 to 2 of a c ordered 4 x 3 x 8 array: two contiguous levels
+    int shape[3] = {4,3,3};
+    int stridesA[3] = {24,8,1};
+    int rank = CoalesceRawArrayIter(3, shape, stridesA);
+    CHECK_EQUAL(2, rank);
+    CHECK_EQUAL(3, shape[0]);
+    CHECK_EQUAL(1, stridesA[0]);
+    CHECK_EQUAL(12, shape[1]);
+    CHECK_EQUAL(8, stridesA[1]);
+}
+
+TEST(PairWiseUtil,CoalesceMixedOrders) {
+    //c ordered x against f ordered result: nothing merges, unit axes still go
+    int shape[3] = {2,1,3};
+    int stridesA[3] = {3,3,1};
+    int stridesB[3] = {1,2,2};
+    int rank = CoalesceRawArrayIter(3, shape, stridesA, stridesB);
+    CHECK_EQUAL(2, rank);
+    CHECK_EQUAL(3, shape[0]);
+    CHECK_EQUAL(1, stridesA[0]);
+    CHECK_EQUAL(2, stridesB[0]);
+    CHECK_EQUAL(2, shape[1]);
+    CHECK_EQUAL(3, stridesA[1]);
+    CHECK_EQUAL(1, stridesB[1]);
+}
+
+TEST(PairWiseUtil,CoalesceKeepsExtentsInInt) {
+    //a contiguous 65536 x 65536 array has 2^32 elements: too many for one axis
+    int shape[2] = {65536,65536};
+    int stridesA[2] = {65536,1};
+    int rank = CoalesceRawArrayIter(2, shape, stridesA);
+    CHECK_EQUAL(2, rank);
+    CHECK_EQUAL(65536, shape[0]);
+    CHECK_EQUAL(1, stridesA[0]);
+    CHECK_EQUAL(65536, shape[1]);
+    CHECK_EQUAL(65536, stridesA[1]);
+}
+
+TEST(PairWiseUtil,ReshapeStrides) {
+    //every other element of a 3 x 4 array, viewed as 2 x 3
+    int shape[2] = {3,2};
+    int stride[2] = {4,2};
+    int newShape[3] = {2,1,3};
+    int newStride[3];
+    CHECK_EQUAL(0, ReshapeStridesC(2, shape, stride, 3, newShape, newStride));
+    CHECK_EQUAL(6, newStride[0]);
+    CHECK_EQUAL(2, newStride[2]);
+
+    //an f ordered 3 x 2 array cannot be split in c order
+    int fStride[2] = {1,3};
+    int flatShape[2] = {2,3};
+    CHECK_EQUAL(-1, ReshapeStridesC(2, shape, fStride, 2, flatShape, newStride));
+
+    //but its length 1 axes come and go
+    int column[2] = {6,1};
+    int columnStride[2] = {3,1};
+    int row[3] = {1,6,1};
+    CHECK_EQUAL(0, ReshapeStridesC(2, column, columnStride, 3, row, newStride));
+    CHECK_EQUAL(3, newStride[1]);
+}
+
 #endif //NATIVEOPERATIONS_PAIRWISEUTILTESTS_H
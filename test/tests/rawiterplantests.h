@@ -0,0 +1,149 @@
+//
+// Raw iteration plan tests
+//
+
+#ifndef NATIVEOPERATIONS_RAWITERPLANTESTS_H
+#define NATIVEOPERATIONS_RAWITERPLANTESTS_H
+#include "testhelpers.h"
+#include <rawiterplan.h>
+#include <transform.h>
+#include <reduce.h>
+#include <vector>
+
+TEST_GROUP(RawIterPlan) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+
+    }
+    void teardown() {
+    }
+};
+
+//a c ordered rows x cols view of the first cols columns of a rows x stride buffer
+static int *columnsView(int rows, int cols, int stride) {
+    int shape[2] = {rows, cols};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    shape::stride(shapeInfo)[0] = stride;
+    shapeInfo[shape::shapeInfoLength(2) - 2] = -1;
+    return shapeInfo;
+}
+
+TEST(RawIterPlan,SeekMatchesRun) {
+    int shape[3] = {3,4,5};
+    int *shapeInfo = shape::shapeBuffer(3, shape);
+    shape::stride(shapeInfo)[0] = 40;
+    shape::stride(shapeInfo)[1] = 10;
+    shapeInfo[shape::shapeInfoLength(3) - 2] = -1;
+
+    RawIterPlan plan(shapeInfo);
+    CHECK_EQUAL(60, plan.length);
+
+    std::vector<Nd4jIndex> visited;
+    auto record = [&](Nd4jIndex *offsets, Nd4jIndex count) {
+        for (Nd4jIndex i = 0; i < count; i++)
+            visited.push_back(offsets[0] + i * plan.strides[0][0]);
+    };
+    plan.run(0, plan.length, record);
+    CHECK_EQUAL(60, (int) visited.size());
+
+    int coord[MAX_RANK];
+    for (Nd4jIndex p = 0; p < plan.length; p++) {
+        Nd4jIndex offset;
+        plan.seek(p, coord, &offset);
+        CHECK_EQUAL(visited[p], offset);
+    }
+
+    delete[] shapeInfo;
+}
+
+TEST(RawIterPlan,SplitRangesCover) {
+    int *shapeInfo = columnsView(7, 9, 16);
+    RawIterPlan plan(shapeInfo);
+
+    std::vector<Nd4jIndex> whole;
+    auto recordWhole = [&](Nd4jIndex *offsets, Nd4jIndex count) {
+        for (Nd4jIndex i = 0; i < count; i++)
+            whole.push_back(offsets[0] + i * plan.strides[0][0]);
+    };
+    plan.run(0, plan.length, recordWhole);
+
+    std::vector<Nd4jIndex> pieces;
+    auto recordPieces = [&](Nd4jIndex *offsets, Nd4jIndex count) {
+        for (Nd4jIndex i = 0; i < count; i++)
+            pieces.push_back(offsets[0] + i * plan.strides[0][0]);
+    };
+    Nd4jIndex previousEnd = 0;
+    for (int part = 0; part < 4; part++) {
+        Nd4jIndex start, end;
+        RawIterPlan::splitRange(plan.length, part, 4, &start, &end);
+        CHECK_EQUAL(previousEnd, start);
+        CHECK(end - start == plan.length / 4 || end - start == plan.length / 4 + 1);
+        plan.run(start, end, recordPieces);
+        previousEnd = end;
+    }
+
+    CHECK_EQUAL(plan.length, previousEnd);
+    CHECK(whole == pieces);
+    delete[] shapeInfo;
+}
+
+TEST(RawIterPlan,ParallelTransformView) {
+    const int rows = 100;
+    const int cols = 120;
+    const int stride = 128;
+    double *x = new double[rows * stride];
+    for (int i = 0; i < rows * stride; i++)
+        x[i] = -i;
+    int *xShapeInfo = columnsView(rows, cols, stride);
+    int resultShape[2] = {rows, cols};
+    int *resultShapeInfo = shape::shapeBuffer(2, resultShape);
+    double *result = new double[rows * cols];
+
+    functions::transform::TransformOpFactory<double> *opFactory = new functions::transform::TransformOpFactory<double>();
+    functions::transform::Transform<double> *op = opFactory->getOp(0);
+    op->exec(x, xShapeInfo, result, resultShapeInfo, nullptr);
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            CHECK_EQUAL(i * stride + j, result[i * cols + j]);
+        }
+    }
+
+    delete op;
+    delete opFactory;
+    delete[] x;
+    delete[] result;
+    delete[] xShapeInfo;
+    delete[] resultShapeInfo;
+}
+
+TEST(RawIterPlan,ParallelReduceView) {
+    const int rows = 100;
+    const int cols = 120;
+    const int stride = 128;
+    double *x = new double[rows * stride];
+    for (int i = 0; i < rows * stride; i++)
+        x[i] = (i % stride) < cols ? 1.0 : 1000.0;
+    int *xShapeInfo = columnsView(rows, cols, stride);
+
+    double extraParams[3] = {0,0,0};
+
+    functions::reduce::ReduceOpFactory<double> *opFactory = new functions::reduce::ReduceOpFactory<double>();
+    functions::reduce::ReduceFunction<double> *sum = opFactory->create(1);
+    functions::reduce::ReduceFunction<double> *mean = opFactory->create(0);
+    DOUBLES_EQUAL(rows * cols, sum->execScalar(x, xShapeInfo, extraParams), 1e-6);
+    DOUBLES_EQUAL(1.0, mean->execScalar(x, xShapeInfo, extraParams), 1e-6);
+
+    delete sum;
+    delete mean;
+    delete opFactory;
+    delete[] x;
+    delete[] xShapeInfo;
+}
+
+#endif //NATIVEOPERATIONS_RAWITERPLANTESTS_H
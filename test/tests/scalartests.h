@@ -660,6 +660,66 @@ TEST(ScalarTransform,ObjectOrientedFloatScalarRMod) {
 }
 
 
+TEST(ScalarTransform,AlongDimension) {
+	//scale every row of a c ordered matrix and every column of an f ordered one
+	int shape[2] = {4,3000};
+	int length = 12000;
+	double *x = new double[length];
+	double *result = new double[length];
+	for(int i = 0; i < length; i++)
+		x[i] = i;
+	int vectorShape[2] = {1,4};
+	int *scalarsShapeInfo = shape::shapeBuffer(2,vectorShape);
+	double scalars[4] = {1,2,3,4};
+	functions::scalar::ScalarTransform<double> *op = opFactory4->getOp(2);
+
+	int *cShapeInfo = shape::shapeBuffer(2,shape);
+	int rowDimension[1] = {1};
+	op->transform(x,cShapeInfo,result,cShapeInfo,scalars,scalarsShapeInfo,nullptr,rowDimension,1);
+	for(int i = 0; i < 4; i++)
+		for(int j = 0; j < 3000; j++)
+			DOUBLES_EQUAL(scalars[i] * x[i * 3000 + j],result[i * 3000 + j],1e-6);
+
+	int fShape[2] = {3000,4};
+	int *fShapeInfo = shape::shapeBufferFortran(2,fShape);
+	int columnDimension[1] = {0};
+	op->transform(x,fShapeInfo,result,fShapeInfo,scalars,scalarsShapeInfo,nullptr,columnDimension,1);
+	for(int i = 0; i < length; i++)
+		DOUBLES_EQUAL(scalars[i / 3000] * x[i],result[i],1e-6);
+
+	delete op;
+	delete[] cShapeInfo;
+	delete[] fShapeInfo;
+	delete[] scalarsShapeInfo;
+	delete[] x;
+	delete[] result;
+}
+
+TEST(ScalarTransform,AlongDimensionMixedOrder) {
+	//c ordered input, f ordered result, set val or less per row
+	int shape[2] = {3,5};
+	double x[15];
+	for(int i = 0; i < 15; i++)
+		x[i] = i;
+	double result[15];
+	int *xShapeInfo = shape::shapeBuffer(2,shape);
+	int *resultShapeInfo = shape::shapeBufferFortran(2,shape);
+	int vectorShape[2] = {1,3};
+	int *scalarsShapeInfo = shape::shapeBuffer(2,vectorShape);
+	double scalars[3] = {2,7,100};
+	int dimension[1] = {1};
+	functions::scalar::ScalarTransform<double> *op = opFactory4->getOp(17);
+	op->transform(x,xShapeInfo,result,resultShapeInfo,scalars,scalarsShapeInfo,nullptr,dimension,1);
+	for(int i = 0; i < 3; i++)
+		for(int j = 0; j < 5; j++)
+			DOUBLES_EQUAL(nd4j::math::nd4j_max<double>(x[i * 5 + j],scalars[i]),result[j * 3 + i],1e-6);
+	delete op;
+	delete[] xShapeInfo;
+	delete[] resultShapeInfo;
+	delete[] scalarsShapeInfo;
+}
+
+
 
 
 #endif //NATIVEOPERATIONS_SCALARTESTS_H
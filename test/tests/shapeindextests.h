@@ -0,0 +1,141 @@
+//
+// 64 bit shape index and in place shape buffer tests; kept apart
+// from shapetests.h, whose older tests no longer build against shape.h
+//
+
+#ifndef NATIVEOPERATIONS_SHAPEINDEXTESTS_H
+#define NATIVEOPERATIONS_SHAPEINDEXTESTS_H
+#include "testhelpers.h"
+#include <shape.h>
+
+TEST_GROUP(ShapeIndex) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+
+    }
+    void teardown() {
+    }
+};
+
+TEST(ShapeIndex,Length64) {
+    //2^32 elements: past what an int can count
+    int shape[2] = {65536,65536};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    Nd4jIndex expected = 65536LL * 65536LL;
+    CHECK(expected == shape::length(shapeInfo));
+    CHECK(expected == shape::prodLong(shape,2));
+    delete[] shapeInfo;
+}
+
+TEST(ShapeIndex,Offset64) {
+    int shape[2] = {65536,65536};
+    int *cShapeInfo = shape::shapeBuffer(2,shape);
+    int *fShapeInfo = shape::shapeBufferFortran(2,shape);
+    int coord[2] = {65535,65534};
+    Nd4jIndex cOffset = 65535LL * 65536LL + 65534LL;
+    Nd4jIndex fOffset = 65534LL * 65536LL + 65535LL;
+    CHECK(cOffset == shape::getOffset(0,shape,shape::stride(cShapeInfo),coord,2));
+    CHECK(fOffset == shape::getOffset(0,shape,shape::stride(fShapeInfo),coord,2));
+
+    int out[2];
+    shape::ind2subOrder(cShapeInfo,cOffset,out);
+    CHECK_EQUAL(65535,out[0]);
+    CHECK_EQUAL(65534,out[1]);
+    shape::ind2subOrder(fShapeInfo,fOffset,out);
+    CHECK_EQUAL(65535,out[0]);
+    CHECK_EQUAL(65534,out[1]);
+    CHECK(fOffset == shape::sub2Ind(2,shape,coord));
+
+    delete[] cShapeInfo;
+    delete[] fShapeInfo;
+}
+
+TEST(ShapeIndex,ShapeBufferInPlace) {
+    int shape[3] = {2,3,4};
+    int *cAllocated = shape::shapeBuffer(3,shape);
+    int *fAllocated = shape::shapeBufferFortran(3,shape);
+    int cBuffer[MAX_RANK * 2 + 4];
+    int fBuffer[MAX_RANK * 2 + 4];
+    CHECK(cBuffer == shape::shapeBuffer(3,shape,cBuffer));
+    CHECK(fBuffer == shape::shapeBufferFortran(3,shape,fBuffer));
+    for(int i = 0; i < shape::shapeInfoLength(3); i++) {
+        CHECK_EQUAL(cAllocated[i],cBuffer[i]);
+        CHECK_EQUAL(fAllocated[i],fBuffer[i]);
+    }
+
+    //the 2d column shape the softmax kernels build
+    int columnShape[2] = {5,1};
+    int columnBuffer[8];
+    shape::shapeBuffer(2,columnShape,columnBuffer);
+    int expected[8] = {2,5,1,1,1,0,1,99};
+    for(int i = 0; i < 8; i++) {
+        CHECK_EQUAL(expected[i],columnBuffer[i]);
+    }
+
+    delete[] cAllocated;
+    delete[] fAllocated;
+}
+
+TEST(ShapeIndex,HelpersInPlace) {
+    int shape[3] = {2,3,4};
+    int stride[MAX_RANK];
+    shape::calcStrides(shape,3,stride);
+    CHECK_EQUAL(12,stride[0]);
+    CHECK_EQUAL(4,stride[1]);
+    CHECK_EQUAL(1,stride[2]);
+    shape::calcStridesFortran(shape,3,stride);
+    CHECK_EQUAL(1,stride[0]);
+    CHECK_EQUAL(2,stride[1]);
+    CHECK_EQUAL(6,stride[2]);
+
+    int range[MAX_RANK];
+    shape::range(0,6,2,range);
+    CHECK_EQUAL(0,range[0]);
+    CHECK_EQUAL(2,range[1]);
+    CHECK_EQUAL(4,range[2]);
+
+    int rearrange[3] = {2,0,1};
+    int permuted[MAX_RANK];
+    shape::doPermuteSwap(3,shape,rearrange,permuted);
+    CHECK_EQUAL(4,permuted[0]);
+    CHECK_EQUAL(2,permuted[1]);
+    CHECK_EQUAL(3,permuted[2]);
+
+    int dimension[1] = {1};
+    int rest[MAX_RANK];
+    shape::everyIndexBut(dimension,1,0,3,rest);
+    CHECK_EQUAL(0,rest[0]);
+    CHECK_EQUAL(2,rest[1]);
+}
+
+TEST(ShapeIndex,RejectsStridesPastInt) {
+    //2^29 * 4 elements per slice in c order, but only 2 * 2^29 in f order
+    int shape[3] = {2,1 << 29,4};
+    CHECK(!shape::stridesFit(3,shape,'c'));
+    CHECK(shape::stridesFit(3,shape,'f'));
+    CHECK(shape::shapeBuffer(3,shape) == nullptr);
+
+    int buffer[MAX_RANK * 2 + 4];
+    buffer[0] = -1;
+    CHECK(shape::shapeBuffer(3,shape,buffer) == nullptr);
+    CHECK_EQUAL(-1,buffer[0]);
+
+    int flipped[3] = {4,1 << 29,2};
+    CHECK(!shape::stridesFit(3,flipped,'f'));
+    CHECK(shape::stridesFit(3,flipped,'c'));
+    CHECK(shape::shapeBufferFortran(3,flipped) == nullptr);
+
+    int fits[3] = {1 << 20,2,2};
+    int *info = shape::shapeBuffer(3,fits);
+    CHECK(info != nullptr);
+    CHECK_EQUAL(4,shape::stride(info)[0]);
+    delete[] info;
+}
+
+#endif //NATIVEOPERATIONS_SHAPEINDEXTESTS_H
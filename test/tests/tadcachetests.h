@@ -0,0 +1,106 @@
+//
+// TAD cache tests
+//
+
+#ifndef NATIVEOPERATIONS_TADCACHETESTS_H
+#define NATIVEOPERATIONS_TADCACHETESTS_H
+#include "testhelpers.h"
+#include <tadcache.h>
+
+TEST_GROUP(TadCache) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+        shape::TadCache::getInstance()->purge();
+        shape::TadCache::getInstance()->resetCounters();
+    }
+    void teardown() {
+        shape::TadCache::getInstance()->setLimits(1024, 64L * 1024L * 1024L);
+        shape::TadCache::getInstance()->purge();
+        shape::TadCache::getInstance()->resetCounters();
+    }
+};
+
+
+TEST(TadCache,MatchesTad) {
+    int shape[3] = {2,3,4};
+    int *shapeInfo = shape::shapeBuffer(3,shape);
+    int dimension[1] = {1};
+    shape::TAD tad(shapeInfo,dimension,1);
+    tad.createTadOnlyShapeInfo();
+    tad.createOffsets();
+
+    std::shared_ptr<shape::TadPack> tadPack = shape::TadCache::getInstance()->get(shapeInfo,dimension,1);
+    CHECK_EQUAL(tad.numTads,tadPack->tad->numTads);
+    CHECK_EQUAL(tad.wholeThing,tadPack->tad->wholeThing);
+    for(int i = 0; i < shape::shapeInfoLength(shape::rank(tad.tadOnlyShapeInfo)); i++)
+        CHECK_EQUAL(tad.tadOnlyShapeInfo[i],tadPack->tad->tadOnlyShapeInfo[i]);
+    for(int i = 0; i < tad.numTads; i++)
+        CHECK_EQUAL(tad.tadOffsets[i],tadPack->tad->tadOffsets[i]);
+
+    delete[] shapeInfo;
+}
+
+TEST(TadCache,HitsAndMisses) {
+    shape::TadCache *cache = shape::TadCache::getInstance();
+    int shape[2] = {4,5};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    //same contents in a different buffer hits as well
+    int *sameShapeInfo = shape::shapeBuffer(2,shape);
+    int zero[1] = {0};
+    int one[1] = {1};
+
+    std::shared_ptr<shape::TadPack> first = cache->get(shapeInfo,one,1);
+    std::shared_ptr<shape::TadPack> second = cache->get(sameShapeInfo,one,1);
+    std::shared_ptr<shape::TadPack> other = cache->get(shapeInfo,zero,1);
+    CHECK(first.get() == second.get());
+    CHECK(first.get() != other.get());
+    CHECK_EQUAL(1,cache->getHits());
+    CHECK_EQUAL(2,cache->getMisses());
+    CHECK_EQUAL(2,cache->getSize());
+
+    delete[] shapeInfo;
+    delete[] sameShapeInfo;
+}
+
+TEST(TadCache,LeastRecentlyUsedEviction) {
+    shape::TadCache *cache = shape::TadCache::getInstance();
+    cache->setLimits(2, 64L * 1024L * 1024L);
+    int shape[3] = {2,3,4};
+    int *shapeInfo = shape::shapeBuffer(3,shape);
+    int dimensions[3] = {0,1,2};
+
+    std::shared_ptr<shape::TadPack> held = cache->get(shapeInfo,dimensions,1);
+    cache->get(shapeInfo,dimensions + 1,1);
+    //touch 0 so 1 is the least recently used
+    cache->get(shapeInfo,dimensions,1);
+    cache->get(shapeInfo,dimensions + 2,1);
+    CHECK_EQUAL(2,cache->getSize());
+    CHECK_EQUAL(1,cache->getEvictions());
+
+    cache->resetCounters();
+    cache->get(shapeInfo,dimensions,1);
+    cache->get(shapeInfo,dimensions + 1,1);
+    CHECK_EQUAL(1,cache->getHits());
+    CHECK_EQUAL(1,cache->getMisses());
+
+    //evicted entries stay valid while held
+    cache->purge();
+    CHECK_EQUAL(0,cache->getSize());
+    CHECK_EQUAL(12,held->tad->numTads);
+    CHECK_EQUAL(2,shape::length(held->tad->tadOnlyShapeInfo));
+
+    //no caching at all
+    cache->setLimits(0,0);
+    cache->get(shapeInfo,dimensions,1);
+    CHECK_EQUAL(0,cache->getSize());
+
+    delete[] shapeInfo;
+}
+
+#endif //NATIVEOPERATIONS_TADCACHETESTS_H
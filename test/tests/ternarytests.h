@@ -0,0 +1,81 @@
+//
+// Ternary transform tests
+//
+
+#ifndef NATIVEOPERATIONS_TERNARYTESTS_H
+#define NATIVEOPERATIONS_TERNARYTESTS_H
+#include "testhelpers.h"
+#include <ternary.h>
+
+static functions::ternary::TernaryOpFactory<double> *ternaryOpFactory = 0;
+
+TEST_GROUP(TernaryTransform) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+        ternaryOpFactory = new functions::ternary::TernaryOpFactory<double>();
+    }
+    void teardown() {
+        delete ternaryOpFactory;
+    }
+};
+
+
+TEST(TernaryTransform,Contiguous) {
+    int shape[2] = {2,2};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    double x[4] = {1,0,-3,4};
+    double y[4] = {2,2,2,2};
+    double z[4] = {1,5,3,3};
+    double params[3] = {2,-1,0.5};
+    double result[4];
+    double assertions[4][4] = {
+            {3,5,-3,11},
+            {0.5,0.5,-6.5,7.5},
+            {2,5,2,2},
+            {1,2,2,3}
+    };
+
+    for(int op = 0; op < 4; op++) {
+        functions::ternary::TernaryTransform<double> *transform = ternaryOpFactory->getOp(op);
+        transform->exec(x,shapeInfo,y,shapeInfo,z,shapeInfo,result,shapeInfo,params);
+        for(int i = 0; i < 4; i++)
+            DOUBLES_EQUAL(assertions[op][i],result[i],1e-6);
+        delete transform;
+    }
+
+    delete[] shapeInfo;
+}
+
+TEST(TernaryTransform,MixedOrders) {
+    //fma of a c ordered x, an f ordered y and a c ordered z in to an f ordered result
+    int shape[2] = {3,4};
+    int *cShapeInfo = shape::shapeBuffer(2,shape);
+    int *fShapeInfo = shape::shapeBufferFortran(2,shape);
+    double x[12];
+    double y[12];
+    double z[12];
+    double result[12];
+    for(int i = 0; i < 12; i++) {
+        x[i] = i;
+        y[i] = i + 1;
+        z[i] = 100 * i;
+    }
+
+    functions::ternary::TernaryTransform<double> *transform = ternaryOpFactory->getOp(0);
+    transform->exec(x,cShapeInfo,y,fShapeInfo,z,cShapeInfo,result,fShapeInfo,nullptr);
+    for(int i = 0; i < 3; i++)
+        for(int j = 0; j < 4; j++)
+            DOUBLES_EQUAL(x[i * 4 + j] * y[j * 3 + i] + z[i * 4 + j],result[j * 3 + i],1e-6);
+
+    delete transform;
+    delete[] cShapeInfo;
+    delete[] fShapeInfo;
+}
+
+#endif //NATIVEOPERATIONS_TERNARYTESTS_H
@@ -0,0 +1,163 @@
+//
+// Work stealing thread pool tests
+//
+
+#ifndef NATIVEOPERATIONS_THREADPOOLTESTS_H
+#define NATIVEOPERATIONS_THREADPOOLTESTS_H
+#include "testhelpers.h"
+#include <threadpool.h>
+#include <transform.h>
+#include <scalar.h>
+#include <pairwise_transform.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+TEST_GROUP(ThreadPool) {
+
+    static int output_method(const char* output, ...) {
+        va_list arguments;
+        va_start(arguments, output);
+        va_end(arguments);
+        return 1;
+    }
+    void setup() {
+
+    }
+    void teardown() {
+        nd4j::ThreadPool::setEnabled(false);
+    }
+};
+
+TEST(ThreadPool,ParallelForCoversEveryIterationOnce) {
+    nd4j::ThreadPool pool(3);
+    const Nd4jIndex length = 100003;
+    std::atomic<int> *visits = new std::atomic<int>[length];
+    for (Nd4jIndex i = 0; i < length; i++)
+        visits[i] = 0;
+
+    std::atomic<Nd4jIndex> shortest(length);
+    auto func = [&](Nd4jIndex start, Nd4jIndex end) {
+        for (Nd4jIndex i = start; i < end; i++)
+            visits[i]++;
+        if (end < length && end - start < shortest.load())
+            shortest = end - start;
+    };
+    pool.parallelFor(0, length, 100, func);
+
+    Nd4jIndex wrong = 0;
+    for (Nd4jIndex i = 0; i < length; i++)
+        wrong += visits[i].load() != 1;
+    CHECK_EQUAL(0, wrong);
+    //only the last range may come in under the grain
+    CHECK(shortest.load() >= 100);
+    delete[] visits;
+}
+
+TEST(ThreadPool,TaskGroupRunsEveryTask) {
+    nd4j::ThreadPool pool(2);
+    std::atomic<int> count(0);
+    nd4j::ThreadPool::TaskGroup group(&pool);
+    for (int i = 0; i < 200; i++)
+        group.run([&] { count++; });
+    group.wait();
+    CHECK_EQUAL(200, count.load());
+}
+
+TEST(ThreadPool,NestedLoopsFinish) {
+    //more nested loops than workers: waiting threads have to run the inner tasks
+    nd4j::ThreadPool pool(2);
+    std::atomic<Nd4jIndex> sum(0);
+    auto outer = [&](Nd4jIndex start, Nd4jIndex end) {
+        for (Nd4jIndex i = start; i < end; i++) {
+            auto inner = [&](Nd4jIndex innerStart, Nd4jIndex innerEnd) {
+                Nd4jIndex local = 0;
+                for (Nd4jIndex j = innerStart; j < innerEnd; j++)
+                    local += j;
+                sum += local;
+            };
+            pool.parallelFor(0, 1000, 10, inner);
+        }
+    };
+    pool.parallelFor(0, 64, 1, outer);
+    CHECK_EQUAL(64L * 999L * 1000L / 2L, sum.load());
+}
+
+TEST(ThreadPool,ConcurrencyIsSharedByCallers) {
+    nd4j::ThreadPool pool(6);
+    pool.setConcurrency(0);
+    int calls = 0;
+    auto count = [&](Nd4jIndex start, Nd4jIndex end) { calls++; };
+    pool.parallelFor(0, 100000, 1, count);
+    //no budget: the caller runs the whole range alone
+    CHECK_EQUAL(1, calls);
+
+    pool.setConcurrency(2);
+    std::atomic<int> active(0);
+    std::atomic<int> mostActive(0);
+    auto busy = [&](Nd4jIndex start, Nd4jIndex end) {
+        int now = ++active;
+        int most = mostActive.load();
+        while (now > most && !mostActive.compare_exchange_weak(most, now));
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        active--;
+    };
+    std::thread callers[3];
+    for (int i = 0; i < 3; i++)
+        callers[i] = std::thread([&] { pool.parallelFor(0, 64, 1, busy); });
+    for (int i = 0; i < 3; i++)
+        callers[i].join();
+    //three callers and two helpers between them
+    CHECK(mostActive.load() <= 5);
+    CHECK_EQUAL(0, active.load());
+}
+
+TEST(ThreadPool,KernelsMatchOpenMP) {
+    const int length = 100000;
+    int shape[2] = {1, length};
+    int *shapeInfo = shape::shapeBuffer(2, shape);
+    double *x = new double[length];
+    double *y = new double[length];
+    double *openmp = new double[length];
+    double *pool = new double[length];
+    for (int i = 0; i < length; i++) {
+        x[i] = i % 2 == 0 ? -i : i;
+        y[i] = 0.5 * i;
+    }
+
+    functions::transform::TransformOpFactory<double> transformFactory;
+    functions::scalar::ScalarOpFactory<double> scalarFactory;
+    functions::pairwise_transforms::PairWiseTransformOpFactory<double> pairwiseFactory;
+    functions::transform::Transform<double> *abs = transformFactory.getOp(0);
+    functions::scalar::ScalarTransform<double> *add = scalarFactory.getOp(0);
+    functions::pairwise_transforms::PairWiseTransform<double> *sum = pairwiseFactory.getOp(0);
+
+    for (int kernel = 0; kernel < 3; kernel++) {
+        for (int usePool = 0; usePool < 2; usePool++) {
+            nd4j::ThreadPool::setEnabled(usePool == 1);
+            double *result = usePool == 1 ? pool : openmp;
+            if (kernel == 0)
+                abs->exec(x, shapeInfo, result, shapeInfo, nullptr);
+            else if (kernel == 1)
+                add->transform(x, 1, result, 1, 3.0, nullptr, length);
+            else
+                sum->exec(x, 1, y, 1, result, 1, nullptr, length);
+        }
+        int mismatches = 0;
+        for (int i = 0; i < length; i++)
+            mismatches += openmp[i] != pool[i];
+        CHECK_EQUAL(0, mismatches);
+    }
+    DOUBLES_EQUAL(149998.5, pool[99999], 1e-6);
+
+    delete abs;
+    delete add;
+    delete sum;
+    delete[] x;
+    delete[] y;
+    delete[] openmp;
+    delete[] pool;
+    delete[] shapeInfo;
+}
+
+#endif //NATIVEOPERATIONS_THREADPOOLTESTS_H
@@ -485,6 +485,22 @@ TEST(Transform,ObjectOrientedFloatPow) {
     delete data;
 }
 
+TEST(Transform,IsMaxTooManyDimensions) {
+    //more dimensions than MAX_RANK: the max of the whole array
+    int shape[2] = {2,3};
+    int *shapeInfo = shape::shapeBuffer(2,shape);
+    double x[6] = {1,5,2,3,0,4};
+    double result[6];
+    double extraParams[1] = {MAX_RANK + 8};
+    functions::transform::Transform<double> *isMax = opFactory->getOp(41);
+    isMax->exec(x,shapeInfo,result,shapeInfo,extraParams);
+    double expected[6] = {0,1,0,0,0,0};
+    for(int i = 0; i < 6; i++)
+        CHECK_EQUAL(expected[i],result[i]);
+    delete isMax;
+    delete[] shapeInfo;
+}
+
 
 
 